@@ -33,30 +33,192 @@
 #include "wiced_timer.h"
 #include "beacon_gatt.h"
 #include "wiced_bt_beacon.h"
+#include "beacon_cache.h"
+#include "beacon_mem.h"
+#include "beacon_sched.h"
+#include "beacon_adv_set.h"
+#include "beacon_ctrl.h"
+#include "beacon_log.h"
+#include "beacon_eid.h"
+#include "beacon_etlm.h"
+#include "beacon_time.h"
+#include "beacon_provision.h"
+#include "beacon_pool.h"
+#include "beacon_prof.h"
 #include "stdio.h"
 #include "stdlib.h"
+#include "string.h"
 #include "inttypes.h"
 
 /******************************************************************************
  *                                Defines
  ******************************************************************************/
-#define BEACON_CNT 5
+/* Built-in beacons, the first entries of the beacon table */
+#define BEACON_BUILTIN_CNT 5
+
+/* Max logical beacons, built-in plus zone beacons */
+#ifndef BEACON_MAX
+#define BEACON_MAX 256
+#endif
+
+/* Zone iBeacons added after the built-in beacons, can be changed with beacon_set_zone_beacons() */
+#ifndef BEACON_ZONE_CNT
+#define BEACON_ZONE_CNT 0
+#endif
+
+/* Zone iBeacon adv interval, first major number and minor numbers (zones) per major */
+#define BEACON_ZONE_INTERVAL        320
+#define BEACON_ZONE_MAJOR_BASE      0x0100
+#define BEACON_ZONE_MINORS          16
+
+/* Index of the Eddystone TLM entry in the legacy beacon table, its inputs change every second */
+#define BEACON_IDX_TLM 4
+
+/* Index of the Eddystone EID entry in the legacy beacon table, its identifier changes every 2^exponent seconds */
+#define BEACON_IDX_EID 3
+
+/* EID rotation exponent, the identifier changes every 2^BEACON_EID_EXPONENT seconds */
+#ifndef BEACON_EID_EXPONENT
+#define BEACON_EID_EXPONENT 10
+#endif
+
+/*
+ * Extended adv mode: the built-in frames are packed into one non-legacy adv set
+ * and the zone iBeacons several per set, with the payload on the secondary PHY.
+ * Can be changed with beacon_set_ext_adv().
+ */
+#ifndef BEACON_EXT_ADV
+#define BEACON_EXT_ADV 0
+#endif
+
+/* Secondary PHY carrying the extended adv payload */
+#ifndef BEACON_EXT_ADV_SECONDARY_PHY
+#define BEACON_EXT_ADV_SECONDARY_PHY WICED_BT_BLE_EXT_ADV_PHY_2M
+#endif
+
+/* Adv interval of the extended set carrying the built-in frames, the fastest built-in interval */
+#define BEACON_EXT_BUILTIN_INTERVAL 80
+
+/* Zone iBeacon frames packed into one extended adv set */
+#define BEACON_ZONE_PER_EXT_ADV     ((WICED_BT_BEACON_EXT_ADV_DATA_MAX - WICED_BT_BEACON_FLAGS_AD_LEN) / \
+                                     (IBEACON_ADV_LEN - WICED_BT_BEACON_FLAGS_AD_LEN))
+
+/*
+ * Periodic adv mode for telemetry: TLM leaves the rotation and goes out on a
+ * periodic train of its own extended set, whose adv data is only the sync
+ * header. Scanners sync once and then get TLM on a fixed schedule without
+ * scanning the primary channels. Can be changed with beacon_set_tlm_periodic().
+ */
+#ifndef BEACON_TLM_PERIODIC
+#define BEACON_TLM_PERIODIC 0
+#endif
+
+/* Adv interval of the TLM sync set, 0.625 ms units, and the periodic interval, 1.25 ms units (1 s, the TLM update rate) */
+#define BEACON_TLM_SYNC_INTERVAL        1280
+#define BEACON_TLM_PERIODIC_INTERVAL    800
+
+/* Adv set owner of the TLM periodic set, not a beacon table index */
+#define BEACON_OWNER_TLM_PERIODIC       BEACON_MAX
+
+/* Patch the resident TLM frame in place every second instead of re-encoding it */
+#ifndef BEACON_TLM_INCREMENTAL
+#define BEACON_TLM_INCREMENTAL 1
+#endif
+
+/*
+ * Encrypted telemetry: TLM goes out as eTLM, encrypted with the EID identity
+ * key and the time base of the current EID period. Can be changed with
+ * beacon_set_tlm_encrypted().
+ */
+#ifndef BEACON_TLM_ENCRYPTED
+#define BEACON_TLM_ENCRYPTED 0
+#endif
+
+/*
+ * Static payloads: the iBeacon, UID and URL adv data of the sample values are
+ * built by the preprocessor into const arrays in flash. beacon_start() hands
+ * them to the controller as they are, with no encoding and no copy, until
+ * beacon_set_provisioning() replaces the sample values.
+ */
+#ifndef BEACON_STATIC_ADV
+#define BEACON_STATIC_ADV 1
+#endif
+
+/*
+ * Tickless rotation: instead of a timer waking the MCU every second, the
+ * scheduler is run ahead to the next second that changes the set
+ * assignment. The sets losing their beacon then are enabled with that
+ * duration, and the controller ends them and wakes the MCU with their
+ * set-terminated events. TLM and the EID are brought up to date at each
+ * wakeup. Can be changed with beacon_set_tickless().
+ */
+#ifndef BEACON_TICKLESS
+#define BEACON_TICKLESS 0
+#endif
+
+/* Longest tickless sleep in seconds, bounds how old the TLM frame on air gets */
+#ifndef BEACON_TICKLESS_MAX_SEC
+#define BEACON_TICKLESS_MAX_SEC 10
+#endif
+
+/* Seconds the wakeup timer waits past a transition for the set-terminated events */
+#define BEACON_TICKLESS_GUARD_SEC   1
+
+/* Adv duration units (10 ms) per second */
+#define BEACON_DURATION_PER_SEC     100
+
+#if BEACON_TICKLESS_MAX_SEC * BEACON_DURATION_PER_SEC > 0xffff
+#error "BEACON_TICKLESS_MAX_SEC exceeds the longest adv duration"
+#endif
+
+/* Scheduler policy deciding which beacons own the adv sets every second */
+#ifndef BEACON_SCHED_POLICY
+#define BEACON_SCHED_POLICY beacon_sched_deadline
+#endif
+
+#if BEACON_CACHE_SLOTS < BEACON_BUILTIN_CNT
+#error "BEACON_CACHE_SLOTS must cover all BEACON_BUILTIN_CNT beacons"
+#endif
+
+#if BEACON_IDX_TLM != BEACON_BUILTIN_CNT - 1
+#error "TLM must be the last built-in beacon so periodic mode can drop it from the table"
+#endif
 
 /* Stack size */
-#define APP_HEAP_SIZE      (1024 * 8)
+#define APP_HEAP_SIZE      BEACON_MEM_HEAP_SIZE
 
 /* User defined UUID for iBeacon */
 #define UUID_IBEACON     0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
 
+/* Major << 16 | minor of the built-in iBeacon */
+#define IBEACON_MAJOR_MINOR     0x00010002
+
+/* Sample values of the built-in beacons, the RAM copies below start from them */
+#define SAMPLE_IBEACON_TX_POWER 0xb3
+#define SAMPLE_RANGING_DATA     0xf0
+#define SAMPLE_NAMESPACE        1, 2, 3, 4, 5, 6, 7, 8, 9, 0
+#define SAMPLE_INSTANCE         0, 1, 2, 3, 4, 5
+#define SAMPLE_URL_TX_POWER     0x01
+#define SAMPLE_URL              "http://www.infineon.com"
+
+/* SAMPLE_URL compressed: scheme "http://www.", "infineon" and the ".com" code, checked against the encoder on the host */
+#define SAMPLE_URL_SCHEME       EDDYSTONE_URL_SCHEME_0
+#define SAMPLE_URL_ENCODED      'i', 'n', 'f', 'i', 'n', 'e', 'o', 'n', 0x07
+#define SAMPLE_URL_ENCODED_LEN  9
+
+/* Random address of the adv sets, the owner of a set is XORed into bytes 1 and 2 */
+#define BEACON_RANDOM_BDA       0x40, 0x00, 0x00, 0x03, 0x04, 0x05
+
 /* Adv parameter defines */
 #define PARAM_EVENT_PROPERTY    (WICED_BT_BLE_EXT_ADV_EVENT_CONNECTABLE_ADV|WICED_BT_BLE_EXT_ADV_EVENT_SCANNABLE_ADV|WICED_BT_BLE_EXT_ADV_EVENT_LEGACY_ADV)    // wiced_bt_ble_ext_adv_event_property_t
 #define PARAM_FILTER_POLICY     (BTM_BLE_ADV_POLICY_ACCEPT_CONN_AND_SCAN)       // wiced_bt_ble_advert_filter_policy_t
 #define PARAM_TX_POWER_MAX      0x7f                                            // tBTM_BLE_ADV_TX_POWER
 #define PARAM_SCAN_REQ_NOTIF    WICED_BT_BLE_EXT_ADV_SCAN_REQ_NOTIFY_ENABLE     // wiced_bt_ble_ext_adv_scan_req_notification_setting_t
 
-#define beacon_idx(i) (i-1)
-#define beacon_adv_id(i) (i+1)
-#define valid_instance(i) (i <= supported_adv)
+/* Extended adv parameter defines, non-connectable and non-scannable so the payload can exceed 31 bytes */
+#define PARAM_EXT_EVENT_PROPERTY    WICED_BT_BLE_EXT_ADV_EVENT_NON_CONN_NON_SCAN_UNDIRECTED     // wiced_bt_ble_ext_adv_event_property_t
+#define PARAM_EXT_FILTER_POLICY     BTM_BLE_ADV_POLICY_ACCEPT_CONN_AND_SCAN                     // wiced_bt_ble_advert_filter_policy_t
+#define PARAM_EXT_SCAN_REQ_NOTIF    WICED_BT_BLE_EXT_ADV_SCAN_REQ_NOTIFY_DISABLE                // wiced_bt_ble_ext_adv_scan_req_notification_setting_t
 
 #define beacon_set_instance_params(instance, interval)   wiced_bt_ble_set_ext_adv_parameters(\
     instance,                           /* wiced_bt_ble_ext_adv_handle_t adv_handle */ \
@@ -75,23 +237,81 @@
     0,                                  /* wiced_bt_ble_ext_adv_sid_t adv_sid */ \
     PARAM_SCAN_REQ_NOTIF);              /* wiced_bt_ble_ext_adv_scan_req_notification_setting_t scan_request_not */
 
+#define beacon_set_ext_instance_params(instance, interval)   wiced_bt_ble_set_ext_adv_parameters(\
+    instance,                           /* wiced_bt_ble_ext_adv_handle_t adv_handle */ \
+    PARAM_EXT_EVENT_PROPERTY,           /* wiced_bt_ble_ext_adv_event_property_t event_properties */ \
+    interval,                           /* uint32_t primary_adv_int_min */ \
+    interval,                           /* uint32_t primary_adv_int_max */ \
+    BTM_BLE_DEFAULT_ADVERT_CHNL_MAP,    /* wiced_bt_ble_advert_chnl_map_t primary_adv_channel_map */ \
+    BLE_ADDR_RANDOM,                    /* wiced_bt_ble_address_type_t own_addr_type */ \
+    BLE_ADDR_RANDOM,                    /* wiced_bt_ble_address_type_t peer_addr_type */ \
+    peer_addr,                          /* wiced_bt_device_address_t peer_addr */ \
+    PARAM_EXT_FILTER_POLICY,            /* wiced_bt_ble_advert_filter_policy_t adv_filter_policy */ \
+    PARAM_TX_POWER_MAX,                 /* int8_t adv_tx_power */ \
+    WICED_BT_BLE_EXT_ADV_PHY_1M,        /* wiced_bt_ble_ext_adv_phy_t primary_adv_phy */ \
+    0,                                  /* uint8_t secondary_adv_max_skip */ \
+    BEACON_EXT_ADV_SECONDARY_PHY,       /* wiced_bt_ble_ext_adv_phy_t secondary_adv_phy */ \
+    instance,                           /* wiced_bt_ble_ext_adv_sid_t adv_sid */ \
+    PARAM_EXT_SCAN_REQ_NOTIF);          /* wiced_bt_ble_ext_adv_scan_req_notification_setting_t scan_request_not */
+
 /******************************************************************************
  *                                Structures
  ******************************************************************************/
-typedef uint8_t beacon_adv_data_t[WICED_BT_BEACON_ADV_DATA_MAX];
+typedef uint8_t beacon_adv_data_t[WICED_BT_BEACON_EXT_ADV_DATA_MAX];
 typedef uint8_t eddystone_namespace_t[EDDYSTONE_UID_NAMESPACE_LEN];
 typedef uint8_t eddystone_instance_t[EDDYSTONE_UID_INSTANCE_ID_LEN];
 typedef uint8_t eddystone_eid_data_t[EDDYSTONE_EID_LEN];
-typedef uint8_t eddystone_encoded_url_t[EDDYSTONE_URL_VALUE_MAX_LEN];
 typedef uint8_t eddystone_etlm_t[EDDYSTONE_ETLM_LEN];
-typedef uint8_t (set_data_func_t)(beacon_adv_data_t adv_data);
+typedef uint8_t (set_data_func_t)(uint32_t param, beacon_adv_data_t adv_data);
+
+/* Encoder of a logical beacon, index into beacon_encoders[] */
+enum
+{
+    BEACON_KIND_IBEACON,
+    BEACON_KIND_EDDYSTONE_UID,
+    BEACON_KIND_EDDYSTONE_URL,
+    BEACON_KIND_EDDYSTONE_EID,
+    BEACON_KIND_EDDYSTONE_TLM,
+    BEACON_KIND_EXT_BUILTIN,    /* All built-in frames in one extended adv */
+    BEACON_KIND_EXT_ZONES,      /* Zone iBeacons, param is first zone << 16 | count */
+};
+
+/* Built-in beacon description */
 typedef struct
 {
-    set_data_func_t * set_data;
-    uint32_t interval;
-    uint8_t  id;
+    uint8_t               kind;
+    uint16_t              interval;
+    uint32_t              param;
+    beacon_sched_target_t target;
 } beacon_adv_t;
 
+/*
+ * Logical beacon table, one array per field in a single buffer sized for
+ * cnt beacons at init. Stepping through one field touches only that field.
+ */
+typedef struct
+{
+    uint16_t               cnt;
+    beacon_sched_state_t  *sched;       /* Scheduler state */
+    uint32_t              *param;       /* Encoder input, e.g. iBeacon major << 16 | minor */
+    beacon_sched_target_t *target;      /* On-air share and staleness limit */
+    uint16_t              *interval;    /* Adv interval, 0.625 ms units */
+    uint8_t               *kind;        /* Encoder */
+    uint8_t               *id;          /* Adv set handle, 0 when off air */
+} beacon_table_t;
+
+/* Constant adv data of a beacon kind and param */
+typedef struct
+{
+    const uint8_t *p_data;
+    uint8_t        len;
+    uint32_t       param;
+} beacon_static_adv_t;
+
+/* RAM of one logical beacon in the beacon table */
+#define BEACON_TABLE_ENTRY_SIZE (sizeof(beacon_sched_state_t) + sizeof(uint32_t) + sizeof(beacon_sched_target_t) + \
+                                 sizeof(uint16_t) + sizeof(uint8_t) + sizeof(uint8_t))
+
 
 /******************************************************************************
  *                              Variables Definitions
@@ -100,9 +320,73 @@ static uint8_t                                  supported_adv;
 static wiced_bt_device_address_t                peer_addr = {0,0,0,0,0,0};
 static uint16_t                                 beacon_conn_id = 0;
 static wiced_bt_db_hash_t                       beacon_db_hash;
-static wiced_bt_ble_ext_adv_duration_config_t   duration_cfg[BEACON_CNT] = {{1},{2},{3},{4},{5}};
 static wiced_timer_t                            beacon_timer;
-static uint8_t                                  adv_idx = 0;
+static wiced_bool_t                             beacon_tickless = BEACON_TICKLESS;
+static uint16_t                                 beacon_tickless_stop[BEACON_SCHED_MAX_SETS];   // transition the MCU sleeps until
+static uint16_t                                 beacon_tickless_start[BEACON_SCHED_MAX_SETS];
+static uint16_t                                 beacon_tickless_stop_cnt;
+static uint16_t                                 beacon_tickless_start_cnt;
+static uint32_t                                 beacon_tickless_ticks;                         // seconds from the last wakeup to the transition
+static uint16_t                                 beacon_tickless_wait;                          // set-terminated events still due
+static uint32_t                                 beacon_tickless_gen;                           // plan generation, new with every plan
+static uint32_t                                 beacon_tickless_armed[BEACON_ADV_SET_MAX + 1]; // generation that armed each set handle, until its event
+static wiced_bool_t                             beacon_tickless_late[BEACON_ADV_SET_MAX + 1];  // event of an earlier plan still due, the guard timer went on without it
+static beacon_sched_t                           beacon_sched;
+static beacon_table_t                           beacon_table;
+static uint16_t                                 beacon_zone_cnt = BEACON_ZONE_CNT;
+static wiced_bool_t                             beacon_ext_adv = BEACON_EXT_ADV;
+static uint16_t                                 beacon_idx_tlm = BEACON_IDX_TLM;
+static uint16_t                                 beacon_idx_eid = BEACON_IDX_EID;
+static uint8_t                                  beacon_tlm_frame = EDDYSTONE_ADV_HDR_LEN;   // TLM frame type offset in its adv data
+static wiced_bool_t                             beacon_tlm_periodic = BEACON_TLM_PERIODIC;
+static uint8_t                                  beacon_tlm_periodic_id;                     // TLM periodic set handle, 0 when not used
+static uint8_t                                  beacon_tlm_periodic_data[WICED_BT_BEACON_ADV_DATA_MAX];
+static uint8_t                                  beacon_tlm_periodic_len;
+static wiced_bool_t                             beacon_tlm_encrypted = BEACON_TLM_ENCRYPTED;
+static beacon_etlm_ctx_t                        beacon_etlm;                                // eTLM key state, salt independent blocks
+static const beacon_time_store_t               *beacon_time_storage;                        // EID time checkpoint, see beacon_set_time_store()
+static uint16_t                                 tlm_vbatt = 10;
+static uint16_t                                 tlm_temp = 15;
+static uint32_t                                 tlm_adv_cnt = 0;
+static uint32_t                                 tlm_sec_cnt = 0;
+
+/* Sample values of the built-in beacons */
+static uint8_t                                  sample_ranging_data = SAMPLE_RANGING_DATA;
+static eddystone_namespace_t                    sample_namespace = { SAMPLE_NAMESPACE };
+static eddystone_instance_t                     sample_instance = { SAMPLE_INSTANCE };
+static uint8_t                                  sample_url_tx_power = SAMPLE_URL_TX_POWER;
+static const char                               sample_url[] = SAMPLE_URL;                  // compressed to the shortest frame
+static eddystone_eid_data_t                     sample_eid;                                 // current EID, from the rotation engine
+static uint8_t                                  sample_eid_identity_key[BEACON_AES_KEY_LEN] =
+    { 0x00,0x11,0x22,0x33,0x44,0x55,0x66,0x77,0x88,0x99,0xaa,0xbb,0xcc,0xdd,0xee,0xff };
+static uint8_t                                  sample_ibeacon_uuid[LEN_UUID_128] = { UUID_IBEACON };
+static uint8_t                                  sample_ibeacon_tx_power = SAMPLE_IBEACON_TX_POWER;
+static uint32_t                                 sample_ibeacon_major_minor = IBEACON_MAJOR_MINOR;
+static wiced_bt_device_address_t                beacon_random_bda = { BEACON_RANDOM_BDA };   // replaced by beacon_set_provisioning()
+static wiced_bool_t                             beacon_static_adv_on = BEACON_STATIC_ADV;   // the sample values are those of the static payloads
+static wiced_bool_t                             beacon_enabled;                             // BTM_ENABLED_EVT seen, the identity is in use
+
+/* Adv data of the sample values, encoded at build time */
+static const uint8_t beacon_static_ibeacon[] =
+{
+    IBEACON_ADV_DATA_INIT(UUID_IBEACON, IBEACON_MAJOR_MINOR >> 16, IBEACON_MAJOR_MINOR & 0xffff, SAMPLE_IBEACON_TX_POWER)
+};
+static const uint8_t beacon_static_uid[] =
+{
+    EDDYSTONE_UID_ADV_DATA_INIT(SAMPLE_RANGING_DATA, SAMPLE_NAMESPACE, SAMPLE_INSTANCE)
+};
+static const uint8_t beacon_static_url[] =
+{
+    EDDYSTONE_URL_ADV_DATA_INIT(SAMPLE_URL_TX_POWER, SAMPLE_URL_SCHEME, SAMPLE_URL_ENCODED_LEN, SAMPLE_URL_ENCODED)
+};
+
+/* Static payloads, indexed by beacon kind, a kind without one has a NULL p_data */
+static const beacon_static_adv_t beacon_static_adv[] =
+{
+    [BEACON_KIND_IBEACON]       = { beacon_static_ibeacon, sizeof(beacon_static_ibeacon), IBEACON_MAJOR_MINOR },
+    [BEACON_KIND_EDDYSTONE_UID] = { beacon_static_uid,     sizeof(beacon_static_uid),     0 },
+    [BEACON_KIND_EDDYSTONE_URL] = { beacon_static_url,     sizeof(beacon_static_url),     0 },
+};
 
 extern const wiced_bt_cfg_settings_t app_cfg_settings;
 /******************************************************************************
@@ -114,166 +398,663 @@ extern const wiced_bt_cfg_settings_t app_cfg_settings;
  */
 void print_bd_address(wiced_bt_device_address_t bdadr)
 {
-    printf("%02X:%02X:%02X:%02X:%02X:%02X\n",bdadr[0],bdadr[1],bdadr[2],bdadr[3],bdadr[4],bdadr[5]);
+    BEACON_LOG_INFO("%02X:%02X:%02X:%02X:%02X:%02X\n",bdadr[0],bdadr[1],bdadr[2],bdadr[3],bdadr[4],bdadr[5]);
 }
 
 /*
  * This function prepares Google Eddystone UID advertising data
  */
-static uint8_t beacon_set_eddystone_uid_advertisement_data(beacon_adv_data_t adv_data)
+static uint8_t beacon_set_eddystone_uid_advertisement_data(uint32_t param, beacon_adv_data_t adv_data)
 {
     /* Set sample values for Eddystone UID*/
     uint8_t len;
-    uint8_t ranging_data = 0xf0;
-    eddystone_namespace_t namespace = { 1,2,3,4,5,6,7,8,9,0 };
-    eddystone_instance_t instance = { 0,1,2,3,4,5 };
 
+    (void)param;
     /* Call Eddystone UID api to prepare adv data*/
-    wiced_bt_eddystone_set_data_for_uid(ranging_data, namespace, instance, adv_data, &len);
+    wiced_bt_eddystone_set_data_for_uid(sample_ranging_data, sample_namespace, sample_instance, adv_data, &len);
     return len;
 }
 
 /*
 * This function prepares Google Eddystone URL advertising data
 */
-static uint8_t beacon_set_eddystone_url_advertisement_data(beacon_adv_data_t adv_data)
+static uint8_t beacon_set_eddystone_url_advertisement_data(uint32_t param, beacon_adv_data_t adv_data)
 {
-    /* Set sample values for Eddystone URL*/
-    uint8_t len;
-    uint8_t beacon_tx_power = 0x01;
-    eddystone_encoded_url_t encoded_url = "infineon.com";
-
-    /* Call Eddystone URL api to prepare adv data*/
-    wiced_bt_eddystone_set_data_for_url(beacon_tx_power, EDDYSTONE_URL_SCHEME_0, encoded_url, adv_data, &len);
-    return len;
+    wiced_bt_beacon_encoder_t enc;
+
+    (void)param;
+    /* Same layout as wiced_bt_eddystone_set_data_for_url, the URL scheme and TLD become codes */
+    wiced_bt_beacon_encoder_init(&enc, adv_data, WICED_BT_BEACON_ADV_DATA_MAX);
+    wiced_bt_beacon_encoder_put_flags(&enc, WICED_BT_BEACON_FLAGS);
+    wiced_bt_eddystone_put_uuid_list(&enc);
+    wiced_bt_eddystone_put_url_string(&enc, sample_url_tx_power, sample_url);
+    return (uint8_t)wiced_bt_beacon_encoder_len(&enc);
 }
 
 /*
 * This function prepares Google Eddystone EID advertising data
 */
-static uint8_t beacon_set_eddystone_eid_advertisement_data(beacon_adv_data_t adv_data)
+static uint8_t beacon_set_eddystone_eid_advertisement_data(uint32_t param, beacon_adv_data_t adv_data)
 {
     /* Set sample values for Eddystone EID*/
     uint8_t len;
-    uint8_t ranging_data = 0xf0;
-    eddystone_eid_data_t eid = { 0x1,0x2,0x3,0x4,0x5,0x6,0x7,0x8 };
 
+    (void)param;
     /* Call Eddystone EID api to prepare adv data*/
-    wiced_bt_eddystone_set_data_for_eid(ranging_data, eid, adv_data, &len);
+    wiced_bt_eddystone_set_data_for_eid(sample_ranging_data, sample_eid, adv_data, &len);
     return len;
 }
 
 /*
-* This function prepares Google Eddystone TLM advertising data
-*/
-static uint8_t beacon_set_eddystone_tlm_advertisement_data(beacon_adv_data_t adv_data)
+ * This function appends the TLM frame of the current inputs, eTLM in encrypted mode
+ */
+static void beacon_put_tlm(wiced_bt_beacon_encoder_t *p_enc)
 {
-    /* Set sample values for Eddystone TLM */
-    uint8_t len;
-    uint16_t vbatt = 10;
-    uint16_t temp =  15;
-    static uint32_t adv_cnt = 0;
-    static uint32_t sec_cnt = 0;
+    if (beacon_tlm_encrypted)
+    {
+        beacon_etlm_put(p_enc, &beacon_etlm, beacon_time_base(), tlm_vbatt, tlm_temp, tlm_adv_cnt, tlm_sec_cnt);
+    }
+    else
+    {
+        wiced_bt_eddystone_put_tlm_unencrypted(p_enc, tlm_vbatt, tlm_temp, tlm_adv_cnt, tlm_sec_cnt);
+    }
+}
 
-    /* For each invocation of API, update Advertising PDU count and Time since power-on or reboot*/
-    adv_cnt++;
-    sec_cnt++;
+/*
+ * This function updates an encoded TLM frame to the current inputs in place,
+ * p_frame is its frame type byte. An eTLM frame is encrypted again with a new salt.
+ */
+static void beacon_patch_tlm(uint8_t *p_frame)
+{
+    if (beacon_tlm_encrypted)
+    {
+        beacon_etlm_patch_frame(p_frame, &beacon_etlm, beacon_time_base(), tlm_vbatt, tlm_temp, tlm_adv_cnt, tlm_sec_cnt);
+    }
+    else
+    {
+        wiced_bt_eddystone_patch_tlm_frame(p_frame, tlm_vbatt, tlm_temp, tlm_adv_cnt, tlm_sec_cnt);
+    }
+}
 
-    /* Call Eddystone TLM api to prepare adv data*/
-    wiced_bt_eddystone_set_data_for_tlm_unencrypted(vbatt, temp, adv_cnt, sec_cnt, adv_data, &len);
-    return len;
+/*
+* This function prepares Google Eddystone TLM advertising data
+*/
+static uint8_t beacon_set_eddystone_tlm_advertisement_data(uint32_t param, beacon_adv_data_t adv_data)
+{
+    wiced_bt_beacon_encoder_t enc;
+
+    (void)param;
+    /* Same layout as wiced_bt_eddystone_set_data_for_tlm_unencrypted: Flags, UUID list, TLM */
+    wiced_bt_beacon_encoder_init(&enc, adv_data, WICED_BT_BEACON_ADV_DATA_MAX);
+    wiced_bt_beacon_encoder_put_flags(&enc, WICED_BT_BEACON_FLAGS);
+    wiced_bt_eddystone_put_uuid_list(&enc);
+    beacon_put_tlm(&enc);
+    return (uint8_t)wiced_bt_beacon_encoder_len(&enc);
 }
 
 /*
 * This function prepares Apple iBeacon advertising data
 */
-static uint8_t beacon_set_ibeacon_advertisement_data(beacon_adv_data_t adv_data)
+static uint8_t beacon_set_ibeacon_advertisement_data(uint32_t param, beacon_adv_data_t adv_data)
 {
-    /* Set sample values for iBeacon */
+    /* Set sample values for iBeacon, major and minor from param */
     uint8_t len;
-    uint8_t ibeacon_uuid[LEN_UUID_128] = { UUID_IBEACON };
-    uint16_t ibeacon_major_number = 0x01;
-    uint16_t ibeacon_minor_number = 0x02;
-    uint8_t tx_power_lcl = 0xb3;
+    uint16_t ibeacon_major_number = (uint16_t)(param >> 16);
+    uint16_t ibeacon_minor_number = (uint16_t)param;
 
-    printf("beacon_set_ibeacon_advertisement_data\n");
+    BEACON_LOG_DEBUG("beacon_set_ibeacon_advertisement_data\n");
 
     /* Call iBeacon api to prepare adv data*/
-    wiced_bt_ibeacon_set_adv_data(ibeacon_uuid, ibeacon_major_number, ibeacon_minor_number, tx_power_lcl, adv_data, &len);
+    wiced_bt_ibeacon_set_adv_data(sample_ibeacon_uuid, ibeacon_major_number, ibeacon_minor_number, sample_ibeacon_tx_power, adv_data, &len);
     return len;
 }
 
 /*
- * beacon_adv_t
+* This function packs all built-in frames into one extended advertisement: a single
+* Flags and Eddystone UUID list followed by the UID, URL, EID and TLM Service Data
+* and the iBeacon Manufacturer Specific data. It records where the TLM frame sits.
+* TLM is left out when it goes out on the periodic train.
+*/
+static uint8_t beacon_set_ext_builtin_advertisement_data(uint32_t param, beacon_adv_data_t adv_data)
+{
+    wiced_bt_beacon_encoder_t enc;
+
+    (void)param;
+    wiced_bt_beacon_encoder_init(&enc, adv_data, sizeof(beacon_adv_data_t));
+    wiced_bt_beacon_encoder_put_flags(&enc, WICED_BT_BEACON_FLAGS);
+    wiced_bt_eddystone_put_uuid_list(&enc);
+    wiced_bt_eddystone_put_uid(&enc, sample_ranging_data, sample_namespace, sample_instance);
+    wiced_bt_eddystone_put_url_string(&enc, sample_url_tx_power, sample_url);
+    wiced_bt_eddystone_put_eid(&enc, sample_ranging_data, sample_eid);
+    if (!beacon_tlm_periodic_id)
+    {
+        beacon_tlm_frame = (uint8_t)(wiced_bt_beacon_encoder_len(&enc) + EDDYSTONE_SERVICE_DATA_HDR_LEN);
+        beacon_put_tlm(&enc);
+    }
+    wiced_bt_ibeacon_put(&enc, sample_ibeacon_uuid, (uint16_t)(sample_ibeacon_major_minor >> 16),
+                         (uint16_t)sample_ibeacon_major_minor, sample_ibeacon_tx_power);
+    return (uint8_t)wiced_bt_beacon_encoder_len(&enc);
+}
+
+/*
+ * Returns the iBeacon major << 16 | minor of a zone
+ */
+static uint32_t beacon_zone_param(uint16_t zone)
+{
+    return ((uint32_t)(BEACON_ZONE_MAJOR_BASE + zone / BEACON_ZONE_MINORS) << 16) | (zone % BEACON_ZONE_MINORS);
+}
+
+/*
+* This function packs the iBeacon frames of several zones into one extended advertisement
+*/
+static uint8_t beacon_set_ext_zones_advertisement_data(uint32_t param, beacon_adv_data_t adv_data)
+{
+    wiced_bt_beacon_encoder_t enc;
+    uint16_t zone = (uint16_t)(param >> 16);
+    uint16_t end = zone + (uint16_t)param;
+    uint32_t zone_param;
+
+    wiced_bt_beacon_encoder_init(&enc, adv_data, sizeof(beacon_adv_data_t));
+    wiced_bt_beacon_encoder_put_flags(&enc, WICED_BT_BEACON_FLAGS);
+    for (; zone < end; zone++)
+    {
+        zone_param = beacon_zone_param(zone);
+        wiced_bt_ibeacon_put(&enc, sample_ibeacon_uuid, (uint16_t)(zone_param >> 16), (uint16_t)zone_param,
+                             sample_ibeacon_tx_power);
+    }
+    return (uint8_t)wiced_bt_beacon_encoder_len(&enc);
+}
+
+/*
+ * Encoders, indexed by beacon kind
+ */
+static set_data_func_t * const beacon_encoders[] =
+{
+    [BEACON_KIND_IBEACON]       = beacon_set_ibeacon_advertisement_data,
+    [BEACON_KIND_EDDYSTONE_UID] = beacon_set_eddystone_uid_advertisement_data,
+    [BEACON_KIND_EDDYSTONE_URL] = beacon_set_eddystone_url_advertisement_data,
+    [BEACON_KIND_EDDYSTONE_EID] = beacon_set_eddystone_eid_advertisement_data,
+    [BEACON_KIND_EDDYSTONE_TLM] = beacon_set_eddystone_tlm_advertisement_data,
+    [BEACON_KIND_EXT_BUILTIN]   = beacon_set_ext_builtin_advertisement_data,
+    [BEACON_KIND_EXT_ZONES]     = beacon_set_ext_zones_advertisement_data,
+};
+
+/*
+ * Built-in beacons with their air-time targets: on-air share in 1/1000 and
+ * the max seconds a beacon may stay off air. TLM changes every second, keep it on air.
  */
-static beacon_adv_t adv[BEACON_CNT] =
+static const beacon_adv_t beacon_builtin[BEACON_BUILTIN_CNT] =
 {
-    {beacon_set_ibeacon_advertisement_data,        160},
-    {beacon_set_eddystone_uid_advertisement_data,  320},
-    {beacon_set_eddystone_url_advertisement_data,   80},
-    {beacon_set_eddystone_eid_advertisement_data,  480},
-    {beacon_set_eddystone_tlm_advertisement_data, 1280},
+    {BEACON_KIND_IBEACON,        160, IBEACON_MAJOR_MINOR, { 800, 2}},
+    {BEACON_KIND_EDDYSTONE_UID,  320, 0,                   { 800, 3}},
+    {BEACON_KIND_EDDYSTONE_URL,   80, 0,                   { 800, 2}},
+    {BEACON_KIND_EDDYSTONE_EID,  480, 0,                   { 600, 4}},
+    {BEACON_KIND_EDDYSTONE_TLM, 1280, 0,                   {1000, 1}},
 };
 
-static void beacon_start(uint8_t instance, uint8_t idx)
+/*
+ * Extended adv mode: one set carries all built-in frames, it stays on air
+ */
+static const beacon_adv_t beacon_ext_builtin =
+    {BEACON_KIND_EXT_BUILTIN, BEACON_EXT_BUILTIN_INTERVAL, 0, {1000, 1}};
+
+/*
+ * This function allocates the beacon table for the built-in and zone beacons
+ * and fills it. Zone iBeacons share the air time the built-in beacons leave
+ * on the sets the scheduler owns. A periodic TLM is not in the table.
+ */
+static wiced_bool_t beacon_table_init(uint16_t zone_cnt, uint8_t sets)
+{
+    beacon_table_t     *p_tbl = &beacon_table;
+    const beacon_adv_t *p_builtin = beacon_ext_adv ? &beacon_ext_builtin : beacon_builtin;
+    uint16_t builtin_cnt = beacon_ext_adv ? 1 : (beacon_tlm_periodic_id ? BEACON_BUILTIN_CNT - 1 : BEACON_BUILTIN_CNT);
+    uint16_t zones_per_beacon = beacon_ext_adv ? BEACON_ZONE_PER_EXT_ADV : 1;
+    uint16_t zone_beacons, cnt, i;
+    uint8_t  *p_buf;
+    int32_t  spare = (int32_t)sets * BEACON_SCHED_SHARE_FULL;
+
+    if (zone_cnt > BEACON_MAX - BEACON_BUILTIN_CNT)
+    {
+        zone_cnt = BEACON_MAX - BEACON_BUILTIN_CNT;
+    }
+    zone_beacons = (zone_cnt + zones_per_beacon - 1) / zones_per_beacon;
+    cnt = builtin_cnt + zone_beacons;
+
+    p_buf = (uint8_t *)beacon_mem_alloc(BEACON_MEM_TABLE, cnt * BEACON_TABLE_ENTRY_SIZE);
+    if (p_buf == NULL)
+    {
+        BEACON_LOG_ERROR("beacon table alloc failed\n");
+        return WICED_FALSE;
+    }
+
+    // widest fields first so every array stays aligned
+    p_tbl->cnt      = cnt;
+    p_tbl->sched    = (beacon_sched_state_t *)p_buf;
+    p_tbl->param    = (uint32_t *)(p_tbl->sched + cnt);
+    p_tbl->target   = (beacon_sched_target_t *)(p_tbl->param + cnt);
+    p_tbl->interval = (uint16_t *)(p_tbl->target + cnt);
+    p_tbl->kind     = (uint8_t *)(p_tbl->interval + cnt);
+    p_tbl->id       = p_tbl->kind + cnt;
+
+    for (i = 0; i < builtin_cnt; i++)
+    {
+        p_tbl->kind[i]     = p_builtin[i].kind;
+        p_tbl->interval[i] = p_builtin[i].interval;
+        p_tbl->param[i]    = (p_builtin[i].kind == BEACON_KIND_IBEACON) ? sample_ibeacon_major_minor : p_builtin[i].param;
+        p_tbl->target[i]   = p_builtin[i].target;
+        p_tbl->id[i]       = 0;
+        spare -= p_builtin[i].target.share;
+    }
+
+    for (i = builtin_cnt; i < cnt; i++)
+    {
+        uint16_t zone = (i - builtin_cnt) * zones_per_beacon;
+
+        if (beacon_ext_adv)
+        {
+            p_tbl->kind[i]  = BEACON_KIND_EXT_ZONES;
+            p_tbl->param[i] = ((uint32_t)zone << 16) | ((zone_cnt - zone < zones_per_beacon) ? zone_cnt - zone : zones_per_beacon);
+        }
+        else
+        {
+            p_tbl->kind[i]  = BEACON_KIND_IBEACON;
+            p_tbl->param[i] = beacon_zone_param(zone);
+        }
+        p_tbl->interval[i]         = BEACON_ZONE_INTERVAL;
+        p_tbl->target[i].share     = (spare > zone_beacons) ? (uint16_t)(spare / zone_beacons) : 1;
+        p_tbl->target[i].max_stale = 0;
+        p_tbl->id[i]               = 0;
+    }
+
+    // the TLM and EID frames are built-in beacons, or part of the packed built-in frames
+    beacon_idx_tlm = beacon_ext_adv ? 0 : BEACON_IDX_TLM;
+    beacon_idx_eid = beacon_ext_adv ? 0 : BEACON_IDX_EID;
+    beacon_tlm_frame = EDDYSTONE_ADV_HDR_LEN;
+
+    BEACON_LOG_INFO("beacon table: %d beacons, %d bytes\n", cnt, (int)(cnt * BEACON_TABLE_ENTRY_SIZE));
+    return WICED_TRUE;
+}
+
+/*
+ * This function sets the random address of an instance, unique per owner
+ */
+static void beacon_set_random_address(uint8_t instance, uint16_t owner)
+{
+    wiced_bt_device_address_t  random_bda;
+
+    memcpy(random_bda, beacon_random_bda, sizeof(random_bda));
+    random_bda[1] ^= (uint8_t)owner; // make address unique
+    random_bda[2] ^= (uint8_t)(owner >> 8);
+    beacon_ctrl_set_random_address(instance, random_bda);
+}
+
+/*
+ * This function encodes the periodic TLM data: the TLM Service Data alone,
+ * scanners have found the Eddystone UUID in the sync header already
+ */
+static void beacon_tlm_periodic_encode(void)
+{
+    wiced_bt_beacon_encoder_t enc;
+
+    wiced_bt_beacon_encoder_init(&enc, beacon_tlm_periodic_data, sizeof(beacon_tlm_periodic_data));
+    beacon_put_tlm(&enc);
+    beacon_tlm_periodic_len = (uint8_t)wiced_bt_beacon_encoder_len(&enc);
+}
+
+/*
+ * This function pushes the new TLM inputs to the periodic train
+ */
+static void beacon_tlm_periodic_update(void)
+{
+#if BEACON_TLM_INCREMENTAL
+    beacon_patch_tlm(&beacon_tlm_periodic_data[EDDYSTONE_SERVICE_DATA_HDR_LEN]);
+#else
+    beacon_tlm_periodic_encode();
+#endif
+    wiced_bt_ble_set_periodic_adv_data(beacon_tlm_periodic_id, beacon_tlm_periodic_len, beacon_tlm_periodic_data);
+}
+
+/*
+ * This function configures the TLM periodic set and starts it. The extended
+ * adv data is the sync header (Flags and the Eddystone UUID list), the
+ * periodic data carries TLM.
+ */
+static void beacon_tlm_periodic_start(void)
+{
+    uint8_t sync_header[WICED_BT_BEACON_ADV_DATA_MAX];
+    wiced_bt_beacon_encoder_t enc;
+    wiced_result_t result;
+
+    wiced_bt_beacon_encoder_init(&enc, sync_header, sizeof(sync_header));
+    wiced_bt_beacon_encoder_put_flags(&enc, WICED_BT_BEACON_FLAGS);
+    wiced_bt_eddystone_put_uuid_list(&enc);
+    beacon_tlm_periodic_encode();
+
+    BEACON_LOG_INFO("beacon_tlm_periodic_start instance %d\n", beacon_tlm_periodic_id);
+    beacon_ctrl_begin();
+    beacon_ctrl_set_params(beacon_tlm_periodic_id, BEACON_TLM_SYNC_INTERVAL);
+    beacon_set_random_address(beacon_tlm_periodic_id, BEACON_OWNER_TLM_PERIODIC);
+    beacon_ctrl_set_data(beacon_tlm_periodic_id, (uint8_t)wiced_bt_beacon_encoder_len(&enc), sync_header);
+    wiced_bt_ble_set_periodic_adv_params(beacon_tlm_periodic_id, BEACON_TLM_PERIODIC_INTERVAL,
+                                         BEACON_TLM_PERIODIC_INTERVAL, 0);
+    wiced_bt_ble_set_periodic_adv_data(beacon_tlm_periodic_id, beacon_tlm_periodic_len, beacon_tlm_periodic_data);
+    result = wiced_bt_ble_start_periodic_adv(beacon_tlm_periodic_id, WICED_TRUE);
+    BEACON_LOG_INFO("wiced_bt_ble_start_periodic_adv: %d\n", result);
+    beacon_ctrl_start(beacon_tlm_periodic_id);
+    beacon_ctrl_commit();
+}
+
+/*
+ * This function updates the Eddystone TLM inputs, called every second or
+ * at a tickless wakeup with the seconds slept. In incremental mode the
+ * resident TLM frame is patched in place, otherwise the TLM payload is
+ * re-encoded. If TLM is on air it is pushed to the controller.
+ */
+static void beacon_update_tlm(uint32_t secs)
+{
+    uint16_t idx = beacon_idx_tlm;
+    const uint8_t *p_data;
+    uint8_t len;
+#if BEACON_TLM_INCREMENTAL
+    uint8_t *p_resident;
+#endif
+
+    /* Update Advertising PDU count and Time since power-on or reboot */
+    tlm_adv_cnt += secs;
+    tlm_sec_cnt += secs;
+    beacon_time_advance(secs);
+
+    if (beacon_tlm_periodic_id)
+    {
+        beacon_tlm_periodic_update();
+        return;
+    }
+
+#if BEACON_TLM_INCREMENTAL
+    p_resident = beacon_cache_lookup((uint8_t)idx, &len);
+    if (p_resident != NULL)
+    {
+        beacon_patch_tlm(&p_resident[beacon_tlm_frame]);
+    }
+    else
+    {
+        beacon_cache_mark_dirty((uint8_t)idx);
+    }
+#else
+    beacon_cache_mark_dirty((uint8_t)idx);
+#endif
+
+    /* A TLM on air gets the new frame right away */
+    if (beacon_table.id[idx])
+    {
+        p_data = beacon_cache_get((uint8_t)idx, beacon_encoders[beacon_table.kind[idx]], beacon_table.param[idx], &len);
+        beacon_ctrl_set_data(beacon_table.id[idx], len, p_data);
+    }
+}
+
+/*
+ * This function takes the EID of the current second from the rotation engine,
+ * a byte copy of a precomputed identifier. Only when the EID period rolls over
+ * is the EID payload encoded again, and pushed if it is on air.
+ */
+static void beacon_update_eid(void)
+{
+    uint16_t idx = beacon_idx_eid;
+    const uint8_t *p_data;
+    uint8_t len;
+
+    /* The beacon time counter carries on across resets, unlike the TLM time since power-on */
+    if (!beacon_eid_get(beacon_time_now(), sample_eid))
+    {
+        return;
+    }
+    // the log thread computes the identifier that replaces this one in the ring
+    beacon_log_wake();
+
+    beacon_cache_mark_dirty((uint8_t)idx);
+    if (beacon_table.id[idx])
+    {
+        p_data = beacon_cache_get((uint8_t)idx, beacon_encoders[beacon_table.kind[idx]], beacon_table.param[idx], &len);
+        beacon_ctrl_set_data(beacon_table.id[idx], len, p_data);
+    }
+}
+
+/*
+ * This function issues the adv parameters of an instance for the apply layer
+ */
+static void beacon_set_params(uint8_t instance, uint32_t interval)
+{
+    if (beacon_ext_adv || instance == beacon_tlm_periodic_id)
+    {
+        beacon_set_ext_instance_params(instance, interval);
+    }
+    else
+    {
+        beacon_set_instance_params(instance, interval);
+    }
+}
+
+/*
+ * This function returns the static payload of a beacon, NULL if its adv data
+ * is not a build-time constant
+ */
+static const uint8_t *beacon_static_get(uint16_t idx, uint8_t *p_len)
+{
+    uint8_t kind = beacon_table.kind[idx];
+
+    if (!beacon_static_adv_on || kind >= sizeof(beacon_static_adv) / sizeof(beacon_static_adv[0]) ||
+        beacon_static_adv[kind].p_data == NULL || beacon_static_adv[kind].param != beacon_table.param[idx])
+    {
+        return NULL;
+    }
+    *p_len = beacon_static_adv[kind].len;
+    return beacon_static_adv[kind].p_data;
+}
+
+/*
+ * This function returns the largest adv data the encoder of a beacon writes
+ */
+static uint16_t beacon_adv_len_max(uint16_t idx, uint16_t data_max)
+{
+    switch (beacon_table.kind[idx])
+    {
+    case BEACON_KIND_IBEACON:
+        return IBEACON_ADV_LEN;
+    case BEACON_KIND_EDDYSTONE_UID:
+        return EDDYSTONE_ADV_HDR_LEN + EDDYSTONE_UID_FRAME_LEN;
+    case BEACON_KIND_EDDYSTONE_URL:
+        return EDDYSTONE_ADV_HDR_LEN + EDDYSTONE_URL_FRAME_LEN;
+    case BEACON_KIND_EDDYSTONE_EID:
+        return EDDYSTONE_ADV_HDR_LEN + EDDYSTONE_EID_FRAME_LEN;
+    case BEACON_KIND_EDDYSTONE_TLM:
+        return EDDYSTONE_ADV_HDR_LEN + EDDYSTONE_TLM_ENCRYPTED_FRAME_LEN;
+    case BEACON_KIND_EXT_ZONES:
+        return WICED_BT_BEACON_FLAGS_AD_LEN + (uint16_t)beacon_table.param[idx] * (IBEACON_ADV_LEN - WICED_BT_BEACON_FLAGS_AD_LEN);
+    default:
+        return data_max;
+    }
+}
+
+/*
+ * This function sizes the payload arena: each cached beacon gets the largest
+ * adv data of its kind, a beacon sent from flash gets nothing, and the
+ * staging buffer fits the largest beacon past the cache slots.
+ */
+static wiced_bool_t beacon_cache_setup(uint16_t data_max)
+{
+    uint16_t slot_size[BEACON_CACHE_SLOTS];
+    uint16_t scratch_size = 0, size, idx;
+    uint8_t len;
+
+    for (idx = 0; idx < BEACON_CACHE_SLOTS; idx++)
+    {
+        slot_size[idx] = 0;
+    }
+    for (idx = 0; idx < beacon_table.cnt; idx++)
+    {
+        if (beacon_static_get(idx, &len) != NULL)
+        {
+            continue;
+        }
+        size = beacon_adv_len_max(idx, data_max);
+        if (idx < BEACON_CACHE_SLOTS)
+        {
+            slot_size[idx] = size;
+        }
+        else if (size > scratch_size)
+        {
+            scratch_size = size;
+        }
+    }
+    return beacon_cache_init(slot_size, scratch_size);
+}
+
+/*
+ * This function configures an instance for a beacon and queues its start.
+ * Parameters, address and data the instance already holds are not sent again.
+ */
+static void beacon_start(uint8_t instance, uint16_t idx)
 {
-    wiced_bt_device_address_t  random_bda = {0x40, 0x01, 0x02, 0x03, 0x04, 0x05};
-    beacon_adv_data_t buff;
+    set_data_func_t *set_data = beacon_encoders[beacon_table.kind[idx]];
+    uint8_t *p_scratch;
+    const uint8_t *p_data;
     uint8_t len;
+    uint32_t prof_start = BEACON_PROF_START();
+
+    BEACON_LOG_DEBUG("beacon_start instance %d for index %d\n", instance, idx);
+    beacon_table.id[idx] = instance;
+    beacon_ctrl_set_params(instance, beacon_table.interval[idx]);
+    beacon_set_random_address(instance, idx);
+    p_data = beacon_static_get(idx, &len);
+    if (p_data != NULL)
+    {
+        /* Flash payload, nothing to encode or copy */
+        beacon_ctrl_set_static_data(instance, len, p_data);
+    }
+    else
+    {
+        /* Only beacons whose inputs changed are encoded again */
+        p_data = beacon_cache_get((uint8_t)idx, set_data, beacon_table.param[idx], &len);
+        if (p_data == NULL)
+        {
+            p_scratch = beacon_cache_scratch();
+            len = set_data(beacon_table.param[idx], p_scratch);
+            p_data = p_scratch;
+        }
 
-    printf("beacon_start instance %d for index %d\n", instance, idx);
-    adv[idx].id = instance;
-    beacon_set_instance_params(instance, adv[idx].interval);
-    random_bda[1] = idx; // make address unique
-    wiced_bt_ble_set_ext_adv_random_address (instance, random_bda);
-    len = adv[idx].set_data(buff);
+        /* Sets adv data for this instance */
+        beacon_ctrl_set_data(instance, len, p_data);
+    }
 
-    /* Sets adv data for this instance & start to adv */
-    wiced_bt_ble_set_ext_adv_data(instance, len, buff);
-    wiced_bt_ble_start_ext_adv(MULTI_ADVERT_START, 1, &duration_cfg[beacon_idx(instance)]);
+    /* Start to adv */
+    beacon_ctrl_start(instance);
+    BEACON_PROF_STOP(BEACON_PROBE_BEACON_START, prof_start);
 }
 
 /*
- * This function stops the adv when the instance is in use. It returns the freed instance.
- * If it was not in adv, it searches for next avaiable free instance and return the free instance.
- * When free instance is no available, it returns value larger than supported_adv
+ * This function stops the adv when the instance is in use
  */
-static uint8_t beacon_stop(uint8_t idx)
+static void beacon_stop(uint16_t idx)
 {
-    uint8_t instance = adv[idx].id;
+    uint8_t instance = beacon_table.id[idx];
 
     // check if it is in use (advertizing)
     if (instance)
     {
-        printf("beacon_stop instance %d\n", instance);
-        adv[idx].id = 0;    // mark as adv stopped
-        wiced_bt_ble_start_ext_adv(MULTI_ADVERT_STOP, 1, &duration_cfg[beacon_idx(instance)]);
+        BEACON_LOG_DEBUG("beacon_stop instance %d\n", instance);
+        beacon_table.id[idx] = 0;    // mark as adv stopped
+        beacon_ctrl_stop(instance);
+        beacon_adv_set_release(instance);
     }
-    else
+}
+
+/*
+ * This function stops the beacons that lose their set and starts the new ones
+ * on free sets, within a controller transaction
+ */
+static void beacon_apply(const uint16_t *stop, uint16_t stop_cnt, const uint16_t *start, uint16_t start_cnt)
+{
+    uint16_t i;
+    uint8_t instance;
+
+    for (i = 0; i < stop_cnt; i++)
+    {
+        beacon_stop(stop[i]);
+    }
+    for (i = 0; i < start_cnt; i++)
+    {
+        instance = beacon_adv_set_acquire(start[i]);
+        if (instance != BEACON_ADV_SET_INVALID)
+        {
+            beacon_start(instance, start[i]);
+        }
+        else
+        {
+            BEACON_LOG_WARN("No free instance\n");
+        }
+    }
+}
+
+/*
+ * This function runs the scheduler ahead to the next second that changes the
+ * set assignment, at most BEACON_TICKLESS_MAX_SEC seconds and no further than
+ * the next EID period. The sets that lose their beacon then are enabled with
+ * that duration so the controller ends them, the timer only guards the
+ * set-terminated events or wakes the MCU when no set ends.
+ */
+static void beacon_tickless_plan(void)
+{
+    uint32_t eid_period = 1u << BEACON_EID_EXPONENT;
+    uint32_t limit = eid_period - (beacon_time_now() & (eid_period - 1));
+    uint16_t i;
+    uint8_t instance;
+
+    if (limit > BEACON_TICKLESS_MAX_SEC)
+    {
+        limit = BEACON_TICKLESS_MAX_SEC;
+    }
+    beacon_tickless_ticks = 0;
+    do
+    {
+        beacon_sched_tick(&beacon_sched, beacon_tickless_stop, &beacon_tickless_stop_cnt,
+                          beacon_tickless_start, &beacon_tickless_start_cnt);
+        beacon_tickless_ticks++;
+    } while (beacon_tickless_stop_cnt == 0 && beacon_tickless_start_cnt == 0 && beacon_tickless_ticks < limit);
+
+    // the sets armed by an earlier plan are left behind with its generation
+    beacon_tickless_gen++;
+    beacon_tickless_wait = 0;
+    for (i = 0; i < beacon_tickless_stop_cnt; i++)
     {
-        // find the next available free instance.
-        // The instance is free only if there is no adv is using this instance.
-        for (instance=1; instance<=supported_adv; instance++)
+        instance = beacon_table.id[beacon_tickless_stop[i]];
+        if (instance)
         {
-            int i;
-
-            // instance is avaiable if it is not in use
-            for (i=0; i<BEACON_CNT; i++)
-            {
-                if (adv[i].id == instance) // in use?
-                {
-                    break;
-                }
-            }
-
-            // if the instance is not in use for all advertisement, we found free instance
-            if (i>=BEACON_CNT)
-            {
-                break;
-            }
+            beacon_ctrl_start_for(instance, (uint16_t)(beacon_tickless_ticks * BEACON_DURATION_PER_SEC));
+            beacon_tickless_armed[instance] = beacon_tickless_gen;
+            beacon_tickless_wait++;
         }
     }
-    return instance;
+    wiced_start_timer(&beacon_timer, beacon_tickless_ticks + (beacon_tickless_wait ? BEACON_TICKLESS_GUARD_SEC : 0));
+}
+
+/*
+ * This function asks the scheduler which beacons own the adv sets for the next
+ * second and applies it. In tickless mode it also plans the next transition.
+ */
+static void beacon_apply_schedule(void)
+{
+    uint16_t stop[BEACON_SCHED_MAX_SETS];
+    uint16_t start[BEACON_SCHED_MAX_SETS];
+    uint16_t stop_cnt, start_cnt;
+
+    beacon_sched_tick(&beacon_sched, stop, &stop_cnt, start, &start_cnt);
+    beacon_ctrl_begin();
+    beacon_apply(stop, stop_cnt, start, start_cnt);
+    if (beacon_tickless)
+    {
+        beacon_tickless_plan();
+    }
+    beacon_ctrl_commit();
 }
 
 /*
@@ -281,36 +1062,101 @@ static uint8_t beacon_stop(uint8_t idx)
  */
 static void beacon_switch_adv(WICED_TIMER_PARAM_TYPE arg)
 {
+    uint32_t prof_start = BEACON_PROF_START();
+
+    (void)arg;
+    beacon_update_tlm(BEACON_SCHED_TICK_SEC);
+    beacon_update_eid();
+    beacon_apply_schedule();
+    BEACON_PROF_STOP(BEACON_PROBE_SWITCH_ADV, prof_start);
+}
+
+/*
+ * This function applies the planned transition at a tickless wakeup and plans
+ * the next one. Sets the controller has ended need no disable. When the guard
+ * timer fires first, the events still due are marked late so they are not
+ * taken for the events of the next plan.
+ */
+static void beacon_tickless_wake(WICED_TIMER_PARAM_TYPE arg)
+{
+    uint32_t prof_start = BEACON_PROF_START();
+    uint16_t i;
     uint8_t instance;
-    uint8_t stop_idx = adv_idx;
-    uint8_t start_idx = stop_idx + supported_adv;
 
-    if (start_idx >= BEACON_CNT)
+    (void)arg;
+    wiced_stop_timer(&beacon_timer);
+    for (i = 0; i < beacon_tickless_stop_cnt && beacon_tickless_wait; i++)
+    {
+        instance = beacon_table.id[beacon_tickless_stop[i]];
+        if (instance && beacon_tickless_armed[instance] == beacon_tickless_gen)
+        {
+            beacon_tickless_late[instance] = WICED_TRUE;
+        }
+    }
+    beacon_tickless_wait = 0;
+    beacon_update_tlm(beacon_tickless_ticks);
+    beacon_update_eid();
+    beacon_ctrl_begin();
+    beacon_apply(beacon_tickless_stop, beacon_tickless_stop_cnt, beacon_tickless_start, beacon_tickless_start_cnt);
+    beacon_tickless_plan();
+    beacon_ctrl_commit();
+    BEACON_PROF_STOP(BEACON_PROBE_SWITCH_ADV, prof_start);
+}
+
+/*
+ * This function handles the extended adv events. In tickless mode the
+ * transition is applied once every set planned to end has ended. An event
+ * of an earlier plan, late after the guard timer, is dropped, as is one the
+ * current plan did not arm the set for: the set may be enabled again.
+ */
+static void beacon_adv_ext_cback(wiced_bt_ble_adv_ext_event_t event, wiced_bt_ble_adv_ext_event_data_t *p_data)
+{
+    uint8_t handle;
+
+    if (event != WICED_BT_BLE_ADV_SET_TERMINATED_EVENT)
     {
-        start_idx -= BEACON_CNT;
+        return;
     }
-    if (++adv_idx >= BEACON_CNT)
+    handle = p_data->adv_set_terminated.adv_handle;
+    BEACON_LOG_DEBUG("adv set %d terminated, status 0x%02x\n", handle, p_data->adv_set_terminated.status);
+    if (handle > BEACON_ADV_SET_MAX)
     {
-        adv_idx = 0;
+        return;
     }
-
-    instance = beacon_stop(stop_idx);
-    if (valid_instance(instance))
+    if (beacon_tickless_late[handle])
     {
-        beacon_start(instance, start_idx);
+        beacon_tickless_late[handle] = WICED_FALSE;
+        BEACON_LOG_DEBUG("adv set %d late event dropped\n", handle);
+        return;
     }
-    else
+    if (beacon_tickless_wait == 0 || beacon_tickless_armed[handle] != beacon_tickless_gen)
+    {
+        BEACON_LOG_DEBUG("adv set %d not armed by plan %"PRIu32"\n", handle, beacon_tickless_gen);
+        return;
+    }
+    beacon_tickless_armed[handle] = 0;
+    beacon_ctrl_terminated(handle);
+
+    if (--beacon_tickless_wait == 0)
     {
-        printf("No free instance\n");
+        beacon_tickless_wake(0);
     }
 }
 
 /*
  * This function set a timer which will change Eddystone TLM advertising data
- * on every interval(1 sec) and rotates the adv within available sets.
+ * on every interval(1 sec) and rotates the adv within available sets. In
+ * tickless mode the timer is a one-shot the transitions rearm.
  */
 static void beacon_set_timer(void)
 {
+    if (beacon_tickless)
+    {
+        wiced_init_timer(&beacon_timer, beacon_tickless_wake, 0, WICED_SECONDS_TIMER);
+        wiced_bt_ble_register_adv_ext_cback(beacon_adv_ext_cback);
+        return;
+    }
+
     /* init beacon timer */
     wiced_init_timer ( &beacon_timer, beacon_switch_adv, 0, WICED_SECONDS_PERIODIC_TIMER );
 
@@ -323,28 +1169,63 @@ static void beacon_set_timer(void)
  */
 static void beacon_adv_init()
 {
-    printf("beacon_adv_init\n");
+    uint16_t data_max;
+    uint8_t  sched_sets;
+    wiced_bool_t heap_ok;
+
+    BEACON_LOG_INFO("beacon_adv_init\n");
 
     /* Set the advertising params and make the device discoverable */
     beacon_set_app_advertisement_data();
     wiced_bt_start_advertisements( BTM_BLE_ADVERT_UNDIRECTED_HIGH, 0, NULL );
 
-    supported_adv = wiced_bt_ble_read_num_ext_adv_sets();
-    if (supported_adv > BEACON_CNT)
+    supported_adv = beacon_adv_set_init(wiced_bt_ble_read_num_ext_adv_sets());
+
+    BEACON_LOG_INFO("Supported adv set: %d\n", supported_adv);
+
+    /* A periodic TLM keeps one set for itself, the scheduler rotates the others */
+    sched_sets = supported_adv;
+    beacon_tlm_periodic_id = BEACON_ADV_SET_INVALID;
+    if (beacon_tlm_periodic && supported_adv > 1)
     {
-        supported_adv = BEACON_CNT;
+        beacon_tlm_periodic_id = beacon_adv_set_acquire(BEACON_OWNER_TLM_PERIODIC);
+        sched_sets--;
     }
 
-    printf("Supported adv set: %d\n", supported_adv);
+    /* The time counter resumes past the last boot, identifiers ahead are computed by the background thread from here on */
+    if (!beacon_time_init(beacon_time_storage, BEACON_EID_EXPONENT))
+    {
+        BEACON_LOG_WARN("time checkpoint not written\n");
+    }
+    BEACON_LOG_INFO("beacon time %"PRIu32"\n", beacon_time_now());
+    if (!beacon_eid_init(sample_eid_identity_key, BEACON_EID_EXPONENT, beacon_time_now()))
+    {
+        BEACON_LOG_WARN("EID init failed\n");
+    }
+    beacon_eid_get(beacon_time_now(), sample_eid);
+    beacon_etlm_init(&beacon_etlm, sample_eid_identity_key);
+
+    data_max = beacon_ext_adv ? WICED_BT_BEACON_EXT_ADV_DATA_MAX : WICED_BT_BEACON_ADV_DATA_MAX;
+    heap_ok = beacon_table_init(beacon_zone_cnt, sched_sets) && beacon_ctrl_init(supported_adv, data_max, beacon_set_params) &&
+              beacon_cache_setup(data_max);
+    beacon_mem_report();
+    if (!heap_ok)
+    {
+        return;
+    }
+    beacon_sched_init(&beacon_sched, &BEACON_SCHED_POLICY, beacon_table.target, beacon_table.sched,
+                      beacon_table.cnt, sched_sets);
 
-    // start adv.
-    for (int idx=0; idx<supported_adv; idx++)
+    if (beacon_tlm_periodic_id)
     {
-        beacon_start( beacon_adv_id(idx), idx );
+        beacon_tlm_periodic_start();
     }
 
-    /* start timer to change beacon ADV data */
+    /* start timer to change beacon ADV data, ahead of the first schedule that arms it in tickless mode */
     beacon_set_timer();
+
+    // start adv.
+    beacon_apply_schedule();
 }
 
 /*
@@ -354,15 +1235,25 @@ static void beacon_init(void)
 {
     wiced_bt_gatt_status_t gatt_status;
 
+    /* GATT response buffers come from the block pool */
+    beacon_pool_init();
+
     /* Register with stack to receive GATT callback */
     gatt_status = wiced_bt_gatt_register(beacon_gatts_callback);
 
-    printf("wiced_bt_gatt_register: %d\n", gatt_status);
+    BEACON_LOG_INFO("wiced_bt_gatt_register: %d\n", gatt_status);
 
     /*  Tell stack to use our GATT database */
     gatt_status =  wiced_bt_gatt_db_init( gatt_database, gatt_database_len, beacon_db_hash );
 
-    printf("wiced_bt_gatt_db_init %d\n", gatt_status);
+    BEACON_LOG_INFO("wiced_bt_gatt_db_init %d\n", gatt_status);
+
+    /* Index the attributes by handle and by type for the GATT request handlers */
+    if (!beacon_gatt_db_init(gatt_database, gatt_database_len,
+            app_gatt_db_ext_attr_tbl, app_gatt_db_ext_attr_tbl_size))
+    {
+        BEACON_LOG_WARN("GATT attribute table init failed\n");
+    }
 
     /* Allow peer to pair */
     wiced_bt_set_pairable_mode(WICED_TRUE, 0);
@@ -382,11 +1273,11 @@ static void beacon_advertisement_stopped(void)
     if (beacon_conn_id == 0)
     {
         result =  wiced_bt_start_advertisements(BTM_BLE_ADVERT_UNDIRECTED_LOW, 0, NULL);
-        printf("wiced_bt_start_advertisements: %d\n", result);
+        BEACON_LOG_INFO("wiced_bt_start_advertisements: %d\n", result);
     }
     else
     {
-        printf("ADV stop\n");
+        BEACON_LOG_INFO("ADV stop\n");
     }
 }
 
@@ -399,13 +1290,15 @@ static wiced_result_t beacon_management_callback(wiced_bt_management_evt_t event
     wiced_result_t                    result = WICED_BT_SUCCESS;
 //    uint8_t                          *p_keys;
     wiced_bt_ble_advert_mode_t       *p_mode;
+    uint32_t                          prof_start = BEACON_PROF_START();
 
-    printf("beacon_management_callback: %x\n", event);
+    BEACON_LOG_DEBUG("beacon_management_callback: %x\n", event);
 
     switch(event)
     {
     /* Bluetooth  stack enabled */
     case BTM_ENABLED_EVT:
+        beacon_enabled = WICED_TRUE;
         beacon_init();
         break;
 
@@ -413,19 +1306,19 @@ static wiced_result_t beacon_management_callback(wiced_bt_management_evt_t event
         break;
 
     case BTM_USER_CONFIRMATION_REQUEST_EVT:
-        printf("Numeric_value: %"PRIu32" \n", p_event_data->user_confirmation_request.numeric_value);
+        BEACON_LOG_INFO("Numeric_value: %"PRIu32" \n", p_event_data->user_confirmation_request.numeric_value);
         wiced_bt_dev_confirm_req_reply( WICED_BT_SUCCESS , p_event_data->user_confirmation_request.bd_addr);
         break;
 
     case BTM_PASSKEY_NOTIFICATION_EVT:
-        printf("\r\n  PassKey Notification from BDA: ");
+        BEACON_LOG_INFO("\r\n  PassKey Notification from BDA: ");
         print_bd_address(p_event_data->user_passkey_notification.bd_addr);
-        printf("PassKey: %"PRIu32" \n", p_event_data->user_passkey_notification.passkey );
+        BEACON_LOG_INFO("PassKey: %"PRIu32" \n", p_event_data->user_passkey_notification.passkey );
         wiced_bt_dev_confirm_req_reply(WICED_BT_SUCCESS, p_event_data->user_passkey_notification.bd_addr );
         break;
 
     case BTM_PAIRING_IO_CAPABILITIES_BLE_REQUEST_EVT:
-        printf("BTM_PAIRING_IO_CAPABILITIES_BLE_REQUEST_EVT:\n" );
+        BEACON_LOG_INFO("BTM_PAIRING_IO_CAPABILITIES_BLE_REQUEST_EVT:\n" );
         p_event_data->pairing_io_capabilities_ble_request.local_io_cap  = BTM_IO_CAPABILITIES_NONE;
         p_event_data->pairing_io_capabilities_ble_request.oob_data      = BTM_OOB_NONE;
         p_event_data->pairing_io_capabilities_ble_request.auth_req      = BTM_LE_AUTH_REQ_BOND | BTM_LE_AUTH_REQ_MITM;
@@ -449,7 +1342,7 @@ static wiced_result_t beacon_management_callback(wiced_bt_management_evt_t event
 
     case BTM_BLE_ADVERT_STATE_CHANGED_EVT:
         p_mode = &p_event_data->ble_advert_state_changed;
-        printf("Advertisement State Change: %d\n", *p_mode);
+        BEACON_LOG_INFO("Advertisement State Change: %d\n", *p_mode);
         if (*p_mode == BTM_BLE_ADVERT_OFF)
         {
             beacon_advertisement_stopped();
@@ -457,10 +1350,11 @@ static wiced_result_t beacon_management_callback(wiced_bt_management_evt_t event
         break;
 
     default:
-        printf("Not handled\n");
+        BEACON_LOG_DEBUG("Not handled\n");
         break;
     }
 
+    BEACON_PROF_STOP(BEACON_PROBE_MGMT_CB, prof_start);
     return result;
 }
 
@@ -484,11 +1378,96 @@ wiced_bt_gatt_status_t beacon_connection_status_event(wiced_bt_gatt_connection_s
     {
         beacon_conn_id = 0;
         result =  wiced_bt_start_advertisements(BTM_BLE_ADVERT_UNDIRECTED_HIGH, 0, NULL);
-        printf("[%s] start adv status %d \n", __FUNCTION__, result);
+        BEACON_LOG_INFO("[%s] start adv status %d \n", __FUNCTION__, result);
     }
     return WICED_BT_GATT_SUCCESS;
 }
 
+/*
+ * Sets the number of zone iBeacons presented after the built-in beacons,
+ * takes effect when the stack is enabled
+ */
+void beacon_set_zone_beacons(uint16_t zone_cnt)
+{
+    beacon_zone_cnt = zone_cnt;
+}
+
+/*
+ * Selects extended adv mode, where the beacon frames are packed into
+ * non-legacy adv sets, takes effect when the stack is enabled
+ */
+void beacon_set_ext_adv(wiced_bool_t ext_adv)
+{
+    beacon_ext_adv = ext_adv;
+}
+
+/*
+ * Selects periodic adv for Eddystone TLM, where TLM leaves the rotation and
+ * goes out on a periodic train, takes effect when the stack is enabled
+ */
+void beacon_set_tlm_periodic(wiced_bool_t tlm_periodic)
+{
+    beacon_tlm_periodic = tlm_periodic;
+}
+
+/*
+ * Selects encrypted telemetry, where TLM goes out as eTLM encrypted with the
+ * EID identity key, takes effect when the stack is enabled
+ */
+void beacon_set_tlm_encrypted(wiced_bool_t tlm_encrypted)
+{
+    beacon_tlm_encrypted = tlm_encrypted;
+}
+
+/*
+ * Selects tickless rotation, where set-terminated events from the controller
+ * drive the rotation instead of a 1 s timer, takes effect when the stack is enabled
+ */
+void beacon_set_tickless(wiced_bool_t tickless)
+{
+    beacon_tickless = tickless;
+}
+
+/*
+ * Sets the storage of the EID time checkpoint
+ */
+void beacon_set_time_store(const beacon_time_store_t *p_store)
+{
+    beacon_time_storage = p_store;
+}
+
+/*
+ * This function takes the identity of the device from its provisioning blob
+ * in place of the sample values. Once the stack is enabled the cache has no
+ * slots for the static beacons, which must then keep their static payloads.
+ */
+wiced_bool_t beacon_set_provisioning(const beacon_provision_t *p_prov)
+{
+    if (beacon_enabled)
+    {
+        BEACON_LOG_ERROR("provisioning after stack enable rejected\n");
+        return WICED_FALSE;
+    }
+    if (!beacon_provision_check(p_prov))
+    {
+        BEACON_LOG_ERROR("provisioning blob rejected\n");
+        return WICED_FALSE;
+    }
+
+    memcpy(sample_ibeacon_uuid, p_prov->ibeacon_uuid, sizeof(sample_ibeacon_uuid));
+    sample_ibeacon_major_minor = ((uint32_t)p_prov->ibeacon_major << 16) | p_prov->ibeacon_minor;
+    sample_ibeacon_tx_power = p_prov->ibeacon_tx_power;
+    memcpy(sample_namespace, p_prov->namespace_id, sizeof(sample_namespace));
+    memcpy(sample_instance, p_prov->instance, sizeof(sample_instance));
+    sample_ranging_data = p_prov->ranging_data;
+    memcpy(sample_eid_identity_key, p_prov->eid_key, sizeof(sample_eid_identity_key));
+    memcpy(beacon_random_bda, p_prov->random_bda, sizeof(beacon_random_bda));
+    beacon_static_adv_on = WICED_FALSE;     // the static payloads carry the sample values
+
+    BEACON_LOG_INFO("provisioned serial %"PRIu32"\n", p_prov->serial);
+    return WICED_TRUE;
+}
+
 /*
  *  Entry point to the application. Set device configuration and start BT
  *  stack initialization.  The actual application initialization will happen
@@ -496,7 +1475,8 @@ wiced_bt_gatt_status_t beacon_connection_status_event(wiced_bt_gatt_connection_s
  */
 void application_start( void )
 {
-    printf("application_start A\n");
+    BEACON_LOG_INFO("application_start A\n");
+    beacon_prof_init();
 
     wiced_result_t wiced_result;
     // Register call back and configuration with stack
@@ -504,14 +1484,14 @@ void application_start( void )
 
     if( WICED_BT_SUCCESS == wiced_result)
    {
-        printf("Bluetooth Stack Initialization Successful \n");
+        BEACON_LOG_INFO("Bluetooth Stack Initialization Successful \n");
    }
    else
    {
-        printf("Bluetooth Stack Initialization failed!! \n");
+        BEACON_LOG_WARN("Bluetooth Stack Initialization failed!! \n");
    }
 
-    printf("application_start B\n");
+    BEACON_LOG_INFO("application_start B\n");
 
-    printf("Beacon Application Start\n");
+    BEACON_LOG_INFO("Beacon Application Start\n");
 }
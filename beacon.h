@@ -10,6 +10,8 @@
 #define _BEACON_H_
 
 #include "wiced_bt_gatt.h"
+#include "beacon_provision.h"
+#include "beacon_time.h"
 
 /*
  * Connection up/down event
@@ -17,6 +19,52 @@
 wiced_bt_gatt_status_t beacon_connection_status_event(wiced_bt_gatt_connection_status_t *p_status);
 
 
+/*
+ * Sets the number of zone iBeacons presented after the built-in beacons,
+ * takes effect when the stack is enabled
+ */
+void beacon_set_zone_beacons(uint16_t zone_cnt);
+
+/*
+ * Selects extended adv mode, where the beacon frames are packed into
+ * non-legacy adv sets, takes effect when the stack is enabled
+ */
+void beacon_set_ext_adv(wiced_bool_t ext_adv);
+
+/*
+ * Selects periodic adv for Eddystone TLM, where TLM leaves the rotation and
+ * goes out on a periodic train, takes effect when the stack is enabled
+ */
+void beacon_set_tlm_periodic(wiced_bool_t tlm_periodic);
+
+/*
+ * Selects encrypted telemetry, where TLM goes out as eTLM encrypted with the
+ * EID identity key, takes effect when the stack is enabled
+ */
+void beacon_set_tlm_encrypted(wiced_bool_t tlm_encrypted);
+
+/*
+ * Selects tickless rotation, where set-terminated events from the controller
+ * drive the rotation instead of a 1 s timer, takes effect when the stack is enabled
+ */
+void beacon_set_tickless(wiced_bool_t tickless);
+
+/*
+ * Sets the non-volatile storage of the EID and eTLM time counter checkpoint,
+ * which the store must keep across resets. Without one the counter starts at
+ * 0 every boot, and so do the eTLM nonces. Takes effect when the stack is
+ * enabled.
+ */
+void beacon_set_time_store(const beacon_time_store_t *p_store);
+
+/*
+ * Replaces the sample iBeacon, Eddystone UID, EID key and random address
+ * values with those of a provisioning blob, takes effect when the stack is
+ * enabled. Returns WICED_FALSE and keeps the sample values if the blob fails
+ * its check or the stack is already enabled.
+ */
+wiced_bool_t beacon_set_provisioning(const beacon_provision_t *p_prov);
+
 /*
  *  Entry point to the application. Set device configuration and start BT
  *  stack initialization.  The actual application initialization will happen
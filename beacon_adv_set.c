@@ -0,0 +1,145 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Extended advertising set handle allocator
+*
+* Bit n of the free map is set when handle n+1 is free. Acquire finds the
+* lowest set bit with a count-trailing-zeros on the first non-zero word,
+* release sets the bit again. The owner table maps handles back to beacons.
+*/
+#include "beacon_adv_set.h"
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+#define BEACON_ADV_SET_WORDS    ((BEACON_ADV_SET_MAX + 31) / 32)
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+static uint32_t beacon_adv_set_free[BEACON_ADV_SET_WORDS];
+static uint16_t beacon_adv_set_owners[BEACON_ADV_SET_MAX];
+static uint8_t  beacon_adv_set_num;
+static uint8_t  beacon_adv_set_free_num;
+
+/* Bit index of the isolated lowest set bit, by its de Bruijn product */
+static const uint8_t beacon_adv_set_debruijn[32] =
+{
+     0,  1, 28,  2, 29, 14, 24,  3, 30, 22, 20, 15, 25, 17,  4,  8,
+    31, 27, 13, 23, 21, 19, 16,  7, 26, 12, 18,  6, 11,  5, 10,  9,
+};
+
+/******************************************************************************
+ *     Private Function Definitions
+ ******************************************************************************/
+
+/*
+ * Returns the index of the lowest set bit of a non-zero word, without
+ * compiler builtins so every supported toolchain builds it
+ */
+static uint8_t beacon_adv_set_lowest_bit(uint32_t word)
+{
+    return beacon_adv_set_debruijn[((word & (0u - word)) * 0x077CB531u) >> 27];
+}
+
+/******************************************************************************
+ *     Public Function Definitions
+ ******************************************************************************/
+
+/*
+ * Makes handles 1..num_sets available
+ */
+uint8_t beacon_adv_set_init(uint8_t num_sets)
+{
+    uint8_t i;
+
+    if (num_sets > BEACON_ADV_SET_MAX)
+    {
+        num_sets = BEACON_ADV_SET_MAX;
+    }
+
+    for (i = 0; i < BEACON_ADV_SET_WORDS; i++)
+    {
+        if (num_sets >= (i + 1) * 32)
+        {
+            beacon_adv_set_free[i] = 0xFFFFFFFF;
+        }
+        else if (num_sets > i * 32)
+        {
+            beacon_adv_set_free[i] = (1UL << (num_sets - i * 32)) - 1;
+        }
+        else
+        {
+            beacon_adv_set_free[i] = 0;
+        }
+    }
+    for (i = 0; i < BEACON_ADV_SET_MAX; i++)
+    {
+        beacon_adv_set_owners[i] = BEACON_ADV_SET_NO_OWNER;
+    }
+    beacon_adv_set_num = num_sets;
+    beacon_adv_set_free_num = num_sets;
+    return num_sets;
+}
+
+/*
+ * Takes the lowest free set for owner
+ */
+uint8_t beacon_adv_set_acquire(uint16_t owner)
+{
+    uint8_t  i, bit;
+
+    for (i = 0; i < BEACON_ADV_SET_WORDS; i++)
+    {
+        if (beacon_adv_set_free[i])
+        {
+            bit = beacon_adv_set_lowest_bit(beacon_adv_set_free[i]);
+            beacon_adv_set_free[i] &= ~(1UL << bit);
+            beacon_adv_set_owners[i * 32 + bit] = owner;
+            beacon_adv_set_free_num--;
+            return (uint8_t)(i * 32 + bit + 1);
+        }
+    }
+    return BEACON_ADV_SET_INVALID;
+}
+
+/*
+ * Returns a set to the free pool
+ */
+void beacon_adv_set_release(uint8_t handle)
+{
+    uint8_t n = handle - 1;
+
+    // ignore invalid handles and sets that are already free
+    if (handle == BEACON_ADV_SET_INVALID || handle > beacon_adv_set_num ||
+        (beacon_adv_set_free[n / 32] & (1UL << (n % 32))))
+    {
+        return;
+    }
+    beacon_adv_set_owners[n] = BEACON_ADV_SET_NO_OWNER;
+    beacon_adv_set_free[n / 32] |= 1UL << (n % 32);
+    beacon_adv_set_free_num++;
+}
+
+/*
+ * Returns the owner of a set
+ */
+uint16_t beacon_adv_set_owner(uint8_t handle)
+{
+    if (handle == BEACON_ADV_SET_INVALID || handle > beacon_adv_set_num)
+    {
+        return BEACON_ADV_SET_NO_OWNER;
+    }
+    return beacon_adv_set_owners[handle - 1];
+}
+
+/*
+ * Returns the number of free sets
+ */
+uint8_t beacon_adv_set_free_count(void)
+{
+    return beacon_adv_set_free_num;
+}
@@ -0,0 +1,54 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Extended advertising set handle allocator
+*
+* Tracks which controller adv sets are free in a bitmap and which beacon
+* owns each set in use. Acquire and release are constant time, independent
+* of the number of beacons and of the number of sets the controller exposes.
+*/
+#ifndef _BEACON_ADV_SET_H_
+#define _BEACON_ADV_SET_H_
+
+#include "wiced_bt_types.h"
+
+/* Max adv sets handled, the controller count is clamped to it */
+#ifndef BEACON_ADV_SET_MAX
+#define BEACON_ADV_SET_MAX          64
+#endif
+
+/* Returned by beacon_adv_set_acquire() when all sets are in use, handles start at 1 */
+#define BEACON_ADV_SET_INVALID      0
+
+/* Owner of a free set, not a valid owner id */
+#define BEACON_ADV_SET_NO_OWNER     0xFFFF
+
+/*
+ * Makes handles 1..num_sets available, returns the number of usable sets
+ */
+uint8_t beacon_adv_set_init(uint8_t num_sets);
+
+/*
+ * Takes the lowest free set for owner, returns BEACON_ADV_SET_INVALID if none is free
+ */
+uint8_t beacon_adv_set_acquire(uint16_t owner);
+
+/*
+ * Returns a set to the free pool
+ */
+void beacon_adv_set_release(uint8_t handle);
+
+/*
+ * Returns the owner of a set, BEACON_ADV_SET_NO_OWNER if it is free or invalid
+ */
+uint16_t beacon_adv_set_owner(uint8_t handle);
+
+/*
+ * Returns the number of free sets
+ */
+uint8_t beacon_adv_set_free_count(void);
+
+#endif // _BEACON_ADV_SET_H_
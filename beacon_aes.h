@@ -0,0 +1,51 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Table-driven AES-128, encryption only
+*
+* Eddystone EID and eTLM only need the forward cipher (ECB blocks, CTR and
+* CMAC), so there is no decryption and no inverse tables. A round is four
+* lookups per column into one 1 KB T-table plus rotates, the final round
+* uses the 256 byte S-box. Both tables are const and stay in flash.
+*/
+#ifndef _BEACON_AES_H_
+#define _BEACON_AES_H_
+
+#include "wiced_bt_types.h"
+#include <stdint.h>
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+#define BEACON_AES_BLOCK_LEN    16
+#define BEACON_AES_KEY_LEN      16
+#define BEACON_AES_ROUNDS       10
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+
+/* Expanded key, round keys as big-endian column words */
+typedef struct
+{
+    uint32_t rk[4 * (BEACON_AES_ROUNDS + 1)];
+} beacon_aes_ctx_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+
+/*
+ * Expands a 128-bit key into the round keys
+ */
+void beacon_aes_set_key(beacon_aes_ctx_t *p_ctx, const uint8_t *p_key);
+
+/*
+ * Encrypts one 16 byte block, p_in and p_out may be the same buffer
+ */
+void beacon_aes_encrypt(const beacon_aes_ctx_t *p_ctx, const uint8_t *p_in, uint8_t *p_out);
+
+#endif // _BEACON_AES_H_
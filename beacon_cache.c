@@ -0,0 +1,146 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Encoded advertisement payload cache
+*
+* Each beacon slot keeps its last encoded adv data and length. A lookup on a
+* clean slot returns the stored bytes without calling the encoder. Slots whose
+* inputs change (e.g. Eddystone TLM every second) are marked dirty by the
+* owner and re-encoded on their next lookup.
+*
+* The arena holds the slots back to back, each as long as the largest adv
+* data of its beacon kind rather than the largest adv data of the mode, so
+* an EID slot takes 21 bytes and not 31, or 254 in extended adv mode. A
+* beacon whose payload is a flash constant gets no slot bytes at all.
+*/
+#include "beacon_cache.h"
+#include "beacon_mem.h"
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint8_t     *data;
+    uint16_t     size;
+    uint8_t      len;
+    wiced_bool_t dirty;
+} beacon_cache_entry_t;
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+static beacon_cache_entry_t beacon_cache[BEACON_CACHE_SLOTS];
+static beacon_cache_stats_t beacon_cache_stats;
+static uint8_t             *beacon_cache_scratch_data;
+
+/******************************************************************************
+ *     Public Function Definitions
+ ******************************************************************************/
+
+/*
+ * Allocates the slots and the staging buffer in one arena, marks all slots
+ * dirty and clears the counters
+ */
+wiced_bool_t beacon_cache_init(const uint16_t slot_size[BEACON_CACHE_SLOTS], uint16_t scratch_size)
+{
+    uint32_t arena_size = scratch_size;
+    uint8_t *p_arena;
+    uint8_t slot;
+
+    for (slot = 0; slot < BEACON_CACHE_SLOTS; slot++)
+    {
+        arena_size += slot_size[slot];
+    }
+    p_arena = (uint8_t *)beacon_mem_alloc(BEACON_MEM_CACHE, arena_size);
+    if (p_arena == NULL)
+    {
+        return WICED_FALSE;
+    }
+
+    beacon_cache_scratch_data = p_arena;
+    p_arena += scratch_size;
+    for (slot = 0; slot < BEACON_CACHE_SLOTS; slot++)
+    {
+        beacon_cache[slot].data = p_arena;
+        beacon_cache[slot].size = slot_size[slot];
+        beacon_cache[slot].len = 0;
+        beacon_cache[slot].dirty = WICED_TRUE;
+        p_arena += slot_size[slot];
+    }
+    beacon_cache_stats.hits = 0;
+    beacon_cache_stats.misses = 0;
+    return WICED_TRUE;
+}
+
+/*
+ * Marks a slot dirty so the next lookup re-encodes it
+ */
+void beacon_cache_mark_dirty(uint8_t slot)
+{
+    if (slot < BEACON_CACHE_SLOTS)
+    {
+        beacon_cache[slot].dirty = WICED_TRUE;
+    }
+}
+
+/*
+ * Returns the encoded adv data of a slot, encoding it first if it is dirty
+ */
+const uint8_t *beacon_cache_get(uint8_t slot, beacon_cache_encode_t *encode, uint32_t param, uint8_t *p_len)
+{
+    beacon_cache_entry_t *p_entry;
+
+    if (slot >= BEACON_CACHE_SLOTS || beacon_cache[slot].size == 0)
+    {
+        *p_len = 0;
+        return NULL;
+    }
+
+    p_entry = &beacon_cache[slot];
+    if (p_entry->dirty)
+    {
+        beacon_cache_stats.misses++;
+        p_entry->len = encode(param, p_entry->data);
+        p_entry->dirty = WICED_FALSE;
+    }
+    else
+    {
+        beacon_cache_stats.hits++;
+    }
+
+    *p_len = p_entry->len;
+    return p_entry->data;
+}
+
+/*
+ * Returns the encoded adv data of a clean slot for in-place updates
+ */
+uint8_t *beacon_cache_lookup(uint8_t slot, uint8_t *p_len)
+{
+    if (slot >= BEACON_CACHE_SLOTS || beacon_cache[slot].size == 0 || beacon_cache[slot].dirty)
+    {
+        return NULL;
+    }
+    *p_len = beacon_cache[slot].len;
+    return beacon_cache[slot].data;
+}
+
+/*
+ * Returns the staging buffer for adv data that is not cached
+ */
+uint8_t *beacon_cache_scratch(void)
+{
+    return beacon_cache_scratch_data;
+}
+
+/*
+ * Returns the hit and miss counters
+ */
+void beacon_cache_get_stats(beacon_cache_stats_t *p_stats)
+{
+    *p_stats = beacon_cache_stats;
+}
@@ -0,0 +1,66 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Encoded advertisement payload cache
+*
+* Keeps the encoded adv data of each beacon slot so the rotation only
+* re-encodes a slot after its inputs were marked dirty. The slots are sized
+* for what they hold and packed into one arena with the staging buffer of
+* beacons that are not cached.
+*/
+#ifndef _BEACON_CACHE_H_
+#define _BEACON_CACHE_H_
+
+#include "wiced_bt_beacon.h"
+
+/* Number of beacon slots the cache holds */
+#define BEACON_CACHE_SLOTS  5
+
+/* Encodes the adv data of a slot from param into adv_data (the slot size) and returns its length */
+typedef uint8_t (beacon_cache_encode_t)(uint32_t param, uint8_t *adv_data);
+
+typedef struct
+{
+    uint32_t hits;      /* Lookups served from the cache */
+    uint32_t misses;    /* Lookups that had to encode */
+} beacon_cache_stats_t;
+
+/*
+ * Allocates the arena: slot_size bytes per slot, the largest adv data its
+ * encoder writes or 0 for a slot never cached, and a staging buffer of
+ * scratch_size bytes. Marks all slots dirty and clears the counters.
+ */
+wiced_bool_t beacon_cache_init(const uint16_t slot_size[BEACON_CACHE_SLOTS], uint16_t scratch_size);
+
+/*
+ * Marks a slot dirty so the next lookup re-encodes it
+ */
+void beacon_cache_mark_dirty(uint8_t slot);
+
+/*
+ * Returns the encoded adv data of a slot, encoding it first if it is dirty.
+ * The data stays valid until the slot is encoded again. Returns NULL for a
+ * slot of size 0.
+ */
+const uint8_t *beacon_cache_get(uint8_t slot, beacon_cache_encode_t *encode, uint32_t param, uint8_t *p_len);
+
+/*
+ * Returns the encoded adv data of a clean slot for in-place updates, or NULL
+ * if the slot is dirty. Does not count as a hit or miss.
+ */
+uint8_t *beacon_cache_lookup(uint8_t slot, uint8_t *p_len);
+
+/*
+ * Returns the staging buffer for adv data that is not cached
+ */
+uint8_t *beacon_cache_scratch(void);
+
+/*
+ * Returns the hit and miss counters
+ */
+void beacon_cache_get_stats(beacon_cache_stats_t *p_stats);
+
+#endif // _BEACON_CACHE_H_
@@ -0,0 +1,346 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Extended advertising controller apply layer
+*
+* The shadow of each adv set holds what the controller last accepted. A
+* configuration command goes out only if it differs from the shadow, and
+* the shadow is updated when it does. Outside a transaction stops and
+* starts are issued right away.
+*/
+#include "beacon_ctrl.h"
+#include "beacon_mem.h"
+#include <string.h>
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+/* Shadow fields the controller is known to hold */
+#define BEACON_CTRL_PARAMS_VALID    0x01
+#define BEACON_CTRL_ADDR_VALID      0x02
+#define BEACON_CTRL_DATA_VALID      0x04
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint32_t                  interval;
+    wiced_bt_device_address_t bda;
+    uint8_t                   valid;
+    uint8_t                   len;
+    uint8_t                  *data;
+    const uint8_t            *p_held;   /* Adv data the controller holds, data or a constant payload */
+    wiced_bool_t              ended;    /* Ended by the controller since the last enable */
+} beacon_ctrl_set_t;
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+static beacon_ctrl_set_t                      *beacon_ctrl_sets;
+static wiced_bt_ble_ext_adv_duration_config_t *beacon_ctrl_stops;
+static wiced_bt_ble_ext_adv_duration_config_t *beacon_ctrl_starts;
+static beacon_ctrl_params_func_t              *beacon_ctrl_set_params_func;
+static beacon_ctrl_stats_t                     beacon_ctrl_stats;
+static uint16_t                                beacon_ctrl_data_max;
+static uint8_t                                 beacon_ctrl_num_sets;
+static uint8_t                                 beacon_ctrl_stop_cnt;
+static uint8_t                                 beacon_ctrl_start_cnt;
+static wiced_bool_t                            beacon_ctrl_in_txn;
+
+/******************************************************************************
+ *     Private Function Definitions
+ ******************************************************************************/
+
+/*
+ * Returns the shadow of a handle, NULL if it is out of range
+ */
+static beacon_ctrl_set_t *beacon_ctrl_get_set(uint8_t handle)
+{
+    if (handle == 0 || handle > beacon_ctrl_num_sets)
+    {
+        return NULL;
+    }
+    return &beacon_ctrl_sets[handle - 1];
+}
+
+/*
+ * Issues the collected disables as one command
+ */
+static void beacon_ctrl_flush_stops(void)
+{
+    if (beacon_ctrl_stop_cnt)
+    {
+        wiced_bt_ble_start_ext_adv(MULTI_ADVERT_STOP, beacon_ctrl_stop_cnt, beacon_ctrl_stops);
+        beacon_ctrl_stats.disable_cmds++;
+        beacon_ctrl_stats.sets_disabled += beacon_ctrl_stop_cnt;
+        beacon_ctrl_stop_cnt = 0;
+    }
+}
+
+/*
+ * Issues the collected enables as one command
+ */
+static void beacon_ctrl_flush_starts(void)
+{
+    if (beacon_ctrl_start_cnt)
+    {
+        wiced_bt_ble_start_ext_adv(MULTI_ADVERT_START, beacon_ctrl_start_cnt, beacon_ctrl_starts);
+        beacon_ctrl_stats.enable_cmds++;
+        beacon_ctrl_stats.sets_enabled += beacon_ctrl_start_cnt;
+        beacon_ctrl_start_cnt = 0;
+    }
+}
+
+/*
+ * Sets the adv data of a set if it changed, copying it to the shadow unless
+ * it is a constant payload
+ */
+static void beacon_ctrl_put_data(uint8_t handle, uint8_t len, const uint8_t *p_data, wiced_bool_t is_static)
+{
+    beacon_ctrl_set_t *p_set = beacon_ctrl_get_set(handle);
+
+    if (p_set == NULL || len > beacon_ctrl_data_max)
+    {
+        return;
+    }
+    if ((p_set->valid & BEACON_CTRL_DATA_VALID) && p_set->len == len &&
+        (p_set->p_held == p_data || memcmp(p_set->p_held, p_data, len) == 0))
+    {
+        beacon_ctrl_stats.data_skipped++;
+        return;
+    }
+    beacon_ctrl_flush_stops();
+    wiced_bt_ble_set_ext_adv_data(handle, len, (uint8_t *)p_data);
+    if (is_static)
+    {
+        p_set->p_held = p_data;
+        beacon_ctrl_stats.data_static++;
+    }
+    else
+    {
+        memcpy(p_set->data, p_data, len);
+        p_set->p_held = p_set->data;
+    }
+    p_set->len = len;
+    p_set->valid |= BEACON_CTRL_DATA_VALID;
+    beacon_ctrl_stats.data++;
+}
+
+/******************************************************************************
+ *     Public Function Definitions
+ ******************************************************************************/
+
+/*
+ * Allocates the state of num_sets adv sets, all unknown to the controller
+ */
+wiced_bool_t beacon_ctrl_init(uint8_t num_sets, uint16_t data_max, beacon_ctrl_params_func_t *set_params)
+{
+    uint8_t *p_buf;
+    uint8_t i;
+
+    p_buf = (uint8_t *)beacon_mem_alloc(BEACON_MEM_CTRL, num_sets * (sizeof(beacon_ctrl_set_t) + data_max +
+                                        2 * sizeof(wiced_bt_ble_ext_adv_duration_config_t)));
+    if (p_buf == NULL && num_sets)
+    {
+        return WICED_FALSE;
+    }
+
+    beacon_ctrl_sets   = (beacon_ctrl_set_t *)p_buf;
+    beacon_ctrl_stops  = (wiced_bt_ble_ext_adv_duration_config_t *)(beacon_ctrl_sets + num_sets);
+    beacon_ctrl_starts = beacon_ctrl_stops + num_sets;
+    p_buf              = (uint8_t *)(beacon_ctrl_starts + num_sets);
+    memset(beacon_ctrl_sets, 0, num_sets * sizeof(beacon_ctrl_set_t));
+    for (i = 0; i < num_sets; i++)
+    {
+        beacon_ctrl_sets[i].data = &p_buf[i * data_max];
+    }
+    memset(&beacon_ctrl_stats, 0, sizeof(beacon_ctrl_stats));
+
+    beacon_ctrl_set_params_func = set_params;
+    beacon_ctrl_data_max  = data_max;
+    beacon_ctrl_num_sets  = num_sets;
+    beacon_ctrl_stop_cnt  = 0;
+    beacon_ctrl_start_cnt = 0;
+    beacon_ctrl_in_txn    = WICED_FALSE;
+    return WICED_TRUE;
+}
+
+/*
+ * Starts collecting enables and disables
+ */
+void beacon_ctrl_begin(void)
+{
+    beacon_ctrl_in_txn = WICED_TRUE;
+}
+
+/*
+ * Disables a set
+ */
+void beacon_ctrl_stop(uint8_t handle)
+{
+    beacon_ctrl_set_t *p_set = beacon_ctrl_get_set(handle);
+
+    if (p_set == NULL)
+    {
+        return;
+    }
+    if (p_set->ended)
+    {
+        beacon_ctrl_stats.disable_skipped++;
+        return;
+    }
+    if (beacon_ctrl_stop_cnt >= beacon_ctrl_num_sets)
+    {
+        beacon_ctrl_flush_stops();
+    }
+    beacon_ctrl_stops[beacon_ctrl_stop_cnt].adv_handle = handle;
+    beacon_ctrl_stops[beacon_ctrl_stop_cnt].adv_duration = 0;
+    beacon_ctrl_stops[beacon_ctrl_stop_cnt].max_ext_adv_events = 0;
+    beacon_ctrl_stop_cnt++;
+    if (!beacon_ctrl_in_txn)
+    {
+        beacon_ctrl_flush_stops();
+    }
+}
+
+/*
+ * Sets the adv interval of a disabled set if it changed
+ */
+void beacon_ctrl_set_params(uint8_t handle, uint32_t interval)
+{
+    beacon_ctrl_set_t *p_set = beacon_ctrl_get_set(handle);
+
+    if (p_set == NULL)
+    {
+        return;
+    }
+    if ((p_set->valid & BEACON_CTRL_PARAMS_VALID) && p_set->interval == interval)
+    {
+        beacon_ctrl_stats.params_skipped++;
+        return;
+    }
+    beacon_ctrl_flush_stops();
+    beacon_ctrl_set_params_func(handle, interval);
+    p_set->interval = interval;
+    p_set->valid |= BEACON_CTRL_PARAMS_VALID;
+    beacon_ctrl_stats.params++;
+}
+
+/*
+ * Sets the random address of a disabled set if it changed
+ */
+void beacon_ctrl_set_random_address(uint8_t handle, wiced_bt_device_address_t bda)
+{
+    beacon_ctrl_set_t *p_set = beacon_ctrl_get_set(handle);
+
+    if (p_set == NULL)
+    {
+        return;
+    }
+    if ((p_set->valid & BEACON_CTRL_ADDR_VALID) && memcmp(p_set->bda, bda, BD_ADDR_LEN) == 0)
+    {
+        beacon_ctrl_stats.addr_skipped++;
+        return;
+    }
+    beacon_ctrl_flush_stops();
+    wiced_bt_ble_set_ext_adv_random_address(handle, bda);
+    memcpy(p_set->bda, bda, BD_ADDR_LEN);
+    p_set->valid |= BEACON_CTRL_ADDR_VALID;
+    beacon_ctrl_stats.addr++;
+}
+
+/*
+ * Sets the adv data of a set if it changed
+ */
+void beacon_ctrl_set_data(uint8_t handle, uint8_t len, const uint8_t *p_data)
+{
+    beacon_ctrl_put_data(handle, len, p_data, WICED_FALSE);
+}
+
+/*
+ * Sets adv data that stays valid and unchanged if it changed, without a copy
+ */
+void beacon_ctrl_set_static_data(uint8_t handle, uint8_t len, const uint8_t *p_data)
+{
+    beacon_ctrl_put_data(handle, len, p_data, WICED_TRUE);
+}
+
+/*
+ * Enables a set
+ */
+void beacon_ctrl_start(uint8_t handle)
+{
+    beacon_ctrl_start_for(handle, 0);
+}
+
+/*
+ * Enables a set for duration, a set already collected gets the duration
+ */
+void beacon_ctrl_start_for(uint8_t handle, uint16_t duration)
+{
+    beacon_ctrl_set_t *p_set = beacon_ctrl_get_set(handle);
+    uint8_t i;
+
+    if (p_set == NULL)
+    {
+        return;
+    }
+    p_set->ended = WICED_FALSE;
+    for (i = 0; i < beacon_ctrl_start_cnt; i++)
+    {
+        if (beacon_ctrl_starts[i].adv_handle == handle)
+        {
+            beacon_ctrl_starts[i].adv_duration = duration;
+            return;
+        }
+    }
+    if (beacon_ctrl_start_cnt >= beacon_ctrl_num_sets)
+    {
+        beacon_ctrl_flush_starts();
+    }
+    beacon_ctrl_starts[beacon_ctrl_start_cnt].adv_handle = handle;
+    beacon_ctrl_starts[beacon_ctrl_start_cnt].adv_duration = duration;
+    beacon_ctrl_starts[beacon_ctrl_start_cnt].max_ext_adv_events = 0;
+    beacon_ctrl_start_cnt++;
+    if (!beacon_ctrl_in_txn)
+    {
+        beacon_ctrl_flush_stops();
+        beacon_ctrl_flush_starts();
+    }
+}
+
+/*
+ * Records that the controller ended a set
+ */
+void beacon_ctrl_terminated(uint8_t handle)
+{
+    beacon_ctrl_set_t *p_set = beacon_ctrl_get_set(handle);
+
+    if (p_set != NULL)
+    {
+        p_set->ended = WICED_TRUE;
+    }
+}
+
+/*
+ * Issues the collected disables and enables and ends the transaction
+ */
+void beacon_ctrl_commit(void)
+{
+    beacon_ctrl_flush_stops();
+    beacon_ctrl_flush_starts();
+    beacon_ctrl_in_txn = WICED_FALSE;
+    beacon_ctrl_stats.commits++;
+}
+
+/*
+ * Returns the command counters
+ */
+void beacon_ctrl_get_stats(beacon_ctrl_stats_t *p_stats)
+{
+    *p_stats = beacon_ctrl_stats;
+}
@@ -0,0 +1,106 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Extended advertising controller apply layer
+*
+* Remembers the parameters, random address and adv data the controller last
+* received for every adv set and skips commands that would not change them.
+* Between beacon_ctrl_begin() and beacon_ctrl_commit() set disables and
+* enables are collected and issued as one multi-set command each: the
+* disables before the first set is reconfigured, the enables at commit.
+* A set the controller ended at the end of its duration needs no disable.
+*/
+#ifndef _BEACON_CTRL_H_
+#define _BEACON_CTRL_H_
+
+#include "wiced_bt_beacon.h"
+
+/* Issues the adv parameters of a set with the given adv interval */
+typedef void (beacon_ctrl_params_func_t)(uint8_t handle, uint32_t interval);
+
+typedef struct
+{
+    uint32_t commits;           /* Transactions committed */
+    uint32_t params;            /* Parameter commands issued */
+    uint32_t params_skipped;    /* Parameter commands skipped, unchanged */
+    uint32_t addr;              /* Random address commands issued */
+    uint32_t addr_skipped;      /* Random address commands skipped, unchanged */
+    uint32_t data;              /* Adv data commands issued */
+    uint32_t data_skipped;      /* Adv data commands skipped, unchanged */
+    uint32_t data_static;       /* Adv data commands issued from constant payloads, not copied */
+    uint32_t enable_cmds;       /* Enable commands issued */
+    uint32_t sets_enabled;      /* Sets carried by the enable commands */
+    uint32_t disable_cmds;      /* Disable commands issued */
+    uint32_t sets_disabled;     /* Sets carried by the disable commands */
+    uint32_t disable_skipped;   /* Disables skipped, the set had ended */
+} beacon_ctrl_stats_t;
+
+/*
+ * Allocates the state of num_sets adv sets (handles 1..num_sets) holding up to
+ * data_max bytes of adv data each, all unknown to the controller. set_params
+ * issues the parameter command of a set.
+ */
+wiced_bool_t beacon_ctrl_init(uint8_t num_sets, uint16_t data_max, beacon_ctrl_params_func_t *set_params);
+
+/*
+ * Starts collecting enables and disables
+ */
+void beacon_ctrl_begin(void);
+
+/*
+ * Disables a set, collected until the next configuration command or commit
+ */
+void beacon_ctrl_stop(uint8_t handle);
+
+/*
+ * Sets the adv interval of a disabled set if it changed
+ */
+void beacon_ctrl_set_params(uint8_t handle, uint32_t interval);
+
+/*
+ * Sets the random address of a disabled set if it changed
+ */
+void beacon_ctrl_set_random_address(uint8_t handle, wiced_bt_device_address_t bda);
+
+/*
+ * Sets the adv data of a set if it changed, the set may be enabled
+ */
+void beacon_ctrl_set_data(uint8_t handle, uint8_t len, const uint8_t *p_data);
+
+/*
+ * Sets adv data that stays valid and unchanged, e.g. a const payload in
+ * flash, if it changed. The shadow keeps the pointer instead of a copy.
+ */
+void beacon_ctrl_set_static_data(uint8_t handle, uint8_t len, const uint8_t *p_data);
+
+/*
+ * Enables a set, collected until commit
+ */
+void beacon_ctrl_start(uint8_t handle);
+
+/*
+ * Enables a set for duration (10 ms units, 0 for no limit), collected until
+ * commit. A set already collected gets the duration instead, an enabled set
+ * is enabled again so its duration starts over.
+ */
+void beacon_ctrl_start_for(uint8_t handle, uint16_t duration);
+
+/*
+ * Records that the controller ended a set, the next disable is skipped
+ */
+void beacon_ctrl_terminated(uint8_t handle);
+
+/*
+ * Issues the collected disables and enables and ends the transaction
+ */
+void beacon_ctrl_commit(void);
+
+/*
+ * Returns the command counters
+ */
+void beacon_ctrl_get_stats(beacon_ctrl_stats_t *p_stats);
+
+#endif // _BEACON_CTRL_H_
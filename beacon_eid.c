@@ -0,0 +1,242 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Eddystone-EID rotation engine
+*
+* The refill keeps the identity key schedule and the schedule of the current
+* temporary key, which only changes every 65536 s, so an identifier ahead
+* costs one AES block. The rotation timer publishes the period it is in, the
+* refill skips ahead to it after a jump and the timer drops ring entries of
+* past periods.
+*/
+#include "beacon_eid.h"
+#include "string.h"
+#include <stdatomic.h>
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+/* Byte of the temporary key input marking it apart from EID inputs */
+#define BEACON_EID_TK_SALT          0xff
+
+/* Counter bits a temporary key covers */
+#define BEACON_EID_TK_SHIFT         16
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint32_t period;                        /* counter >> exponent */
+    uint8_t  eid[EDDYSTONE_EID_LEN];
+} beacon_eid_entry_t;
+
+typedef struct
+{
+    beacon_aes_ctx_t   ik;                  /* Identity key schedule, read only after init */
+    beacon_aes_ctx_t   tk;                  /* Temporary key schedule of the refill */
+    uint32_t           tk_hi;               /* counter >> 16 tk belongs to */
+    wiced_bool_t       tk_valid;
+    uint8_t            exponent;
+    _Atomic wiced_bool_t ready;             /* Set once init has filled the ring */
+    beacon_eid_entry_t ring[BEACON_EID_AHEAD];
+    _Atomic uint32_t   head;                /* Next entry to fill, refill only */
+    _Atomic uint32_t   tail;                /* Entry of the current period, get only */
+    uint32_t           next;                /* Period the refill computes next */
+    _Atomic uint32_t   now;                 /* Period of the last get */
+    uint32_t           served_period;
+    wiced_bool_t       served_valid;
+    _Atomic uint32_t   computed;            /* Read by beacon_eid_get_stats() */
+    beacon_eid_stats_t stats;
+} beacon_eid_t;
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+static beacon_eid_t beacon_eid;
+
+/******************************************************************************
+ *     Private Function Definitions
+ ******************************************************************************/
+
+/*
+ * Expands the temporary key of a time counter from the identity key schedule
+ */
+static void beacon_eid_temp_key(const beacon_aes_ctx_t *p_ik, uint32_t counter, beacon_aes_ctx_t *p_tk)
+{
+    uint8_t block[BEACON_AES_BLOCK_LEN] = { 0 };
+
+    block[11] = BEACON_EID_TK_SALT;
+    block[14] = (uint8_t)(counter >> 24);
+    block[15] = (uint8_t)(counter >> 16);
+    beacon_aes_encrypt(p_ik, block, block);
+    beacon_aes_set_key(p_tk, block);
+}
+
+/*
+ * Computes the EID of a time counter with the schedule of its temporary key
+ */
+static void beacon_eid_from_temp_key(const beacon_aes_ctx_t *p_tk, uint8_t exponent, uint32_t counter, uint8_t *p_eid)
+{
+    uint8_t block[BEACON_AES_BLOCK_LEN] = { 0 };
+
+    counter &= ~((1u << exponent) - 1);
+    block[11] = exponent;
+    block[12] = (uint8_t)(counter >> 24);
+    block[13] = (uint8_t)(counter >> 16);
+    block[14] = (uint8_t)(counter >> 8);
+    block[15] = (uint8_t)counter;
+    beacon_aes_encrypt(p_tk, block, block);
+    memcpy(p_eid, block, EDDYSTONE_EID_LEN);
+}
+
+/*
+ * Fills the ring up to BEACON_EID_AHEAD entries past the consumer
+ */
+static uint32_t beacon_eid_fill(void)
+{
+    beacon_eid_t *p_eid = &beacon_eid;
+    beacon_eid_entry_t *p_entry;
+    uint32_t head = atomic_load_explicit(&p_eid->head, memory_order_relaxed);
+    uint32_t now = atomic_load_explicit(&p_eid->now, memory_order_relaxed);
+    uint32_t counter;
+    uint32_t cnt = 0;
+
+    // after a jump start at the current period, get drops what lies behind it
+    if (p_eid->next < now)
+    {
+        p_eid->next = now;
+    }
+
+    while (head - atomic_load_explicit(&p_eid->tail, memory_order_acquire) < BEACON_EID_AHEAD)
+    {
+        counter = p_eid->next << p_eid->exponent;
+        if (!p_eid->tk_valid || p_eid->tk_hi != counter >> BEACON_EID_TK_SHIFT)
+        {
+            beacon_eid_temp_key(&p_eid->ik, counter, &p_eid->tk);
+            p_eid->tk_hi = counter >> BEACON_EID_TK_SHIFT;
+            p_eid->tk_valid = WICED_TRUE;
+        }
+
+        p_entry = &p_eid->ring[head & (BEACON_EID_AHEAD - 1)];
+        p_entry->period = p_eid->next;
+        beacon_eid_from_temp_key(&p_eid->tk, p_eid->exponent, counter, p_entry->eid);
+        atomic_store_explicit(&p_eid->head, ++head, memory_order_release);
+        p_eid->next++;
+        cnt++;
+    }
+    atomic_fetch_add_explicit(&p_eid->computed, cnt, memory_order_relaxed);
+    return cnt;
+}
+
+/******************************************************************************
+ *     Public Function Definitions
+ ******************************************************************************/
+
+/*
+ * Computes the EID of a time counter from scratch
+ */
+void beacon_eid_compute(const uint8_t *p_identity_key, uint8_t exponent, uint32_t counter, uint8_t *p_eid)
+{
+    beacon_aes_ctx_t ctx;
+
+    beacon_aes_set_key(&ctx, p_identity_key);
+    beacon_eid_temp_key(&ctx, counter, &ctx);
+    beacon_eid_from_temp_key(&ctx, exponent, counter, p_eid);
+}
+
+/*
+ * Sets the identity key and exponent and fills the ring
+ */
+wiced_bool_t beacon_eid_init(const uint8_t *p_identity_key, uint8_t exponent, uint32_t counter)
+{
+    beacon_eid_t *p_eid = &beacon_eid;
+
+    if (exponent > BEACON_EID_EXPONENT_MAX)
+    {
+        return WICED_FALSE;
+    }
+
+    memset(p_eid, 0, sizeof(*p_eid));
+    beacon_aes_set_key(&p_eid->ik, p_identity_key);
+    p_eid->exponent = exponent;
+    p_eid->next = counter >> exponent;
+    atomic_store_explicit(&p_eid->now, p_eid->next, memory_order_relaxed);
+    beacon_eid_fill();
+
+    // the refill thread may run from here on
+    atomic_store_explicit(&p_eid->ready, WICED_TRUE, memory_order_release);
+    return WICED_TRUE;
+}
+
+/*
+ * Computes identifiers ahead, nothing before init
+ */
+uint32_t beacon_eid_refill(void)
+{
+    if (!atomic_load_explicit(&beacon_eid.ready, memory_order_acquire))
+    {
+        return 0;
+    }
+    return beacon_eid_fill();
+}
+
+/*
+ * Copies the EID of a time counter when its period changed
+ */
+wiced_bool_t beacon_eid_get(uint32_t counter, uint8_t *p_eid)
+{
+    beacon_eid_t *p_state = &beacon_eid;
+    beacon_eid_entry_t *p_entry = NULL;
+    beacon_aes_ctx_t tk;
+    uint32_t period = counter >> p_state->exponent;
+    uint32_t tail = atomic_load_explicit(&p_state->tail, memory_order_relaxed);
+    uint32_t head;
+
+    if (p_state->served_valid && period == p_state->served_period)
+    {
+        return WICED_FALSE;
+    }
+    atomic_store_explicit(&p_state->now, period, memory_order_relaxed);
+
+    // drop the entries of past periods
+    head = atomic_load_explicit(&p_state->head, memory_order_acquire);
+    for (; tail != head; tail++)
+    {
+        p_entry = &p_state->ring[tail & (BEACON_EID_AHEAD - 1)];
+        if (p_entry->period >= period)
+        {
+            break;
+        }
+    }
+
+    if (tail != head && p_entry->period == period)
+    {
+        memcpy(p_eid, p_entry->eid, EDDYSTONE_EID_LEN);
+        p_state->stats.served++;
+    }
+    else
+    {
+        beacon_eid_temp_key(&p_state->ik, counter, &tk);
+        beacon_eid_from_temp_key(&tk, p_state->exponent, counter, p_eid);
+        p_state->stats.misses++;
+    }
+    atomic_store_explicit(&p_state->tail, tail, memory_order_release);
+
+    p_state->served_period = period;
+    p_state->served_valid = WICED_TRUE;
+    return WICED_TRUE;
+}
+
+/*
+ * Returns the refill and rotation counters
+ */
+void beacon_eid_get_stats(beacon_eid_stats_t *p_stats)
+{
+    p_stats->computed = atomic_load_explicit(&beacon_eid.computed, memory_order_relaxed);
+    p_stats->served   = beacon_eid.stats.served;
+    p_stats->misses   = beacon_eid.stats.misses;
+}
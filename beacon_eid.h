@@ -0,0 +1,90 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Eddystone-EID rotation engine
+*
+* An ephemeral identifier is derived from the 128-bit identity key shared
+* with the resolver, the rotation exponent K and the beacon time counter in
+* seconds:
+*
+*   temporary key = AES(identity key, 11 x 00 | FF | 00 00 | counter >> 16)
+*   EID           = AES(temporary key, 11 x 00 | K | counter & ~(2^K - 1))[0..7]
+*
+* with the counter bytes big-endian. The EID changes every 2^K seconds.
+*
+* The identifiers of the next BEACON_EID_AHEAD periods are computed ahead of
+* time by beacon_eid_refill() on a low priority thread. beacon_eid_get() on
+* the rotation timer only compares the period and, when it changed, copies
+* 8 bytes out of the ring. If the ring has not caught up, e.g. after the
+* counter jumped, the identifier is computed inline and counted as a miss.
+*
+* The ring is single producer (refill) and single consumer (get), no lock.
+*/
+#ifndef _BEACON_EID_H_
+#define _BEACON_EID_H_
+
+#include "wiced_bt_beacon.h"
+#include "beacon_aes.h"
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+
+/* Identifiers kept in the ring, the current one included, power of 2 */
+#ifndef BEACON_EID_AHEAD
+#define BEACON_EID_AHEAD            8
+#endif
+
+/* Largest rotation exponent, 2^15 s is about 9 hours */
+#define BEACON_EID_EXPONENT_MAX     15
+
+#if (BEACON_EID_AHEAD & (BEACON_EID_AHEAD - 1)) != 0
+#error "BEACON_EID_AHEAD must be a power of 2"
+#endif
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint32_t computed;      /* Identifiers computed ahead by the refill */
+    uint32_t served;        /* Rotations served from the ring */
+    uint32_t misses;        /* Rotations that computed the identifier inline */
+} beacon_eid_stats_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+
+/*
+ * Computes the EID of a time counter from scratch, both key schedules included
+ */
+void beacon_eid_compute(const uint8_t *p_identity_key, uint8_t exponent, uint32_t counter, uint8_t *p_eid);
+
+/*
+ * Sets the identity key and rotation exponent and fills the ring from the
+ * period of counter on. Call once, before the refill thread can see it.
+ */
+wiced_bool_t beacon_eid_init(const uint8_t *p_identity_key, uint8_t exponent, uint32_t counter);
+
+/*
+ * Computes identifiers until the ring holds BEACON_EID_AHEAD periods from the
+ * current one on. Runs on a low priority thread, returns the count computed.
+ */
+uint32_t beacon_eid_refill(void);
+
+/*
+ * Copies the EID of a time counter to p_eid (EDDYSTONE_EID_LEN bytes) when
+ * its period differs from the last call, returns WICED_TRUE if it did
+ */
+wiced_bool_t beacon_eid_get(uint32_t counter, uint8_t *p_eid);
+
+/*
+ * Returns the refill and rotation counters
+ */
+void beacon_eid_get_stats(beacon_eid_stats_t *p_stats);
+
+#endif // _BEACON_EID_H_
@@ -0,0 +1,206 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Eddystone eTLM encryption
+*
+* EAX with an empty header:
+*   N' = OMAC0(nonce), H' = OMAC1(), C = CTR(N', tlm), tag = N' ^ H' ^ OMAC2(C)
+* where OMACt(M) is CMAC over the block [t] followed by M. The nonce (6 bytes)
+* and the ciphertext (12 bytes) are single partial blocks, so each OMAC is
+* the precomputed E([t]) ^ K2 ^ padding, XORed with the data and encrypted once.
+*/
+#include "beacon_etlm.h"
+#include "string.h"
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+/* CMAC subkey reduction constant */
+#define BEACON_ETLM_CMAC_RB         0x87
+
+/* CMAC padding of a partial last block */
+#define BEACON_ETLM_CMAC_PAD        0x80
+
+/* OMAC tweaks of the nonce, header and ciphertext, and the salt permutation keys */
+#define BEACON_ETLM_OMAC_NONCE      0
+#define BEACON_ETLM_OMAC_HEADER     1
+#define BEACON_ETLM_OMAC_CIPHER     2
+#define BEACON_ETLM_SALT_KEY        3
+
+/* Offsets in the TLM encrypted frame from its frame type byte */
+#define BEACON_ETLM_FRAME_ETLM      2
+#define BEACON_ETLM_FRAME_SALT      (BEACON_ETLM_FRAME_ETLM + EDDYSTONE_ETLM_LEN)
+
+/******************************************************************************
+ *     Private Function Definitions
+ ******************************************************************************/
+
+/*
+ * Doubles a block in GF(2^128), the CMAC subkey step
+ */
+static void beacon_etlm_dbl(const uint8_t *p_in, uint8_t *p_out)
+{
+    uint8_t carry = (p_in[0] & 0x80) ? BEACON_ETLM_CMAC_RB : 0;
+    int i;
+
+    for (i = 0; i < BEACON_AES_BLOCK_LEN - 1; i++)
+    {
+        p_out[i] = (uint8_t)((p_in[i] << 1) | (p_in[i + 1] >> 7));
+    }
+    p_out[BEACON_AES_BLOCK_LEN - 1] = (uint8_t)(p_in[BEACON_AES_BLOCK_LEN - 1] << 1) ^ carry;
+}
+
+/*
+ * Encrypts the OMAC tweak block [t]
+ */
+static void beacon_etlm_tweak(const beacon_aes_ctx_t *p_aes, uint8_t t, uint8_t *p_out)
+{
+    uint8_t block[BEACON_AES_BLOCK_LEN] = { 0 };
+
+    block[BEACON_AES_BLOCK_LEN - 1] = t;
+    beacon_aes_encrypt(p_aes, block, p_out);
+}
+
+/*
+ * Serialises the TLM values as the unencrypted frame carries them
+ */
+static void beacon_etlm_tlm_data(uint16_t vbatt, uint16_t temp, uint32_t adv_cnt, uint32_t sec_cnt, uint8_t *p)
+{
+    UINT16_TO_STREAM(p, vbatt);
+    UINT16_TO_STREAM(p, temp);
+    UINT32_TO_STREAM(p, adv_cnt);
+    UINT32_TO_STREAM(p, sec_cnt);
+}
+
+/******************************************************************************
+ *     Public Function Definitions
+ ******************************************************************************/
+
+/*
+ * Expands the identity key and precomputes the salt independent EAX blocks
+ */
+void beacon_etlm_init(beacon_etlm_ctx_t *p_ctx, const uint8_t *p_identity_key)
+{
+    uint8_t l[BEACON_AES_BLOCK_LEN], k1[BEACON_AES_BLOCK_LEN], k2[BEACON_AES_BLOCK_LEN];
+    uint8_t block[BEACON_AES_BLOCK_LEN];
+    int i;
+
+    memset(p_ctx, 0, sizeof(*p_ctx));
+    beacon_aes_set_key(&p_ctx->aes, p_identity_key);
+
+    // E([0]) is both the CMAC subkey base and the first nonce OMAC block
+    beacon_etlm_tweak(&p_ctx->aes, BEACON_ETLM_OMAC_NONCE, l);
+    beacon_etlm_dbl(l, k1);
+    beacon_etlm_dbl(k1, k2);
+
+    // [1] alone is a full last block, its CMAC is E([1] ^ K1)
+    memcpy(block, k1, sizeof(block));
+    block[BEACON_AES_BLOCK_LEN - 1] ^= BEACON_ETLM_OMAC_HEADER;
+    beacon_aes_encrypt(&p_ctx->aes, block, p_ctx->header_tag);
+
+    beacon_etlm_tweak(&p_ctx->aes, BEACON_ETLM_OMAC_CIPHER, p_ctx->cipher_pre);
+    for (i = 0; i < BEACON_AES_BLOCK_LEN; i++)
+    {
+        p_ctx->nonce_pre[i] = l[i] ^ k2[i];
+        p_ctx->cipher_pre[i] ^= k2[i];
+    }
+    p_ctx->nonce_pre[BEACON_ETLM_NONCE_LEN] ^= BEACON_ETLM_CMAC_PAD;
+    p_ctx->cipher_pre[EDDYSTONE_ETLM_LEN] ^= BEACON_ETLM_CMAC_PAD;
+
+    beacon_etlm_tweak(&p_ctx->aes, BEACON_ETLM_SALT_KEY, block);
+    p_ctx->salt_mask[0] = (uint16_t)((block[0] << 8) | block[1]);
+    p_ctx->salt_mask[1] = (uint16_t)((block[2] << 8) | block[3]);
+}
+
+/*
+ * Returns the salt of the next refresh: a keyed permutation of the refresh
+ * count, odd multiplies and xorshifts are both invertible on 16 bits
+ */
+uint16_t beacon_etlm_next_salt(beacon_etlm_ctx_t *p_ctx, uint32_t time_base)
+{
+    uint16_t x;
+
+    if (time_base != p_ctx->salt_time_base)
+    {
+        p_ctx->salt_time_base = time_base;
+        p_ctx->salt_cnt = 0;
+    }
+    x = (uint16_t)(p_ctx->salt_cnt++ ^ p_ctx->salt_mask[0]);
+    x = (uint16_t)(x * 0x6487u);
+    x ^= x >> 7;
+    x = (uint16_t)(x * 0x2c1bu);
+    x ^= x >> 8;
+    return (uint16_t)(x ^ p_ctx->salt_mask[1]);
+}
+
+/*
+ * Encrypts 12 bytes of TLM data with three AES blocks, returns the MIC
+ */
+uint16_t beacon_etlm_encrypt(const beacon_etlm_ctx_t *p_ctx, uint32_t time_base, uint16_t salt,
+                             const uint8_t *p_tlm, uint8_t *p_etlm)
+{
+    uint8_t n_tag[BEACON_AES_BLOCK_LEN], stream[BEACON_AES_BLOCK_LEN], block[BEACON_AES_BLOCK_LEN];
+    int i;
+
+    // N' = OMAC0(time base | salt)
+    memcpy(block, p_ctx->nonce_pre, sizeof(block));
+    block[0] ^= (uint8_t)(time_base >> 24);
+    block[1] ^= (uint8_t)(time_base >> 16);
+    block[2] ^= (uint8_t)(time_base >> 8);
+    block[3] ^= (uint8_t)time_base;
+    block[4] ^= (uint8_t)(salt >> 8);
+    block[5] ^= (uint8_t)salt;
+    beacon_aes_encrypt(&p_ctx->aes, block, n_tag);
+
+    // one CTR block covers the data
+    beacon_aes_encrypt(&p_ctx->aes, n_tag, stream);
+    memcpy(block, p_ctx->cipher_pre, sizeof(block));
+    for (i = 0; i < EDDYSTONE_ETLM_LEN; i++)
+    {
+        p_etlm[i] = p_tlm[i] ^ stream[i];
+        block[i] ^= p_etlm[i];
+    }
+
+    // tag = N' ^ H' ^ OMAC2(C), only its first two bytes are sent
+    beacon_aes_encrypt(&p_ctx->aes, block, block);
+    return (uint16_t)(((n_tag[0] ^ p_ctx->header_tag[0] ^ block[0]) << 8) |
+                      (n_tag[1] ^ p_ctx->header_tag[1] ^ block[1]));
+}
+
+/*
+ * Appends an Eddystone TLM encrypted frame of the TLM values
+ */
+wiced_bool_t beacon_etlm_put(wiced_bt_beacon_encoder_t *p_enc, beacon_etlm_ctx_t *p_ctx, uint32_t time_base,
+                             uint16_t vbatt, uint16_t temp, uint32_t adv_cnt, uint32_t sec_cnt)
+{
+    uint8_t tlm[EDDYSTONE_ETLM_LEN], etlm[EDDYSTONE_ETLM_LEN];
+    uint16_t salt = beacon_etlm_next_salt(p_ctx, time_base);
+    uint16_t mic;
+
+    beacon_etlm_tlm_data(vbatt, temp, adv_cnt, sec_cnt, tlm);
+    mic = beacon_etlm_encrypt(p_ctx, time_base, salt, tlm, etlm);
+    return wiced_bt_eddystone_put_tlm_encrypted(p_enc, etlm, salt, mic);
+}
+
+/*
+ * Encrypts the TLM values again into an encoded TLM encrypted frame
+ */
+void beacon_etlm_patch_frame(uint8_t *p_frame, beacon_etlm_ctx_t *p_ctx, uint32_t time_base,
+                             uint16_t vbatt, uint16_t temp, uint32_t adv_cnt, uint32_t sec_cnt)
+{
+    uint8_t tlm[EDDYSTONE_ETLM_LEN];
+    uint16_t salt = beacon_etlm_next_salt(p_ctx, time_base);
+    uint16_t mic;
+    uint8_t *p;
+
+    beacon_etlm_tlm_data(vbatt, temp, adv_cnt, sec_cnt, tlm);
+    mic = beacon_etlm_encrypt(p_ctx, time_base, salt, tlm, &p_frame[BEACON_ETLM_FRAME_ETLM]);
+
+    // same byte order as wiced_bt_eddystone_put_tlm_encrypted
+    p = &p_frame[BEACON_ETLM_FRAME_SALT];
+    UINT16_TO_STREAM(p, salt);
+    UINT16_TO_STREAM(p, mic);
+}
@@ -0,0 +1,86 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Eddystone eTLM encryption
+*
+* Encrypts the 12 bytes of TLM data (VBATT, TEMP, ADV_CNT, SEC_CNT as the
+* unencrypted frame carries them) with AES-EAX under the EID identity key.
+* The 48-bit nonce is the EID time base, the counter of the current EID
+* period, followed by the 16-bit salt, both big-endian. There is no header.
+* The MIC is the first two bytes of the EAX tag, big-endian.
+*
+* Everything that depends only on the key is computed once: the CMAC
+* subkeys, the OMAC of the empty header and the first OMAC blocks of the
+* nonce and the ciphertext. A TLM refresh then costs three AES blocks, the
+* nonce OMAC, one CTR block and the ciphertext OMAC.
+*
+* Salts come from a keyed 16-bit permutation of a refresh count that restarts
+* with every time base, so salts do not repeat within an EID period as long
+* as it has fewer than 65536 refreshes, and do not count up on air. A nonce
+* is therefore only unique if no time base is used twice. The caller must
+* take it from a time counter that never goes back, across resets too, such
+* as the one of beacon_time.h.
+*/
+#ifndef _BEACON_ETLM_H_
+#define _BEACON_ETLM_H_
+
+#include "wiced_bt_beacon.h"
+#include "beacon_aes.h"
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+/* Nonce bytes: time base and salt */
+#define BEACON_ETLM_NONCE_LEN       6
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    beacon_aes_ctx_t aes;                           /* Identity key schedule */
+    uint8_t  nonce_pre[BEACON_AES_BLOCK_LEN];       /* E(0) ^ K2 ^ nonce padding */
+    uint8_t  cipher_pre[BEACON_AES_BLOCK_LEN];      /* E([2]) ^ K2 ^ ciphertext padding */
+    uint8_t  header_tag[BEACON_AES_BLOCK_LEN];      /* OMAC of the empty header */
+    uint16_t salt_mask[2];                          /* Keys of the salt permutation */
+    uint32_t salt_time_base;                        /* Time base of the refresh count */
+    uint16_t salt_cnt;                              /* Refresh count in this time base */
+} beacon_etlm_ctx_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+
+/*
+ * Expands the identity key and precomputes the salt independent EAX blocks
+ */
+void beacon_etlm_init(beacon_etlm_ctx_t *p_ctx, const uint8_t *p_identity_key);
+
+/*
+ * Returns the salt of the next refresh in a time base
+ */
+uint16_t beacon_etlm_next_salt(beacon_etlm_ctx_t *p_ctx, uint32_t time_base);
+
+/*
+ * Encrypts 12 bytes of TLM data into p_etlm with the given salt, returns the MIC
+ */
+uint16_t beacon_etlm_encrypt(const beacon_etlm_ctx_t *p_ctx, uint32_t time_base, uint16_t salt,
+                             const uint8_t *p_tlm, uint8_t *p_etlm);
+
+/*
+ * Appends an Eddystone TLM encrypted frame of the TLM values, with the next salt
+ */
+wiced_bool_t beacon_etlm_put(wiced_bt_beacon_encoder_t *p_enc, beacon_etlm_ctx_t *p_ctx, uint32_t time_base,
+                             uint16_t vbatt, uint16_t temp, uint32_t adv_cnt, uint32_t sec_cnt);
+
+/*
+ * Encrypts the TLM values again into an encoded TLM encrypted frame, p_frame
+ * is its frame type byte
+ */
+void beacon_etlm_patch_frame(uint8_t *p_frame, beacon_etlm_ctx_t *p_ctx, uint32_t time_base,
+                             uint16_t vbatt, uint16_t temp, uint32_t adv_cnt, uint32_t sec_cnt);
+
+#endif // _BEACON_ETLM_H_
@@ -8,39 +8,121 @@
 *
 */
 #include "wiced_bt_gatt.h"
-#include "wiced_memory.h"
+#include "beacon_mem.h"
 #include "cycfg_gap.h"
 #include "cycfg_gatt_db.h"
 #include "beacon.h"
-#include "stdlib.h"
+#include "beacon_gatt.h"
+#include "beacon_gatt_index.h"
+#include "beacon_gatt_rsp.h"
+#include "beacon_log.h"
+#include "beacon_pool.h"
+#include "beacon_prof.h"
 #include "stdio.h"
+#include "string.h"
 
 extern const wiced_bt_cfg_settings_t app_cfg_settings;
 typedef void (*pfn_free_buffer_t)(uint8_t *);
 
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+/*
+ * Attribute values and LEGATTDB_PERM_* permissions indexed by handle, built
+ * from the lookup table and the records of the database. Handles without a
+ * value in the lookup table are NULL. Both arrays share one heap buffer, the
+ * permissions follow the pointers.
+ */
+static gatt_db_lookup_table_t **beacon_gatt_attr;
+static uint8_t                 *beacon_gatt_perm;
+static uint16_t                 beacon_gatt_attr_cnt;  /* Highest handle + 1 */
+
 /******************************************************************************
  *                             Local Function Definitions
  ******************************************************************************/
 void* app_alloc_buffer(int len)
 {
-    uint8_t *p = (uint8_t *)malloc(len);
-    printf( "%s() len %d alloc %p \n", __FUNCTION__,len, p);
-    return p;
+    return beacon_pool_alloc((uint16_t)len);
 }
 
 void app_free_buffer(uint8_t *p_buf)
 {
-    if (p_buf != NULL)
-    {
-        printf( "%s()free:%p \n",__FUNCTION__, p_buf);
-        free(p_buf);
-    }
+    beacon_pool_free(p_buf);
 }
 
 /******************************************************************************
  *                          Function Definitions
  ******************************************************************************/
 
+/*
+ * Builds the handle-indexed attribute table from the value lookup table and
+ * the attribute type index from the database records
+ */
+wiced_bool_t beacon_gatt_db_init(const uint8_t *p_db, uint16_t db_len,
+        gatt_db_lookup_table_t *p_attr_tbl, uint16_t attr_tbl_size)
+{
+    uint16_t i, handle, cnt = 0;
+
+    beacon_mem_free(BEACON_MEM_GATT);
+    beacon_gatt_attr     = NULL;
+    beacon_gatt_perm     = NULL;
+    beacon_gatt_attr_cnt = 0;
+    if (beacon_gatt_index_init(p_db, db_len) == 0)
+    {
+        return WICED_FALSE;
+    }
+
+    for (i = 0; i < attr_tbl_size; i++)
+    {
+        if (p_attr_tbl[i].handle >= cnt)
+        {
+            cnt = p_attr_tbl[i].handle + 1;
+        }
+    }
+
+    beacon_gatt_attr = (gatt_db_lookup_table_t **)beacon_mem_alloc(BEACON_MEM_GATT,
+                                                                   cnt * (sizeof(gatt_db_lookup_table_t *) + 1));
+    if (beacon_gatt_attr == NULL)
+    {
+        BEACON_LOG_ERROR("gatt attr table alloc failed\n");
+        return WICED_FALSE;
+    }
+    beacon_gatt_perm = (uint8_t *)&beacon_gatt_attr[cnt];
+    memset(beacon_gatt_attr, 0, cnt * (sizeof(gatt_db_lookup_table_t *) + 1));
+    for (i = 0; i < attr_tbl_size; i++)
+    {
+        beacon_gatt_attr[p_attr_tbl[i].handle] = &p_attr_tbl[i];
+    }
+    for (i = 0; i < beacon_gatt_index_count(); i++)
+    {
+        handle = beacon_gatt_index_handle(i);
+        if (handle < cnt)
+        {
+            beacon_gatt_perm[handle] = beacon_gatt_index_perm(i);
+        }
+    }
+    beacon_gatt_attr_cnt = cnt;
+
+    beacon_gatt_rsp_init();
+    return WICED_TRUE;
+}
+
+/*
+ * Returns the value of an attribute, NULL if the handle has none
+ */
+gatt_db_lookup_table_t *beacon_gatt_attr_find(uint16_t handle)
+{
+    return (handle < beacon_gatt_attr_cnt) ? beacon_gatt_attr[handle] : NULL;
+}
+
+/*
+ * Returns the permission of an attribute, LEGATTDB_PERM_NONE if the handle has no value
+ */
+uint8_t beacon_gatt_attr_perm(uint16_t handle)
+{
+    return (handle < beacon_gatt_attr_cnt) ? beacon_gatt_perm[handle] : LEGATTDB_PERM_NONE;
+}
+
 /*
  * Setup advertisement data with configured advertisment array from BTConfigurator
  * By default, includes 16 byte UUID and device name
@@ -58,24 +140,16 @@ wiced_bt_gatt_status_t beacon_req_read_handler(uint16_t conn_id,
         wiced_bt_gatt_read_t *p_read_req,
         uint16_t len_requested)
 {
+    gatt_db_lookup_table_t *p_attr = beacon_gatt_attr_find(p_read_req->handle);
     int to_copy;
     uint8_t * copy_from;
 
-    switch(p_read_req->handle)
+    if (p_attr == NULL)
     {
-    case HDLC_GAP_DEVICE_NAME_VALUE:
-        to_copy = app_gap_device_name_len;
-        copy_from = (uint8_t *) app_gap_device_name;
-        break;
-
-    case HDLC_GAP_APPEARANCE_VALUE:
-        to_copy = 2;
-        copy_from = (uint8_t *) &app_cfg_settings.p_ble_cfg->appearance;
-        break;
-
-    default:
         return WICED_BT_GATT_INVALID_HANDLE;
     }
+    to_copy = p_attr->cur_len;
+    copy_from = p_attr->p_data;
 
     // Adjust copying location & length limit based on offset
     copy_from += p_read_req->offset;
@@ -108,49 +182,47 @@ wiced_bt_gatt_status_t beacon_req_read_by_type_handler(uint16_t conn_id,
         wiced_bt_gatt_read_by_type_t *p_read_req,
         uint16_t len_requested)
 {
-    int         to_copy;
-    uint8_t     * copy_from;
+    gatt_db_lookup_table_t *p_attr;
     uint16_t    attr_handle = p_read_req->s_handle;
-    uint8_t    *p_rsp = wiced_bt_get_buffer(len_requested);
+    uint8_t    *p_rsp;
+    const uint8_t *p_static;
     uint8_t     pair_len = 0;
+    uint16_t    pos, cnt, static_len;
     int used = 0;
 
+    /* Read by type returns all attributes of the specified type, between the start and end handles */
+    cnt = beacon_gatt_index_find(&p_read_req->uuid, p_read_req->s_handle,
+            p_read_req->e_handle, &pos);
+
+    /* Static attributes only, send the pre-serialised pairs, nothing to free */
+    static_len = beacon_gatt_rsp_read_by_type(pos, cnt, len_requested, &p_static, &pair_len);
+    if (static_len != 0)
+    {
+        wiced_bt_gatt_server_send_read_by_type_rsp(conn_id, opcode, pair_len,
+                static_len, (uint8_t *)p_static, NULL);
+        return WICED_BT_GATT_SUCCESS;
+    }
+
+    p_rsp = app_alloc_buffer(len_requested);
     if (p_rsp == NULL)
     {
-        printf("[%s] no memory len_requested: %d!!\n", __FUNCTION__,
+        BEACON_LOG_ERROR("[%s] no memory len_requested: %d!!\n", __FUNCTION__,
                 len_requested);
         wiced_bt_gatt_server_send_error_rsp(conn_id, opcode, attr_handle,
                 WICED_BT_GATT_INSUF_RESOURCE);
         return WICED_BT_GATT_INSUF_RESOURCE;
     }
 
-    /* Read by type returns all attributes of the specified type, between the start and end handles */
-    while (WICED_TRUE)
+    for (; cnt > 0; cnt--, pos++)
     {
-        /// Add your code here
-        attr_handle = wiced_bt_gatt_find_handle_by_type(attr_handle,
-                p_read_req->e_handle, &p_read_req->uuid);
-
-        if (attr_handle == 0)
-            break;
-
-        switch(attr_handle)
+        attr_handle = beacon_gatt_index_handle(pos);
+        p_attr = beacon_gatt_attr_find(attr_handle);
+        if (p_attr == NULL)
         {
-        case HDLC_GAP_DEVICE_NAME_VALUE:
-            to_copy = app_gap_device_name_len;
-            copy_from = (uint8_t *) app_gap_device_name;
-            break;
-
-        case HDLC_GAP_APPEARANCE_VALUE:
-            to_copy = 2;
-            copy_from = (uint8_t *) &app_cfg_settings.p_ble_cfg->appearance;
-            break;
-
-        default:
-            printf("[%s] found type but no attribute ??\n", __FUNCTION__);
+            BEACON_LOG_WARN("[%s] found type but no attribute ??\n", __FUNCTION__);
             wiced_bt_gatt_server_send_error_rsp(conn_id, opcode,
                     p_read_req->s_handle, WICED_BT_GATT_ERR_UNLIKELY);
-            wiced_bt_free_buffer(p_rsp);
+            app_free_buffer(p_rsp);
             return WICED_BT_GATT_ERR_UNLIKELY;
         }
 
@@ -159,33 +231,30 @@ wiced_bt_gatt_status_t beacon_req_read_by_type_handler(uint16_t conn_id,
                 len_requested - used,
                 &pair_len,
                 attr_handle,
-                to_copy,
-                copy_from);
+                p_attr->cur_len,
+                p_attr->p_data);
 
         if (filled == 0) {
             break;
         }
         used += filled;
-
-        /* Increment starting handle for next search to one past current */
-        attr_handle++;
     }
 
     if (used == 0)
     {
-        printf("[%s] attr not found 0x%04x -  0x%04x Type: 0x%04x\n",
+        BEACON_LOG_WARN("[%s] attr not found 0x%04x -  0x%04x Type: 0x%04x\n",
                 __FUNCTION__, p_read_req->s_handle, p_read_req->e_handle,
                 p_read_req->uuid.uu.uuid16);
 
         wiced_bt_gatt_server_send_error_rsp(conn_id, opcode, p_read_req->s_handle,
                 WICED_BT_GATT_INVALID_HANDLE);
-        wiced_bt_free_buffer(p_rsp);
+        app_free_buffer(p_rsp);
         return WICED_BT_GATT_INVALID_HANDLE;
     }
 
     /* Send the response */
     wiced_bt_gatt_server_send_read_by_type_rsp(conn_id, opcode, pair_len,
-            used, p_rsp, (wiced_bt_gatt_app_context_t)wiced_bt_free_buffer);
+            used, p_rsp, (wiced_bt_gatt_app_context_t)app_free_buffer);
 
     return WICED_BT_GATT_SUCCESS;
 }
@@ -198,18 +267,28 @@ wiced_bt_gatt_status_t beacon_req_read_multi_handler(uint16_t conn_id,
         wiced_bt_gatt_read_multiple_req_t *p_read_req,
         uint16_t len_requested)
 {
-    uint8_t     *p_rsp = wiced_bt_get_buffer(len_requested);
+    uint8_t     *p_rsp;
+    const uint8_t *p_static;
     int         used = 0;
     int         xx;
-    uint16_t    handle;
-    int         to_copy;
-    uint8_t     * copy_from;
+    uint16_t    handle, static_len;
+    gatt_db_lookup_table_t *p_attr;
+
+    /* Static attributes only, send the pre-serialised values, nothing to free */
+    static_len = beacon_gatt_rsp_read_multi(opcode, p_read_req, len_requested, &p_static);
+    if (static_len != 0)
+    {
+        wiced_bt_gatt_server_send_read_multiple_rsp(conn_id, opcode, static_len,
+                (uint8_t *)p_static, NULL);
+        return WICED_BT_GATT_SUCCESS;
+    }
 
     handle = wiced_bt_gatt_get_handle_from_stream(p_read_req->p_handle_stream, 0);
+    p_rsp = app_alloc_buffer(len_requested);
 
     if (p_rsp == NULL)
     {
-        printf ("[%s] no memory len_requested: %d!!\n", __FUNCTION__,
+        BEACON_LOG_ERROR("[%s] no memory len_requested: %d!!\n", __FUNCTION__,
                 len_requested);
 
         wiced_bt_gatt_server_send_error_rsp(conn_id, opcode, handle,
@@ -222,31 +301,21 @@ wiced_bt_gatt_status_t beacon_req_read_multi_handler(uint16_t conn_id,
     {
         handle = wiced_bt_gatt_get_handle_from_stream(p_read_req->p_handle_stream, xx);
 
-        switch(handle)
+        p_attr = beacon_gatt_attr_find(handle);
+        if (p_attr == NULL)
         {
-        case HDLC_GAP_DEVICE_NAME_VALUE:
-            to_copy = app_gap_device_name_len;
-            copy_from = (uint8_t *) app_gap_device_name;
-            break;
-
-        case HDLC_GAP_APPEARANCE_VALUE:
-            to_copy = 2;
-            copy_from = (uint8_t *) &app_cfg_settings.p_ble_cfg->appearance;
-            break;
-
-        default:
-            printf ("[%s] no handle 0x%04xn", __FUNCTION__, handle);
+            BEACON_LOG_WARN("[%s] no handle 0x%04xn", __FUNCTION__, handle);
             wiced_bt_gatt_server_send_error_rsp(conn_id, opcode,
                     *p_read_req->p_handle_stream, WICED_BT_GATT_ERR_UNLIKELY);
-            wiced_bt_free_buffer(p_rsp);
+            app_free_buffer(p_rsp);
             return WICED_BT_GATT_ERR_UNLIKELY;
         }
         int filled = wiced_bt_gatt_put_read_multi_rsp_in_stream(opcode,
                     p_rsp + used,
                     len_requested - used,
                     handle,
-                    to_copy,
-                    copy_from);
+                    p_attr->cur_len,
+                    p_attr->p_data);
 
         if (!filled) {
             break;
@@ -256,17 +325,17 @@ wiced_bt_gatt_status_t beacon_req_read_multi_handler(uint16_t conn_id,
 
     if (used == 0)
     {
-        printf ("[%s] no attr found\n", __FUNCTION__);
+        BEACON_LOG_WARN("[%s] no attr found\n", __FUNCTION__);
 
         wiced_bt_gatt_server_send_error_rsp(conn_id, opcode,
                 *p_read_req->p_handle_stream, WICED_BT_GATT_INVALID_HANDLE);
-        wiced_bt_free_buffer(p_rsp);
+        app_free_buffer(p_rsp);
         return WICED_BT_GATT_INVALID_HANDLE;
     }
 
     /* Send the response */
     wiced_bt_gatt_server_send_read_multiple_rsp(conn_id, opcode, used, p_rsp,
-            (wiced_bt_gatt_app_context_t)wiced_bt_free_buffer);
+            (wiced_bt_gatt_app_context_t)app_free_buffer);
 
     return WICED_BT_GATT_SUCCESS;
 }
@@ -278,9 +347,33 @@ wiced_bt_gatt_status_t beacon_write_handler(uint16_t conn_id,
         wiced_bt_gatt_opcode_t opcode,
         wiced_bt_gatt_write_req_t* p_data)
 {
-    printf("[%s] conn_id:%d handle:%04x\n", __FUNCTION__, conn_id,
+    gatt_db_lookup_table_t *p_attr = beacon_gatt_attr_find(p_data->handle);
+
+    (void)opcode;
+    BEACON_LOG_DEBUG("[%s] conn_id:%d handle:%04x\n", __FUNCTION__, conn_id,
             p_data->handle);
 
+    if (p_attr == NULL)
+    {
+        return WICED_BT_GATT_INVALID_HANDLE;
+    }
+    if (!(beacon_gatt_perm[p_data->handle] & LEGATTDB_PERM_WRITABLE))
+    {
+        return WICED_BT_GATT_WRITE_NOT_PERMIT;
+    }
+    if (p_data->offset > p_attr->cur_len)
+    {
+        return WICED_BT_GATT_INVALID_OFFSET;
+    }
+    if (p_data->offset + p_data->val_len > p_attr->max_len)
+    {
+        return WICED_BT_GATT_INVALID_ATTR_LEN;
+    }
+
+    // a write replaces the value from the offset on
+    memcpy(p_attr->p_data + p_data->offset, p_data->p_val, p_data->val_len);
+    p_attr->cur_len = p_data->offset + p_data->val_len;
+
     return WICED_BT_GATT_SUCCESS;
 }
 
@@ -289,7 +382,7 @@ wiced_bt_gatt_status_t beacon_write_handler(uint16_t conn_id,
  */
 wiced_bt_gatt_status_t beacon_req_mtu_handler( uint16_t conn_id, uint16_t mtu)
 {
-    printf("req_mtu: %d\n", mtu);
+    BEACON_LOG_INFO("req_mtu: %d\n", mtu);
     wiced_bt_gatt_server_send_mtu_rsp(conn_id, mtu,
             app_cfg_settings.p_ble_cfg->ble_max_rx_pdu_size);
     return WICED_BT_GATT_SUCCESS;
@@ -301,7 +394,7 @@ wiced_bt_gatt_status_t beacon_req_mtu_handler( uint16_t conn_id, uint16_t mtu)
 wiced_bt_gatt_status_t beacon_req_value_conf_handler(uint16_t conn_id,
         uint16_t handle)
 {
-    printf("[%s] conn_id:%d handle:%x\n", __FUNCTION__, conn_id, handle);
+    BEACON_LOG_DEBUG("[%s] conn_id:%d handle:%x\n", __FUNCTION__, conn_id, handle);
 
     return WICED_BT_GATT_SUCCESS;
 }
@@ -312,6 +405,8 @@ wiced_bt_gatt_status_t beacon_req_value_conf_handler(uint16_t conn_id,
 wiced_bt_gatt_status_t beacon_gatts_req_callback(wiced_bt_gatt_attribute_request_t *p_data)
 {
     wiced_bt_gatt_status_t result = WICED_BT_GATT_INVALID_PDU;
+    beacon_probe_t probe = BEACON_PROBE_GATT_OTHER;
+    uint32_t prof_start = BEACON_PROF_START();
 
     switch (p_data->opcode)
     {
@@ -321,6 +416,7 @@ wiced_bt_gatt_status_t beacon_gatts_req_callback(wiced_bt_gatt_attribute_request
                     p_data->opcode,
                     &p_data->data.read_req,
                     p_data->len_requested);
+            probe = BEACON_PROBE_GATT_READ;
             break;
 
         case GATT_REQ_READ_BY_TYPE:
@@ -328,6 +424,7 @@ wiced_bt_gatt_status_t beacon_gatts_req_callback(wiced_bt_gatt_attribute_request
                     p_data->opcode,
                     &p_data->data.read_by_type,
                     p_data->len_requested);
+            probe = BEACON_PROBE_GATT_READ_BY_TYPE;
             break;
 
         case GATT_REQ_READ_MULTI:
@@ -336,6 +433,7 @@ wiced_bt_gatt_status_t beacon_gatts_req_callback(wiced_bt_gatt_attribute_request
                     p_data->opcode,
                     &p_data->data.read_multiple_req,
                     p_data->len_requested);
+            probe = BEACON_PROBE_GATT_READ_MULTI;
             break;
 
         case GATT_REQ_WRITE:
@@ -359,6 +457,7 @@ wiced_bt_gatt_status_t beacon_gatts_req_callback(wiced_bt_gatt_attribute_request
                         p_data->data.write_req.handle,
                         result);
             }
+            probe = BEACON_PROBE_GATT_WRITE;
             break;
 
         case GATT_REQ_MTU:
@@ -372,11 +471,12 @@ wiced_bt_gatt_status_t beacon_gatts_req_callback(wiced_bt_gatt_attribute_request
             break;
 
        default:
-            printf("Invalid GATT request conn_id:%d opcode:%d\n",
+            BEACON_LOG_WARN("Invalid GATT request conn_id:%d opcode:%d\n",
                     p_data->conn_id, p_data->opcode);
             break;
     }
 
+    BEACON_PROF_STOP(probe, prof_start);
     return result;
 }
 
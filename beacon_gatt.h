@@ -12,6 +12,23 @@
 #include "cycfg_gap.h"
 #include "cycfg_gatt_db.h"
 
+/*
+ * Builds the lookup structures of the GATT request handlers over a database
+ * passed to wiced_bt_gatt_db_init() and its value lookup table
+ */
+wiced_bool_t beacon_gatt_db_init(const uint8_t *p_db, uint16_t db_len,
+        gatt_db_lookup_table_t *p_attr_tbl, uint16_t attr_tbl_size);
+
+/*
+ * Returns the value of an attribute, NULL if the handle has none
+ */
+gatt_db_lookup_table_t *beacon_gatt_attr_find(uint16_t handle);
+
+/*
+ * Returns the LEGATTDB_PERM_* permission of an attribute with a value,
+ * LEGATTDB_PERM_NONE if the handle has none
+ */
+uint8_t beacon_gatt_attr_perm(uint16_t handle);
 
 wiced_bt_gatt_status_t beacon_gatts_callback(wiced_bt_gatt_evt_t event, wiced_bt_gatt_event_data_t *p_data);
 void beacon_set_app_advertisement_data();
@@ -0,0 +1,218 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Attribute type index of the GATT database
+*
+* A database record is handle (LE16), permission, length of type + value,
+* one reserved byte when the attribute is writable, then the type UUID and
+* the value. The entries point at the type in the database, nothing is copied.
+*/
+#include "beacon_gatt_index.h"
+#include "wiced_bt_gatt.h"
+#include "beacon_mem.h"
+#include "beacon_log.h"
+#include "stdlib.h"
+#include "string.h"
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+/* Handle, permission and length */
+#define BEACON_GATT_RECORD_HDR_LEN      4
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    const uint8_t *p_type;      /* Type UUID in the database, little endian */
+    uint16_t       handle;
+    uint8_t        type_len;    /* LEN_UUID_16 or LEN_UUID_128 */
+    uint8_t        perm;
+} beacon_gatt_index_entry_t;
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+static beacon_gatt_index_entry_t *beacon_gatt_index;
+static uint16_t                   beacon_gatt_index_cnt;
+
+/******************************************************************************
+ *                          Private Function Definitions
+ ******************************************************************************/
+
+/*
+ * Walks the database records, fills p_entries if not NULL and returns the
+ * number of attributes. Stops at the first malformed record.
+ */
+static uint16_t beacon_gatt_index_walk(const uint8_t *p_db, uint16_t db_len, beacon_gatt_index_entry_t *p_entries)
+{
+    uint32_t off = 0;
+    uint16_t cnt = 0;
+
+    while (off + BEACON_GATT_RECORD_HDR_LEN <= db_len)
+    {
+        const uint8_t *p = &p_db[off];
+        uint8_t reserved = (p[2] & LEGATTDB_PERM_WRITABLE) ? 1 : 0;
+        uint8_t type_len = (p[2] & LEGATTDB_PERM_SERVICE_UUID_128) ? LEN_UUID_128 : LEN_UUID_16;
+
+        if (p[3] < type_len || off + BEACON_GATT_RECORD_HDR_LEN + reserved + p[3] > db_len)
+        {
+            BEACON_LOG_WARN("gatt index: bad record at offset %d\n", off);
+            break;
+        }
+        if (p_entries != NULL)
+        {
+            p_entries[cnt].p_type   = &p[BEACON_GATT_RECORD_HDR_LEN + reserved];
+            p_entries[cnt].handle   = p[0] | (p[1] << 8);
+            p_entries[cnt].type_len = type_len;
+            p_entries[cnt].perm     = p[2];
+        }
+        cnt++;
+        off += BEACON_GATT_RECORD_HDR_LEN + reserved + p[3];
+    }
+    return cnt;
+}
+
+/*
+ * Orders an entry against a type and handle: by type length, type bytes, then handle
+ */
+static int beacon_gatt_index_cmp(const beacon_gatt_index_entry_t *p_entry, const uint8_t *p_type,
+                                 uint8_t type_len, uint32_t handle)
+{
+    int diff;
+
+    if (p_entry->type_len != type_len)
+    {
+        return p_entry->type_len - type_len;
+    }
+    diff = memcmp(p_entry->p_type, p_type, type_len);
+    return diff ? diff : (int)p_entry->handle - (int)handle;
+}
+
+static int beacon_gatt_index_sort_cmp(const void *p_a, const void *p_b)
+{
+    const beacon_gatt_index_entry_t *p_entry = (const beacon_gatt_index_entry_t *)p_b;
+
+    return beacon_gatt_index_cmp((const beacon_gatt_index_entry_t *)p_a, p_entry->p_type, p_entry->type_len,
+                                 p_entry->handle);
+}
+
+/*
+ * Returns the position of the first entry not ordered before type and handle
+ */
+static uint16_t beacon_gatt_index_lower_bound(const uint8_t *p_type, uint8_t type_len, uint32_t handle)
+{
+    uint16_t lo = 0, hi = beacon_gatt_index_cnt, mid;
+
+    while (lo < hi)
+    {
+        mid = lo + (hi - lo) / 2;
+        if (beacon_gatt_index_cmp(&beacon_gatt_index[mid], p_type, type_len, handle) < 0)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/******************************************************************************
+ *     Public Function Definitions
+ ******************************************************************************/
+
+/*
+ * Builds the index over a database in the stack's record layout
+ */
+uint16_t beacon_gatt_index_init(const uint8_t *p_db, uint16_t db_len)
+{
+    uint16_t cnt = beacon_gatt_index_walk(p_db, db_len, NULL);
+
+    beacon_mem_free(BEACON_MEM_GATT_INDEX);
+    beacon_gatt_index     = NULL;
+    beacon_gatt_index_cnt = 0;
+    if (cnt == 0)
+    {
+        return 0;
+    }
+
+    beacon_gatt_index = (beacon_gatt_index_entry_t *)beacon_mem_alloc(BEACON_MEM_GATT_INDEX,
+                                                                    cnt * sizeof(beacon_gatt_index_entry_t));
+    if (beacon_gatt_index == NULL)
+    {
+        BEACON_LOG_ERROR("gatt index alloc failed\n");
+        return 0;
+    }
+    beacon_gatt_index_walk(p_db, db_len, beacon_gatt_index);
+    qsort(beacon_gatt_index, cnt, sizeof(beacon_gatt_index_entry_t), beacon_gatt_index_sort_cmp);
+    beacon_gatt_index_cnt = cnt;
+    return cnt;
+}
+
+/*
+ * Finds the attributes of a type within a handle range: two binary searches
+ * bound the run of matching entries
+ */
+uint16_t beacon_gatt_index_find(const wiced_bt_uuid_t *p_uuid, uint16_t s_handle, uint16_t e_handle,
+                                uint16_t *p_pos)
+{
+    uint8_t        uuid16[LEN_UUID_16];
+    const uint8_t *p_type;
+    uint16_t       first, last;
+
+    *p_pos = 0;
+    if (p_uuid->len == LEN_UUID_16)
+    {
+        uuid16[0] = (uint8_t)p_uuid->uu.uuid16;
+        uuid16[1] = (uint8_t)(p_uuid->uu.uuid16 >> 8);
+        p_type    = uuid16;
+    }
+    else if (p_uuid->len == LEN_UUID_128)
+    {
+        p_type = p_uuid->uu.uuid128;
+    }
+    else
+    {
+        // the database holds no 32-bit types
+        return 0;
+    }
+    if (s_handle > e_handle)
+    {
+        return 0;
+    }
+
+    first  = beacon_gatt_index_lower_bound(p_type, p_uuid->len, s_handle);
+    last   = beacon_gatt_index_lower_bound(p_type, p_uuid->len, (uint32_t)e_handle + 1);
+    *p_pos = first;
+    return last - first;
+}
+
+/*
+ * Returns the handle at an index position
+ */
+uint16_t beacon_gatt_index_handle(uint16_t pos)
+{
+    return (pos < beacon_gatt_index_cnt) ? beacon_gatt_index[pos].handle : 0;
+}
+
+/*
+ * Returns the permission of the attribute at an index position
+ */
+uint8_t beacon_gatt_index_perm(uint16_t pos)
+{
+    return (pos < beacon_gatt_index_cnt) ? beacon_gatt_index[pos].perm : LEGATTDB_PERM_NONE;
+}
+
+/*
+ * Returns the number of attributes indexed
+ */
+uint16_t beacon_gatt_index_count(void)
+{
+    return beacon_gatt_index_cnt;
+}
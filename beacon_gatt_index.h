@@ -0,0 +1,48 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Attribute type index of the GATT database
+*
+* The index lists every attribute of the database sorted by type UUID and
+* then by handle, so the attributes of one type within a handle range are
+* found with a binary search and sit next to each other. Read By Type walks
+* them directly instead of rescanning the database for every match.
+*/
+#ifndef _BEACON_GATT_INDEX_H_
+#define _BEACON_GATT_INDEX_H_
+
+#include "wiced_bt_types.h"
+
+/*
+ * Builds the index over a database in the stack's record layout, the
+ * database must stay in place. Returns the number of attributes indexed.
+ */
+uint16_t beacon_gatt_index_init(const uint8_t *p_db, uint16_t db_len);
+
+/*
+ * Finds the attributes of type p_uuid with handles in [s_handle, e_handle].
+ * Returns their count and sets *p_pos to the first one, for
+ * beacon_gatt_index_handle(). Handles come in ascending order.
+ */
+uint16_t beacon_gatt_index_find(const wiced_bt_uuid_t *p_uuid, uint16_t s_handle, uint16_t e_handle,
+                                uint16_t *p_pos);
+
+/*
+ * Returns the handle at an index position
+ */
+uint16_t beacon_gatt_index_handle(uint16_t pos);
+
+/*
+ * Returns the LEGATTDB_PERM_* permission of the attribute at an index position
+ */
+uint8_t beacon_gatt_index_perm(uint16_t pos);
+
+/*
+ * Returns the number of attributes indexed
+ */
+uint16_t beacon_gatt_index_count(void);
+
+#endif // _BEACON_GATT_INDEX_H_
@@ -0,0 +1,296 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Pre-serialised responses for static GATT attributes
+*
+* Three arenas hold the static attributes serialised the way each response
+* carries them:
+*  - pairs: handle + value, in type index order, so the matches of one Read
+*    By Type are adjacent
+*  - values: value only, in handle order, for Read Multiple
+*  - var: length + value, in handle order, for Read Multiple Variable Length
+* A request is served from the cache when the attributes it needs are
+* consecutive entries of an arena, which is always the case when they are
+* all static.
+*/
+#include "beacon_gatt_rsp.h"
+#include "beacon_gatt.h"
+#include "beacon_gatt_index.h"
+#include "beacon_mem.h"
+#include "beacon_log.h"
+#include "string.h"
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+/* Length field of a Read Multiple Variable Length element */
+#define BEACON_GATT_RSP_VAR_HDR_LEN     2
+
+/* Handle field of a Read By Type pair */
+#define BEACON_GATT_RSP_PAIR_HDR_LEN    2
+
+/* A Read By Type pair length is one byte */
+#define BEACON_GATT_RSP_VALUE_MAX       (255 - BEACON_GATT_RSP_PAIR_HDR_LEN)
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint16_t key;       /* Index position or handle */
+    uint16_t off;       /* In the pairs or the values arena */
+    uint16_t len;       /* Value length */
+} beacon_gatt_rsp_slot_t;
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+static void                   *beacon_gatt_rsp_buf;
+static beacon_gatt_rsp_slot_t *beacon_gatt_rsp_by_pos;      /* Static attributes by index position */
+static beacon_gatt_rsp_slot_t *beacon_gatt_rsp_by_handle;   /* Static attributes by handle */
+static uint8_t                *beacon_gatt_rsp_pairs;
+static uint8_t                *beacon_gatt_rsp_values;
+static uint8_t                *beacon_gatt_rsp_var;
+static uint16_t                beacon_gatt_rsp_cnt;
+static beacon_gatt_rsp_stats_t beacon_gatt_rsp_stats;
+
+/******************************************************************************
+ *                          Private Function Definitions
+ ******************************************************************************/
+
+/*
+ * Returns the value of the attribute at an index position if it is static
+ */
+static gatt_db_lookup_table_t *beacon_gatt_rsp_static_attr(uint16_t pos)
+{
+    gatt_db_lookup_table_t *p_attr;
+
+    if (beacon_gatt_index_perm(pos) & LEGATTDB_PERM_WRITABLE)
+    {
+        return NULL;
+    }
+    p_attr = beacon_gatt_attr_find(beacon_gatt_index_handle(pos));
+    return (p_attr != NULL && p_attr->cur_len <= BEACON_GATT_RSP_VALUE_MAX) ? p_attr : NULL;
+}
+
+/*
+ * Returns the slot whose key is key, NULL if there is none
+ */
+static const beacon_gatt_rsp_slot_t *beacon_gatt_rsp_find(const beacon_gatt_rsp_slot_t *p_slots, uint16_t key)
+{
+    uint16_t lo = 0, hi = beacon_gatt_rsp_cnt, mid;
+
+    while (lo < hi)
+    {
+        mid = lo + (hi - lo) / 2;
+        if (p_slots[mid].key == key)
+        {
+            return &p_slots[mid];
+        }
+        if (p_slots[mid].key < key)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return NULL;
+}
+
+/******************************************************************************
+ *     Public Function Definitions
+ ******************************************************************************/
+
+/*
+ * Serialises the static attributes of the type index
+ */
+uint16_t beacon_gatt_rsp_init(void)
+{
+    gatt_db_lookup_table_t *p_attr;
+    beacon_gatt_rsp_slot_t  slot;
+    uint16_t pos, cnt = 0, k, j, off;
+    uint32_t bytes = 0;
+    uint8_t *p;
+
+    beacon_mem_free(BEACON_MEM_GATT_RSP);
+    beacon_gatt_rsp_buf = NULL;
+    beacon_gatt_rsp_cnt = 0;
+
+    for (pos = 0; pos < beacon_gatt_index_count(); pos++)
+    {
+        if ((p_attr = beacon_gatt_rsp_static_attr(pos)) != NULL)
+        {
+            cnt++;
+            bytes += p_attr->cur_len;
+        }
+    }
+    if (cnt == 0)
+    {
+        return 0;
+    }
+
+    // slots, then pairs and var carry a 2-byte header per value, values none
+    beacon_gatt_rsp_buf = beacon_mem_alloc(BEACON_MEM_GATT_RSP,
+                                           2 * cnt * sizeof(beacon_gatt_rsp_slot_t) + 3 * bytes + 4 * cnt);
+    if (beacon_gatt_rsp_buf == NULL)
+    {
+        BEACON_LOG_ERROR("gatt rsp cache alloc failed\n");
+        return 0;
+    }
+    beacon_gatt_rsp_by_pos    = (beacon_gatt_rsp_slot_t *)beacon_gatt_rsp_buf;
+    beacon_gatt_rsp_by_handle = beacon_gatt_rsp_by_pos + cnt;
+    beacon_gatt_rsp_pairs     = (uint8_t *)(beacon_gatt_rsp_by_handle + cnt);
+    beacon_gatt_rsp_values    = beacon_gatt_rsp_pairs + bytes + BEACON_GATT_RSP_PAIR_HDR_LEN * cnt;
+    beacon_gatt_rsp_var       = beacon_gatt_rsp_values + bytes;
+
+    // pairs in index order
+    p = beacon_gatt_rsp_pairs;
+    for (pos = 0, k = 0; pos < beacon_gatt_index_count(); pos++)
+    {
+        if ((p_attr = beacon_gatt_rsp_static_attr(pos)) == NULL)
+        {
+            continue;
+        }
+        beacon_gatt_rsp_by_pos[k].key = pos;
+        beacon_gatt_rsp_by_pos[k].off = (uint16_t)(p - beacon_gatt_rsp_pairs);
+        beacon_gatt_rsp_by_pos[k].len = p_attr->cur_len;
+        UINT16_TO_STREAM(p, p_attr->handle);
+        memcpy(p, p_attr->p_data, p_attr->cur_len);
+        p += p_attr->cur_len;
+
+        // insertion sort by handle, there are few static attributes
+        slot.key = p_attr->handle;
+        slot.len = p_attr->cur_len;
+        for (j = k; j > 0 && beacon_gatt_rsp_by_handle[j - 1].key > slot.key; j--)
+        {
+            beacon_gatt_rsp_by_handle[j] = beacon_gatt_rsp_by_handle[j - 1];
+        }
+        beacon_gatt_rsp_by_handle[j] = slot;
+        k++;
+    }
+
+    // values and var in handle order
+    for (k = 0, off = 0; k < cnt; k++)
+    {
+        p_attr = beacon_gatt_attr_find(beacon_gatt_rsp_by_handle[k].key);
+        beacon_gatt_rsp_by_handle[k].off = off;
+        memcpy(&beacon_gatt_rsp_values[off], p_attr->p_data, p_attr->cur_len);
+
+        p = &beacon_gatt_rsp_var[off + BEACON_GATT_RSP_VAR_HDR_LEN * k];
+        UINT16_TO_STREAM(p, p_attr->cur_len);
+        memcpy(p, p_attr->p_data, p_attr->cur_len);
+        off += p_attr->cur_len;
+    }
+
+    beacon_gatt_rsp_cnt = cnt;
+    return cnt;
+}
+
+/*
+ * Read By Type: the pairs of consecutive index positions are adjacent in the
+ * pairs arena. Stops where the dynamic path stops, at a pair of another
+ * length or one that does not fit.
+ */
+uint16_t beacon_gatt_rsp_read_by_type(uint16_t pos, uint16_t cnt, uint16_t len_max,
+                                      const uint8_t **pp_rsp, uint8_t *p_pair_len)
+{
+    const beacon_gatt_rsp_slot_t *p_first = beacon_gatt_rsp_find(beacon_gatt_rsp_by_pos, pos);
+    const beacon_gatt_rsp_slot_t *p_end   = beacon_gatt_rsp_by_pos + beacon_gatt_rsp_cnt;
+    const beacon_gatt_rsp_slot_t *p_slot;
+    uint16_t used = 0, i;
+
+    if (p_first == NULL)
+    {
+        beacon_gatt_rsp_stats.misses++;
+        return 0;
+    }
+
+    for (i = 0, p_slot = p_first; i < cnt; i++, p_slot++)
+    {
+        if (p_slot == p_end || p_slot->key != pos + i)
+        {
+            // a non-static match is next and there may be room for it
+            beacon_gatt_rsp_stats.misses++;
+            return 0;
+        }
+        if (p_slot->len != p_first->len || used + BEACON_GATT_RSP_PAIR_HDR_LEN + p_slot->len > len_max)
+        {
+            break;
+        }
+        used += BEACON_GATT_RSP_PAIR_HDR_LEN + p_slot->len;
+    }
+    if (used == 0)
+    {
+        beacon_gatt_rsp_stats.misses++;
+        return 0;
+    }
+
+    *pp_rsp     = &beacon_gatt_rsp_pairs[p_first->off];
+    *p_pair_len = (uint8_t)(BEACON_GATT_RSP_PAIR_HDR_LEN + p_first->len);
+    beacon_gatt_rsp_stats.hits++;
+    return used;
+}
+
+/*
+ * Read Multiple: the requested handles must be consecutive static attributes,
+ * their values are then adjacent in the values or the var arena
+ */
+uint16_t beacon_gatt_rsp_read_multi(wiced_bt_gatt_opcode_t opcode, wiced_bt_gatt_read_multiple_req_t *p_req,
+                                    uint16_t len_max, const uint8_t **pp_rsp)
+{
+    uint16_t hdr = (opcode == GATT_REQ_READ_MULTI_VAR_LENGTH) ? BEACON_GATT_RSP_VAR_HDR_LEN : 0;
+    const beacon_gatt_rsp_slot_t *p_first, *p_slot;
+    uint16_t used = 0;
+    int      i;
+
+    if (p_req->num_handles <= 0)
+    {
+        beacon_gatt_rsp_stats.misses++;
+        return 0;
+    }
+    p_first = beacon_gatt_rsp_find(beacon_gatt_rsp_by_handle,
+                                   wiced_bt_gatt_get_handle_from_stream(p_req->p_handle_stream, 0));
+    if (p_first == NULL)
+    {
+        beacon_gatt_rsp_stats.misses++;
+        return 0;
+    }
+
+    for (i = 0, p_slot = p_first; i < p_req->num_handles; i++, p_slot++)
+    {
+        if (p_slot == beacon_gatt_rsp_by_handle + beacon_gatt_rsp_cnt ||
+            p_slot->key != wiced_bt_gatt_get_handle_from_stream(p_req->p_handle_stream, i))
+        {
+            beacon_gatt_rsp_stats.misses++;
+            return 0;
+        }
+        if (used + hdr + p_slot->len > len_max)
+        {
+            break;
+        }
+        used += hdr + p_slot->len;
+    }
+    if (used == 0)
+    {
+        beacon_gatt_rsp_stats.misses++;
+        return 0;
+    }
+
+    *pp_rsp = hdr ? &beacon_gatt_rsp_var[p_first->off + hdr * (p_first - beacon_gatt_rsp_by_handle)] :
+                    &beacon_gatt_rsp_values[p_first->off];
+    beacon_gatt_rsp_stats.hits++;
+    return used;
+}
+
+/*
+ * Returns the hit and miss counters
+ */
+void beacon_gatt_rsp_get_stats(beacon_gatt_rsp_stats_t *p_stats)
+{
+    *p_stats = beacon_gatt_rsp_stats;
+}
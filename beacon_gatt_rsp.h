@@ -0,0 +1,62 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Pre-serialised responses for static GATT attributes
+*
+* A static attribute is one the database does not declare writable and whose
+* value sits in the lookup table, like the device name and the appearance.
+* Its Read By Type pair and its Read Multiple elements are serialised once
+* at init, so a request that only touches static attributes is answered
+* with a slice of the cache, without allocating or copying.
+*
+* The value of a static attribute must not change after beacon_gatt_rsp_init().
+*/
+#ifndef _BEACON_GATT_RSP_H_
+#define _BEACON_GATT_RSP_H_
+
+#include "wiced_bt_gatt.h"
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint32_t hits;      /* Requests answered from the cache */
+    uint32_t misses;    /* Requests that touched a non-static attribute */
+} beacon_gatt_rsp_stats_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+
+/*
+ * Serialises the static attributes of the type index, call after the index
+ * and the handle table are built. Returns the number of static attributes.
+ */
+uint16_t beacon_gatt_rsp_init(void);
+
+/*
+ * Read By Type over index positions [pos, pos + cnt). Returns the response
+ * length and sets *pp_rsp and *p_pair_len, or returns 0 if an attribute the
+ * response needs is not static.
+ */
+uint16_t beacon_gatt_rsp_read_by_type(uint16_t pos, uint16_t cnt, uint16_t len_max,
+                                      const uint8_t **pp_rsp, uint8_t *p_pair_len);
+
+/*
+ * Read Multiple and Read Multiple Variable Length. Returns the response
+ * length and sets *pp_rsp, or returns 0 if an attribute the response needs
+ * is not static or the handles are not in ascending order.
+ */
+uint16_t beacon_gatt_rsp_read_multi(wiced_bt_gatt_opcode_t opcode, wiced_bt_gatt_read_multiple_req_t *p_req,
+                                    uint16_t len_max, const uint8_t **pp_rsp);
+
+/*
+ * Returns the hit and miss counters
+ */
+void beacon_gatt_rsp_get_stats(beacon_gatt_rsp_stats_t *p_stats);
+
+#endif // _BEACON_GATT_RSP_H_
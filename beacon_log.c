@@ -0,0 +1,284 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Deferred binary logging
+*
+* Writers claim a slot by advancing the head with a compare-and-swap, fill
+* it and then publish it by storing its sequence number. The drain reads
+* slots in order and stops at the first one not yet published, so a writer
+* preempted between claim and publish only delays the records behind it.
+* A full ring drops the new record instead of overwriting one that may be
+* formatted at that moment.
+*
+* A pending flag, set by the first wake after a drain and cleared when the
+* next drain starts, keeps the writers from waking the drain thread for
+* every record. A record published after the flag is cleared sets it again.
+*/
+#include "beacon_log.h"
+#include "stdio.h"
+#include "string.h"
+#include <stdatomic.h>
+#include <stddef.h>
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+/* Longest conversion specification, flags, width, precision and length included */
+#define BEACON_LOG_SPEC_MAX         16
+
+/* Argument widths a length modifier selects */
+#define BEACON_LOG_LEN_INT          0   /* none, h, hh */
+#define BEACON_LOG_LEN_LONG         1   /* l */
+#define BEACON_LOG_LEN_LLONG        2   /* ll, j */
+#define BEACON_LOG_LEN_SIZE         3   /* z, t */
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    _Atomic uint32_t seq;                       /* Claim index + 1 once published */
+    const char *fmt;
+    uintptr_t   arg[BEACON_LOG_MAX_ARGS];
+} beacon_log_record_t;
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+static beacon_log_record_t beacon_log_ring[BEACON_LOG_RING_SIZE];
+static _Atomic uint32_t    beacon_log_head;     /* Next slot to claim */
+static _Atomic uint32_t    beacon_log_tail;     /* Next slot to drain */
+static _Atomic uint32_t    beacon_log_drops;
+static _Atomic uint32_t    beacon_log_pending;  /* Woken and not drained since */
+static beacon_log_wake_t   beacon_log_waker;
+
+/******************************************************************************
+ *     Private Function Definitions
+ ******************************************************************************/
+
+/*
+ * Prints one argument with its conversion specification, converted back from
+ * uintptr_t to the type printf reads for that conversion and length
+ */
+static void beacon_log_print_arg(const char *p_spec, char conv, uint8_t len_mod, uintptr_t arg)
+{
+    if (conv == 's')
+    {
+        printf(p_spec, (const char *)arg);
+    }
+    else if (conv == 'p')
+    {
+        printf(p_spec, (void *)arg);
+    }
+    else if (conv == 'd' || conv == 'i')
+    {
+        if (len_mod == BEACON_LOG_LEN_LONG)
+        {
+            printf(p_spec, (long)(intptr_t)arg);
+        }
+        else if (len_mod == BEACON_LOG_LEN_LLONG)
+        {
+            printf(p_spec, (long long)(intptr_t)arg);
+        }
+        else if (len_mod == BEACON_LOG_LEN_SIZE)
+        {
+            printf(p_spec, (ptrdiff_t)(intptr_t)arg);
+        }
+        else
+        {
+            printf(p_spec, (int)(intptr_t)arg);
+        }
+    }
+    else if (len_mod == BEACON_LOG_LEN_LONG)
+    {
+        printf(p_spec, (unsigned long)arg);
+    }
+    else if (len_mod == BEACON_LOG_LEN_LLONG)
+    {
+        printf(p_spec, (unsigned long long)arg);
+    }
+    else if (len_mod == BEACON_LOG_LEN_SIZE)
+    {
+        printf(p_spec, (size_t)arg);
+    }
+    else
+    {
+        // u, o, x, X, and c, which takes an int that has the same width
+        printf(p_spec, (unsigned int)arg);
+    }
+}
+
+/*
+ * Prints a record: the literal text as it is, every conversion with printf
+ * and its own argument. Conversions past the stored arguments or not for an
+ * integer, string or pointer are printed as they are written.
+ */
+static void beacon_log_format(const char *fmt, const uintptr_t *p_arg)
+{
+    char        spec[BEACON_LOG_SPEC_MAX];
+    const char *p = fmt, *p_start;
+    uint32_t    n = 0;
+    uint8_t     len_mod;
+
+    while (*p != '\0')
+    {
+        p_start = p;
+        while (*p != '\0' && *p != '%')
+        {
+            p++;
+        }
+        if (p != p_start)
+        {
+            printf("%.*s", (int)(p - p_start), p_start);
+        }
+        if (*p == '\0')
+        {
+            break;
+        }
+
+        p_start = p++;
+        if (*p == '%')
+        {
+            putchar('%');
+            p++;
+            continue;
+        }
+        p += strspn(p, "-+ #0123456789.");
+        len_mod = BEACON_LOG_LEN_INT;
+        if (*p == 'h')
+        {
+            p += (p[1] == 'h') ? 2 : 1;
+        }
+        else if (*p == 'l')
+        {
+            len_mod = (p[1] == 'l') ? BEACON_LOG_LEN_LLONG : BEACON_LOG_LEN_LONG;
+            p += (p[1] == 'l') ? 2 : 1;
+        }
+        else if (*p == 'j')
+        {
+            len_mod = BEACON_LOG_LEN_LLONG;
+            p++;
+        }
+        else if (*p == 'z' || *p == 't')
+        {
+            len_mod = BEACON_LOG_LEN_SIZE;
+            p++;
+        }
+
+        if (*p == '\0' || strchr("diuoxXcsp", *p) == NULL || n == BEACON_LOG_MAX_ARGS ||
+            p + 1 - p_start >= BEACON_LOG_SPEC_MAX)
+        {
+            p += (*p != '\0');
+            printf("%.*s", (int)(p - p_start), p_start);
+            continue;
+        }
+        memcpy(spec, p_start, (size_t)(p + 1 - p_start));
+        spec[p + 1 - p_start] = '\0';
+        beacon_log_print_arg(spec, *p, len_mod, p_arg[n++]);
+        p++;
+    }
+}
+
+/******************************************************************************
+ *     Public Function Definitions
+ ******************************************************************************/
+
+/*
+ * Stores one record, drops it if the ring is full
+ */
+void beacon_log_write(const char *fmt, uintptr_t a0, uintptr_t a1, uintptr_t a2,
+                      uintptr_t a3, uintptr_t a4, uintptr_t a5)
+{
+    beacon_log_record_t *p_rec;
+    uint32_t head = atomic_load_explicit(&beacon_log_head, memory_order_relaxed);
+
+    do
+    {
+        if (head - atomic_load_explicit(&beacon_log_tail, memory_order_acquire) >= BEACON_LOG_RING_SIZE)
+        {
+            atomic_fetch_add_explicit(&beacon_log_drops, 1, memory_order_relaxed);
+            return;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&beacon_log_head, &head, head + 1,
+                                                    memory_order_relaxed, memory_order_relaxed));
+
+    p_rec = &beacon_log_ring[head & (BEACON_LOG_RING_SIZE - 1)];
+    p_rec->fmt    = fmt;
+    p_rec->arg[0] = a0;
+    p_rec->arg[1] = a1;
+    p_rec->arg[2] = a2;
+    p_rec->arg[3] = a3;
+    p_rec->arg[4] = a4;
+    p_rec->arg[5] = a5;
+    atomic_store_explicit(&p_rec->seq, head + 1, memory_order_release);
+    beacon_log_wake();
+}
+
+/*
+ * Formats published records with printf, oldest first
+ */
+uint32_t beacon_log_drain(uint32_t max)
+{
+    beacon_log_record_t *p_rec;
+    uint32_t tail = atomic_load_explicit(&beacon_log_tail, memory_order_relaxed);
+    uint32_t cnt = 0;
+
+    // a record published from here on wakes the thread again
+    atomic_exchange_explicit(&beacon_log_pending, 0, memory_order_acq_rel);
+
+    while (max == 0 || cnt < max)
+    {
+        p_rec = &beacon_log_ring[tail & (BEACON_LOG_RING_SIZE - 1)];
+        if (atomic_load_explicit(&p_rec->seq, memory_order_acquire) != tail + 1)
+        {
+            break;
+        }
+        beacon_log_format(p_rec->fmt, p_rec->arg);
+
+        // hand the slot back to the writers only after it has been formatted
+        atomic_store_explicit(&beacon_log_tail, ++tail, memory_order_release);
+        cnt++;
+    }
+
+    // stopped at max, come back for the rest
+    if (max != 0 && cnt == max)
+    {
+        beacon_log_wake();
+    }
+    return cnt;
+}
+
+/*
+ * Registers the drain thread wake, records written before set the pending
+ * flag without waking anything
+ */
+void beacon_log_set_wake(beacon_log_wake_t p_wake)
+{
+    beacon_log_waker = p_wake;
+    atomic_store_explicit(&beacon_log_pending, 1, memory_order_release);
+    p_wake();
+}
+
+/*
+ * Wakes the drain thread on the first request after a drain
+ */
+void beacon_log_wake(void)
+{
+    if (!atomic_exchange_explicit(&beacon_log_pending, 1, memory_order_acq_rel) && beacon_log_waker != NULL)
+    {
+        beacon_log_waker();
+    }
+}
+
+/*
+ * Returns the drop and write counters
+ */
+void beacon_log_get_stats(beacon_log_stats_t *p_stats)
+{
+    // every claimed slot is written
+    p_stats->drops   = atomic_load_explicit(&beacon_log_drops, memory_order_relaxed);
+    p_stats->written = atomic_load_explicit(&beacon_log_head, memory_order_relaxed);
+}
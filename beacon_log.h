@@ -0,0 +1,142 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Deferred binary logging
+*
+* A log call stores its format string pointer and raw arguments in a ring
+* buffer and returns, it does not format or touch the UART. A low priority
+* thread drains the ring later with beacon_log_drain(), which is where the
+* formatting happens. Any thread may log; the ring is lock-free.
+*
+* The drain thread blocks until the function registered with
+* beacon_log_set_wake() wakes it. The first record after a drain calls it,
+* the records behind it do not.
+*
+* Arguments are stored as uintptr_t, so they must be integers, pointers or
+* strings that outlive the record (literals, __FUNCTION__). Up to
+* BEACON_LOG_MAX_ARGS arguments per call. The drain hands each argument to
+* printf as the type its conversion specification expects (%d int, %lx
+* unsigned long, PRIu32, %s, %p), integers no wider than a pointer.
+*
+* Calls more verbose than BEACON_LOG_LEVEL are compiled out, their arguments are not
+* evaluated.
+*/
+#ifndef _BEACON_LOG_H_
+#define _BEACON_LOG_H_
+
+#include "wiced_bt_types.h"
+#include <stdint.h>
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+#define BEACON_LOG_LEVEL_NONE       0
+#define BEACON_LOG_LEVEL_ERROR      1
+#define BEACON_LOG_LEVEL_WARN       2
+#define BEACON_LOG_LEVEL_INFO       3
+#define BEACON_LOG_LEVEL_DEBUG      4
+
+/* Calls above this level are compiled out */
+#ifndef BEACON_LOG_LEVEL
+#define BEACON_LOG_LEVEL            BEACON_LOG_LEVEL_DEBUG
+#endif
+
+/* Records in the ring, a power of 2 */
+#ifndef BEACON_LOG_RING_SIZE
+#define BEACON_LOG_RING_SIZE        64
+#endif
+
+#if (BEACON_LOG_RING_SIZE & (BEACON_LOG_RING_SIZE - 1)) != 0
+#error "BEACON_LOG_RING_SIZE must be a power of 2"
+#endif
+
+/* Max arguments of one log call */
+#define BEACON_LOG_MAX_ARGS         6
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+/* Wakes the drain thread, called from the thread that logs */
+typedef void (*beacon_log_wake_t)(void);
+
+typedef struct
+{
+    uint32_t drops;     /* Records lost because the ring was full */
+    uint32_t written;   /* Records stored */
+} beacon_log_stats_t;
+
+/******************************************************************************
+ *                                Macros
+ ******************************************************************************/
+/* Pads the arguments to BEACON_LOG_MAX_ARGS, the format string comes first */
+#define BEACON_LOG_ARGS_(fmt, a0, a1, a2, a3, a4, a5, ...)  \
+    (fmt), (uintptr_t)(a0), (uintptr_t)(a1), (uintptr_t)(a2), (uintptr_t)(a3), (uintptr_t)(a4), (uintptr_t)(a5)
+#define BEACON_LOG_ARGS(...)        BEACON_LOG_ARGS_(__VA_ARGS__, 0, 0, 0, 0, 0, 0, 0)
+
+#define BEACON_LOG_ON(...)          beacon_log_write(BEACON_LOG_ARGS(__VA_ARGS__))
+
+/* Keeps the arguments referenced so nothing is reported unused, the call is removed */
+#define BEACON_LOG_OFF(...)         do { if (0) beacon_log_write(BEACON_LOG_ARGS(__VA_ARGS__)); } while (0)
+
+#if BEACON_LOG_LEVEL >= BEACON_LOG_LEVEL_ERROR
+#define BEACON_LOG_ERROR(...)       BEACON_LOG_ON(__VA_ARGS__)
+#else
+#define BEACON_LOG_ERROR(...)       BEACON_LOG_OFF(__VA_ARGS__)
+#endif
+
+#if BEACON_LOG_LEVEL >= BEACON_LOG_LEVEL_WARN
+#define BEACON_LOG_WARN(...)        BEACON_LOG_ON(__VA_ARGS__)
+#else
+#define BEACON_LOG_WARN(...)        BEACON_LOG_OFF(__VA_ARGS__)
+#endif
+
+#if BEACON_LOG_LEVEL >= BEACON_LOG_LEVEL_INFO
+#define BEACON_LOG_INFO(...)        BEACON_LOG_ON(__VA_ARGS__)
+#else
+#define BEACON_LOG_INFO(...)        BEACON_LOG_OFF(__VA_ARGS__)
+#endif
+
+#if BEACON_LOG_LEVEL >= BEACON_LOG_LEVEL_DEBUG
+#define BEACON_LOG_DEBUG(...)       BEACON_LOG_ON(__VA_ARGS__)
+#else
+#define BEACON_LOG_DEBUG(...)       BEACON_LOG_OFF(__VA_ARGS__)
+#endif
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+
+/*
+ * Stores one record, use the BEACON_LOG_* macros. Drops the record and counts
+ * it if the ring is full.
+ */
+void beacon_log_write(const char *fmt, uintptr_t a0, uintptr_t a1, uintptr_t a2,
+                      uintptr_t a3, uintptr_t a4, uintptr_t a5);
+
+/*
+ * Formats up to max records (0 for all) with printf, oldest first, and
+ * returns the number formatted. Only one thread may drain.
+ */
+uint32_t beacon_log_drain(uint32_t max);
+
+/*
+ * Registers the function that wakes the drain thread and wakes it once for
+ * the records written before
+ */
+void beacon_log_set_wake(beacon_log_wake_t p_wake);
+
+/*
+ * Wakes the drain thread unless a wake is already pending since its last
+ * drain, also for the other work it does
+ */
+void beacon_log_wake(void);
+
+/*
+ * Returns the drop and write counters
+ */
+void beacon_log_get_stats(beacon_log_stats_t *p_stats);
+
+#endif // _BEACON_LOG_H_
@@ -0,0 +1,103 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Application heap accounting
+*
+* One slot per module holds its buffer and size. Taking a new buffer frees
+* the old one first, so a module sized again for a new configuration does
+* not hold both.
+*/
+#include "beacon_mem.h"
+#include "beacon_log.h"
+#include "wiced_memory.h"
+#include <inttypes.h>
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+static void              *beacon_mem_bufs[BEACON_MEM_MODULES];
+static beacon_mem_stats_t beacon_mem_stats;
+
+static const char * const beacon_mem_names[BEACON_MEM_MODULES] =
+{
+    [BEACON_MEM_TABLE]      = "beacon table",
+    [BEACON_MEM_CTRL]       = "adv set shadows",
+    [BEACON_MEM_CACHE]      = "payload arena",
+    [BEACON_MEM_GATT]       = "gatt attributes",
+    [BEACON_MEM_GATT_INDEX] = "gatt type index",
+    [BEACON_MEM_GATT_RSP]   = "gatt responses",
+};
+
+/******************************************************************************
+ *     Public Function Definitions
+ ******************************************************************************/
+
+/*
+ * Frees the buffer the module holds and takes one of size bytes in its place
+ */
+void *beacon_mem_alloc(uint8_t module, uint32_t size)
+{
+    if (module >= BEACON_MEM_MODULES)
+    {
+        return NULL;
+    }
+    beacon_mem_free(module);
+
+    beacon_mem_bufs[module] = wiced_bt_get_buffer(size);
+    if (beacon_mem_bufs[module] != NULL)
+    {
+        beacon_mem_stats.bytes[module] = size;
+        beacon_mem_stats.total += size + BEACON_MEM_BUF_OVERHEAD;
+        if (beacon_mem_stats.total > beacon_mem_stats.high_water)
+        {
+            beacon_mem_stats.high_water = beacon_mem_stats.total;
+        }
+    }
+    return beacon_mem_bufs[module];
+}
+
+/*
+ * Frees the buffer the module holds
+ */
+void beacon_mem_free(uint8_t module)
+{
+    if (module < BEACON_MEM_MODULES && beacon_mem_bufs[module] != NULL)
+    {
+        wiced_bt_free_buffer(beacon_mem_bufs[module]);
+        beacon_mem_bufs[module] = NULL;
+        beacon_mem_stats.total -= beacon_mem_stats.bytes[module] + BEACON_MEM_BUF_OVERHEAD;
+        beacon_mem_stats.bytes[module] = 0;
+    }
+}
+
+/*
+ * Returns the bytes held per module
+ */
+void beacon_mem_get_stats(beacon_mem_stats_t *p_stats)
+{
+    *p_stats = beacon_mem_stats;
+}
+
+/*
+ * Logs the bytes held per module and the total against the heap size
+ */
+void beacon_mem_report(void)
+{
+    uint8_t module;
+
+    for (module = 0; module < BEACON_MEM_MODULES; module++)
+    {
+        BEACON_LOG_INFO("heap %s: %"PRIu32" bytes\n", beacon_mem_names[module], beacon_mem_stats.bytes[module]);
+    }
+    if (beacon_mem_stats.total > BEACON_MEM_HEAP_SIZE)
+    {
+        BEACON_LOG_WARN("heap %"PRIu32" of %d bytes, over budget\n", beacon_mem_stats.total, BEACON_MEM_HEAP_SIZE);
+    }
+    else
+    {
+        BEACON_LOG_INFO("heap %"PRIu32" of %d bytes\n", beacon_mem_stats.total, BEACON_MEM_HEAP_SIZE);
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Application heap accounting
+*
+* Each module that takes memory from the application heap holds one buffer,
+* sized at init for the configuration in use. It takes it through
+* beacon_mem_alloc(), which frees the module's previous buffer and keeps
+* the bytes each module holds, so the heap in use can be reported per
+* module against APP_HEAP_SIZE.
+*/
+#ifndef _BEACON_MEM_H_
+#define _BEACON_MEM_H_
+
+#include "wiced_bt_types.h"
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+/* Application heap the module buffers come from */
+#define BEACON_MEM_HEAP_SIZE        (1024 * 8)
+
+/* Heap overhead of one buffer, header and alignment */
+#define BEACON_MEM_BUF_OVERHEAD     8
+
+/* Modules holding a heap buffer */
+enum
+{
+    BEACON_MEM_TABLE,               /* Logical beacon table, beacon.c */
+    BEACON_MEM_CTRL,                /* Adv set shadows, beacon_ctrl.c */
+    BEACON_MEM_CACHE,               /* Payload arena, beacon_cache.c */
+    BEACON_MEM_GATT,                /* Attribute table by handle, beacon_gatt.c */
+    BEACON_MEM_GATT_INDEX,          /* Attribute index by type, beacon_gatt_index.c */
+    BEACON_MEM_GATT_RSP,            /* Pre-serialised responses, beacon_gatt_rsp.c */
+    BEACON_MEM_MODULES
+};
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint32_t bytes[BEACON_MEM_MODULES];     /* Bytes each module holds */
+    uint32_t total;                         /* Sum, with BEACON_MEM_BUF_OVERHEAD per buffer */
+    uint32_t high_water;                    /* Largest total so far */
+} beacon_mem_stats_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+
+/*
+ * Frees the buffer the module holds and takes one of size bytes in its place,
+ * returns NULL if the heap has no room
+ */
+void *beacon_mem_alloc(uint8_t module, uint32_t size);
+
+/*
+ * Frees the buffer the module holds
+ */
+void beacon_mem_free(uint8_t module);
+
+/*
+ * Returns the bytes held per module
+ */
+void beacon_mem_get_stats(beacon_mem_stats_t *p_stats);
+
+/*
+ * Logs the bytes held per module and the total against the heap size
+ */
+void beacon_mem_report(void);
+
+#endif // _BEACON_MEM_H_
@@ -0,0 +1,186 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Fixed-size block pool for GATT response buffers
+*
+* The blocks of a class sit next to each other in the arena, so free finds the
+* class of a block from its address. Free blocks are linked through their
+* first word.
+*/
+#include "beacon_pool.h"
+#include "beacon_log.h"
+#include "stdio.h"
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+/* Blocks are rounded up to keep every block aligned for the link word */
+#define BEACON_POOL_ALIGN           sizeof(uintptr_t)
+#define BEACON_POOL_BLOCK(size)     (((size) + BEACON_POOL_ALIGN - 1) & ~(BEACON_POOL_ALIGN - 1))
+
+#define BEACON_POOL_ARENA_SIZE      (BEACON_POOL_BLOCK(BEACON_POOL_SMALL_SIZE) * BEACON_POOL_SMALL_CNT + \
+                                     BEACON_POOL_BLOCK(BEACON_POOL_MEDIUM_SIZE) * BEACON_POOL_MEDIUM_CNT + \
+                                     BEACON_POOL_BLOCK(BEACON_POOL_LARGE_SIZE) * BEACON_POOL_LARGE_CNT)
+
+#if BEACON_POOL_SMALL_SIZE > BEACON_POOL_MEDIUM_SIZE || BEACON_POOL_MEDIUM_SIZE > BEACON_POOL_LARGE_SIZE
+#error "BEACON_POOL size classes must be in ascending order"
+#endif
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct beacon_pool_block
+{
+    struct beacon_pool_block *p_next;
+} beacon_pool_block_t;
+
+typedef struct
+{
+    uint8_t             *p_start;
+    uint8_t             *p_end;
+    beacon_pool_block_t *p_free;
+    beacon_pool_stats_t  stats;
+} beacon_pool_class_t;
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+static uintptr_t beacon_pool_arena[BEACON_POOL_ARENA_SIZE / BEACON_POOL_ALIGN];
+
+static const uint16_t beacon_pool_sizes[BEACON_POOL_CLASS_CNT][2] =
+{
+    { BEACON_POOL_SMALL_SIZE,  BEACON_POOL_SMALL_CNT },
+    { BEACON_POOL_MEDIUM_SIZE, BEACON_POOL_MEDIUM_CNT },
+    { BEACON_POOL_LARGE_SIZE,  BEACON_POOL_LARGE_CNT },
+};
+
+static beacon_pool_class_t beacon_pool_classes[BEACON_POOL_CLASS_CNT];
+
+/******************************************************************************
+ *     Public Function Definitions
+ ******************************************************************************/
+
+/*
+ * Cuts the arena into blocks
+ */
+void beacon_pool_init(void)
+{
+    uint8_t *p = (uint8_t *)beacon_pool_arena;
+    uint16_t block, i;
+    uint8_t  c;
+
+    for (c = 0; c < BEACON_POOL_CLASS_CNT; c++)
+    {
+        beacon_pool_class_t *p_class = &beacon_pool_classes[c];
+
+        block                   = BEACON_POOL_BLOCK(beacon_pool_sizes[c][0]);
+        p_class->p_start        = p;
+        p_class->p_free         = NULL;
+        p_class->stats          = (beacon_pool_stats_t){ 0 };
+        p_class->stats.size     = beacon_pool_sizes[c][0];
+        p_class->stats.blocks   = beacon_pool_sizes[c][1];
+
+        // link in reverse so the lowest block goes out first
+        for (i = beacon_pool_sizes[c][1]; i > 0; i--)
+        {
+            beacon_pool_block_t *p_block = (beacon_pool_block_t *)(p + (i - 1) * block);
+
+            p_block->p_next = p_class->p_free;
+            p_class->p_free = p_block;
+        }
+        p += block * beacon_pool_sizes[c][1];
+        p_class->p_end = p;
+    }
+}
+
+/*
+ * Takes a block of the smallest class that fits, a larger one if it is empty
+ */
+void *beacon_pool_alloc(uint16_t len)
+{
+    beacon_pool_class_t *p_class;
+    beacon_pool_block_t *p_block;
+    uint8_t c, first;
+
+    for (first = 0; first < BEACON_POOL_CLASS_CNT && beacon_pool_classes[first].stats.size < len; first++)
+        ;
+    if (first == BEACON_POOL_CLASS_CNT)
+    {
+        BEACON_LOG_WARN("pool: no class for %d bytes\n", len);
+        return NULL;
+    }
+
+    for (c = first; c < BEACON_POOL_CLASS_CNT; c++)
+    {
+        p_class = &beacon_pool_classes[c];
+        p_block = p_class->p_free;
+        if (p_block != NULL)
+        {
+            p_class->p_free = p_block->p_next;
+            p_class->stats.allocs++;
+            if (++p_class->stats.in_use > p_class->stats.high_water)
+            {
+                p_class->stats.high_water = p_class->stats.in_use;
+            }
+            return p_block;
+        }
+    }
+
+    beacon_pool_classes[first].stats.fails++;
+    BEACON_LOG_WARN("pool: out of blocks for %d bytes\n", len);
+    return NULL;
+}
+
+/*
+ * Returns a block to the class whose range holds it
+ */
+void beacon_pool_free(void *p_block)
+{
+    beacon_pool_class_t *p_class;
+    uint8_t c;
+
+    if (p_block == NULL)
+    {
+        return;
+    }
+    for (c = 0; c < BEACON_POOL_CLASS_CNT; c++)
+    {
+        p_class = &beacon_pool_classes[c];
+        if ((uint8_t *)p_block >= p_class->p_start && (uint8_t *)p_block < p_class->p_end)
+        {
+            ((beacon_pool_block_t *)p_block)->p_next = p_class->p_free;
+            p_class->p_free = (beacon_pool_block_t *)p_block;
+            p_class->stats.in_use--;
+            return;
+        }
+    }
+    BEACON_LOG_ERROR("pool: free of %p outside the arena\n", p_block);
+}
+
+/*
+ * Copies the stats of a size class
+ */
+void beacon_pool_get_stats(uint8_t class_idx, beacon_pool_stats_t *p_stats)
+{
+    *p_stats = beacon_pool_classes[class_idx].stats;
+}
+
+/*
+ * Prints the stats of every class
+ */
+void beacon_pool_dump(void)
+{
+    beacon_pool_stats_t stats;
+    uint8_t c;
+
+    printf("pool class: blocks in_use high_water allocs fails\n");
+    for (c = 0; c < BEACON_POOL_CLASS_CNT; c++)
+    {
+        beacon_pool_get_stats(c, &stats);
+        printf("%u B: %u %u %u %lu %lu\n", stats.size, stats.blocks, stats.in_use, stats.high_water,
+               (unsigned long)stats.allocs, (unsigned long)stats.fails);
+    }
+}
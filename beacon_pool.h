@@ -0,0 +1,95 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Fixed-size block pool for GATT response buffers
+*
+* A statically reserved arena is cut into blocks of a few size classes, matched
+* to the ATT MTUs a response can be sized for: the default MTU before an MTU
+* exchange, the MTU common phones negotiate, and the largest MTU this device
+* accepts (ble_max_rx_pdu_size in design.cybt). A request takes a block of the
+* smallest class that fits and spills to a larger class when that one is
+* empty. Alloc and free are constant time and never touch the heap.
+*
+* Not thread safe: all GATT buffers are allocated and freed on the stack thread.
+*/
+#ifndef _BEACON_POOL_H_
+#define _BEACON_POOL_H_
+
+#include "wiced_bt_types.h"
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+/* Default ATT MTU, responses before an MTU exchange */
+#ifndef BEACON_POOL_SMALL_SIZE
+#define BEACON_POOL_SMALL_SIZE      23
+#endif
+#ifndef BEACON_POOL_SMALL_CNT
+#define BEACON_POOL_SMALL_CNT       8
+#endif
+
+/* MTU commonly negotiated by phones */
+#ifndef BEACON_POOL_MEDIUM_SIZE
+#define BEACON_POOL_MEDIUM_SIZE     185
+#endif
+#ifndef BEACON_POOL_MEDIUM_CNT
+#define BEACON_POOL_MEDIUM_CNT      4
+#endif
+
+/* Largest MTU accepted, keep in line with ble_max_rx_pdu_size */
+#ifndef BEACON_POOL_LARGE_SIZE
+#define BEACON_POOL_LARGE_SIZE      512
+#endif
+#ifndef BEACON_POOL_LARGE_CNT
+#define BEACON_POOL_LARGE_CNT       2
+#endif
+
+#define BEACON_POOL_CLASS_CNT       3
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint16_t size;          /* Largest request served by the class */
+    uint16_t blocks;
+    uint16_t in_use;
+    uint16_t high_water;    /* Most blocks in use at once */
+    uint32_t allocs;
+    uint32_t fails;         /* Requests for this class that found no free block */
+} beacon_pool_stats_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+
+/*
+ * Cuts the arena into blocks, every block is free afterwards
+ */
+void beacon_pool_init(void);
+
+/*
+ * Returns a block of at least len bytes, NULL if len is larger than the
+ * largest class or no block that fits is free
+ */
+void *beacon_pool_alloc(uint16_t len);
+
+/*
+ * Returns a block to its class, NULL is ignored
+ */
+void beacon_pool_free(void *p_block);
+
+/*
+ * Copies the stats of a size class, classes are ordered by size
+ */
+void beacon_pool_get_stats(uint8_t class_idx, beacon_pool_stats_t *p_stats);
+
+/*
+ * Prints the stats of every class
+ */
+void beacon_pool_dump(void);
+
+#endif // _BEACON_POOL_H_
@@ -0,0 +1,162 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Hot-path latency probes
+*
+* Recording a sample is a handful of compares and adds plus one count
+* leading zeros for the histogram bucket, no division and no locking.
+*/
+#include "beacon_prof.h"
+#include "stdio.h"
+#include "string.h"
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+/* Leading zeros of a 32-bit word, 32 for 0 */
+#if BEACON_PROF_CLOCK_GETTIME
+#define BEACON_PROF_CLZ(v)      beacon_prof_clz(v)
+#else
+#define BEACON_PROF_CLZ(v)      __CLZ(v)        // CMSIS, one instruction with every toolchain
+#endif
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+static beacon_prof_stats_t beacon_prof_stats[BEACON_PROBE_CNT];
+
+static const char * const beacon_prof_names[BEACON_PROBE_CNT] =
+{
+    [BEACON_PROBE_SWITCH_ADV]        = "beacon_switch_adv",
+    [BEACON_PROBE_BEACON_START]      = "beacon_start",
+    [BEACON_PROBE_GATT_READ]         = "gatt read",
+    [BEACON_PROBE_GATT_READ_BY_TYPE] = "gatt read by type",
+    [BEACON_PROBE_GATT_READ_MULTI]   = "gatt read multi",
+    [BEACON_PROBE_GATT_WRITE]        = "gatt write",
+    [BEACON_PROBE_GATT_OTHER]        = "gatt other",
+    [BEACON_PROBE_MGMT_CB]           = "management callback",
+};
+
+#if BEACON_PROF_CLOCK_GETTIME
+/******************************************************************************
+ *     Private Function Definitions
+ ******************************************************************************/
+
+/*
+ * Counts the leading zeros of a word without compiler builtins
+ */
+static uint32_t beacon_prof_clz(uint32_t v)
+{
+    uint32_t n = 32;
+    uint32_t shift;
+
+    for (shift = 16; shift; shift >>= 1)
+    {
+        if (v >> shift)
+        {
+            v >>= shift;
+            n -= shift;
+        }
+    }
+    return n - v;
+}
+#endif
+
+/******************************************************************************
+ *     Public Function Definitions
+ ******************************************************************************/
+
+/*
+ * Starts the time source and clears all probes
+ */
+void beacon_prof_init(void)
+{
+#if !BEACON_PROF_CLOCK_GETTIME
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    beacon_prof_reset();
+}
+
+/*
+ * Adds one sample to a probe
+ */
+void beacon_prof_record(beacon_probe_t probe, uint32_t elapsed)
+{
+    beacon_prof_stats_t *p_stats = &beacon_prof_stats[probe];
+
+    if (p_stats->count == 0 || elapsed < p_stats->min)
+    {
+        p_stats->min = elapsed;
+    }
+    if (elapsed > p_stats->max)
+    {
+        p_stats->max = elapsed;
+    }
+    p_stats->count++;
+    p_stats->sum += elapsed;
+    p_stats->hist[32 - BEACON_PROF_CLZ(elapsed)]++;
+}
+
+/*
+ * Clears all probes
+ */
+void beacon_prof_reset(void)
+{
+    memset(beacon_prof_stats, 0, sizeof(beacon_prof_stats));
+}
+
+/*
+ * Copies the stats of a probe
+ */
+void beacon_prof_get(beacon_probe_t probe, beacon_prof_stats_t *p_stats)
+{
+    *p_stats = beacon_prof_stats[probe];
+}
+
+/*
+ * Returns the name of a probe
+ */
+const char *beacon_prof_name(beacon_probe_t probe)
+{
+    return (probe < BEACON_PROBE_CNT) ? beacon_prof_names[probe] : "?";
+}
+
+/*
+ * Prints every probe that has samples, one line of totals and one of
+ * histogram buckets as <2^k:count
+ */
+void beacon_prof_dump(void)
+{
+    beacon_prof_stats_t stats;
+    uint32_t probe, k;
+
+    printf("probe (%s): count min mean max\n", BEACON_PROF_UNIT);
+    for (probe = 0; probe < BEACON_PROBE_CNT; probe++)
+    {
+        beacon_prof_get((beacon_probe_t)probe, &stats);
+        if (stats.count == 0)
+        {
+            continue;
+        }
+        printf("%s: %lu %lu %lu %lu\n", beacon_prof_names[probe], (unsigned long)stats.count,
+               (unsigned long)stats.min, (unsigned long)(stats.sum / stats.count), (unsigned long)stats.max);
+        printf(" ");
+        for (k = 0; k < BEACON_PROF_BUCKETS; k++)
+        {
+            if (stats.hist[k] && k == 0)
+            {
+                printf(" 0:%lu", (unsigned long)stats.hist[k]);
+            }
+            else if (stats.hist[k])
+            {
+                printf(" <2^%lu:%lu", (unsigned long)k, (unsigned long)stats.hist[k]);
+            }
+        }
+        printf("\n");
+    }
+}
@@ -0,0 +1,132 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Hot-path latency probes
+*
+* A probe times a code section with the DWT cycle counter on target, or with
+* clock_gettime() in ns in host builds (BEACON_PROF_CLOCK_GETTIME). Every
+* probe keeps its count, min, max and sum, and a log2 histogram: bucket k
+* counts the samples in [2^(k-1), 2^k), bucket 0 the zero samples.
+*
+* Updates are not atomic. A probe must only be recorded from one thread at a
+* time, and a dump taken while probes run may mix old and new values.
+*
+* Set BEACON_PROF to 0 to compile the probes out.
+*/
+#ifndef _BEACON_PROF_H_
+#define _BEACON_PROF_H_
+
+#include "wiced_bt_types.h"
+#include <stdint.h>
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+#ifndef BEACON_PROF
+#define BEACON_PROF                 1
+#endif
+
+/* Histogram buckets, one per bit of a 32-bit sample plus zero */
+#define BEACON_PROF_BUCKETS         33
+
+/* Probed code sections */
+typedef enum
+{
+    BEACON_PROBE_SWITCH_ADV,            /* Rotation timer: TLM update and schedule apply */
+    BEACON_PROBE_BEACON_START,          /* Configure and queue one beacon */
+    BEACON_PROBE_GATT_READ,             /* GATT read and read blob */
+    BEACON_PROBE_GATT_READ_BY_TYPE,     /* GATT read by type */
+    BEACON_PROBE_GATT_READ_MULTI,       /* GATT read multiple */
+    BEACON_PROBE_GATT_WRITE,            /* GATT write requests and commands */
+    BEACON_PROBE_GATT_OTHER,            /* MTU, confirmations and unknown requests */
+    BEACON_PROBE_MGMT_CB,               /* Management callback */
+    BEACON_PROBE_CNT
+} beacon_probe_t;
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t hist[BEACON_PROF_BUCKETS];
+} beacon_prof_stats_t;
+
+/******************************************************************************
+ *                                Time source
+ ******************************************************************************/
+#if BEACON_PROF_CLOCK_GETTIME
+#include <time.h>
+
+static inline uint32_t beacon_prof_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+#define BEACON_PROF_UNIT            "ns"
+#else
+#include "cybsp.h"
+
+static inline uint32_t beacon_prof_now(void)
+{
+    return DWT->CYCCNT;
+}
+#define BEACON_PROF_UNIT            "cycles"
+#endif
+
+/******************************************************************************
+ *                                Macros
+ ******************************************************************************/
+#if BEACON_PROF
+/* Starts a probe, returns the start time to pass to BEACON_PROF_STOP */
+#define BEACON_PROF_START()             beacon_prof_now()
+#define BEACON_PROF_STOP(probe, start)  beacon_prof_record((probe), beacon_prof_now() - (start))
+#else
+#define BEACON_PROF_START()             0
+#define BEACON_PROF_STOP(probe, start)  ((void)(probe), (void)(start))
+#endif
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+
+/*
+ * Starts the time source and clears all probes
+ */
+void beacon_prof_init(void);
+
+/*
+ * Adds one sample to a probe, use BEACON_PROF_STOP
+ */
+void beacon_prof_record(beacon_probe_t probe, uint32_t elapsed);
+
+/*
+ * Clears all probes
+ */
+void beacon_prof_reset(void);
+
+/*
+ * Copies the stats of a probe
+ */
+void beacon_prof_get(beacon_probe_t probe, beacon_prof_stats_t *p_stats);
+
+/*
+ * Returns the name of a probe
+ */
+const char *beacon_prof_name(beacon_probe_t probe);
+
+/*
+ * Prints count, min, mean, max and the non-empty histogram buckets of every
+ * probe that has samples
+ */
+void beacon_prof_dump(void);
+
+#endif // _BEACON_PROF_H_
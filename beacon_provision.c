@@ -0,0 +1,82 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Per-device provisioning blob
+*
+* The CRC uses a 16-entry table, half a byte per step, which keeps the flash
+* cost to 64 bytes on the device and is fast enough for the host tool.
+*/
+#include "beacon_provision.h"
+#include "stddef.h"
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+/* Bytes covered by the CRC */
+#define BEACON_PROVISION_CRC_LEN        offsetof(beacon_provision_t, crc)
+
+/* The CRC steps half a byte at a time */
+#define BEACON_PROVISION_NIBBLE_BITS    4
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+/* CRC-32 of each nibble, reflected polynomial 0xedb88320 */
+static const uint32_t beacon_provision_crc_table[16] =
+{
+    0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+    0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+};
+
+/******************************************************************************
+ *     Public Function Definitions
+ ******************************************************************************/
+
+/*
+ * Returns the CRC-32 of len bytes, continuing from crc
+ */
+uint32_t beacon_provision_crc32(uint32_t crc, const uint8_t *p_data, uint32_t len)
+{
+    crc = ~crc;
+    while (len-- > 0)
+    {
+        crc ^= *p_data++;
+        crc = (crc >> BEACON_PROVISION_NIBBLE_BITS) ^ beacon_provision_crc_table[crc & 0x0f];
+        crc = (crc >> BEACON_PROVISION_NIBBLE_BITS) ^ beacon_provision_crc_table[crc & 0x0f];
+    }
+    return ~crc;
+}
+
+/*
+ * Encodes the adv data of the blob fields and closes it with its CRC
+ */
+wiced_bool_t beacon_provision_seal(beacon_provision_t *p_prov)
+{
+    p_prov->magic   = BEACON_PROVISION_MAGIC;
+    p_prov->version = BEACON_PROVISION_VERSION;
+    p_prov->size    = sizeof(*p_prov);
+
+    // the same encoders the application uses, see beacon.c
+    p_prov->ibeacon_adv_len = (uint8_t)wiced_bt_ibeacon_encode(p_prov->ibeacon_uuid, p_prov->ibeacon_major,
+                                                               p_prov->ibeacon_minor, p_prov->ibeacon_tx_power,
+                                                               p_prov->ibeacon_adv, sizeof(p_prov->ibeacon_adv));
+    p_prov->uid_adv_len = (uint8_t)wiced_bt_eddystone_encode_uid(p_prov->ranging_data, p_prov->namespace_id,
+                                                                 p_prov->instance, p_prov->uid_adv,
+                                                                 sizeof(p_prov->uid_adv));
+
+    p_prov->crc = beacon_provision_crc32(0, (const uint8_t *)p_prov, BEACON_PROVISION_CRC_LEN);
+    return p_prov->ibeacon_adv_len != 0 && p_prov->uid_adv_len != 0;
+}
+
+/*
+ * Returns WICED_TRUE if the blob has the expected magic, version, size and CRC
+ */
+wiced_bool_t beacon_provision_check(const beacon_provision_t *p_prov)
+{
+    return p_prov->magic == BEACON_PROVISION_MAGIC && p_prov->version == BEACON_PROVISION_VERSION &&
+           p_prov->size == sizeof(*p_prov) &&
+           p_prov->crc == beacon_provision_crc32(0, (const uint8_t *)p_prov, BEACON_PROVISION_CRC_LEN);
+}
@@ -0,0 +1,79 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Per-device provisioning blob
+*
+* The factory provisioning tool (host/provision) writes one blob per device:
+* its iBeacon UUID, major and minor, Eddystone namespace and instance, EID
+* identity key and static random address, plus the iBeacon and UID adv data
+* the device sends with them, encoded by the beacon library, so a test
+* station can match what it scans. All fields sit at their natural
+* alignment, multi-byte fields are little-endian, and a CRC-32 of the bytes
+* before it closes the blob.
+*/
+#ifndef _BEACON_PROVISION_H_
+#define _BEACON_PROVISION_H_
+
+#include "wiced_bt_beacon.h"
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+/* "BPRV" and the layout version */
+#define BEACON_PROVISION_MAGIC          0x56525042u
+#define BEACON_PROVISION_VERSION        1
+
+/* Blob size, the layout has no padding */
+#define BEACON_PROVISION_SIZE           140
+
+/* Identity key bytes */
+#define BEACON_PROVISION_KEY_LEN        16
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint32_t magic;                                             /* BEACON_PROVISION_MAGIC */
+    uint16_t version;                                           /* BEACON_PROVISION_VERSION */
+    uint16_t size;                                              /* BEACON_PROVISION_SIZE */
+    uint32_t serial;                                            /* Device serial number */
+    uint16_t ibeacon_major;
+    uint16_t ibeacon_minor;
+    uint8_t  ibeacon_uuid[LEN_UUID_128];
+    uint8_t  namespace_id[EDDYSTONE_UID_NAMESPACE_LEN];
+    uint8_t  instance[EDDYSTONE_UID_INSTANCE_ID_LEN];
+    uint8_t  eid_key[BEACON_PROVISION_KEY_LEN];                 /* EID and eTLM identity key */
+    uint8_t  random_bda[BD_ADDR_LEN];                           /* Static random address, MSB first */
+    uint8_t  ibeacon_tx_power;                                  /* iBeacon measured power */
+    uint8_t  ranging_data;                                      /* Eddystone UID and EID ranging data */
+    uint8_t  ibeacon_adv_len;
+    uint8_t  uid_adv_len;
+    uint8_t  ibeacon_adv[WICED_BT_BEACON_ADV_DATA_MAX];         /* iBeacon adv data the device sends */
+    uint8_t  uid_adv[WICED_BT_BEACON_ADV_DATA_MAX];             /* Eddystone UID adv data the device sends */
+    uint32_t crc;                                               /* CRC-32 of the bytes before it */
+} beacon_provision_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+
+/*
+ * Returns the CRC-32 (IEEE 802.3) of len bytes, continuing from crc, 0 to start
+ */
+uint32_t beacon_provision_crc32(uint32_t crc, const uint8_t *p_data, uint32_t len);
+
+/*
+ * Encodes the adv data of the blob fields and closes it with its CRC
+ */
+wiced_bool_t beacon_provision_seal(beacon_provision_t *p_prov);
+
+/*
+ * Returns WICED_TRUE if the blob has the expected magic, version, size and CRC
+ */
+wiced_bool_t beacon_provision_check(const beacon_provision_t *p_prov);
+
+#endif // _BEACON_PROVISION_H_
@@ -0,0 +1,226 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Beacon air-time scheduler
+*
+* Each tick the policy selects the beacons for the next tick, the scheduler
+* turns the selection into stop and start lists and then accounts the tick:
+* a beacon earns its share as credit every tick and pays a full share for
+* every tick on air, so the credit is the air time it is owed.
+*/
+#include "beacon_sched.h"
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+/* Key of a beacon that misses its staleness deadline unless started now */
+#define BEACON_SCHED_KEY_URGENT     (1L << 24)
+
+/******************************************************************************
+ *     Private Function Definitions
+ ******************************************************************************/
+
+/*
+ * Round robin, stops the oldest beacon and starts the next one
+ */
+static void beacon_sched_select_round_robin(beacon_sched_t *p_sched)
+{
+    uint16_t i;
+    wiced_bool_t any_on = WICED_FALSE;
+
+    for (i = 0; i < p_sched->cnt; i++)
+    {
+        p_sched->p_state[i].next_on = p_sched->p_state[i].on;
+        any_on |= p_sched->p_state[i].on;
+    }
+
+    if (p_sched->cnt <= p_sched->sets || !any_on)
+    {
+        // first tick (or enough sets for everybody), fill the sets in order
+        for (i = 0; i < p_sched->cnt; i++)
+        {
+            p_sched->p_state[i].next_on = (i < p_sched->sets);
+        }
+        p_sched->rr_next = 0;
+        return;
+    }
+
+    p_sched->p_state[p_sched->rr_next].next_on = WICED_FALSE;
+    p_sched->p_state[(p_sched->rr_next + p_sched->sets) % p_sched->cnt].next_on = WICED_TRUE;
+    if (++p_sched->rr_next >= p_sched->cnt)
+    {
+        p_sched->rr_next = 0;
+    }
+}
+
+/*
+ * Priority of a beacon for the next tick. Beacons at their staleness deadline
+ * come first, then the credit decides. On-air beacons get the hysteresis bonus
+ * so a swap only happens when it pays for its stop and start.
+ */
+static int32_t beacon_sched_key(const beacon_sched_t *p_sched, uint16_t idx)
+{
+    const beacon_sched_target_t *p_target = &p_sched->p_target[idx];
+    const beacon_sched_state_t  *p_state = &p_sched->p_state[idx];
+
+    if (p_state->on)
+    {
+        return p_state->credit + BEACON_SCHED_HYSTERESIS;
+    }
+    if (p_target->max_stale && p_state->off_age >= p_target->max_stale)
+    {
+        return BEACON_SCHED_KEY_URGENT + p_state->credit;
+    }
+    return p_state->credit;
+}
+
+/*
+ * Deadline first, then largest credit. One pass over the beacons keeps the
+ * top entries by key in a list sorted by descending key; a beacon only has
+ * to beat the last entry to get in, so most beacons cost one compare.
+ * Equal keys keep the lower index.
+ */
+static void beacon_sched_select_deadline(beacon_sched_t *p_sched)
+{
+    int32_t  top_key[BEACON_SCHED_MAX_SETS];
+    uint16_t top_idx[BEACON_SCHED_MAX_SETS];
+    uint16_t i, n, top_cnt = 0;
+    int32_t  key;
+    uint16_t picks = p_sched->sets < p_sched->cnt ? p_sched->sets : p_sched->cnt;
+
+    for (i = 0; i < p_sched->cnt; i++)
+    {
+        p_sched->p_state[i].next_on = WICED_FALSE;
+        if (picks == 0)
+        {
+            continue;
+        }
+        key = beacon_sched_key(p_sched, i);
+
+        if (top_cnt == picks && key <= top_key[top_cnt - 1])
+        {
+            continue;
+        }
+        if (top_cnt < picks)
+        {
+            top_cnt++;
+        }
+        for (n = top_cnt - 1; n > 0 && top_key[n - 1] < key; n--)
+        {
+            top_key[n] = top_key[n - 1];
+            top_idx[n] = top_idx[n - 1];
+        }
+        top_key[n] = key;
+        top_idx[n] = i;
+    }
+
+    for (n = 0; n < top_cnt; n++)
+    {
+        p_sched->p_state[top_idx[n]].next_on = WICED_TRUE;
+    }
+}
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+const beacon_sched_policy_t beacon_sched_round_robin = { "round-robin", beacon_sched_select_round_robin };
+const beacon_sched_policy_t beacon_sched_deadline    = { "deadline",    beacon_sched_select_deadline };
+
+/******************************************************************************
+ *     Public Function Definitions
+ ******************************************************************************/
+
+/*
+ * Initializes a scheduler with all beacons off air
+ */
+void beacon_sched_init(beacon_sched_t *p_sched, const beacon_sched_policy_t *p_policy,
+                       const beacon_sched_target_t *p_target, beacon_sched_state_t *p_state,
+                       uint16_t cnt, uint16_t sets)
+{
+    uint16_t i;
+
+    p_sched->p_policy = p_policy;
+    p_sched->p_target = p_target;
+    p_sched->p_state  = p_state;
+    p_sched->cnt      = cnt;
+    p_sched->sets     = (sets > BEACON_SCHED_MAX_SETS) ? BEACON_SCHED_MAX_SETS : sets;
+    p_sched->rr_next  = 0;
+    p_sched->ticks    = 0;
+    p_sched->swaps    = 0;
+
+    for (i = 0; i < cnt; i++)
+    {
+        p_state[i].credit      = 0;
+        p_state[i].on_ticks    = 0;
+        p_state[i].missed      = 0;
+        p_state[i].off_age     = 0;
+        p_state[i].max_off_age = 0;
+        p_state[i].on          = WICED_FALSE;
+        p_state[i].next_on     = WICED_FALSE;
+    }
+}
+
+/*
+ * Schedules the next tick and accounts it
+ */
+void beacon_sched_tick(beacon_sched_t *p_sched, uint16_t *p_stop, uint16_t *p_stop_cnt,
+                       uint16_t *p_start, uint16_t *p_start_cnt)
+{
+    uint16_t i;
+    uint16_t stop_cnt = 0, start_cnt = 0;
+
+    p_sched->p_policy->select(p_sched);
+
+    for (i = 0; i < p_sched->cnt; i++)
+    {
+        beacon_sched_state_t *p_state = &p_sched->p_state[i];
+        const beacon_sched_target_t *p_target = &p_sched->p_target[i];
+
+        if (p_state->on && !p_state->next_on)
+        {
+            p_stop[stop_cnt++] = i;
+        }
+        else if (!p_state->on && p_state->next_on)
+        {
+            p_start[start_cnt++] = i;
+        }
+        p_state->on = p_state->next_on;
+
+        // account the tick the selection is on air for
+        p_state->credit += p_target->share;
+        if (p_state->on)
+        {
+            p_state->credit -= BEACON_SCHED_SHARE_FULL;
+            p_state->on_ticks++;
+            p_state->off_age = 0;
+        }
+        else
+        {
+            p_state->off_age++;
+            if (p_state->off_age > p_state->max_off_age)
+            {
+                p_state->max_off_age = p_state->off_age;
+            }
+            if (p_target->max_stale && p_state->off_age == p_target->max_stale + 1)
+            {
+                p_state->missed++;
+            }
+        }
+        if (p_state->credit > BEACON_SCHED_CREDIT_MAX)
+        {
+            p_state->credit = BEACON_SCHED_CREDIT_MAX;
+        }
+        else if (p_state->credit < -BEACON_SCHED_CREDIT_MAX)
+        {
+            p_state->credit = -BEACON_SCHED_CREDIT_MAX;
+        }
+    }
+
+    p_sched->ticks++;
+    p_sched->swaps += stop_cnt + start_cnt;
+    *p_stop_cnt  = stop_cnt;
+    *p_start_cnt = start_cnt;
+}
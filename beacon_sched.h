@@ -0,0 +1,100 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Beacon air-time scheduler
+*
+* Decides each second which beacons own the limited hardware adv sets.
+* Every beacon has a target on-air share and a maximum staleness (the
+* longest it may stay off air). The policy is pluggable: the round-robin
+* policy reproduces the original fixed rotation, the deadline policy
+* serves staleness deadlines first and then the beacons furthest behind
+* their share, and keeps beacons on air unless a swap is worth its
+* controller commands.
+*/
+#ifndef _BEACON_SCHED_H_
+#define _BEACON_SCHED_H_
+
+#include "wiced_bt_types.h"
+
+/* Scheduler tick in seconds */
+#define BEACON_SCHED_TICK_SEC       1
+
+/* Max hardware adv sets scheduled, bounds the per-tick stop and start lists */
+#ifndef BEACON_SCHED_MAX_SETS
+#define BEACON_SCHED_MAX_SETS       64
+#endif
+
+/* Share unit, a share of BEACON_SCHED_SHARE_FULL is always on air */
+#define BEACON_SCHED_SHARE_FULL     1000
+
+/* Credit an on-air beacon keeps over a waiting one before it is swapped out */
+#ifndef BEACON_SCHED_HYSTERESIS
+#define BEACON_SCHED_HYSTERESIS     500
+#endif
+
+/* Bound of the share credit, limits catch-up after long overload */
+#define BEACON_SCHED_CREDIT_MAX     (4 * BEACON_SCHED_SHARE_FULL)
+
+typedef struct
+{
+    uint16_t share;         /* Target on-air share, in 1/BEACON_SCHED_SHARE_FULL */
+    uint16_t max_stale;     /* Max consecutive ticks off air, 0 for no deadline */
+} beacon_sched_target_t;
+
+typedef struct
+{
+    int32_t  credit;        /* Share owed to the beacon, grows by share per tick off target */
+    uint32_t on_ticks;      /* Ticks spent on air */
+    uint32_t missed;        /* Staleness deadlines missed */
+    uint16_t off_age;       /* Consecutive ticks off air */
+    uint16_t max_off_age;   /* Longest time off air seen */
+    wiced_bool_t on;        /* Currently on air */
+    wiced_bool_t next_on;   /* Selected for the next tick */
+} beacon_sched_state_t;
+
+typedef struct beacon_sched beacon_sched_t;
+
+typedef struct
+{
+    const char *name;
+    /* Sets next_on for every beacon, at most p_sched->sets of them */
+    void (*select)(beacon_sched_t *p_sched);
+} beacon_sched_policy_t;
+
+struct beacon_sched
+{
+    const beacon_sched_policy_t *p_policy;
+    const beacon_sched_target_t *p_target;  /* cnt entries */
+    beacon_sched_state_t        *p_state;   /* cnt entries, owned by the caller */
+    uint16_t                     cnt;       /* Number of beacons */
+    uint16_t                     sets;      /* Number of hardware adv sets */
+    uint16_t                     rr_next;   /* Round-robin position */
+    uint32_t                     ticks;     /* Ticks scheduled */
+    uint32_t                     swaps;     /* Stops plus starts issued */
+};
+
+/* Original fixed rotation: stops the oldest beacon and starts the next one every tick */
+extern const beacon_sched_policy_t beacon_sched_round_robin;
+
+/* Earliest staleness deadline first, then largest share credit, with hysteresis */
+extern const beacon_sched_policy_t beacon_sched_deadline;
+
+/*
+ * Initializes a scheduler with all beacons off air, sets is clamped to BEACON_SCHED_MAX_SETS
+ */
+void beacon_sched_init(beacon_sched_t *p_sched, const beacon_sched_policy_t *p_policy,
+                       const beacon_sched_target_t *p_target, beacon_sched_state_t *p_state,
+                       uint16_t cnt, uint16_t sets);
+
+/*
+ * Schedules the next tick. Fills p_stop and p_start (BEACON_SCHED_MAX_SETS
+ * entries each) with the beacons to take off and put on air and their counts. The caller issues
+ * the stops first so the freed adv sets can be reused by the starts.
+ */
+void beacon_sched_tick(beacon_sched_t *p_sched, uint16_t *p_stop, uint16_t *p_stop_cnt,
+                       uint16_t *p_start, uint16_t *p_start_cnt);
+
+#endif // _BEACON_SCHED_H_
@@ -0,0 +1,98 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Beacon time counter
+*
+* The checkpoint in RAM mirrors the stored one. While the counter is below
+* it nothing is written. The counter reaches it at the start of a period,
+* and the next checkpoint is written before that period is used. A failed
+* write is tried again at the next advance.
+*/
+#include "beacon_time.h"
+#include "beacon_log.h"
+#include "inttypes.h"
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+static const beacon_time_store_t *beacon_time_store;
+static uint32_t                   beacon_time_counter;
+static uint32_t                   beacon_time_checkpoint;     // last written, the counter stays below it
+static uint32_t                   beacon_time_period_mask;
+
+/******************************************************************************
+ *     Private Function Definitions
+ ******************************************************************************/
+
+/*
+ * Writes the checkpoint one period past the current one
+ */
+static wiced_bool_t beacon_time_save(void)
+{
+    uint32_t checkpoint = (beacon_time_counter & ~beacon_time_period_mask) + beacon_time_period_mask + 1;
+
+    if (beacon_time_store == NULL)
+    {
+        return WICED_TRUE;
+    }
+    if (!beacon_time_store->p_save(checkpoint))
+    {
+        BEACON_LOG_WARN("time checkpoint %"PRIu32" not written\n", checkpoint);
+        return WICED_FALSE;
+    }
+    beacon_time_checkpoint = checkpoint;
+    return WICED_TRUE;
+}
+
+/******************************************************************************
+ *     Public Function Definitions
+ ******************************************************************************/
+
+/*
+ * Resumes the counter at the start of the first period past the checkpoint
+ */
+wiced_bool_t beacon_time_init(const beacon_time_store_t *p_store, uint8_t exponent)
+{
+    uint32_t checkpoint = 0;
+
+    beacon_time_store = p_store;
+    beacon_time_period_mask = (1u << exponent) - 1;
+    if (p_store != NULL && !p_store->p_load(&checkpoint))
+    {
+        checkpoint = 0;
+    }
+    beacon_time_counter = (checkpoint + beacon_time_period_mask) & ~beacon_time_period_mask;
+    beacon_time_checkpoint = beacon_time_counter;
+    return beacon_time_save();
+}
+
+/*
+ * Moves the checkpoint on once the counter reaches it
+ */
+void beacon_time_advance(uint32_t secs)
+{
+    beacon_time_counter += secs;
+    if (beacon_time_store != NULL && beacon_time_counter >= beacon_time_checkpoint)
+    {
+        beacon_time_save();
+    }
+}
+
+/*
+ * Returns the counter
+ */
+uint32_t beacon_time_now(void)
+{
+    return beacon_time_counter;
+}
+
+/*
+ * Returns the counter at the start of the current period
+ */
+uint32_t beacon_time_base(void)
+{
+    return beacon_time_counter & ~beacon_time_period_mask;
+}
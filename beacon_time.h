@@ -0,0 +1,64 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Beacon time counter
+*
+* The time counter of the Eddystone EID and the eTLM nonce, in seconds. It is
+* kept apart from the TLM time since power-on because it must never go back:
+* a resolver expects it to keep counting, and a counter that restarts with
+* every boot sends the identifiers and eTLM time bases of the last boot again.
+*
+* A checkpoint in non-volatile storage holds the start of the EID period the
+* counter may not reach before the checkpoint moves on. It is written one
+* period ahead at boot and each time the counter enters a new period, so the
+* storage sees one write per period. At boot the counter resumes at the
+* checkpoint: the time the device was off is not counted, the counter lags a
+* resolver by it, but every period of the last boot is left behind.
+*
+* Without a store the counter starts at 0 every boot.
+*/
+#ifndef _BEACON_TIME_H_
+#define _BEACON_TIME_H_
+
+#include "wiced_bt_types.h"
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    wiced_bool_t (*p_load)(uint32_t *p_checkpoint); /* Reads the checkpoint, WICED_FALSE if there is none */
+    wiced_bool_t (*p_save)(uint32_t checkpoint);    /* Writes the checkpoint, WICED_FALSE if it failed */
+} beacon_time_store_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+
+/*
+ * Resumes the counter at the checkpoint of p_store, NULL for none, and moves
+ * the checkpoint one EID period of 2^exponent seconds ahead. Returns
+ * WICED_FALSE if the checkpoint could not be written.
+ */
+wiced_bool_t beacon_time_init(const beacon_time_store_t *p_store, uint8_t exponent);
+
+/*
+ * Advances the counter, writing the next checkpoint when it enters a new
+ * EID period
+ */
+void beacon_time_advance(uint32_t secs);
+
+/*
+ * Returns the counter
+ */
+uint32_t beacon_time_now(void);
+
+/*
+ * Returns the counter at the start of the current EID period
+ */
+uint32_t beacon_time_base(void);
+
+#endif // _BEACON_TIME_H_
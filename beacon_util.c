@@ -40,20 +40,74 @@
 #include "string.h"
 
 /*
-* This function copies advertiement elements into a flat buffer and return the lenght
+* This function starts an encoding pass into a caller-owned buffer
 */
-void wiced_bt_beacon_set_adv_data(wiced_bt_beacon_ble_advert_elem_t *beacon_adv_elem, uint8_t num_elem,
-                                  uint8_t adv_data[WICED_BT_BEACON_ADV_DATA_MAX], uint8_t *adv_len)
+void wiced_bt_beacon_encoder_init(wiced_bt_beacon_encoder_t *p_enc, uint8_t *p_buf, uint16_t size)
 {
-    uint8_t i = 0, j = 0;
-    for (i = 0; i < num_elem; i++)
+    p_enc->p_buf    = p_buf;
+    p_enc->size     = size;
+    p_enc->len      = 0;
+    p_enc->overflow = WICED_FALSE;
+}
+
+/*
+* This function appends the length and type of an AD structure and returns where its payload goes
+*/
+uint8_t *wiced_bt_beacon_encoder_reserve(wiced_bt_beacon_encoder_t *p_enc, wiced_bt_ble_advert_type_t advert_type,
+                                         uint8_t data_len)
+{
+    uint8_t *p;
+
+    if (p_enc->overflow || (uint32_t)p_enc->len + 2 + data_len > p_enc->size)
+    {
+        p_enc->overflow = WICED_TRUE;
+        return NULL;
+    }
+
+    p = &p_enc->p_buf[p_enc->len];
+    UINT8_TO_STREAM(p, data_len + 1);   // data_len + advert_type
+    UINT8_TO_STREAM(p, advert_type);
+    p_enc->len += 2 + data_len;
+    return p;
+}
+
+/*
+* This function appends an AD structure
+*/
+wiced_bool_t wiced_bt_beacon_encoder_put_elem(wiced_bt_beacon_encoder_t *p_enc, wiced_bt_ble_advert_type_t advert_type,
+                                              const uint8_t *p_data, uint8_t data_len)
+{
+    uint8_t *p = wiced_bt_beacon_encoder_reserve(p_enc, advert_type, data_len);
+
+    if (p == NULL)
+    {
+        return WICED_FALSE;
+    }
+    memcpy(p, p_data, data_len);
+    return WICED_TRUE;
+}
+
+/*
+* This function appends a Flags AD structure
+*/
+wiced_bool_t wiced_bt_beacon_encoder_put_flags(wiced_bt_beacon_encoder_t *p_enc, uint8_t flags)
+{
+    uint8_t *p = wiced_bt_beacon_encoder_reserve(p_enc, BTM_BLE_ADVERT_TYPE_FLAG, 1);
+
+    if (p == NULL)
     {
-        adv_data[j++] = beacon_adv_elem[i].len;
-        adv_data[j++] = beacon_adv_elem[i].advert_type;
-        memcpy(&adv_data[j], beacon_adv_elem[i].data, (beacon_adv_elem[i].len - 1)); // len -1 for advert_type
-        j += beacon_adv_elem[i].len - 1;
+        return WICED_FALSE;
     }
-    *adv_len = j;
+    *p = flags;
+    return WICED_TRUE;
+}
+
+/*
+* This function returns the encoded length, or 0 if the pass overflowed the buffer
+*/
+uint16_t wiced_bt_beacon_encoder_len(const wiced_bt_beacon_encoder_t *p_enc)
+{
+    return p_enc->overflow ? 0 : p_enc->len;
 }
 
 // For 43012C0 platform, the multi adv APIs are not defined in ROM, hence define them in library
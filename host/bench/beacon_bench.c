@@ -0,0 +1,547 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host microbenchmark of the beacon library encoders and the beacon rotation.
+*
+* For each encoder the benchmark reports the time per encoded frame and the
+* bytes moved by memcpy per frame, and checks the frame against the bytes
+* the target produces. The rotation benchmark drives beacon_switch_adv()
+* through the stub timer and reports the controller commands per rotation.
+* The parallel benchmark encodes from several threads at once, each with
+* its own encoder context, and checks every frame. The log benchmark compares
+* a deferred log call with formatting the same line in place. The rotation
+* also prints the latency probes recorded on the way, with the p99 taken as
+* the upper bound of the histogram bucket that holds it.
+*
+* Usage: beacon_bench [iterations]
+*/
+#include "wiced_bt_beacon.h"
+#include "host_stub.h"
+#include "beacon.h"
+#include "beacon_cache.h"
+#include "beacon_adv_set.h"
+#include "beacon_ctrl.h"
+#include "beacon_log.h"
+#include "beacon_prof.h"
+#include "bench_util.h"
+#include <pthread.h>
+#include <string.h>
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+#define BENCH_THREADS               4
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef void (bench_encode_func_t)(uint8_t adv_data[WICED_BT_BEACON_ADV_DATA_MAX], uint8_t *adv_len);
+
+typedef struct
+{
+    const char          *name;
+    bench_encode_func_t *encode;
+    const uint8_t       *expected;
+    uint8_t              expected_len;
+} bench_encoder_t;
+
+typedef struct
+{
+    pthread_t thread;
+    uint32_t  id;
+    uint32_t  iterations;
+    uint32_t  mismatches;
+} bench_thread_t;
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+/* Sample inputs, same values as beacon.c */
+static uint8_t bench_namespace[EDDYSTONE_UID_NAMESPACE_LEN] = { 1,2,3,4,5,6,7,8,9,0 };
+static uint8_t bench_instance[EDDYSTONE_UID_INSTANCE_ID_LEN] = { 0,1,2,3,4,5 };
+static uint8_t bench_url[EDDYSTONE_URL_VALUE_MAX_LEN] = "infineon.com";
+static uint8_t bench_eid[EDDYSTONE_EID_LEN] = { 1,2,3,4,5,6,7,8 };
+static uint8_t bench_etlm[EDDYSTONE_ETLM_LEN] = { 0,1,2,3,4,5,6,7,8,9,10,11 };
+static uint8_t bench_ibeacon_uuid[LEN_UUID_128] = { 0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15 };
+
+/* Expected frames */
+static const uint8_t bench_expected_uid[] =
+{
+    0x02, 0x01, 0x06, 0x03, 0x03, 0xAA, 0xFE, 0x17, 0x16, 0xAA, 0xFE, 0x00, 0xF0,
+    1,2,3,4,5,6,7,8,9,0, 0,1,2,3,4,5, 0x00, 0x00,
+};
+static const uint8_t bench_expected_url[] =
+{
+    0x02, 0x01, 0x06, 0x03, 0x03, 0xAA, 0xFE, 0x12, 0x16, 0xAA, 0xFE, 0x10, 0x01, 0x00,
+    'i','n','f','i','n','e','o','n','.','c','o','m',
+};
+static const uint8_t bench_expected_eid[] =
+{
+    0x02, 0x01, 0x06, 0x03, 0x03, 0xAA, 0xFE, 0x0D, 0x16, 0xAA, 0xFE, 0x30, 0xF0,
+    1,2,3,4,5,6,7,8,
+};
+static const uint8_t bench_expected_tlm[] =
+{
+    0x02, 0x01, 0x06, 0x03, 0x03, 0xAA, 0xFE, 0x11, 0x16, 0xAA, 0xFE, 0x20, 0x00,
+    0x0A, 0x00, 0x0F, 0x00, 0x78, 0x56, 0x34, 0x12, 0x21, 0x43, 0x65, 0x87,
+};
+static const uint8_t bench_expected_etlm[] =
+{
+    0x02, 0x01, 0x06, 0x03, 0x03, 0xAA, 0xFE, 0x15, 0x16, 0xAA, 0xFE, 0x20, 0x01,
+    0,1,2,3,4,5,6,7,8,9,10,11, 0x34, 0x12, 0xCD, 0xAB,
+};
+static const uint8_t bench_expected_ibeacon[] =
+{
+    0x02, 0x01, 0x06, 0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15,
+    0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15, 0x01, 0x00, 0x02, 0x00, 0xB3,
+};
+
+/******************************************************************************
+ *                          Encoder wrappers
+ ******************************************************************************/
+static void bench_uid(uint8_t adv_data[WICED_BT_BEACON_ADV_DATA_MAX], uint8_t *adv_len)
+{
+    wiced_bt_eddystone_set_data_for_uid(0xf0, bench_namespace, bench_instance, adv_data, adv_len);
+}
+
+static void bench_url_frame(uint8_t adv_data[WICED_BT_BEACON_ADV_DATA_MAX], uint8_t *adv_len)
+{
+    wiced_bt_eddystone_set_data_for_url(0x01, EDDYSTONE_URL_SCHEME_0, bench_url, adv_data, adv_len);
+}
+
+static void bench_eid_frame(uint8_t adv_data[WICED_BT_BEACON_ADV_DATA_MAX], uint8_t *adv_len)
+{
+    wiced_bt_eddystone_set_data_for_eid(0xf0, bench_eid, adv_data, adv_len);
+}
+
+static void bench_tlm(uint8_t adv_data[WICED_BT_BEACON_ADV_DATA_MAX], uint8_t *adv_len)
+{
+    wiced_bt_eddystone_set_data_for_tlm_unencrypted(10, 15, 0x12345678, 0x87654321, adv_data, adv_len);
+}
+
+static void bench_etlm_frame(uint8_t adv_data[WICED_BT_BEACON_ADV_DATA_MAX], uint8_t *adv_len)
+{
+    wiced_bt_eddystone_set_data_for_tlm_encrypted(bench_etlm, 0x1234, 0xABCD, adv_data, adv_len);
+}
+
+static void bench_ibeacon(uint8_t adv_data[WICED_BT_BEACON_ADV_DATA_MAX], uint8_t *adv_len)
+{
+    wiced_bt_ibeacon_set_adv_data(bench_ibeacon_uuid, 0x01, 0x02, 0xb3, adv_data, adv_len);
+}
+
+static const bench_encoder_t bench_encoders[] =
+{
+    { "wiced_bt_eddystone_set_data_for_uid",             bench_uid,        bench_expected_uid,     sizeof(bench_expected_uid) },
+    { "wiced_bt_eddystone_set_data_for_url",             bench_url_frame,  bench_expected_url,     sizeof(bench_expected_url) },
+    { "wiced_bt_eddystone_set_data_for_eid",             bench_eid_frame,  bench_expected_eid,     sizeof(bench_expected_eid) },
+    { "wiced_bt_eddystone_set_data_for_tlm_unencrypted", bench_tlm,        bench_expected_tlm,     sizeof(bench_expected_tlm) },
+    { "wiced_bt_eddystone_set_data_for_tlm_encrypted",   bench_etlm_frame, bench_expected_etlm,    sizeof(bench_expected_etlm) },
+    { "wiced_bt_ibeacon_set_adv_data",                   bench_ibeacon,    bench_expected_ibeacon, sizeof(bench_expected_ibeacon) },
+};
+
+/******************************************************************************
+ *                          Benchmarks
+ ******************************************************************************/
+static void bench_run_encoders(uint32_t iterations)
+{
+    uint8_t  adv_data[WICED_BT_BEACON_ADV_DATA_MAX];
+    uint8_t  adv_len = 0;
+    uint32_t i, n;
+
+    printf("%-48s %10s %12s %8s\n", "encoder", "ns/frame", "memcpy B/fr", "adv len");
+    for (n = 0; n < sizeof(bench_encoders) / sizeof(bench_encoders[0]); n++)
+    {
+        const bench_encoder_t *p_enc = &bench_encoders[n];
+        uint64_t start, elapsed;
+
+        // check the frame before timing it
+        memset(adv_data, 0, sizeof(adv_data));
+        p_enc->encode(adv_data, &adv_len);
+        BENCH_CHECK(adv_len == p_enc->expected_len);
+        BENCH_CHECK(memcmp(adv_data, p_enc->expected, p_enc->expected_len) == 0);
+
+        host_stub_reset_counters();
+        start = bench_now_ns();
+        for (i = 0; i < iterations; i++)
+        {
+            p_enc->encode(adv_data, &adv_len);
+        }
+        elapsed = bench_now_ns() - start;
+
+        printf("%-48s %10.1f %12.1f %8u\n", p_enc->name,
+               (double)elapsed / iterations,
+               (double)host_copy_bytes / iterations,
+               adv_len);
+    }
+}
+
+/*
+ * Patches the TLM counters of a resident frame, the incremental TLM path
+ */
+static void bench_run_tlm_patch(uint32_t iterations)
+{
+    uint8_t  adv_data[WICED_BT_BEACON_ADV_DATA_MAX];
+    uint8_t  expected[WICED_BT_BEACON_ADV_DATA_MAX];
+    uint16_t len;
+    uint64_t start, elapsed;
+    uint32_t i;
+
+    len = wiced_bt_eddystone_encode_tlm_unencrypted(10, 15, 0, 0, adv_data, sizeof(adv_data));
+
+    host_stub_reset_counters();
+    start = bench_now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        wiced_bt_eddystone_patch_tlm_unencrypted(adv_data, 10, 15, i, i + 1);
+    }
+    elapsed = bench_now_ns() - start;
+
+    BENCH_CHECK(wiced_bt_eddystone_encode_tlm_unencrypted(10, 15, iterations - 1, iterations, expected, sizeof(expected)) == len);
+    BENCH_CHECK(memcmp(adv_data, expected, len) == 0);
+
+    printf("%-48s %10.1f %12.1f %8u\n", "wiced_bt_eddystone_patch_tlm_unencrypted",
+           (double)elapsed / iterations, (double)host_copy_bytes / iterations, len);
+}
+
+/*
+ * Acquire/release pairs on a full-size allocator with most sets in use
+ */
+static void bench_run_adv_set(uint32_t iterations)
+{
+    uint64_t start, elapsed;
+    uint32_t i;
+    uint8_t  sets, handle = BEACON_ADV_SET_INVALID;
+
+    sets = beacon_adv_set_init(HOST_STUB_MAX_ADV_SETS);
+    for (i = 0; i + 1 < sets; i++)
+    {
+        BENCH_CHECK(beacon_adv_set_acquire(i) == i + 1);
+    }
+
+    start = bench_now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        handle = beacon_adv_set_acquire((uint16_t)(i & 0xFF));
+        beacon_adv_set_release(handle);
+    }
+    elapsed = bench_now_ns() - start;
+
+    BENCH_CHECK(handle == sets);
+    BENCH_CHECK(beacon_adv_set_owner(sets) == BEACON_ADV_SET_NO_OWNER);
+    BENCH_CHECK(beacon_adv_set_owner(1) == 0);
+    BENCH_CHECK(beacon_adv_set_acquire(sets) == sets);
+    BENCH_CHECK(beacon_adv_set_acquire(0) == BEACON_ADV_SET_INVALID);
+    BENCH_CHECK(beacon_adv_set_free_count() == 0);
+
+    printf("%-48s %10.1f %12.1f %8u\n", "beacon_adv_set_acquire + release",
+           (double)elapsed / iterations, 0.0, sets);
+}
+
+/*
+ * Deferred log call against formatting in place, the cost the BT thread pays
+ * per line. The ring is drained between batches, outside the timed writes.
+ */
+static void bench_run_log(uint32_t iterations)
+{
+    beacon_log_stats_t stats0, stats1;
+    uint64_t start, write_ns = 0, drain_ns = 0, format_ns;
+    uint32_t i, n, drained = 0;
+
+    beacon_log_drain(0);
+    beacon_log_get_stats(&stats0);
+    for (i = 0; i < iterations; i += n)
+    {
+        n = (iterations - i < BEACON_LOG_RING_SIZE) ? iterations - i : BEACON_LOG_RING_SIZE;
+
+        start = bench_now_ns();
+        for (uint32_t k = 0; k < n; k++)
+        {
+            BEACON_LOG_DEBUG("beacon_start instance %d for index %d\n", (i + k) & 3, i + k);
+        }
+        write_ns += bench_now_ns() - start;
+
+        start = bench_now_ns();
+        drained += beacon_log_drain(0);
+        drain_ns += bench_now_ns() - start;
+    }
+    beacon_log_get_stats(&stats1);
+
+    start = bench_now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        host_trace_printf("beacon_start instance %d for index %d\n", i & 3, i);
+    }
+    format_ns = bench_now_ns() - start;
+
+    BENCH_CHECK(drained == iterations);
+    BENCH_CHECK(stats1.written - stats0.written == iterations);
+    BENCH_CHECK(stats1.drops == stats0.drops);
+
+    printf("%-48s %10.1f %12.1f %8u\n", "BEACON_LOG_DEBUG, 2 args", (double)write_ns / iterations, 0.0, 0);
+    printf("%-48s %10.1f %12.1f %8u\n", "  drain (log thread) per record", (double)drain_ns / iterations, 0.0, 0);
+    printf("%-48s %10.1f %12.1f %8u\n", "printf in place (formatted, muted)", (double)format_ns / iterations, 0.0, 0);
+}
+
+/*
+ * Cost of one empty START/STOP probe pair, the overhead added to each probed section
+ */
+static void bench_run_prof(uint32_t iterations)
+{
+    beacon_prof_stats_t stats;
+    uint64_t start, elapsed;
+    uint32_t i, t0;
+
+    beacon_prof_reset();
+    start = bench_now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        t0 = BEACON_PROF_START();
+        BEACON_PROF_STOP(BEACON_PROBE_GATT_OTHER, t0);
+    }
+    elapsed = bench_now_ns() - start;
+    beacon_prof_get(BEACON_PROBE_GATT_OTHER, &stats);
+    beacon_prof_reset();
+
+    BENCH_CHECK(stats.count == iterations);
+    printf("%-48s %10.1f %12.1f %8u\n", "BEACON_PROF_START + STOP", (double)elapsed / iterations, 0.0, 0);
+}
+
+/*
+ * Returns the upper bound of the histogram bucket holding the 99th percentile
+ */
+static uint64_t bench_prof_p99(const beacon_prof_stats_t *p_stats)
+{
+    uint32_t k, seen = 0;
+
+    for (k = 0; k < BEACON_PROF_BUCKETS; k++)
+    {
+        seen += p_stats->hist[k];
+        if ((uint64_t)seen * 100 >= (uint64_t)p_stats->count * 99)
+        {
+            break;
+        }
+    }
+    return k ? (1ull << k) : 0;
+}
+
+/*
+ * Prints the probes that have samples
+ */
+static void bench_print_prof(void)
+{
+    beacon_prof_stats_t stats;
+    uint32_t probe;
+
+    printf("\n%-48s %10s %10s %10s %10s %10s\n", "probe (" BEACON_PROF_UNIT ")", "count", "min", "mean", "p99 <", "max");
+    for (probe = 0; probe < BEACON_PROBE_CNT; probe++)
+    {
+        beacon_prof_get((beacon_probe_t)probe, &stats);
+        if (stats.count)
+        {
+            printf("%-48s %10u %10u %10.0f %10llu %10u\n", beacon_prof_name((beacon_probe_t)probe), stats.count,
+                   stats.min, (double)stats.sum / stats.count, (unsigned long long)bench_prof_p99(&stats), stats.max);
+        }
+    }
+}
+
+/*
+ * Each thread composes UID + TLM frames that carry its id, then checks them.
+ * No locks: every thread owns its context and buffer.
+ */
+static void *bench_parallel_thread(void *arg)
+{
+    bench_thread_t           *p_thread = (bench_thread_t *)arg;
+    wiced_bt_beacon_encoder_t enc;
+    uint8_t                   adv_data[WICED_BT_BEACON_ADV_DATA_MAX * 2];
+    uint8_t                   instance[EDDYSTONE_UID_INSTANCE_ID_LEN] = { 0 };
+    uint32_t                  i;
+
+    instance[0] = (uint8_t)p_thread->id;
+    for (i = 0; i < p_thread->iterations; i++)
+    {
+        instance[5] = (uint8_t)i;
+        wiced_bt_beacon_encoder_init(&enc, adv_data, sizeof(adv_data));
+        wiced_bt_beacon_encoder_put_flags(&enc, WICED_BT_BEACON_FLAGS);
+        wiced_bt_eddystone_put_uuid_list(&enc);
+        wiced_bt_eddystone_put_uid(&enc, 0xf0, bench_namespace, instance);
+        wiced_bt_eddystone_put_tlm_unencrypted(&enc, 10, 15, i, p_thread->id);
+
+        if (wiced_bt_beacon_encoder_len(&enc) != 31 + 18 ||
+            adv_data[EDDYSTONE_ADV_HDR_LEN + 2 + EDDYSTONE_UID_NAMESPACE_LEN] != (uint8_t)p_thread->id ||
+            adv_data[EDDYSTONE_ADV_HDR_LEN + 2 + EDDYSTONE_UID_NAMESPACE_LEN + 5] != (uint8_t)i ||
+            adv_data[31 + 14] != (uint8_t)p_thread->id)
+        {
+            p_thread->mismatches++;
+        }
+    }
+    return NULL;
+}
+
+static void bench_run_parallel(uint32_t iterations)
+{
+    bench_thread_t threads[BENCH_THREADS];
+    uint64_t       start, elapsed;
+    uint32_t       i, mismatches = 0;
+
+    start = bench_now_ns();
+    for (i = 0; i < BENCH_THREADS; i++)
+    {
+        threads[i].id         = i + 1;
+        threads[i].iterations = iterations;
+        threads[i].mismatches = 0;
+        pthread_create(&threads[i].thread, NULL, bench_parallel_thread, &threads[i]);
+    }
+    for (i = 0; i < BENCH_THREADS; i++)
+    {
+        pthread_join(threads[i].thread, NULL);
+        mismatches += threads[i].mismatches;
+    }
+    elapsed = bench_now_ns() - start;
+
+    printf("\n%-48s %10s %12s %8s\n", "parallel encode", "Mframes/s", "threads", "errors");
+    printf("%-48s %10.2f %12u %8u\n", "flags + uuid list + UID + TLM",
+           (double)iterations * BENCH_THREADS * 1000.0 / elapsed, BENCH_THREADS, mismatches);
+    BENCH_CHECK(mismatches == 0);
+}
+
+/*
+ * Sets bit 0, 1 or 2 of *p_seen if adv data is the encoder output of the
+ * application's iBeacon, UID or URL sample values
+ */
+static void bench_find_static_frame(const uint8_t *p_data, uint16_t len, uint32_t *p_seen)
+{
+    uint8_t url[EDDYSTONE_URL_VALUE_MAX_LEN], url_adv[WICED_BT_BEACON_ADV_DATA_MAX];
+    uint8_t scheme, url_len;
+    uint16_t url_adv_len;
+
+    BENCH_CHECK(wiced_bt_eddystone_compress_url("http://www.infineon.com", &scheme, url, &url_len));
+    url_adv_len = wiced_bt_eddystone_encode_url(0x01, scheme, url, url_len, url_adv, sizeof(url_adv));
+
+    if (len == sizeof(bench_expected_ibeacon) && memcmp(p_data, bench_expected_ibeacon, len) == 0)
+    {
+        *p_seen |= 1;
+    }
+    else if (len == sizeof(bench_expected_uid) && memcmp(p_data, bench_expected_uid, len) == 0)
+    {
+        *p_seen |= 2;
+    }
+    else if (len == url_adv_len && memcmp(p_data, url_adv, len) == 0)
+    {
+        *p_seen |= 4;
+    }
+}
+
+static void bench_run_rotation(uint32_t rotations)
+{
+    beacon_cache_stats_t stats;
+    beacon_ctrl_stats_t  ctrl0, ctrl1;
+    uint64_t start, elapsed, drain_ns;
+    uint32_t cmds, seen = 0;
+    uint16_t len;
+    uint8_t  handle, sec;
+    beacon_log_stats_t log0, log1;
+    beacon_prof_stats_t prof;
+
+    application_start();
+    host_stub_bt_enable();
+
+    host_stub_reset_counters();
+    beacon_prof_reset();
+    beacon_ctrl_get_stats(&ctrl0);
+    beacon_log_get_stats(&log0);
+    start = bench_now_ns();
+    host_stub_advance_ms(rotations * 1000);
+    elapsed = bench_now_ns() - start;
+    beacon_ctrl_get_stats(&ctrl1);
+
+    // the log thread formats after the rotation, count only the BT thread
+    drain_ns = host_stub_log_drain_ns();
+    elapsed -= drain_ns;
+
+    cmds = host_stub_counters.set_ext_adv_parameters + host_stub_counters.set_ext_adv_random_address +
+           host_stub_counters.set_ext_adv_data + host_stub_counters.start_ext_adv + host_stub_counters.stop_ext_adv;
+
+    printf("\n%-48s %10s %12s %8s\n", "rotation", "ns/rot", "memcpy B/rot", "cmds/rot");
+    printf("%-48s %10.1f %12.1f %8.2f\n", "beacon_switch_adv",
+           (double)elapsed / rotations,
+           (double)host_copy_bytes / rotations,
+           (double)cmds / rotations);
+    printf("  set_params %.2f  set_addr %.2f  set_data %.2f  start %.2f  stop %.2f  adv data B %.1f\n",
+           (double)host_stub_counters.set_ext_adv_parameters / rotations,
+           (double)host_stub_counters.set_ext_adv_random_address / rotations,
+           (double)host_stub_counters.set_ext_adv_data / rotations,
+           (double)host_stub_counters.start_ext_adv / rotations,
+           (double)host_stub_counters.stop_ext_adv / rotations,
+           (double)host_stub_counters.adv_data_bytes / rotations);
+
+    printf("  apply layer per rotation: skipped params %.2f  addr %.2f  data %.2f  sets per enable %.2f\n",
+           (double)(ctrl1.params_skipped - ctrl0.params_skipped) / rotations,
+           (double)(ctrl1.addr_skipped - ctrl0.addr_skipped) / rotations,
+           (double)(ctrl1.data_skipped - ctrl0.data_skipped) / rotations,
+           (ctrl1.enable_cmds - ctrl0.enable_cmds) ?
+           (double)(ctrl1.sets_enabled - ctrl0.sets_enabled) / (ctrl1.enable_cmds - ctrl0.enable_cmds) : 0.0);
+    beacon_log_get_stats(&log1);
+    printf("  deferred log: records %.2f  drain %.1f ns/rot on the log thread  drops %u\n",
+           (double)host_stub_counters.log_records / rotations, (double)drain_ns / rotations, log1.drops - log0.drops);
+    BENCH_CHECK(log1.drops == log0.drops);
+    BENCH_CHECK(host_stub_counters.disallowed == 0);
+    BENCH_CHECK(ctrl1.commits - ctrl0.commits == rotations);
+
+    // TLM on air must carry the latest second count
+    for (handle = 1; handle <= wiced_bt_ble_read_num_ext_adv_sets(); handle++)
+    {
+        const uint8_t *p_data = host_stub_adv_data(handle, &len);
+
+        if (host_stub_adv_enabled(handle) && len > EDDYSTONE_TLM_SEC_CNT_OFFSET &&
+            p_data[EDDYSTONE_ADV_HDR_LEN] == EDDYSTONE_FRAME_TYPE_TLM)
+        {
+            const uint8_t *p = &p_data[EDDYSTONE_TLM_SEC_CNT_OFFSET];
+            BENCH_CHECK((uint32_t)(p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24)) == rotations);
+        }
+    }
+
+    beacon_cache_get_stats(&stats);
+    printf("  payload cache hits %u  misses %u  (%.1f%% hit)\n", stats.hits, stats.misses,
+           100.0 * stats.hits / (stats.hits + stats.misses));
+    printf("  static payloads: %.2f set_data/rot sent from flash, not encoded or copied\n",
+           (double)(ctrl1.data_static - ctrl0.data_static) / rotations);
+    BENCH_CHECK(ctrl1.data_static > ctrl0.data_static);
+
+    bench_print_prof();
+    beacon_prof_get(BEACON_PROBE_SWITCH_ADV, &prof);
+    BENCH_CHECK(prof.count == rotations);
+
+    // the static payloads on air are byte for byte what the encoders produce
+    for (sec = 0; sec < 10 && seen != 7; sec++)
+    {
+        for (handle = 1; handle <= wiced_bt_ble_read_num_ext_adv_sets(); handle++)
+        {
+            const uint8_t *p_data = host_stub_adv_data(handle, &len);
+
+            if (p_data != NULL && host_stub_adv_enabled(handle))
+            {
+                bench_find_static_frame(p_data, len, &seen);
+            }
+        }
+        host_stub_advance_ms(1000);
+    }
+    BENCH_CHECK(seen == 7);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t iterations = bench_iterations(argc, argv, BENCH_DEFAULT_ITERATIONS);
+
+    printf("Beacon encoder benchmark, %u iterations\n\n", iterations);
+    bench_run_encoders(iterations);
+    bench_run_tlm_patch(iterations);
+    bench_run_adv_set(iterations);
+    bench_run_log(iterations);
+    bench_run_prof(iterations);
+    bench_run_parallel(iterations);
+    bench_run_rotation(iterations / 100 ? iterations / 100 : 1);
+    return 0;
+}
@@ -0,0 +1,51 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Timing helpers shared by the host benchmarks.
+*/
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Default iteration count, overridden by the first command line argument */
+#define BENCH_DEFAULT_ITERATIONS    1000000
+
+static inline uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint32_t bench_iterations(int argc, char *argv[], uint32_t def)
+{
+    if (argc > 1)
+    {
+        long n = strtol(argv[1], NULL, 0);
+        if (n > 0)
+        {
+            return (uint32_t)n;
+        }
+    }
+    return def;
+}
+
+/* Aborts the benchmark when a self-check fails */
+#define BENCH_CHECK(cond)                                                       \
+    do {                                                                        \
+        if (!(cond))                                                            \
+        {                                                                       \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            exit(1);                                                            \
+        }                                                                       \
+    } while (0)
+
+#endif /* BENCH_UTIL_H */
@@ -0,0 +1,458 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host benchmark of the gateway beacon frame decoder.
+*
+* Round trip: random iBeacon and Eddystone frames are encoded with the beacon
+* library, legacy one per report and extended several per report, decoded
+* again and every field compared. Encoded URLs are also expanded back to the
+* string they were compressed from. Truncated and foreign AD structures must
+* be counted, not decoded. The application is run on the stub and every
+* beacon kind it advertises must decode from the adv data on air.
+*
+* Throughput: a batch of mixed legacy reports is decoded over and over, on
+* one thread and then on one thread per core, each with its own batch and
+* frame array, and the frames per second per core are reported.
+*
+* Usage: decode_bench [iterations]
+*/
+#include "wiced_bt_beacon.h"
+#include "host_stub.h"
+#include "beacon.h"
+#include "beacon_decode.h"
+#include "bench_util.h"
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+/* Reports of the round trip and of one throughput batch */
+#define DECODE_BENCH_ROUND_TRIPS    20000
+#define DECODE_BENCH_BATCH_REPORTS  1024
+
+/* Largest batch buffer, every record a length byte and legacy adv data */
+#define DECODE_BENCH_BATCH_SIZE     (DECODE_BENCH_BATCH_REPORTS * (1 + WICED_BT_BEACON_ADV_DATA_MAX))
+
+/* Most threads of the parallel run */
+#define DECODE_BENCH_THREADS_MAX    16
+
+/* Beacon kinds the application advertises and the seconds to watch it */
+#define DECODE_BENCH_APP_KINDS      5
+#define DECODE_BENCH_APP_SECONDS    30
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint8_t  buf[DECODE_BENCH_BATCH_SIZE];
+    uint32_t len;
+    uint32_t reports;
+    beacon_decode_frame_t frames[DECODE_BENCH_BATCH_REPORTS + BEACON_DECODE_REPORT_FRAMES_MAX];
+} decode_bench_batch_t;
+
+typedef struct
+{
+    pthread_t             thread;
+    uint32_t              iterations;
+    uint64_t              frames;
+    uint64_t              ns;
+    decode_bench_batch_t *p_batch;
+} decode_bench_thread_t;
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+static uint32_t decode_bench_seed = 0x9e3779b9u;
+
+static decode_bench_batch_t decode_bench_batches[DECODE_BENCH_THREADS_MAX];
+
+/* Sink so the compiler keeps the timed work */
+static volatile uint32_t decode_bench_sink;
+
+/******************************************************************************
+ *                          Private Function Definitions
+ ******************************************************************************/
+
+static uint32_t decode_bench_rand(void)
+{
+    decode_bench_seed ^= decode_bench_seed << 13;
+    decode_bench_seed ^= decode_bench_seed >> 17;
+    decode_bench_seed ^= decode_bench_seed << 5;
+    return decode_bench_seed;
+}
+
+static void decode_bench_rand_bytes(uint8_t *p, uint32_t len)
+{
+    while (len-- > 0)
+    {
+        *p++ = (uint8_t)decode_bench_rand();
+    }
+}
+
+/*
+ * Builds a random URL that compresses
+ */
+static void decode_bench_rand_url(char *p_url)
+{
+    static const char *const schemes[] = { "http://www.", "https://www.", "http://", "https://" };
+    static const char *const tlds[] = { ".com", ".org/", ".net", ".info/", ".io", "" };
+    uint32_t n = 1 + decode_bench_rand() % 8;
+
+    p_url += sprintf(p_url, "%s", schemes[decode_bench_rand() % 4]);
+    while (n-- > 0)
+    {
+        *p_url++ = (char)('a' + decode_bench_rand() % 26);
+    }
+    sprintf(p_url, "%s", tlds[decode_bench_rand() % 6]);
+}
+
+/*
+ * Encodes a random frame of a kind with the library, and sets the frame the
+ * decoder must return for it
+ */
+static wiced_bool_t decode_bench_put(wiced_bt_beacon_encoder_t *p_enc, uint8_t kind, beacon_decode_frame_t *p_expected)
+{
+    beacon_decode_frame_t *p = p_expected;
+    char url[BEACON_DECODE_URL_STRING_MAX];
+
+    memset(p, 0, sizeof(*p));
+    p->kind = kind;
+    p->tx_power = (int8_t)decode_bench_rand();
+    switch (kind)
+    {
+    case BEACON_DECODE_IBEACON:
+        decode_bench_rand_bytes(p->u.ibeacon.uuid, BEACON_DECODE_UUID_LEN);
+        p->u.ibeacon.major = (uint16_t)decode_bench_rand();
+        p->u.ibeacon.minor = (uint16_t)decode_bench_rand();
+        return wiced_bt_ibeacon_put(p_enc, p->u.ibeacon.uuid, p->u.ibeacon.major, p->u.ibeacon.minor,
+                                    (uint8_t)p->tx_power);
+
+    case BEACON_DECODE_EDDYSTONE_UID:
+        decode_bench_rand_bytes(p->u.uid.namespace_id, BEACON_DECODE_NAMESPACE_LEN);
+        decode_bench_rand_bytes(p->u.uid.instance, BEACON_DECODE_INSTANCE_LEN);
+        return wiced_bt_eddystone_put_uid(p_enc, (uint8_t)p->tx_power, p->u.uid.namespace_id, p->u.uid.instance);
+
+    case BEACON_DECODE_EDDYSTONE_URL:
+        decode_bench_rand_url(url);
+        BENCH_CHECK(wiced_bt_eddystone_compress_url(url, &p->u.url.scheme, p->u.url.encoded, &p->u.url.len));
+        return wiced_bt_eddystone_put_url(p_enc, (uint8_t)p->tx_power, p->u.url.scheme, p->u.url.encoded,
+                                          p->u.url.len);
+
+    case BEACON_DECODE_EDDYSTONE_TLM:
+        p->tx_power = 0;
+        p->u.tlm.vbatt = (uint16_t)decode_bench_rand();
+        p->u.tlm.temp = (uint16_t)decode_bench_rand();
+        p->u.tlm.adv_cnt = decode_bench_rand();
+        p->u.tlm.sec_cnt = decode_bench_rand();
+        return wiced_bt_eddystone_put_tlm_unencrypted(p_enc, p->u.tlm.vbatt, p->u.tlm.temp, p->u.tlm.adv_cnt,
+                                                      p->u.tlm.sec_cnt);
+
+    case BEACON_DECODE_EDDYSTONE_ETLM:
+        p->tx_power = 0;
+        decode_bench_rand_bytes(p->u.etlm.etlm, BEACON_DECODE_ETLM_LEN);
+        p->u.etlm.salt = (uint16_t)decode_bench_rand();
+        p->u.etlm.mic = (uint16_t)decode_bench_rand();
+        return wiced_bt_eddystone_put_tlm_encrypted(p_enc, p->u.etlm.etlm, p->u.etlm.salt, p->u.etlm.mic);
+
+    default:
+        decode_bench_rand_bytes(p->u.eid, BEACON_DECODE_EID_LEN);
+        return wiced_bt_eddystone_put_eid(p_enc, (uint8_t)p->tx_power, p->u.eid);
+    }
+}
+
+/*
+ * Returns whether a decoded frame carries the fields of the expected one
+ */
+static wiced_bool_t decode_bench_same(const beacon_decode_frame_t *p_frame, const beacon_decode_frame_t *p_expected)
+{
+    if (p_frame->kind != p_expected->kind || p_frame->tx_power != p_expected->tx_power)
+    {
+        return WICED_FALSE;
+    }
+    switch (p_frame->kind)
+    {
+    case BEACON_DECODE_IBEACON:
+        return memcmp(&p_frame->u.ibeacon, &p_expected->u.ibeacon, sizeof(p_frame->u.ibeacon)) == 0;
+    case BEACON_DECODE_EDDYSTONE_UID:
+        return memcmp(&p_frame->u.uid, &p_expected->u.uid, sizeof(p_frame->u.uid)) == 0;
+    case BEACON_DECODE_EDDYSTONE_URL:
+        return p_frame->u.url.scheme == p_expected->u.url.scheme && p_frame->u.url.len == p_expected->u.url.len &&
+               memcmp(p_frame->u.url.encoded, p_expected->u.url.encoded, p_frame->u.url.len) == 0;
+    case BEACON_DECODE_EDDYSTONE_TLM:
+        return memcmp(&p_frame->u.tlm, &p_expected->u.tlm, sizeof(p_frame->u.tlm)) == 0;
+    case BEACON_DECODE_EDDYSTONE_ETLM:
+        return memcmp(&p_frame->u.etlm, &p_expected->u.etlm, sizeof(p_frame->u.etlm)) == 0;
+    case BEACON_DECODE_EDDYSTONE_EID:
+        return memcmp(p_frame->u.eid, p_expected->u.eid, BEACON_DECODE_EID_LEN) == 0;
+    }
+    return WICED_FALSE;
+}
+
+/*
+ * Encodes a legacy report of one random frame, with the Flags and, for
+ * Eddystone, the UUID list the library puts in front
+ */
+static uint16_t decode_bench_legacy_report(uint8_t *p_buf, beacon_decode_frame_t *p_expected)
+{
+    wiced_bt_beacon_encoder_t enc;
+    uint8_t kind = (uint8_t)(BEACON_DECODE_IBEACON + decode_bench_rand() % (BEACON_DECODE_KINDS - 1));
+
+    wiced_bt_beacon_encoder_init(&enc, p_buf, WICED_BT_BEACON_ADV_DATA_MAX);
+    wiced_bt_beacon_encoder_put_flags(&enc, WICED_BT_BEACON_FLAGS);
+    if (kind != BEACON_DECODE_IBEACON)
+    {
+        wiced_bt_eddystone_put_uuid_list(&enc);
+    }
+    BENCH_CHECK(decode_bench_put(&enc, kind, p_expected));
+    p_expected->flags = WICED_BT_BEACON_FLAGS;
+    return wiced_bt_beacon_encoder_len(&enc);
+}
+
+/*
+ * Encodes reports and decodes them again, one frame per legacy report and
+ * several per extended report
+ */
+static void decode_bench_round_trip(void)
+{
+    static uint8_t buf[DECODE_BENCH_ROUND_TRIPS * (1 + WICED_BT_BEACON_EXT_ADV_DATA_MAX)];
+    static beacon_decode_frame_t expected[DECODE_BENCH_ROUND_TRIPS * BEACON_DECODE_REPORT_FRAMES_MAX];
+    static beacon_decode_frame_t frames[DECODE_BENCH_ROUND_TRIPS * BEACON_DECODE_REPORT_FRAMES_MAX];
+    wiced_bt_beacon_encoder_t enc;
+    beacon_decode_stats_t stats;
+    char url[BEACON_DECODE_URL_STRING_MAX], expanded[BEACON_DECODE_URL_STRING_MAX];
+    uint32_t pos = 0, n_expected = 0, n, i, k;
+    uint8_t scheme, len;
+
+    for (i = 0; i < DECODE_BENCH_ROUND_TRIPS; i++)
+    {
+        if (i % 4 != 3)
+        {
+            buf[pos] = (uint8_t)decode_bench_legacy_report(&buf[pos + 1], &expected[n_expected]);
+            expected[n_expected++].report = i;
+        }
+        else
+        {
+            // extended adv data: frames of every kind until one does not fit
+            wiced_bt_beacon_encoder_init(&enc, &buf[pos + 1], WICED_BT_BEACON_EXT_ADV_DATA_MAX);
+            wiced_bt_beacon_encoder_put_flags(&enc, WICED_BT_BEACON_FLAGS);
+            wiced_bt_eddystone_put_uuid_list(&enc);
+            for (k = 0; k < BEACON_DECODE_REPORT_FRAMES_MAX; k++)
+            {
+                if (!decode_bench_put(&enc, (uint8_t)(1 + decode_bench_rand() % (BEACON_DECODE_KINDS - 1)),
+                                      &expected[n_expected]))
+                {
+                    break;
+                }
+                expected[n_expected].flags = WICED_BT_BEACON_FLAGS;
+                expected[n_expected++].report = i;
+            }
+            buf[pos] = (uint8_t)enc.len;
+        }
+        pos += 1 + buf[pos];
+    }
+
+    n = beacon_decode_batch(buf, pos, frames, sizeof(frames) / sizeof(frames[0]), &stats);
+    BENCH_CHECK(stats.consumed == pos && stats.reports == DECODE_BENCH_ROUND_TRIPS);
+    BENCH_CHECK(stats.malformed == 0 && stats.dropped == 0);
+    BENCH_CHECK(n == n_expected);
+    for (i = 0; i < n; i++)
+    {
+        BENCH_CHECK(frames[i].report == expected[i].report && frames[i].flags == expected[i].flags);
+        BENCH_CHECK(decode_bench_same(&frames[i], &expected[i]));
+    }
+
+    // expanding an encoded URL gives back the string it was compressed from
+    for (i = 0; i < 1000; i++)
+    {
+        decode_bench_rand_url(url);
+        BENCH_CHECK(wiced_bt_eddystone_compress_url(url, &scheme, frames[0].u.url.encoded, &len));
+        frames[0].u.url.scheme = scheme;
+        frames[0].u.url.len = len;
+        BENCH_CHECK(beacon_decode_url_string(&frames[0].u.url, expanded));
+        BENCH_CHECK(strcmp(url, expanded) == 0);
+    }
+
+    printf("round trip: %u reports, %u frames, %u AD structures decoded and checked\n",
+           stats.reports, n, stats.ads);
+}
+
+/*
+ * Checks that truncated and foreign AD structures are not decoded
+ */
+static void decode_bench_malformed(void)
+{
+    beacon_decode_frame_t frames[BEACON_DECODE_REPORT_FRAMES_MAX], expected;
+    beacon_decode_stats_t stats;
+    beacon_decode_ad_t ads[8];
+    uint8_t report[WICED_BT_BEACON_ADV_DATA_MAX];
+    uint16_t len;
+    int ok;
+
+    // the AD structures of a library frame
+    len = decode_bench_legacy_report(report, &expected);
+    BENCH_CHECK(beacon_decode_ads(report, len, ads, 8, &ok) == (expected.kind == BEACON_DECODE_IBEACON ? 2 : 3));
+    BENCH_CHECK(ok && ads[0].type == BTM_BLE_ADVERT_TYPE_FLAG && ads[0].len == 1 && ads[0].offset == 2);
+
+    // one byte short: the last AD structure overruns the report
+    memset(&stats, 0, sizeof(stats));
+    BENCH_CHECK(beacon_decode_report(report, len - 1, 0, frames, &stats) == 0);
+    BENCH_CHECK(stats.malformed == 1);
+    BENCH_CHECK(beacon_decode_ads(report, len - 1, ads, 8, &ok) >= 1 && !ok);
+
+    // a frame of the right kind but the wrong length, and a foreign company ID
+    memset(&stats, 0, sizeof(stats));
+    len = (uint16_t)wiced_bt_eddystone_encode_eid(0, expected.u.eid, report, sizeof(report));
+    report[len - (2 + LEN_UUID_16 + EDDYSTONE_EID_FRAME_LEN)]--;
+    BENCH_CHECK(beacon_decode_report(report, len - 1, 0, frames, &stats) == 0 && stats.malformed == 0);
+    len = (uint16_t)wiced_bt_ibeacon_encode(expected.u.eid, 1, 2, 3, report, sizeof(report));
+    report[WICED_BT_BEACON_FLAGS_AD_LEN + 2] ^= 1;
+    BENCH_CHECK(beacon_decode_report(report, len, 0, frames, &stats) == 0);
+    BENCH_CHECK(stats.frames[BEACON_DECODE_NONE] == 5);
+}
+
+/*
+ * Runs the application and decodes what it advertises
+ */
+static void decode_bench_run_app(void)
+{
+    static const char sample_url[] = "http://www.infineon.com";
+    beacon_decode_frame_t frames[BEACON_DECODE_REPORT_FRAMES_MAX];
+    beacon_decode_stats_t stats;
+    char url[BEACON_DECODE_URL_STRING_MAX];
+    const uint8_t *p_data;
+    uint32_t seen = 0, n, i;
+    uint16_t len;
+    uint8_t set, sec;
+
+    application_start();
+    host_stub_bt_enable();
+    memset(&stats, 0, sizeof(stats));
+
+    for (sec = 0; sec < DECODE_BENCH_APP_SECONDS; sec++)
+    {
+        for (set = 1; set <= HOST_STUB_MAX_ADV_SETS; set++)
+        {
+            p_data = host_stub_adv_data(set, &len);
+            if (p_data == NULL || !host_stub_adv_enabled(set))
+            {
+                continue;
+            }
+            n = beacon_decode_report(p_data, len, set, frames, &stats);
+            for (i = 0; i < n; i++)
+            {
+                seen |= 1u << frames[i].kind;
+                if (frames[i].kind == BEACON_DECODE_EDDYSTONE_URL)
+                {
+                    BENCH_CHECK(beacon_decode_url_string(&frames[i].u.url, url));
+                    BENCH_CHECK(strcmp(url, sample_url) == 0);
+                }
+            }
+        }
+        host_stub_advance_ms(1000);
+    }
+    BENCH_CHECK(stats.malformed == 0);
+    BENCH_CHECK(__builtin_popcount(seen) == DECODE_BENCH_APP_KINDS);
+    printf("application: %u beacon kinds decoded from %u reports on air\n\n", DECODE_BENCH_APP_KINDS,
+           stats.reports);
+}
+
+/*
+ * Fills a throughput batch with random legacy reports
+ */
+static void decode_bench_fill_batch(decode_bench_batch_t *p_batch)
+{
+    beacon_decode_frame_t expected;
+    uint32_t i;
+
+    p_batch->len = 0;
+    for (i = 0; i < DECODE_BENCH_BATCH_REPORTS; i++)
+    {
+        p_batch->buf[p_batch->len] = (uint8_t)decode_bench_legacy_report(&p_batch->buf[p_batch->len + 1], &expected);
+        p_batch->len += 1 + p_batch->buf[p_batch->len];
+    }
+    p_batch->reports = DECODE_BENCH_BATCH_REPORTS;
+}
+
+/*
+ * Decodes one batch over and over
+ */
+static void *decode_bench_thread(void *p_arg)
+{
+    decode_bench_thread_t *p_thread = (decode_bench_thread_t *)p_arg;
+    decode_bench_batch_t *p_batch = p_thread->p_batch;
+    beacon_decode_stats_t stats;
+    uint64_t t0 = bench_now_ns();
+    uint32_t i;
+
+    for (i = 0; i < p_thread->iterations; i++)
+    {
+        p_thread->frames += beacon_decode_batch(p_batch->buf, p_batch->len, p_batch->frames,
+                                                sizeof(p_batch->frames) / sizeof(p_batch->frames[0]), &stats);
+        decode_bench_sink = p_batch->frames[i % DECODE_BENCH_BATCH_REPORTS].u.tlm.sec_cnt;
+    }
+    p_thread->ns = bench_now_ns() - t0;
+    return NULL;
+}
+
+/*
+ * Times the decoder on one thread and on one thread per core
+ */
+static void decode_bench_run(uint32_t iterations)
+{
+    decode_bench_thread_t threads[DECODE_BENCH_THREADS_MAX];
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t n_threads = (cores < 1) ? 1 : (cores > DECODE_BENCH_THREADS_MAX) ? DECODE_BENCH_THREADS_MAX : (uint32_t)cores;
+    uint32_t batches = iterations / DECODE_BENCH_BATCH_REPORTS + 1;
+    uint64_t frames = 0, ns = 0;
+    uint32_t i;
+
+    for (i = 0; i < n_threads; i++)
+    {
+        decode_bench_fill_batch(&decode_bench_batches[i]);
+    }
+
+    memset(threads, 0, sizeof(threads));
+    threads[0].iterations = batches;
+    threads[0].p_batch = &decode_bench_batches[0];
+    decode_bench_thread(&threads[0]);
+    BENCH_CHECK(threads[0].frames == (uint64_t)batches * DECODE_BENCH_BATCH_REPORTS);
+    printf("%-36s %10.1f ns  %7.2f M frames/s\n", "decode, 1 thread", (double)threads[0].ns / threads[0].frames,
+           (double)threads[0].frames * 1000.0 / (double)threads[0].ns);
+
+    memset(threads, 0, sizeof(threads));
+    for (i = 0; i < n_threads; i++)
+    {
+        threads[i].iterations = batches;
+        threads[i].p_batch = &decode_bench_batches[i];
+        pthread_create(&threads[i].thread, NULL, decode_bench_thread, &threads[i]);
+    }
+    for (i = 0; i < n_threads; i++)
+    {
+        pthread_join(threads[i].thread, NULL);
+        frames += threads[i].frames;
+        ns += threads[i].ns;
+    }
+    BENCH_CHECK(frames == (uint64_t)n_threads * batches * DECODE_BENCH_BATCH_REPORTS);
+    printf("%-36s %10.1f ns  %7.2f M frames/s per core, %u threads\n", "decode, thread per core",
+           (double)ns / frames, (double)frames * 1000.0 / (double)ns, n_threads);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t iterations = bench_iterations(argc, argv, BENCH_DEFAULT_ITERATIONS);
+
+    decode_bench_round_trip();
+    decode_bench_malformed();
+    decode_bench_run_app();
+
+    printf("Beacon decoder benchmark, %u frames per thread, batches of %u reports\n\n", iterations,
+           DECODE_BENCH_BATCH_REPORTS);
+    decode_bench_run(iterations);
+    return 0;
+}
@@ -0,0 +1,361 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host benchmark of the Eddystone-EID rotation engine.
+*
+* Checks the AES-128 block against the FIPS-197 example and the EID against
+* reference values computed with OpenSSL, then reports:
+*  - AES key expansion and block encryption
+*  - identifiers per second computed from scratch (both key schedules)
+*  - identifiers per second of the refill, which keeps the key schedules
+*  - the rotation side: the cost of beacon_eid_get() when the period is
+*    unchanged, when it takes a precomputed identifier and when it misses
+*
+* Every identifier the rotation serves must match one computed from scratch.
+* The application is also run on the stub for two EID periods, the EID frame
+* on air must carry the identifier of the second period. It is then booted
+* twice, each boot in its own process, with a time checkpoint store that
+* outlives them: the second boot must resume the time counter past the
+* periods of the first and send the identifier of that period.
+*
+* Usage: eid_bench [iterations]
+*/
+#include "host_stub.h"
+#include "beacon.h"
+#include "beacon_aes.h"
+#include "beacon_eid.h"
+#include "bench_util.h"
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+/* Rotation exponent and identity key of the application, see beacon.c */
+#define EID_BENCH_APP_EXPONENT      10
+#define EID_BENCH_APP_KEY           0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, \
+                                    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+
+/* Eddystone UUID and EID frame type heading the identifier in the adv data */
+#define EID_BENCH_FRAME_HDR         0xaa, 0xfe, 0x30
+#define EID_BENCH_FRAME_HDR_LEN     3
+#define EID_BENCH_FRAME_EID_OFFSET  (EID_BENCH_FRAME_HDR_LEN + 1)
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+static const uint8_t eid_bench_key[BEACON_AES_KEY_LEN] = { EID_BENCH_APP_KEY };
+
+/* Sink so the compiler keeps the timed work */
+static volatile uint8_t eid_bench_sink;
+
+/* Time checkpoint of the simulated boots, valid flag and value, shared with the child processes */
+static uint32_t *eid_bench_nv;
+
+/******************************************************************************
+ *                          Private Function Definitions
+ ******************************************************************************/
+
+/*
+ * Checks AES and EID against known answers
+ */
+static void eid_bench_known_answers(void)
+{
+    static const uint8_t fips_key[BEACON_AES_KEY_LEN] =
+        { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f };
+    static const uint8_t fips_pt[BEACON_AES_BLOCK_LEN] =
+        { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff };
+    static const uint8_t fips_ct[BEACON_AES_BLOCK_LEN] =
+        { 0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a };
+    static const uint8_t eid_0[EDDYSTONE_EID_LEN] =
+        { 0x74, 0x1c, 0xa0, 0xb4, 0x3f, 0x6b, 0xdd, 0x09 };
+    static const uint8_t eid_1a2b3[EDDYSTONE_EID_LEN] =
+        { 0x16, 0x1e, 0x24, 0x00, 0x2a, 0xb0, 0x2e, 0x5c };
+    beacon_aes_ctx_t ctx;
+    uint8_t block[BEACON_AES_BLOCK_LEN];
+    uint8_t eid[EDDYSTONE_EID_LEN];
+
+    beacon_aes_set_key(&ctx, fips_key);
+    beacon_aes_encrypt(&ctx, fips_pt, block);
+    BENCH_CHECK(memcmp(block, fips_ct, sizeof(block)) == 0);
+
+    // counter 0x1a2b3 also checks the temporary key of a non-zero counter >> 16
+    beacon_eid_compute(eid_bench_key, EID_BENCH_APP_EXPONENT, 0, eid);
+    BENCH_CHECK(memcmp(eid, eid_0, sizeof(eid)) == 0);
+    beacon_eid_compute(eid_bench_key, EID_BENCH_APP_EXPONENT, 0x1a2b3, eid);
+    BENCH_CHECK(memcmp(eid, eid_1a2b3, sizeof(eid)) == 0);
+}
+
+/*
+ * Returns the EID of the EID frame in adv data, NULL if there is none
+ */
+static const uint8_t *eid_bench_find_frame(const uint8_t *p_data, uint16_t len)
+{
+    static const uint8_t hdr[EID_BENCH_FRAME_HDR_LEN] = { EID_BENCH_FRAME_HDR };
+    uint16_t i;
+
+    for (i = 0; i + EID_BENCH_FRAME_EID_OFFSET + EDDYSTONE_EID_LEN <= len; i++)
+    {
+        if (memcmp(&p_data[i], hdr, sizeof(hdr)) == 0)
+        {
+            return &p_data[i + EID_BENCH_FRAME_EID_OFFSET];
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Reads the checkpoint of the simulated boots
+ */
+static wiced_bool_t eid_bench_nv_load(uint32_t *p_checkpoint)
+{
+    if (!eid_bench_nv[0])
+    {
+        return WICED_FALSE;
+    }
+    *p_checkpoint = eid_bench_nv[1];
+    return WICED_TRUE;
+}
+
+/*
+ * Writes the checkpoint of the simulated boots
+ */
+static wiced_bool_t eid_bench_nv_save(uint32_t checkpoint)
+{
+    eid_bench_nv[0] = 1;
+    eid_bench_nv[1] = checkpoint;
+    return WICED_TRUE;
+}
+
+static const beacon_time_store_t eid_bench_nv_store = { eid_bench_nv_load, eid_bench_nv_save };
+
+/*
+ * Returns the EID on air within 8 s, NULL if the EID beacon does not come up
+ */
+static const uint8_t *eid_bench_on_air(void)
+{
+    const uint8_t *p_data, *p_eid = NULL;
+    uint16_t len;
+    uint8_t set, sec;
+
+    for (sec = 0; sec < 8 && p_eid == NULL; sec++)
+    {
+        for (set = 1; set <= HOST_STUB_MAX_ADV_SETS && p_eid == NULL; set++)
+        {
+            p_data = host_stub_adv_data(set, &len);
+            if (p_data != NULL && host_stub_adv_enabled(set))
+            {
+                p_eid = eid_bench_find_frame(p_data, len);
+            }
+        }
+        if (p_eid == NULL)
+        {
+            host_stub_advance_ms(1000);
+        }
+    }
+    return p_eid;
+}
+
+/*
+ * Runs the application into its second EID period and checks the EID on air
+ */
+static void eid_bench_run_app(void)
+{
+    uint8_t expected[EDDYSTONE_EID_LEN];
+    const uint8_t *p_eid;
+    beacon_eid_stats_t stats;
+
+    application_start();
+    host_stub_bt_enable();
+
+    // half way into the second period, the EID beacon is on air within a few seconds
+    host_stub_advance_ms((1u << EID_BENCH_APP_EXPONENT) * 1500u);
+    beacon_eid_compute(eid_bench_key, EID_BENCH_APP_EXPONENT, 1u << EID_BENCH_APP_EXPONENT, expected);
+    p_eid = eid_bench_on_air();
+    BENCH_CHECK(p_eid != NULL);
+    BENCH_CHECK(memcmp(p_eid, expected, EDDYSTONE_EID_LEN) == 0);
+
+    beacon_eid_get_stats(&stats);
+    BENCH_CHECK(stats.misses == 0);
+    printf("application: %u EIDs computed ahead, %u rotations served, %u misses\n\n",
+           stats.computed, stats.served, stats.misses);
+}
+
+/*
+ * Boots the application in a child process for run_ms with the shared
+ * checkpoint store, the EID on air at the end must be that of counter
+ */
+static void eid_bench_boot(uint32_t run_ms, uint32_t counter)
+{
+    uint8_t expected[EDDYSTONE_EID_LEN];
+    const uint8_t *p_eid;
+    pid_t pid;
+    int   status;
+
+    fflush(stdout);
+    pid = fork();
+    BENCH_CHECK(pid >= 0);
+    if (pid == 0)
+    {
+        beacon_set_time_store(&eid_bench_nv_store);
+        application_start();
+        host_stub_bt_enable();
+        host_stub_advance_ms(run_ms);
+
+        beacon_eid_compute(eid_bench_key, EID_BENCH_APP_EXPONENT, counter, expected);
+        p_eid = eid_bench_on_air();
+        BENCH_CHECK(p_eid != NULL);
+        BENCH_CHECK(memcmp(p_eid, expected, EDDYSTONE_EID_LEN) == 0);
+        fflush(stdout);
+        _exit(0);
+    }
+    BENCH_CHECK(waitpid(pid, &status, 0) == pid);
+    BENCH_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+/*
+ * Boots twice: the second boot resumes the time counter at the checkpoint the
+ * first left, the start of the period after its last one
+ */
+static void eid_bench_reboot(void)
+{
+    uint32_t period = 1u << EID_BENCH_APP_EXPONENT;
+
+    eid_bench_nv = mmap(NULL, 2 * sizeof(uint32_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    BENCH_CHECK(eid_bench_nv != MAP_FAILED);
+
+    // the first boot ends in its second period, with the checkpoint at the third
+    eid_bench_boot(period * 1500u, period);
+    BENCH_CHECK(eid_bench_nv[0] && eid_bench_nv[1] == 2 * period);
+
+    eid_bench_boot(10000, 2 * period);
+    BENCH_CHECK(eid_bench_nv[0] && eid_bench_nv[1] == 3 * period);
+    printf("application: reboot resumes the time counter at %u, the EID of that period is on air\n\n",
+           2 * period);
+    munmap(eid_bench_nv, 2 * sizeof(uint32_t));
+}
+
+/*
+ * Times AES key expansion and block encryption
+ */
+static void eid_bench_run_aes(uint32_t iterations)
+{
+    beacon_aes_ctx_t ctx;
+    uint8_t block[BEACON_AES_BLOCK_LEN] = { 0 };
+    uint64_t t0, key_ns, block_ns;
+    uint32_t i;
+
+    t0 = bench_now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        block[0] = (uint8_t)i;
+        beacon_aes_set_key(&ctx, block);
+        eid_bench_sink = (uint8_t)ctx.rk[43];
+    }
+    key_ns = bench_now_ns() - t0;
+
+    t0 = bench_now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        // chained so every block waits for the one before
+        beacon_aes_encrypt(&ctx, block, block);
+    }
+    block_ns = bench_now_ns() - t0;
+    eid_bench_sink = block[0];
+
+    printf("%-36s %10.1f ns\n", "AES-128 key expansion", (double)key_ns / iterations);
+    printf("%-36s %10.1f ns  %7.1f MB/s\n", "AES-128 block", (double)block_ns / iterations,
+           (double)iterations * BEACON_AES_BLOCK_LEN * 1000.0 / (double)block_ns);
+}
+
+/*
+ * Times EIDs computed from scratch and by the refill, and the rotation side
+ */
+static void eid_bench_run_eid(uint32_t iterations)
+{
+    uint8_t eid[EDDYSTONE_EID_LEN], expected[EDDYSTONE_EID_LEN];
+    beacon_eid_stats_t before, after;
+    uint64_t t0, scratch_ns, refill_ns = 0, swap_ns = 0, same_ns, miss_ns;
+    uint32_t i, refilled = 0;
+
+    t0 = bench_now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        beacon_eid_compute(eid_bench_key, 0, i, eid);
+        eid_bench_sink = eid[0];
+    }
+    scratch_ns = bench_now_ns() - t0;
+
+    // exponent 0: a new identifier every second, one refill per rotation
+    BENCH_CHECK(beacon_eid_init(eid_bench_key, 0, 0));
+    beacon_eid_get_stats(&before);
+    for (i = 0; i < iterations; i++)
+    {
+        t0 = bench_now_ns();
+        BENCH_CHECK(beacon_eid_get(i, eid));
+        swap_ns += bench_now_ns() - t0;
+
+        t0 = bench_now_ns();
+        refilled += beacon_eid_refill();
+        refill_ns += bench_now_ns() - t0;
+    }
+    beacon_eid_get_stats(&after);
+    BENCH_CHECK(after.misses == before.misses);
+    BENCH_CHECK(after.served - before.served == iterations);
+
+    // same period, nothing to copy
+    t0 = bench_now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        eid_bench_sink = (uint8_t)beacon_eid_get(iterations - 1, eid);
+    }
+    same_ns = bench_now_ns() - t0;
+
+    // served identifiers match the ones computed from scratch
+    BENCH_CHECK(beacon_eid_init(eid_bench_key, 3, 0x12345));
+    for (i = 0; i < 4096; i++)
+    {
+        beacon_eid_refill();
+        BENCH_CHECK(beacon_eid_get(0x12345 + (i << 3), eid));
+        beacon_eid_compute(eid_bench_key, 3, 0x12345 + (i << 3), expected);
+        BENCH_CHECK(memcmp(eid, expected, sizeof(eid)) == 0);
+    }
+
+    // counter jumps past the ring without refills, every rotation misses
+    beacon_eid_get_stats(&before);
+    t0 = bench_now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        BENCH_CHECK(beacon_eid_get(0x1000000 + i * BEACON_EID_AHEAD * 8, eid));
+    }
+    miss_ns = bench_now_ns() - t0;
+    beacon_eid_get_stats(&after);
+    BENCH_CHECK(after.misses - before.misses == iterations);
+
+    printf("%-36s %10.1f ns  %7.2f M IDs/s\n", "EID from scratch", (double)scratch_ns / iterations,
+           (double)iterations * 1000.0 / (double)scratch_ns);
+    printf("%-36s %10.1f ns  %7.2f M IDs/s\n", "EID refill ahead", (double)refill_ns / refilled,
+           (double)refilled * 1000.0 / (double)refill_ns);
+    printf("%-36s %10.1f ns\n", "rotation, same period", (double)same_ns / iterations);
+    printf("%-36s %10.1f ns\n", "rotation, precomputed EID", (double)swap_ns / iterations);
+    printf("%-36s %10.1f ns\n", "rotation, miss (computed inline)", (double)miss_ns / iterations);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t iterations = bench_iterations(argc, argv, BENCH_DEFAULT_ITERATIONS);
+
+    eid_bench_known_answers();
+    eid_bench_run_app();
+    eid_bench_reboot();
+
+    printf("Eddystone-EID benchmark, %u iterations, ring of %u identifiers\n\n", iterations, BEACON_EID_AHEAD);
+    eid_bench_run_aes(iterations);
+    eid_bench_run_eid(iterations);
+    return 0;
+}
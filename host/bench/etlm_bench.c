@@ -0,0 +1,492 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host benchmark of the Eddystone eTLM encryption.
+*
+* A plain AES-EAX over any nonce, header and message length serves as the
+* reference. It is checked against the EAX paper test vectors, and every eTLM
+* the precomputed path produces must decrypt and verify with it. The salts of
+* one time base must all differ. The benchmark reports:
+*  - key setup of the precomputed path
+*  - one eTLM refresh with the reference EAX, key schedule included, and with
+*    the precomputed path, in ns and refreshes per second
+*  - AES blocks per refresh of both
+*
+* The application is also booted twice on the stub in encrypted telemetry
+* mode, each boot in its own process, with a time checkpoint store that
+* outlives them. The TLM frame on air must decrypt to its TLM values and carry
+* a valid MIC. The second boot must use a new time base, so the two boots do
+* not send the same nonce at the same time.
+*
+* Usage: etlm_bench [iterations]
+*/
+#include "host_stub.h"
+#include "beacon.h"
+#include "beacon_aes.h"
+#include "beacon_etlm.h"
+#include "bench_util.h"
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+/* Identity key and TLM inputs of the application, see beacon.c */
+#define ETLM_BENCH_APP_KEY          0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, \
+                                    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+#define ETLM_BENCH_APP_VBATT        10
+#define ETLM_BENCH_APP_TEMP         15
+
+/* Eddystone UUID, TLM frame type and encrypted version heading an eTLM frame */
+#define ETLM_BENCH_FRAME_HDR        0xaa, 0xfe, 0x20, 0x01
+#define ETLM_BENCH_FRAME_HDR_LEN    4
+#define ETLM_BENCH_FRAME_LEN        (ETLM_BENCH_FRAME_HDR_LEN + EDDYSTONE_ETLM_LEN + 4)
+
+/* EID period of the application, the time base of the second boot */
+#define ETLM_BENCH_APP_PERIOD       1024
+
+/* Largest reference EAX nonce, header and message */
+#define ETLM_BENCH_EAX_MAX          32
+
+/* AES blocks of a refresh: reference EAX with a 6 byte nonce and 12 byte message, precomputed path */
+#define ETLM_BENCH_REF_BLOCKS       7
+#define ETLM_BENCH_PRE_BLOCKS       3
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    const char   *key;
+    const char   *nonce;
+    const char   *header;
+    const char   *msg;
+    const char   *cipher;      /* Ciphertext followed by the 16 byte tag */
+} etlm_bench_vector_t;
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+static const uint8_t etlm_bench_key[BEACON_AES_KEY_LEN] = { ETLM_BENCH_APP_KEY };
+
+/* Sink so the compiler keeps the timed work */
+static volatile uint8_t etlm_bench_sink;
+
+/* Time checkpoint of the simulated boots, valid flag and value, shared with the child processes */
+static uint32_t *etlm_bench_nv;
+
+/******************************************************************************
+ *                          Private Function Definitions
+ ******************************************************************************/
+
+/*
+ * Doubles a block in GF(2^128)
+ */
+static void etlm_bench_dbl(const uint8_t *p_in, uint8_t *p_out)
+{
+    uint8_t carry = (p_in[0] & 0x80) ? 0x87 : 0;
+    int i;
+
+    for (i = 0; i < BEACON_AES_BLOCK_LEN - 1; i++)
+    {
+        p_out[i] = (uint8_t)((p_in[i] << 1) | (p_in[i + 1] >> 7));
+    }
+    p_out[BEACON_AES_BLOCK_LEN - 1] = (uint8_t)(p_in[BEACON_AES_BLOCK_LEN - 1] << 1) ^ carry;
+}
+
+/*
+ * OMAC of [t] followed by the message, CMAC with the subkeys K1 and K2
+ */
+static void etlm_bench_omac(const beacon_aes_ctx_t *p_aes, const uint8_t *p_k1, const uint8_t *p_k2, uint8_t t,
+                            const uint8_t *p_msg, uint32_t len, uint8_t *p_tag)
+{
+    uint8_t x[BEACON_AES_BLOCK_LEN] = { 0 };
+    const uint8_t *k = (len % BEACON_AES_BLOCK_LEN) ? p_k2 : p_k1;
+    uint32_t i, n;
+
+    // the tweak block, then every message block but the last
+    x[BEACON_AES_BLOCK_LEN - 1] = t;
+    if (len == 0)
+    {
+        for (i = 0; i < BEACON_AES_BLOCK_LEN; i++)
+        {
+            x[i] ^= k[i];
+        }
+        beacon_aes_encrypt(p_aes, x, p_tag);
+        return;
+    }
+    beacon_aes_encrypt(p_aes, x, x);
+    while (len > BEACON_AES_BLOCK_LEN)
+    {
+        for (i = 0; i < BEACON_AES_BLOCK_LEN; i++)
+        {
+            x[i] ^= p_msg[i];
+        }
+        beacon_aes_encrypt(p_aes, x, x);
+        p_msg += BEACON_AES_BLOCK_LEN;
+        len -= BEACON_AES_BLOCK_LEN;
+    }
+    n = len;
+    for (i = 0; i < n; i++)
+    {
+        x[i] ^= p_msg[i];
+    }
+    if (n < BEACON_AES_BLOCK_LEN)
+    {
+        x[n] ^= 0x80;
+    }
+    for (i = 0; i < BEACON_AES_BLOCK_LEN; i++)
+    {
+        x[i] ^= k[i];
+    }
+    beacon_aes_encrypt(p_aes, x, p_tag);
+}
+
+/*
+ * Reference AES-EAX, key schedule included. Encrypts or decrypts p_in into
+ * p_out and returns the tag, computed over the ciphertext.
+ */
+static void etlm_bench_eax(const uint8_t *p_key, const uint8_t *p_nonce, uint32_t nonce_len,
+                           const uint8_t *p_hdr, uint32_t hdr_len, const uint8_t *p_in, uint32_t len,
+                           wiced_bool_t decrypt, uint8_t *p_out, uint8_t *p_tag)
+{
+    beacon_aes_ctx_t aes;
+    uint8_t n_tag[BEACON_AES_BLOCK_LEN], h_tag[BEACON_AES_BLOCK_LEN], c_tag[BEACON_AES_BLOCK_LEN];
+    uint8_t ctr[BEACON_AES_BLOCK_LEN], stream[BEACON_AES_BLOCK_LEN];
+    uint8_t k1[BEACON_AES_BLOCK_LEN], k2[BEACON_AES_BLOCK_LEN];
+    uint32_t i;
+    int j;
+
+    beacon_aes_set_key(&aes, p_key);
+    memset(k2, 0, sizeof(k2));
+    beacon_aes_encrypt(&aes, k2, k2);
+    etlm_bench_dbl(k2, k1);
+    etlm_bench_dbl(k1, k2);
+
+    etlm_bench_omac(&aes, k1, k2, 0, p_nonce, nonce_len, n_tag);
+    etlm_bench_omac(&aes, k1, k2, 1, p_hdr, hdr_len, h_tag);
+    if (decrypt)
+    {
+        etlm_bench_omac(&aes, k1, k2, 2, p_in, len, c_tag);
+    }
+
+    memcpy(ctr, n_tag, sizeof(ctr));
+    for (i = 0; i < len; i++)
+    {
+        if (i % BEACON_AES_BLOCK_LEN == 0)
+        {
+            beacon_aes_encrypt(&aes, ctr, stream);
+            for (j = BEACON_AES_BLOCK_LEN - 1; j >= 0 && ++ctr[j] == 0; j--)
+            {
+            }
+        }
+        p_out[i] = p_in[i] ^ stream[i % BEACON_AES_BLOCK_LEN];
+    }
+    if (!decrypt)
+    {
+        etlm_bench_omac(&aes, k1, k2, 2, p_out, len, c_tag);
+    }
+
+    for (i = 0; i < BEACON_AES_BLOCK_LEN; i++)
+    {
+        p_tag[i] = n_tag[i] ^ h_tag[i] ^ c_tag[i];
+    }
+}
+
+/*
+ * Parses a hex string, returns its length in bytes
+ */
+static uint32_t etlm_bench_hex(const char *p_hex, uint8_t *p_out)
+{
+    uint32_t len = 0;
+    unsigned int byte;
+
+    while (p_hex[0] && p_hex[1] && sscanf(p_hex, "%2x", &byte) == 1)
+    {
+        p_out[len++] = (uint8_t)byte;
+        p_hex += 2;
+    }
+    return len;
+}
+
+/*
+ * Checks the reference EAX against the EAX paper test vectors
+ */
+static void etlm_bench_vectors(void)
+{
+    static const etlm_bench_vector_t vectors[] =
+    {
+        { "233952DEE4D5ED5F9B9C6D6FF80FF478", "62EC67F9C3A4A407FCB2A8C49031A8B3", "6BFB914FD07EAE6B",
+          "", "E037830E8389F27B025A2D6527E79D01" },
+        { "91945D3F4DCBEE0BF45EF52255F095A4", "BECAF043B0A23D843194BA972C66DEBD", "FA3BFD4806EB53FA",
+          "F7FB", "19DD5C4C9331049D0BDAB0277408F67967E5" },
+        { "01F74AD64077F2E704C0F60ADA3DD523", "70C3DB4F0D26368400A10ED05D2BFF5E", "234A3463C1264AC6",
+          "1A47CB4933", "D851D5BAE03A59F238A23E39199DC9266626C40F80" },
+    };
+    uint8_t key[BEACON_AES_KEY_LEN], nonce[ETLM_BENCH_EAX_MAX], hdr[ETLM_BENCH_EAX_MAX], msg[ETLM_BENCH_EAX_MAX];
+    uint8_t expected[2 * ETLM_BENCH_EAX_MAX], out[ETLM_BENCH_EAX_MAX], tag[BEACON_AES_BLOCK_LEN];
+    uint32_t v, nonce_len, hdr_len, msg_len;
+
+    for (v = 0; v < sizeof(vectors) / sizeof(vectors[0]); v++)
+    {
+        BENCH_CHECK(etlm_bench_hex(vectors[v].key, key) == BEACON_AES_KEY_LEN);
+        nonce_len = etlm_bench_hex(vectors[v].nonce, nonce);
+        hdr_len = etlm_bench_hex(vectors[v].header, hdr);
+        msg_len = etlm_bench_hex(vectors[v].msg, msg);
+        BENCH_CHECK(etlm_bench_hex(vectors[v].cipher, expected) == msg_len + BEACON_AES_BLOCK_LEN);
+
+        etlm_bench_eax(key, nonce, nonce_len, hdr, hdr_len, msg, msg_len, WICED_FALSE, out, tag);
+        BENCH_CHECK(memcmp(out, expected, msg_len) == 0);
+        BENCH_CHECK(memcmp(tag, &expected[msg_len], BEACON_AES_BLOCK_LEN) == 0);
+    }
+}
+
+/*
+ * Builds the eTLM nonce: time base and salt, big-endian
+ */
+static void etlm_bench_nonce(uint32_t time_base, uint16_t salt, uint8_t *p_nonce)
+{
+    p_nonce[0] = (uint8_t)(time_base >> 24);
+    p_nonce[1] = (uint8_t)(time_base >> 16);
+    p_nonce[2] = (uint8_t)(time_base >> 8);
+    p_nonce[3] = (uint8_t)time_base;
+    p_nonce[4] = (uint8_t)(salt >> 8);
+    p_nonce[5] = (uint8_t)salt;
+}
+
+/*
+ * Checks the precomputed path against the reference and the salt permutation
+ */
+static void etlm_bench_check(void)
+{
+    static uint8_t seen[65536 / 8];
+    beacon_etlm_ctx_t ctx;
+    uint8_t tlm[EDDYSTONE_ETLM_LEN], etlm[EDDYSTONE_ETLM_LEN], ref[EDDYSTONE_ETLM_LEN];
+    uint8_t nonce[BEACON_ETLM_NONCE_LEN], tag[BEACON_AES_BLOCK_LEN];
+    uint32_t i, time_base;
+    uint16_t salt, mic;
+
+    beacon_etlm_init(&ctx, etlm_bench_key);
+    for (i = 0; i < 4096; i++)
+    {
+        time_base = (i * 0x9e3779b9u) & ~0x3ffu;
+        salt = (uint16_t)(i * 40503u);
+        memset(tlm, (int)i, sizeof(tlm));
+        tlm[0] = (uint8_t)(i >> 8);
+
+        mic = beacon_etlm_encrypt(&ctx, time_base, salt, tlm, etlm);
+        etlm_bench_nonce(time_base, salt, nonce);
+        etlm_bench_eax(etlm_bench_key, nonce, sizeof(nonce), NULL, 0, tlm, sizeof(tlm), WICED_FALSE, ref, tag);
+        BENCH_CHECK(memcmp(etlm, ref, sizeof(etlm)) == 0);
+        BENCH_CHECK(mic == (uint16_t)((tag[0] << 8) | tag[1]));
+    }
+
+    // a time base has 65536 distinct salts
+    memset(seen, 0, sizeof(seen));
+    for (i = 0; i < 65536; i++)
+    {
+        salt = beacon_etlm_next_salt(&ctx, 0x400);
+        BENCH_CHECK(!(seen[salt >> 3] & (1u << (salt & 7))));
+        seen[salt >> 3] |= (uint8_t)(1u << (salt & 7));
+    }
+}
+
+/*
+ * Returns the eTLM frame in adv data, NULL if there is none
+ */
+static const uint8_t *etlm_bench_find_frame(const uint8_t *p_data, uint16_t len)
+{
+    static const uint8_t hdr[ETLM_BENCH_FRAME_HDR_LEN] = { ETLM_BENCH_FRAME_HDR };
+    uint16_t i;
+
+    for (i = 0; i + ETLM_BENCH_FRAME_LEN <= len; i++)
+    {
+        if (memcmp(&p_data[i], hdr, sizeof(hdr)) == 0)
+        {
+            return &p_data[i + ETLM_BENCH_FRAME_HDR_LEN];
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Reads the checkpoint of the simulated boots
+ */
+static wiced_bool_t etlm_bench_nv_load(uint32_t *p_checkpoint)
+{
+    if (!etlm_bench_nv[0])
+    {
+        return WICED_FALSE;
+    }
+    *p_checkpoint = etlm_bench_nv[1];
+    return WICED_TRUE;
+}
+
+/*
+ * Writes the checkpoint of the simulated boots
+ */
+static wiced_bool_t etlm_bench_nv_save(uint32_t checkpoint)
+{
+    etlm_bench_nv[0] = 1;
+    etlm_bench_nv[1] = checkpoint;
+    return WICED_TRUE;
+}
+
+static const beacon_time_store_t etlm_bench_nv_store = { etlm_bench_nv_load, etlm_bench_nv_save };
+
+/*
+ * Runs the application with encrypted telemetry and checks that the eTLM on
+ * air decrypts with the nonce of time_base, returns its salt
+ */
+static uint16_t etlm_bench_run_app(uint32_t time_base)
+{
+    const uint8_t *p_data, *p_frame = NULL;
+    uint8_t nonce[BEACON_ETLM_NONCE_LEN], tlm[EDDYSTONE_ETLM_LEN], tag[BEACON_AES_BLOCK_LEN];
+    uint16_t len, salt, mic;
+    uint32_t sec_cnt;
+    uint8_t set, sec;
+
+    beacon_set_tlm_encrypted(WICED_TRUE);
+    beacon_set_time_store(&etlm_bench_nv_store);
+    application_start();
+    host_stub_bt_enable();
+    host_stub_advance_ms(10000);
+
+    for (sec = 0; sec < 8 && p_frame == NULL; sec++)
+    {
+        for (set = 1; set <= HOST_STUB_MAX_ADV_SETS && p_frame == NULL; set++)
+        {
+            p_data = host_stub_adv_data(set, &len);
+            if (p_data != NULL && host_stub_adv_enabled(set))
+            {
+                p_frame = etlm_bench_find_frame(p_data, len);
+            }
+        }
+        if (p_frame == NULL)
+        {
+            host_stub_advance_ms(1000);
+        }
+    }
+    BENCH_CHECK(p_frame != NULL);
+
+    // salt and MIC follow the eTLM as the frame encoder streams them, little-endian
+    salt = (uint16_t)(p_frame[EDDYSTONE_ETLM_LEN] | (p_frame[EDDYSTONE_ETLM_LEN + 1] << 8));
+    mic = (uint16_t)(p_frame[EDDYSTONE_ETLM_LEN + 2] | (p_frame[EDDYSTONE_ETLM_LEN + 3] << 8));
+
+    // still in the first EID period of the boot
+    etlm_bench_nonce(time_base, salt, nonce);
+    etlm_bench_eax(etlm_bench_key, nonce, sizeof(nonce), NULL, 0, p_frame, EDDYSTONE_ETLM_LEN, WICED_TRUE, tlm, tag);
+    BENCH_CHECK(mic == (uint16_t)((tag[0] << 8) | tag[1]));
+    BENCH_CHECK((tlm[0] | (tlm[1] << 8)) == ETLM_BENCH_APP_VBATT);
+    BENCH_CHECK((tlm[2] | (tlm[3] << 8)) == ETLM_BENCH_APP_TEMP);
+    sec_cnt = (uint32_t)tlm[8] | ((uint32_t)tlm[9] << 8) | ((uint32_t)tlm[10] << 16) | ((uint32_t)tlm[11] << 24);
+    BENCH_CHECK(sec_cnt > 0 && sec_cnt <= host_stub_now_ms() / 1000);
+
+    printf("application: eTLM on air at %u s decrypts to SEC_CNT %u, MIC valid, time base %u, salt %04x\n",
+           (unsigned)(host_stub_now_ms() / 1000), sec_cnt, time_base, salt);
+    return salt;
+}
+
+/*
+ * Boots the application in a child process, the salt on air lands in p_salt
+ */
+static void etlm_bench_boot(uint32_t time_base, uint16_t *p_salt)
+{
+    pid_t pid;
+    int   status;
+
+    fflush(stdout);
+    pid = fork();
+    BENCH_CHECK(pid >= 0);
+    if (pid == 0)
+    {
+        *p_salt = etlm_bench_run_app(time_base);
+        fflush(stdout);
+        _exit(0);
+    }
+    BENCH_CHECK(waitpid(pid, &status, 0) == pid);
+    BENCH_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+/*
+ * Boots twice: the salts start over with the refresh count, the time base
+ * must not
+ */
+static void etlm_bench_reboot(void)
+{
+    uint16_t *p_salts = mmap(NULL, 2 * sizeof(uint16_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+    etlm_bench_nv = mmap(NULL, 2 * sizeof(uint32_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    BENCH_CHECK(p_salts != MAP_FAILED && etlm_bench_nv != MAP_FAILED);
+    etlm_bench_boot(0, &p_salts[0]);
+    etlm_bench_boot(ETLM_BENCH_APP_PERIOD, &p_salts[1]);
+    BENCH_CHECK(p_salts[0] == p_salts[1]);
+    printf("application: two boots, same salt, different time bases and nonces\n\n");
+    munmap(etlm_bench_nv, 2 * sizeof(uint32_t));
+    munmap(p_salts, 2 * sizeof(uint16_t));
+}
+
+/*
+ * Times the key setup and an eTLM refresh with both paths
+ */
+static void etlm_bench_run(uint32_t iterations)
+{
+    beacon_etlm_ctx_t ctx;
+    uint8_t tlm[EDDYSTONE_ETLM_LEN] = { 0 }, etlm[EDDYSTONE_ETLM_LEN];
+    uint8_t nonce[BEACON_ETLM_NONCE_LEN], tag[BEACON_AES_BLOCK_LEN];
+    uint64_t t0, init_ns, ref_ns, pre_ns;
+    uint32_t i;
+    uint16_t mic = 0;
+
+    t0 = bench_now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        beacon_etlm_init(&ctx, etlm_bench_key);
+        etlm_bench_sink = ctx.header_tag[0];
+    }
+    init_ns = bench_now_ns() - t0;
+
+    t0 = bench_now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        tlm[11] = (uint8_t)i;
+        etlm_bench_nonce(0, (uint16_t)i, nonce);
+        etlm_bench_eax(etlm_bench_key, nonce, sizeof(nonce), NULL, 0, tlm, sizeof(tlm), WICED_FALSE, etlm, tag);
+        etlm_bench_sink = tag[0];
+    }
+    ref_ns = bench_now_ns() - t0;
+
+    t0 = bench_now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        tlm[11] = (uint8_t)i;
+        mic ^= beacon_etlm_encrypt(&ctx, 0, beacon_etlm_next_salt(&ctx, 0), tlm, etlm);
+    }
+    pre_ns = bench_now_ns() - t0;
+    etlm_bench_sink = (uint8_t)mic;
+
+    printf("%-36s %10s %14s %12s\n", "eTLM refresh", "ns", "refreshes/s", "AES blocks");
+    printf("%-36s %10.1f\n", "key setup, precomputed path", (double)init_ns / iterations);
+    printf("%-36s %10.1f %14.0f %12u\n", "reference EAX, key schedule incl.", (double)ref_ns / iterations,
+           (double)iterations * 1e9 / (double)ref_ns, ETLM_BENCH_REF_BLOCKS);
+    printf("%-36s %10.1f %14.0f %12u\n", "precomputed", (double)pre_ns / iterations,
+           (double)iterations * 1e9 / (double)pre_ns, ETLM_BENCH_PRE_BLOCKS);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t iterations = bench_iterations(argc, argv, BENCH_DEFAULT_ITERATIONS);
+
+    etlm_bench_vectors();
+    etlm_bench_check();
+    etlm_bench_reboot();
+
+    printf("Eddystone eTLM benchmark, %u iterations\n\n", iterations);
+    etlm_bench_run(iterations);
+    return 0;
+}
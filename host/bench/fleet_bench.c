@@ -0,0 +1,299 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host benchmark of a virtualised beacon fleet.
+*
+* Runs the application with the built-in beacons plus a number of zone
+* iBeacons over a number of controller adv sets, in legacy or extended adv
+* mode, optionally with TLM on a periodic train (pa), and reports the rotation CPU time and controller commands per second,
+* the RAM allocated per logical beacon (beacon table plus adv set state), the
+* share of zone beacons seen on air and the air time on the primary and
+* secondary channels. Every configuration runs in its own process so the
+* application starts clean.
+*
+* Usage: fleet_bench [rotations]
+*/
+#include "wiced_bt_beacon.h"
+#include "host_stub.h"
+#include "beacon.h"
+#include "bench_util.h"
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+#define FLEET_DEFAULT_ROTATIONS     10000
+#define FLEET_BUILTIN_CNT           5
+#define FLEET_ZONE_MAJOR_BASE       0x0100
+#define FLEET_ZONE_MINORS           16
+#define FLEET_ZONE_MAX              251
+
+/* Zone iBeacons packed into one extended adv set */
+#define FLEET_ZONE_PER_EXT_ADV      ((WICED_BT_BEACON_EXT_ADV_DATA_MAX - WICED_BT_BEACON_FLAGS_AD_LEN) / \
+                                     (IBEACON_DATA_LENGTH + 2))
+
+/* iBeacon major and minor offsets in its AD structure, both little endian */
+#define FLEET_IBEACON_MAJOR_OFFSET  22
+#define FLEET_IBEACON_MINOR_OFFSET  24
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint16_t     zones;
+    uint8_t      sets;
+    wiced_bool_t ext;
+    wiced_bool_t periodic;
+} fleet_config_t;
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+static const fleet_config_t fleet_configs[] =
+{
+    {   0,  4, WICED_FALSE, WICED_FALSE },
+    {  27,  4, WICED_FALSE, WICED_FALSE },
+    {  27,  8, WICED_FALSE, WICED_FALSE },
+    { 123,  8, WICED_FALSE, WICED_FALSE },
+    { 251,  8, WICED_FALSE, WICED_FALSE },
+    { 251, 16, WICED_FALSE, WICED_FALSE },
+    {   0,  4, WICED_TRUE,  WICED_FALSE },
+    {  27,  4, WICED_TRUE,  WICED_FALSE },
+    { 123,  8, WICED_TRUE,  WICED_FALSE },
+    { 251,  8, WICED_TRUE,  WICED_FALSE },
+    { 251, 16, WICED_TRUE,  WICED_FALSE },
+    {   0,  4, WICED_FALSE, WICED_TRUE  },
+    {  27,  8, WICED_FALSE, WICED_TRUE  },
+    {   0,  4, WICED_TRUE,  WICED_TRUE  },
+    { 123,  8, WICED_TRUE,  WICED_TRUE  },
+};
+
+static const char * const fleet_modes[2][2] =
+{
+    { "legacy", "legacy+pa" },
+    { "ext",    "ext+pa"    },
+};
+
+/******************************************************************************
+ *     Private Function Definitions
+ ******************************************************************************/
+
+/*
+ * Walks the AD structures of one set, marks the zone iBeacons in seen[] and
+ * returns the number of built-in frames (Eddystone service data and the
+ * built-in iBeacon)
+ */
+static uint8_t fleet_scan_set(const uint8_t *p_data, uint16_t len, uint8_t *seen)
+{
+    uint16_t pos;
+    uint8_t  builtin = 0;
+
+    for (pos = 0; pos + 1 < len; pos += p_data[pos] + 1)
+    {
+        const uint8_t *p_ad = &p_data[pos];
+
+        BENCH_CHECK(p_ad[0] != 0 && pos + p_ad[0] < len);
+        if (p_ad[1] == BTM_BLE_ADVERT_TYPE_SERVICE_DATA)
+        {
+            builtin++;
+        }
+        else if (p_ad[1] == BTM_BLE_ADVERT_TYPE_MANUFACTURER && p_ad[0] == IBEACON_DATA_LENGTH + 1)
+        {
+            uint16_t major = p_ad[FLEET_IBEACON_MAJOR_OFFSET] | (p_ad[FLEET_IBEACON_MAJOR_OFFSET + 1] << 8);
+            uint16_t minor = p_ad[FLEET_IBEACON_MINOR_OFFSET] | (p_ad[FLEET_IBEACON_MINOR_OFFSET + 1] << 8);
+
+            if (major >= FLEET_ZONE_MAJOR_BASE)
+            {
+                uint32_t zone = (uint32_t)(major - FLEET_ZONE_MAJOR_BASE) * FLEET_ZONE_MINORS + minor;
+
+                BENCH_CHECK(zone < FLEET_ZONE_MAX);
+                seen[zone] = 1;
+            }
+            else
+            {
+                builtin++;
+            }
+        }
+    }
+    return builtin;
+}
+
+/*
+ * Marks the zone iBeacons on air in seen[], adds the air time of the enabled
+ * sets and returns their number
+ */
+static uint8_t fleet_scan(uint8_t sets, uint8_t *seen, uint8_t *p_builtin, uint64_t *p_primary_us,
+                          uint64_t *p_secondary_us)
+{
+    uint8_t  handle, on = 0;
+    uint16_t len;
+    uint32_t primary_us, secondary_us;
+
+    *p_builtin = 0;
+    for (handle = 1; handle <= sets; handle++)
+    {
+        const uint8_t *p_data = host_stub_adv_data(handle, &len);
+
+        if (!host_stub_adv_enabled(handle))
+        {
+            continue;
+        }
+        on++;
+        *p_builtin += fleet_scan_set(p_data, len, seen);
+        host_stub_adv_air_us(handle, &primary_us, &secondary_us);
+        *p_primary_us += primary_us;
+        *p_secondary_us += secondary_us;
+    }
+    return on;
+}
+
+/*
+ * Returns the TLM second count on the periodic train, checks there is exactly one
+ */
+static uint32_t fleet_periodic_tlm_sec_cnt(uint8_t sets)
+{
+    uint8_t  handle, trains = 0;
+    uint16_t len;
+    uint32_t sec_cnt = 0;
+
+    for (handle = 1; handle <= sets; handle++)
+    {
+        const uint8_t *p_data = host_stub_periodic_adv_data(handle, &len);
+
+        if (p_data == NULL)
+        {
+            continue;
+        }
+        trains++;
+        BENCH_CHECK(len == EDDYSTONE_SERVICE_DATA_HDR_LEN + EDDYSTONE_TLM_UNENCRYPTED_FRAME_LEN &&
+                    p_data[1] == BTM_BLE_ADVERT_TYPE_SERVICE_DATA &&
+                    p_data[EDDYSTONE_SERVICE_DATA_HDR_LEN] == EDDYSTONE_FRAME_TYPE_TLM);
+        p_data += EDDYSTONE_TLM_SEC_CNT_OFFSET - EDDYSTONE_ADV_HDR_LEN + EDDYSTONE_SERVICE_DATA_HDR_LEN;
+        sec_cnt = p_data[0] | (p_data[1] << 8) | (p_data[2] << 16) | ((uint32_t)p_data[3] << 24);
+    }
+    BENCH_CHECK(trains == 1);
+    return sec_cnt;
+}
+
+static void fleet_run(const fleet_config_t *p_cfg, uint32_t rotations)
+{
+    uint8_t  seen[FLEET_ZONE_MAX];
+    uint32_t cnt = FLEET_BUILTIN_CNT + p_cfg->zones;
+    uint32_t alloc_bytes, cmds, i, seen_cnt = 0;
+    uint64_t start, elapsed, primary_us = 0, secondary_us = 0;
+    uint8_t  builtin, rotated_sets = p_cfg->sets, builtin_frames = FLEET_BUILTIN_CNT;
+    uint32_t sec_cnt = 0;
+
+    if (p_cfg->ext)
+    {
+        // one built-in beacon plus the zones packed per set
+        cnt = 1 + (p_cfg->zones + FLEET_ZONE_PER_EXT_ADV - 1) / FLEET_ZONE_PER_EXT_ADV;
+    }
+    if (p_cfg->periodic)
+    {
+        // TLM leaves the rotation for a set of its own
+        rotated_sets--;
+        builtin_frames--;
+        if (!p_cfg->ext)
+        {
+            cnt--;
+        }
+    }
+    host_stub_set_num_ext_adv_sets(p_cfg->sets);
+    beacon_set_zone_beacons(p_cfg->zones);
+    beacon_set_ext_adv(p_cfg->ext);
+    beacon_set_tlm_periodic(p_cfg->periodic);
+
+    host_stub_reset_counters();
+    application_start();
+    host_stub_bt_enable();
+    alloc_bytes = host_stub_counters.buffer_bytes;
+
+    host_stub_reset_counters();
+    start = bench_now_ns();
+    host_stub_advance_ms(rotations * 1000);
+    elapsed = bench_now_ns() - start - host_stub_log_drain_ns();
+
+    BENCH_CHECK(host_stub_counters.disallowed == 0);
+    cmds = host_stub_counters.set_ext_adv_parameters + host_stub_counters.set_ext_adv_random_address +
+           host_stub_counters.set_ext_adv_data + host_stub_counters.start_ext_adv + host_stub_counters.stop_ext_adv +
+           host_stub_counters.set_periodic_adv_params + host_stub_counters.set_periodic_adv_data +
+           host_stub_counters.start_periodic_adv;
+
+    // coverage: which zone beacons get on air within 4 seconds per logical beacon
+    memset(seen, 0, sizeof(seen));
+    for (i = 0; i < cnt * 4; i++)
+    {
+        host_stub_advance_ms(1000);
+        BENCH_CHECK(fleet_scan(p_cfg->sets, seen, &builtin, &primary_us, &secondary_us) ==
+                    (cnt < rotated_sets ? cnt : rotated_sets) + p_cfg->sets - rotated_sets);
+
+        // the packed built-in set keeps all frames on air every second
+        if (p_cfg->ext)
+        {
+            BENCH_CHECK(builtin == builtin_frames);
+        }
+
+        // the periodic train carries a fresh TLM every second
+        if (p_cfg->periodic)
+        {
+            BENCH_CHECK(i == 0 || fleet_periodic_tlm_sec_cnt(p_cfg->sets) == sec_cnt + 1);
+            sec_cnt = fleet_periodic_tlm_sec_cnt(p_cfg->sets);
+        }
+    }
+    for (i = 0; i < p_cfg->zones; i++)
+    {
+        seen_cnt += seen[i];
+    }
+
+    printf("%-9s %8u %6u %10.1f %10.2f %10.1f %12u %10.1f %10.0f %10.0f\n", fleet_modes[p_cfg->ext][p_cfg->periodic],
+           cnt, p_cfg->sets, (double)elapsed / rotations, (double)cmds / rotations,
+           (double)alloc_bytes / cnt, alloc_bytes,
+           p_cfg->zones ? 100.0 * seen_cnt / p_cfg->zones : 100.0,
+           (double)primary_us / (cnt * 4), (double)secondary_us / (cnt * 4));
+
+    // with spare adv sets every zone beacon gets air time
+    if (p_cfg->sets > 4)
+    {
+        BENCH_CHECK(seen_cnt == p_cfg->zones);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t rotations = bench_iterations(argc, argv, FLEET_DEFAULT_ROTATIONS * 100) / 100;
+    uint32_t c;
+    int      status;
+
+    if (rotations == 0)
+    {
+        rotations = 1;
+    }
+
+    printf("Beacon fleet benchmark, %u rotations\n\n", rotations);
+    printf("%-9s %8s %6s %10s %10s %10s %12s %10s %10s %10s\n", "mode", "beacons", "sets", "ns/rot", "cmds/rot",
+           "B/beacon", "alloc B", "zones on %", "prim us/s", "sec us/s");
+    fflush(stdout);
+
+    for (c = 0; c < sizeof(fleet_configs) / sizeof(fleet_configs[0]); c++)
+    {
+        pid_t pid = fork();
+
+        BENCH_CHECK(pid >= 0);
+        if (pid == 0)
+        {
+            fleet_run(&fleet_configs[c], rotations);
+            fflush(stdout);
+            _exit(0);
+        }
+        BENCH_CHECK(waitpid(pid, &status, 0) == pid);
+        BENCH_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+    return 0;
+}
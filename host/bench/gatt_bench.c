@@ -0,0 +1,508 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host benchmark of the GATT Read By Type path.
+*
+* Builds a synthetic database of several hundred attributes with the stack's
+* database macros and, for a set of attribute types, reports the time to find
+* the matching handles by rescanning the database with
+* wiced_bt_gatt_find_handle_by_type() from each match on, the time to find
+* them in the type index, and the time of a whole Read By Type request
+* through beacon_gatts_callback(). The scan and the index must agree, and
+* the response must carry the expected pairs. Requests that only touch
+* attributes the database does not declare writable are answered from the
+* pre-serialised response cache and take no buffer; the allocs column shows
+* buffers taken per request. The Read Multiple rows do the same for lists of
+* handles.
+*
+* The buffer rows time a GATT_GET_RESPONSE_BUFFER_EVT plus its
+* GATT_APP_BUFFER_TRANSMITTED_EVT, served by the block pool, against malloc and
+* free of the same size, and report the pool high-water marks. Requests must
+* not allocate from the stack or fail.
+*
+* Usage: gatt_bench [iterations]
+*/
+#include "host_stub.h"
+#include "beacon_gatt.h"
+#include "beacon_gatt_index.h"
+#include "beacon_gatt_rsp.h"
+#include "beacon_pool.h"
+#include "bench_util.h"
+#include <string.h>
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+#define GATT_BENCH_SERVICES         48
+#define GATT_BENCH_SERVICE_ATTRS    9
+#define GATT_BENCH_ATTR_MAX         (3 + GATT_BENCH_SERVICES * GATT_BENCH_SERVICE_ATTRS)
+#define GATT_BENCH_DB_MAX           (GATT_BENCH_ATTR_MAX * 24)
+#define GATT_BENCH_VALUE_MAX        16
+#define GATT_BENCH_RSP_LEN          512
+#define GATT_BENCH_MATCH_MAX        GATT_BENCH_ATTR_MAX
+
+#define GATT_BENCH_SERVICE_BASE     0x4000
+#define GATT_BENCH_CUSTOM_BASE      0x3000
+#define GATT_BENCH_BATTERY_LEVEL    0x2A19
+#define GATT_BENCH_DEVICE_NAME      0x2A00
+
+/* Custom 128-bit characteristic UUID, the last byte is the service number */
+#define GATT_BENCH_UUID128(s)       0xfb, 0x34, 0x9b, 0x5f, 0x80, 0x00, 0x00, 0x80, \
+                                    0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, (uint8_t)(s)
+
+#define GATT_BENCH_RW               (LEGATTDB_PERM_READABLE | LEGATTDB_PERM_WRITE_REQ)
+
+/* Field before each value in a response */
+#define GATT_BENCH_FIELD_NONE       0
+#define GATT_BENCH_FIELD_HANDLE     1   /* Read By Type */
+#define GATT_BENCH_FIELD_LEN        2   /* Read Multiple Variable Length */
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    const char     *name;
+    wiced_bt_uuid_t uuid;
+    uint16_t        s_handle;
+    uint16_t        e_handle;
+    uint16_t        matches;        /* Expected */
+    uint16_t        value_len;      /* Of every match */
+} gatt_bench_case_t;
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+static uint8_t                gatt_bench_db[GATT_BENCH_DB_MAX];
+static uint16_t               gatt_bench_db_len;
+static gatt_db_lookup_table_t gatt_bench_attr_tbl[GATT_BENCH_ATTR_MAX];
+static uint16_t               gatt_bench_attr_cnt;
+static uint8_t                gatt_bench_values[GATT_BENCH_ATTR_MAX][GATT_BENCH_VALUE_MAX];
+
+/******************************************************************************
+ *                          Private Function Definitions
+ ******************************************************************************/
+static void gatt_bench_put(const uint8_t *p_rec, uint16_t len)
+{
+    BENCH_CHECK(gatt_bench_db_len + len <= GATT_BENCH_DB_MAX);
+    memcpy(&gatt_bench_db[gatt_bench_db_len], p_rec, len);
+    gatt_bench_db_len += len;
+}
+
+/*
+ * Gives an attribute an app-held value, like an app_gatt_db_ext_attr_tbl entry
+ */
+static void gatt_bench_put_value(uint16_t handle, uint16_t len)
+{
+    gatt_db_lookup_table_t *p_attr = &gatt_bench_attr_tbl[gatt_bench_attr_cnt];
+
+    BENCH_CHECK(gatt_bench_attr_cnt < GATT_BENCH_ATTR_MAX && len <= GATT_BENCH_VALUE_MAX);
+    p_attr->handle  = handle;
+    p_attr->max_len = GATT_BENCH_VALUE_MAX;
+    p_attr->cur_len = len;
+    p_attr->p_data  = gatt_bench_values[gatt_bench_attr_cnt];
+    memset(p_attr->p_data, (uint8_t)handle, len);
+    gatt_bench_attr_cnt++;
+}
+
+/*
+ * GAP service, then per service: a Battery Level with its CCCD, a writable
+ * custom 16-bit characteristic and a writable 128-bit one with its CCCD.
+ * Returns the last handle.
+ */
+static uint16_t gatt_bench_build(void)
+{
+    uint16_t h = 1, s;
+
+    {
+        const uint8_t rec[] =
+        {
+            PRIMARY_SERVICE_UUID16(h, __UUID_SERVICE_GENERIC_ACCESS),
+            CHARACTERISTIC_UUID16(h + 1, h + 2, GATT_BENCH_DEVICE_NAME, GATT_CHAR_PROPERTIES_BIT_READ,
+                                  LEGATTDB_PERM_READABLE),
+        };
+        gatt_bench_put(rec, sizeof(rec));
+        gatt_bench_put_value(h + 2, 13);
+        h += 3;
+    }
+
+    for (s = 0; s < GATT_BENCH_SERVICES; s++, h += GATT_BENCH_SERVICE_ATTRS)
+    {
+        const uint8_t rec[] =
+        {
+            PRIMARY_SERVICE_UUID16(h, GATT_BENCH_SERVICE_BASE + s),
+            CHARACTERISTIC_UUID16(h + 1, h + 2, GATT_BENCH_BATTERY_LEVEL,
+                                  GATT_CHAR_PROPERTIES_BIT_READ | GATT_CHAR_PROPERTIES_BIT_NOTIFY,
+                                  LEGATTDB_PERM_READABLE),
+            CHAR_DESCRIPTOR_UUID16_WRITABLE(h + 3, GATT_UUID_CHAR_CLIENT_CONFIG, GATT_BENCH_RW),
+            CHARACTERISTIC_UUID16_WRITABLE(h + 4, h + 5, GATT_BENCH_CUSTOM_BASE + s,
+                                           GATT_CHAR_PROPERTIES_BIT_READ | GATT_CHAR_PROPERTIES_BIT_WRITE,
+                                           GATT_BENCH_RW),
+            CHARACTERISTIC_UUID128_WRITABLE(h + 6, h + 7, GATT_BENCH_UUID128(s),
+                                            GATT_CHAR_PROPERTIES_BIT_READ | GATT_CHAR_PROPERTIES_BIT_NOTIFY,
+                                            GATT_BENCH_RW),
+            CHAR_DESCRIPTOR_UUID16_WRITABLE(h + 8, GATT_UUID_CHAR_CLIENT_CONFIG, GATT_BENCH_RW),
+        };
+        gatt_bench_put(rec, sizeof(rec));
+        gatt_bench_put_value(h + 2, 1);
+        gatt_bench_put_value(h + 3, 2);
+        gatt_bench_put_value(h + 5, 4);
+        gatt_bench_put_value(h + 7, 8);
+        gatt_bench_put_value(h + 8, 2);
+    }
+    return h - 1;
+}
+
+/*
+ * Handles of a type in range the way the request handler used to find them:
+ * one database scan per match, each resuming one past the previous match
+ */
+static uint16_t gatt_bench_scan(const gatt_bench_case_t *p_case, uint16_t *p_handles)
+{
+    wiced_bt_uuid_t uuid = p_case->uuid;
+    uint16_t handle = p_case->s_handle, cnt = 0;
+
+    while ((handle = wiced_bt_gatt_find_handle_by_type(handle, p_case->e_handle, &uuid)) != 0)
+    {
+        p_handles[cnt++] = handle;
+        if (handle++ == p_case->e_handle)
+        {
+            break;
+        }
+    }
+    return cnt;
+}
+
+static uint16_t gatt_bench_index(const gatt_bench_case_t *p_case, uint16_t *p_handles)
+{
+    uint16_t pos, cnt, i;
+
+    cnt = beacon_gatt_index_find(&p_case->uuid, p_case->s_handle, p_case->e_handle, &pos);
+    for (i = 0; i < cnt; i++)
+    {
+        p_handles[i] = beacon_gatt_index_handle(pos + i);
+    }
+    return cnt;
+}
+
+/*
+ * Buffers taken from the pool so far, over all classes
+ */
+static uint32_t gatt_bench_pool_allocs(void)
+{
+    beacon_pool_stats_t stats;
+    uint32_t allocs = 0;
+    uint8_t  c;
+
+    for (c = 0; c < BEACON_POOL_CLASS_CNT; c++)
+    {
+        beacon_pool_get_stats(c, &stats);
+        allocs += stats.allocs;
+    }
+    return allocs;
+}
+
+/*
+ * Checks the last response against the values of the handles, every value
+ * byte is the low byte of its handle
+ */
+static void gatt_bench_check_rsp(const uint16_t *p_handles, uint16_t cnt, uint8_t field)
+{
+    const gatt_db_lookup_table_t *p_attr;
+    const uint8_t *p_rsp;
+    uint16_t len, off = 0, i, k;
+
+    p_rsp = host_stub_gatt_rsp(&len);
+    for (i = 0; i < cnt; i++)
+    {
+        p_attr = beacon_gatt_attr_find(p_handles[i]);
+        BENCH_CHECK(p_attr != NULL);
+        if (field != GATT_BENCH_FIELD_NONE)
+        {
+            uint16_t expected = (field == GATT_BENCH_FIELD_HANDLE) ? p_handles[i] : p_attr->cur_len;
+
+            BENCH_CHECK(off + 2 <= len && (p_rsp[off] | (p_rsp[off + 1] << 8)) == expected);
+            off += 2;
+        }
+        for (k = 0; k < p_attr->cur_len; k++)
+        {
+            BENCH_CHECK(off < len && p_rsp[off++] == (uint8_t)p_handles[i]);
+        }
+    }
+    BENCH_CHECK(off == len);
+}
+
+static void gatt_bench_run_case(const gatt_bench_case_t *p_case, uint32_t iterations)
+{
+    wiced_bt_gatt_event_data_t evt;
+    uint16_t scan_handles[GATT_BENCH_MATCH_MAX], index_handles[GATT_BENCH_MATCH_MAX];
+    uint16_t scan_cnt = 0, index_cnt = 0;
+    uint64_t start, scan_ns, index_ns, req_ns;
+    uint32_t i, allocs;
+
+    start = bench_now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        scan_cnt = gatt_bench_scan(p_case, scan_handles);
+    }
+    scan_ns = bench_now_ns() - start;
+
+    start = bench_now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        index_cnt = gatt_bench_index(p_case, index_handles);
+    }
+    index_ns = bench_now_ns() - start;
+
+    BENCH_CHECK(scan_cnt == p_case->matches);
+    BENCH_CHECK(index_cnt == scan_cnt);
+    BENCH_CHECK(memcmp(index_handles, scan_handles, scan_cnt * sizeof(uint16_t)) == 0);
+
+    memset(&evt, 0, sizeof(evt));
+    evt.attribute_request.opcode                 = GATT_REQ_READ_BY_TYPE;
+    evt.attribute_request.data.read_by_type.uuid = p_case->uuid;
+    evt.attribute_request.len_requested          = GATT_BENCH_RSP_LEN;
+
+    host_stub_reset_counters();
+    allocs = gatt_bench_pool_allocs();
+    start = bench_now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        evt.attribute_request.data.read_by_type.s_handle = p_case->s_handle;
+        evt.attribute_request.data.read_by_type.e_handle = p_case->e_handle;
+        BENCH_CHECK(beacon_gatts_callback(GATT_ATTRIBUTE_REQUEST_EVT, &evt) == WICED_BT_GATT_SUCCESS);
+    }
+    req_ns = bench_now_ns() - start;
+    allocs = gatt_bench_pool_allocs() - allocs;
+
+    BENCH_CHECK(host_stub_counters.gatt_rsp == iterations);
+    BENCH_CHECK(host_stub_counters.buffers_alloc == 0);
+    BENCH_CHECK(host_stub_counters.gatt_rsp_bytes == (uint64_t)iterations * p_case->matches * (p_case->value_len + 2));
+    gatt_bench_check_rsp(index_handles, index_cnt, GATT_BENCH_FIELD_HANDLE);
+
+    printf("%-40s %8u %10.1f %10.1f %11.1f %7.1f\n", p_case->name, p_case->matches, (double)scan_ns / iterations,
+           (double)index_ns / iterations, (double)req_ns / iterations, (double)allocs / iterations);
+}
+
+/*
+ * Read Multiple of a handle list, plain and variable length
+ */
+static void gatt_bench_run_multi(const char *name, const uint16_t *p_handles, uint16_t cnt, uint32_t iterations)
+{
+    static const wiced_bt_gatt_opcode_t opcodes[] = { GATT_REQ_READ_MULTI, GATT_REQ_READ_MULTI_VAR_LENGTH };
+    wiced_bt_gatt_event_data_t evt;
+    uint8_t  stream[2 * GATT_BENCH_MATCH_MAX];
+    uint64_t start, req_ns;
+    uint32_t i, o, allocs;
+    uint8_t *p = stream;
+    char     row[64];
+
+    for (i = 0; i < cnt; i++)
+    {
+        UINT16_TO_STREAM(p, p_handles[i]);
+    }
+
+    for (o = 0; o < sizeof(opcodes) / sizeof(opcodes[0]); o++)
+    {
+        memset(&evt, 0, sizeof(evt));
+        evt.attribute_request.opcode                                 = opcodes[o];
+        evt.attribute_request.data.read_multiple_req.num_handles     = cnt;
+        evt.attribute_request.data.read_multiple_req.p_handle_stream = stream;
+        evt.attribute_request.len_requested                          = GATT_BENCH_RSP_LEN;
+
+        host_stub_reset_counters();
+        allocs = gatt_bench_pool_allocs();
+        start = bench_now_ns();
+        for (i = 0; i < iterations; i++)
+        {
+            BENCH_CHECK(beacon_gatts_callback(GATT_ATTRIBUTE_REQUEST_EVT, &evt) == WICED_BT_GATT_SUCCESS);
+        }
+        req_ns = bench_now_ns() - start;
+        allocs = gatt_bench_pool_allocs() - allocs;
+
+        BENCH_CHECK(host_stub_counters.gatt_rsp == iterations);
+        gatt_bench_check_rsp(p_handles, cnt, (opcodes[o] == GATT_REQ_READ_MULTI_VAR_LENGTH) ?
+                             GATT_BENCH_FIELD_LEN : GATT_BENCH_FIELD_NONE);
+
+        snprintf(row, sizeof(row), "%s%s", name, o ? ", var length" : "");
+        printf("%-40s %8u %10s %10s %11.1f %7.1f\n", row, cnt, "", "", (double)req_ns / iterations,
+               (double)allocs / iterations);
+    }
+}
+
+/*
+ * Returns the permission of a handle from the type index, apart from the
+ * handle-indexed table the write handler reads
+ */
+static uint8_t gatt_bench_perm(uint16_t handle)
+{
+    uint16_t pos;
+
+    for (pos = 0; pos < beacon_gatt_index_count(); pos++)
+    {
+        if (beacon_gatt_index_handle(pos) == handle)
+        {
+            return beacon_gatt_index_perm(pos);
+        }
+    }
+    return LEGATTDB_PERM_NONE;
+}
+
+/*
+ * Writes every handle and checks only the writable attributes take the value
+ */
+static void gatt_bench_check_write(uint16_t last)
+{
+    wiced_bt_gatt_event_data_t evt;
+    uint8_t  val = 0, old = 0;
+    uint16_t handle;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.attribute_request.opcode                 = GATT_REQ_WRITE;
+    evt.attribute_request.data.write_req.p_val   = &val;
+    evt.attribute_request.data.write_req.val_len = 1;
+    for (handle = 1; handle <= last; handle++)
+    {
+        gatt_db_lookup_table_t *p_attr = beacon_gatt_attr_find(handle);
+        wiced_bt_gatt_status_t  expected = WICED_BT_GATT_INVALID_HANDLE;
+
+        if (p_attr != NULL)
+        {
+            expected = (gatt_bench_perm(handle) & LEGATTDB_PERM_WRITABLE) ?
+                       WICED_BT_GATT_SUCCESS : WICED_BT_GATT_WRITE_NOT_PERMIT;
+            old = p_attr->p_data[0];
+            val = (uint8_t)~old;
+        }
+        evt.attribute_request.data.write_req.handle = handle;
+        BENCH_CHECK(beacon_gatts_callback(GATT_ATTRIBUTE_REQUEST_EVT, &evt) == expected);
+        if (p_attr != NULL)
+        {
+            BENCH_CHECK(p_attr->p_data[0] == ((expected == WICED_BT_GATT_SUCCESS) ? val : old));
+        }
+    }
+}
+
+/*
+ * Response buffer round trip through the GATT callback against malloc and free
+ */
+static void gatt_bench_run_buffers(uint32_t iterations)
+{
+    static const uint16_t lens[] = { BEACON_POOL_SMALL_SIZE, BEACON_POOL_MEDIUM_SIZE, BEACON_POOL_LARGE_SIZE };
+    wiced_bt_gatt_event_data_t evt, xmit;
+    beacon_pool_stats_t stats;
+    uint64_t start, pool_ns, malloc_ns;
+    uint32_t i, l;
+    char     name[48];
+
+    printf("\n%-40s %8s %10s %10s\n", "response buffer", "bytes", "pool ns", "malloc ns");
+    for (l = 0; l < sizeof(lens) / sizeof(lens[0]); l++)
+    {
+        start = bench_now_ns();
+        for (i = 0; i < iterations; i++)
+        {
+            evt.buffer_request.len_requested = lens[l];
+            beacon_gatts_callback(GATT_GET_RESPONSE_BUFFER_EVT, &evt);
+            BENCH_CHECK(evt.buffer_request.buffer.p_app_rsp_buffer != NULL);
+            evt.buffer_request.buffer.p_app_rsp_buffer[0] = (uint8_t)i;
+
+            xmit.buffer_xmitted.p_app_data = evt.buffer_request.buffer.p_app_rsp_buffer;
+            xmit.buffer_xmitted.p_app_ctxt = evt.buffer_request.buffer.p_app_ctxt;
+            beacon_gatts_callback(GATT_APP_BUFFER_TRANSMITTED_EVT, &xmit);
+        }
+        pool_ns = bench_now_ns() - start;
+
+        start = bench_now_ns();
+        for (i = 0; i < iterations; i++)
+        {
+            uint8_t *volatile p = malloc(lens[l]);
+
+            BENCH_CHECK(p != NULL);
+            p[0] = (uint8_t)i;
+            free(p);
+        }
+        malloc_ns = bench_now_ns() - start;
+
+        snprintf(name, sizeof(name), "get + transmitted, class %u", l);
+        printf("%-40s %8u %10.1f %10.1f\n", name, lens[l], (double)pool_ns / iterations,
+               (double)malloc_ns / iterations);
+    }
+
+    printf("\n%-40s %8s %10s %10s %10s\n", "pool class", "blocks", "high water", "allocs", "fails");
+    for (l = 0; l < BEACON_POOL_CLASS_CNT; l++)
+    {
+        beacon_pool_get_stats(l, &stats);
+        snprintf(name, sizeof(name), "%u B", stats.size);
+        printf("%-40s %8u %10u %10u %10u\n", name, stats.blocks, stats.high_water, stats.allocs, stats.fails);
+        BENCH_CHECK(stats.in_use == 0);
+        BENCH_CHECK(stats.fails == 0);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t iterations = bench_iterations(argc, argv, BENCH_DEFAULT_ITERATIONS) / 10;
+    uint16_t last, attrs, mid;
+    uint32_t c;
+
+    if (iterations == 0)
+    {
+        iterations = 1;
+    }
+
+    // response buffers go back to the pool through the transmitted event
+    beacon_pool_init();
+    wiced_bt_gatt_register(beacon_gatts_callback);
+    last = gatt_bench_build();
+    BENCH_CHECK(wiced_bt_gatt_db_init(gatt_bench_db, gatt_bench_db_len, NULL) == WICED_BT_GATT_SUCCESS);
+    BENCH_CHECK(beacon_gatt_db_init(gatt_bench_db, gatt_bench_db_len, gatt_bench_attr_tbl, gatt_bench_attr_cnt));
+    attrs = beacon_gatt_index_init(gatt_bench_db, gatt_bench_db_len);
+    BENCH_CHECK(attrs == last);
+
+    // first handle of the middle service
+    mid = 4 + (GATT_BENCH_SERVICES / 2) * GATT_BENCH_SERVICE_ATTRS;
+
+    {
+        const gatt_bench_case_t cases[] =
+        {
+            { "Device Name, first service",
+              { LEN_UUID_16, { .uuid16 = GATT_BENCH_DEVICE_NAME } }, 1, 0xFFFF, 1, 13 },
+            { "custom UUID16, last service",
+              { LEN_UUID_16, { .uuid16 = GATT_BENCH_CUSTOM_BASE + GATT_BENCH_SERVICES - 1 } }, 1, 0xFFFF, 1, 4 },
+            { "custom UUID128, last service",
+              { LEN_UUID_128, { .uuid128 = { GATT_BENCH_UUID128(GATT_BENCH_SERVICES - 1) } } }, 1, 0xFFFF, 1, 8 },
+            { "Battery Level, one per service",
+              { LEN_UUID_16, { .uuid16 = GATT_BENCH_BATTERY_LEVEL } }, 1, 0xFFFF, GATT_BENCH_SERVICES, 1 },
+            { "CCCD, two per service",
+              { LEN_UUID_16, { .uuid16 = GATT_UUID_CHAR_CLIENT_CONFIG } }, 1, 0xFFFF, 2 * GATT_BENCH_SERVICES, 2 },
+            { "CCCD, middle service range",
+              { LEN_UUID_16, { .uuid16 = GATT_UUID_CHAR_CLIENT_CONFIG } }, mid, mid + GATT_BENCH_SERVICE_ATTRS - 1, 2, 2 },
+        };
+
+        printf("GATT Read By Type benchmark, %u attributes, %u requests per case\n\n", attrs, iterations);
+        printf("%-40s %8s %10s %10s %11s %7s\n", "type", "matches", "scan ns", "index ns", "request ns", "allocs");
+        for (c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+        {
+            gatt_bench_run_case(&cases[c], iterations);
+        }
+    }
+
+    {
+        // Device Name and the first Battery Level are static, the custom UUID16 value is writable
+        const uint16_t static_handles[]  = { 3, 6 };
+        const uint16_t dynamic_handles[] = { 3, 9 };
+        beacon_gatt_rsp_stats_t rsp_stats;
+
+        printf("\n");
+        gatt_bench_run_multi("Read Multiple, static", static_handles, 2, iterations);
+        gatt_bench_run_multi("Read Multiple, one writable", dynamic_handles, 2, iterations);
+
+        beacon_gatt_rsp_get_stats(&rsp_stats);
+        printf("  response cache hits %u  misses %u\n", rsp_stats.hits, rsp_stats.misses);
+    }
+    gatt_bench_check_write(last);
+    gatt_bench_run_buffers(iterations);
+    return 0;
+}
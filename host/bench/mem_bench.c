@@ -0,0 +1,188 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host benchmark of the application heap.
+*
+* Runs the application in legacy and extended adv mode with a number of zone
+* iBeacons and reports the heap each module holds, the payload arena against
+* the five data_max slots it used to take, and the total against the
+* application heap. Then looks for the most zone iBeacons each mode fits in
+* the heap. Every configuration runs in its own process so the application
+* starts clean.
+*
+* Usage: mem_bench [rotations]
+*/
+#include "wiced_bt_beacon.h"
+#include "host_stub.h"
+#include "beacon.h"
+#include "beacon_mem.h"
+#include "beacon_cache.h"
+#include "bench_util.h"
+#include <sys/wait.h>
+#include <unistd.h>
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+#define MEM_DEFAULT_ROTATIONS       100
+#define MEM_ZONE_MAX                251
+
+/* Exit status of a configuration that does not fit in the heap */
+#define MEM_EXIT_OVER_BUDGET        3
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint16_t     zones;
+    uint8_t      sets;
+    wiced_bool_t ext;
+} mem_config_t;
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+static const mem_config_t mem_configs[] =
+{
+    {   0,  4, WICED_FALSE },
+    {  27,  4, WICED_FALSE },
+    { 123,  8, WICED_FALSE },
+    { 251,  8, WICED_FALSE },
+    {   0,  4, WICED_TRUE  },
+    {  27,  4, WICED_TRUE  },
+    { 123,  8, WICED_TRUE  },
+    { 251, 16, WICED_TRUE  },
+};
+
+/******************************************************************************
+ *     Private Function Definitions
+ ******************************************************************************/
+
+/*
+ * Starts the application in a configuration, rotates and returns the heap stats
+ */
+static void mem_start(const mem_config_t *p_cfg, uint32_t rotations, beacon_mem_stats_t *p_stats)
+{
+    host_stub_set_num_ext_adv_sets(p_cfg->sets);
+    beacon_set_zone_beacons(p_cfg->zones);
+    beacon_set_ext_adv(p_cfg->ext);
+
+    host_stub_reset_counters();
+    application_start();
+    host_stub_bt_enable();
+    host_stub_advance_ms(rotations * 1000);
+    BENCH_CHECK(host_stub_counters.disallowed == 0);
+
+    beacon_mem_get_stats(p_stats);
+}
+
+static void mem_run(const mem_config_t *p_cfg, uint32_t rotations)
+{
+    beacon_mem_stats_t stats;
+    uint32_t data_max = p_cfg->ext ? WICED_BT_BEACON_EXT_ADV_DATA_MAX : WICED_BT_BEACON_ADV_DATA_MAX;
+    uint32_t arena_old = BEACON_CACHE_SLOTS * data_max;
+    uint32_t sum = 0;
+    uint8_t  module, bufs = 0;
+
+    mem_start(p_cfg, rotations, &stats);
+
+    for (module = 0; module < BEACON_MEM_MODULES; module++)
+    {
+        sum += stats.bytes[module];
+        bufs += (stats.bytes[module] != 0);
+    }
+    BENCH_CHECK(stats.total == sum + bufs * BEACON_MEM_BUF_OVERHEAD);
+    BENCH_CHECK(stats.high_water >= stats.total);
+
+    // the arena replaces the data_max slots and the data_max staging buffer on the stack
+    BENCH_CHECK(stats.bytes[BEACON_MEM_CACHE] <= arena_old + data_max);
+    if (!p_cfg->ext)
+    {
+        BENCH_CHECK(stats.bytes[BEACON_MEM_CACHE] < arena_old);
+    }
+
+    printf("%-6s %6u %5u %7u %7u %7u %7u %7u %7u %9u %7u %7u\n", p_cfg->ext ? "ext" : "legacy",
+           p_cfg->zones, p_cfg->sets, stats.bytes[BEACON_MEM_TABLE], stats.bytes[BEACON_MEM_CTRL],
+           stats.bytes[BEACON_MEM_CACHE], stats.bytes[BEACON_MEM_GATT], stats.bytes[BEACON_MEM_GATT_INDEX],
+           stats.bytes[BEACON_MEM_GATT_RSP], arena_old, stats.total, stats.high_water);
+}
+
+/*
+ * Runs a configuration in a child process, returns its exit status
+ */
+static int mem_fork(const mem_config_t *p_cfg, uint32_t rotations, wiced_bool_t report)
+{
+    beacon_mem_stats_t stats;
+    pid_t pid;
+    int   status;
+
+    fflush(stdout);
+    pid = fork();
+    BENCH_CHECK(pid >= 0);
+    if (pid == 0)
+    {
+        if (report)
+        {
+            mem_run(p_cfg, rotations);
+            fflush(stdout);
+            _exit(0);
+        }
+        mem_start(p_cfg, rotations, &stats);
+        _exit(stats.high_water <= BEACON_MEM_HEAP_SIZE ? 0 : MEM_EXIT_OVER_BUDGET);
+    }
+    BENCH_CHECK(waitpid(pid, &status, 0) == pid);
+    BENCH_CHECK(WIFEXITED(status));
+    return WEXITSTATUS(status);
+}
+
+/*
+ * Returns the most zone iBeacons a mode fits in the heap, the heap grows with them
+ */
+static uint16_t mem_zones_max(wiced_bool_t ext, uint8_t sets, uint32_t rotations)
+{
+    mem_config_t cfg = { 0, sets, ext };
+    uint16_t lo = 0, hi = MEM_ZONE_MAX;
+
+    BENCH_CHECK(mem_fork(&cfg, rotations, WICED_FALSE) == 0);
+    while (lo < hi)
+    {
+        cfg.zones = (uint16_t)((lo + hi + 1) / 2);
+        if (mem_fork(&cfg, rotations, WICED_FALSE) == 0)
+        {
+            lo = cfg.zones;
+        }
+        else
+        {
+            hi = cfg.zones - 1;
+        }
+    }
+    return lo;
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t rotations = bench_iterations(argc, argv, MEM_DEFAULT_ROTATIONS * 10000) / 10000;
+    uint32_t c;
+
+    if (rotations == 0)
+    {
+        rotations = 1;
+    }
+
+    printf("Beacon heap benchmark, %u rotations, heap %d bytes\n\n", rotations, BEACON_MEM_HEAP_SIZE);
+    printf("%-6s %6s %5s %7s %7s %7s %7s %7s %7s %9s %7s %7s\n", "mode", "zones", "sets", "table", "ctrl",
+           "arena", "gatt", "index", "rsp", "arena old", "total", "high");
+
+    for (c = 0; c < sizeof(mem_configs) / sizeof(mem_configs[0]); c++)
+    {
+        BENCH_CHECK(mem_fork(&mem_configs[c], rotations, WICED_TRUE) == 0);
+    }
+
+    printf("\nmost zone iBeacons in the heap: legacy %u (8 sets), ext %u (16 sets)\n",
+           mem_zones_max(WICED_FALSE, 8, 1), mem_zones_max(WICED_TRUE, 16, 1));
+    return 0;
+}
@@ -0,0 +1,272 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host benchmark of the factory provisioning generator.
+*
+* A lot is generated into a temporary file on one thread and then on one
+* thread per core, and both files must be byte for byte the same. Every blob
+* of the lot must pass its check, be found in the index by its random
+* address, and carry adv data that the gateway decoder decodes back to its
+* fields. One blob is then given to the application on the stub, which must
+* advertise its iBeacon, UID and EID identity from its random address.
+*
+* Usage: provision_bench [devices]
+*/
+#include "wiced_bt_beacon.h"
+#include "host_stub.h"
+#include "beacon.h"
+#include "beacon_eid.h"
+#include "beacon_decode.h"
+#include "beacon_provision_gen.h"
+#include "bench_util.h"
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+/* Devices of the lot unless given on the command line */
+#define PROVISION_BENCH_DEVICES     100000
+
+/* EID rotation exponent of the application, see beacon.c */
+#define PROVISION_BENCH_EID_EXPONENT 10
+
+/* Seconds to watch the application */
+#define PROVISION_BENCH_APP_SECONDS 30
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    const uint8_t *p_map;
+    size_t         len;
+} provision_bench_file_t;
+
+/******************************************************************************
+ *                          Private Function Definitions
+ ******************************************************************************/
+
+/*
+ * Makes a temporary file name, the generator creates the file
+ */
+static void provision_bench_tmp_path(char *p_path, size_t len)
+{
+    const char *p_dir = getenv("TMPDIR");
+    int fd;
+
+    snprintf(p_path, len, "%s/provision_bench.XXXXXX", (p_dir != NULL) ? p_dir : "/tmp");
+    fd = mkstemp(p_path);
+    BENCH_CHECK(fd >= 0);
+    close(fd);
+}
+
+static void provision_bench_map(const char *p_path, provision_bench_file_t *p_file)
+{
+    struct stat st;
+    void *p_map;
+    int fd = open(p_path, O_RDONLY);
+
+    BENCH_CHECK(fd >= 0 && fstat(fd, &st) == 0);
+    p_map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    BENCH_CHECK(p_map != MAP_FAILED);
+    close(fd);
+    p_file->p_map = (const uint8_t *)p_map;
+    p_file->len = (size_t)st.st_size;
+}
+
+/*
+ * Decodes one frame of adv data, which must hold exactly one
+ */
+static void provision_bench_decode(const uint8_t *p_data, uint8_t len, uint8_t kind, beacon_decode_frame_t *p_frame)
+{
+    beacon_decode_frame_t frames[BEACON_DECODE_REPORT_FRAMES_MAX];
+    beacon_decode_stats_t stats;
+
+    memset(&stats, 0, sizeof(stats));
+    BENCH_CHECK(beacon_decode_report(p_data, len, 0, frames, &stats) == 1);
+    BENCH_CHECK(frames[0].kind == kind);
+    *p_frame = frames[0];
+}
+
+/*
+ * Checks the blob of every device of a mapped lot
+ */
+static void provision_bench_check_lot(const provision_bench_file_t *p_file, const beacon_provision_lot_t *p_lot)
+{
+    const beacon_provision_file_hdr_t *p_hdr = beacon_provision_file_open(p_file->p_map, p_file->len);
+    const beacon_provision_t *p_prov;
+    beacon_decode_frame_t frame;
+    uint64_t t0;
+    uint32_t i, serial;
+
+    BENCH_CHECK(p_hdr != NULL);
+    BENCH_CHECK(p_hdr->device_cnt == p_lot->device_cnt && p_hdr->first_serial == p_lot->first_serial);
+    BENCH_CHECK(p_hdr->blob_offset % BEACON_PROVISION_FILE_ALIGN == 0);
+
+    t0 = bench_now_ns();
+    for (i = 0; i < p_lot->device_cnt; i++)
+    {
+        serial = p_lot->first_serial + i;
+        p_prov = beacon_provision_file_blob(p_file->p_map, serial);
+        BENCH_CHECK(p_prov != NULL && beacon_provision_check(p_prov) && p_prov->serial == serial);
+        BENCH_CHECK(beacon_provision_file_find(p_file->p_map, p_prov->random_bda) == p_prov);
+        BENCH_CHECK((p_prov->random_bda[0] & 0xc0) == 0xc0);
+        BENCH_CHECK(p_prov->ibeacon_major == p_lot->first_major + (i >> 16) && p_prov->ibeacon_minor == (uint16_t)i);
+
+        provision_bench_decode(p_prov->ibeacon_adv, p_prov->ibeacon_adv_len, BEACON_DECODE_IBEACON, &frame);
+        BENCH_CHECK(memcmp(frame.u.ibeacon.uuid, p_lot->ibeacon_uuid, LEN_UUID_128) == 0);
+        BENCH_CHECK(frame.u.ibeacon.major == p_prov->ibeacon_major && frame.u.ibeacon.minor == p_prov->ibeacon_minor);
+        BENCH_CHECK((uint8_t)frame.tx_power == p_lot->ibeacon_tx_power);
+
+        provision_bench_decode(p_prov->uid_adv, p_prov->uid_adv_len, BEACON_DECODE_EDDYSTONE_UID, &frame);
+        BENCH_CHECK(memcmp(frame.u.uid.namespace_id, p_lot->namespace_id, EDDYSTONE_UID_NAMESPACE_LEN) == 0);
+        BENCH_CHECK(memcmp(frame.u.uid.instance, p_prov->instance, EDDYSTONE_UID_INSTANCE_ID_LEN) == 0);
+        BENCH_CHECK((uint8_t)frame.tx_power == p_lot->ranging_data);
+    }
+    BENCH_CHECK(beacon_provision_file_blob(p_file->p_map, p_lot->first_serial + p_lot->device_cnt) == NULL);
+    printf("%-36s %10.1f ns per device, blob, index and adv data checked\n", "check",
+           (double)(bench_now_ns() - t0) / p_lot->device_cnt);
+}
+
+/*
+ * Provisions the application with one blob and checks what it advertises
+ */
+static void provision_bench_run_app(const beacon_provision_t *p_prov)
+{
+    beacon_decode_frame_t frames[BEACON_DECODE_REPORT_FRAMES_MAX];
+    beacon_decode_stats_t stats;
+    beacon_provision_t bad, late;
+    uint8_t eid[EDDYSTONE_EID_LEN];
+    const uint8_t *p_data, *p_bda;
+    uint32_t seen = 0, n, i;
+    uint16_t len;
+    uint8_t set, sec;
+
+    // a blob that fails its check leaves the sample values
+    memcpy(&bad, p_prov, sizeof(bad));
+    bad.ibeacon_minor ^= 1;
+    BENCH_CHECK(!beacon_set_provisioning(&bad));
+    BENCH_CHECK(beacon_set_provisioning(p_prov));
+
+    // a valid blob of another device, too late to take
+    memcpy(&late, p_prov, sizeof(late));
+    late.serial++;
+    BENCH_CHECK(beacon_provision_seal(&late));
+
+    application_start();
+    host_stub_bt_enable();
+
+    // the static beacons have no cache slots now, the identity stays
+    BENCH_CHECK(!beacon_set_provisioning(&late));
+    beacon_eid_compute(p_prov->eid_key, PROVISION_BENCH_EID_EXPONENT, 0, eid);
+    memset(&stats, 0, sizeof(stats));
+
+    for (sec = 0; sec < PROVISION_BENCH_APP_SECONDS; sec++)
+    {
+        for (set = 1; set <= HOST_STUB_MAX_ADV_SETS; set++)
+        {
+            p_data = host_stub_adv_data(set, &len);
+            if (p_data == NULL || !host_stub_adv_enabled(set))
+            {
+                continue;
+            }
+            n = beacon_decode_report(p_data, len, set, frames, &stats);
+            for (i = 0; i < n; i++)
+            {
+                switch (frames[i].kind)
+                {
+                case BEACON_DECODE_IBEACON:
+                    BENCH_CHECK(memcmp(frames[i].u.ibeacon.uuid, p_prov->ibeacon_uuid, LEN_UUID_128) == 0);
+                    BENCH_CHECK(frames[i].u.ibeacon.major == p_prov->ibeacon_major);
+                    BENCH_CHECK(frames[i].u.ibeacon.minor == p_prov->ibeacon_minor);
+                    break;
+                case BEACON_DECODE_EDDYSTONE_UID:
+                    BENCH_CHECK(memcmp(frames[i].u.uid.namespace_id, p_prov->namespace_id,
+                                       EDDYSTONE_UID_NAMESPACE_LEN) == 0);
+                    BENCH_CHECK(memcmp(frames[i].u.uid.instance, p_prov->instance, EDDYSTONE_UID_INSTANCE_ID_LEN) == 0);
+                    break;
+                case BEACON_DECODE_EDDYSTONE_EID:
+                    BENCH_CHECK(memcmp(frames[i].u.eid, eid, EDDYSTONE_EID_LEN) == 0);
+                    break;
+                default:
+                    continue;
+                }
+                seen |= 1u << frames[i].kind;
+
+                // the set owner is mixed into bytes 1 and 2 only
+                p_bda = host_stub_adv_random_address(set);
+                BENCH_CHECK(p_bda[0] == p_prov->random_bda[0]);
+                BENCH_CHECK(memcmp(&p_bda[3], &p_prov->random_bda[3], BD_ADDR_LEN - 3) == 0);
+            }
+        }
+        host_stub_advance_ms(1000);
+    }
+    BENCH_CHECK(stats.malformed == 0);
+    BENCH_CHECK(seen == ((1u << BEACON_DECODE_IBEACON) | (1u << BEACON_DECODE_EDDYSTONE_UID) |
+                         (1u << BEACON_DECODE_EDDYSTONE_EID)));
+    printf("application: serial %u advertises its iBeacon, UID and EID identity\n", p_prov->serial);
+}
+
+int main(int argc, char *argv[])
+{
+    static const uint8_t crc_check[] = "123456789";
+    beacon_provision_lot_t lot;
+    beacon_provision_timing_t timing;
+    provision_bench_file_t one, all;
+    char path_one[256], path_all[256];
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t i;
+
+    BENCH_CHECK(sizeof(beacon_provision_t) == BEACON_PROVISION_SIZE);
+    BENCH_CHECK(sizeof(beacon_provision_file_hdr_t) == 48 && sizeof(beacon_provision_index_t) == 12);
+    BENCH_CHECK(beacon_provision_crc32(0, crc_check, sizeof(crc_check) - 1) == 0xcbf43926u);
+
+    memset(&lot, 0, sizeof(lot));
+    for (i = 0; i < sizeof(lot.master_key); i++)
+    {
+        lot.master_key[i] = (uint8_t)(0x5a ^ i);
+        lot.ibeacon_uuid[i] = (uint8_t)i;
+    }
+    memcpy(lot.namespace_id, "\x01\x02\x03\x04\x05\x06\x07\x08\x09\x00", EDDYSTONE_UID_NAMESPACE_LEN);
+    lot.first_major = 100;
+    lot.first_serial = 2000000;
+    lot.device_cnt = bench_iterations(argc, argv, PROVISION_BENCH_DEVICES);
+    lot.ibeacon_tx_power = 0xb3;
+    lot.ranging_data = 0xf0;
+
+    printf("Factory provisioning benchmark, %u devices of %u bytes\n\n", lot.device_cnt, BEACON_PROVISION_SIZE);
+    provision_bench_tmp_path(path_one, sizeof(path_one));
+    provision_bench_tmp_path(path_all, sizeof(path_all));
+
+    lot.threads = 1;
+    BENCH_CHECK(beacon_provision_generate(&lot, path_one, &timing) == BEACON_PROVISION_OK);
+    printf("%-36s %10.1f ns per device, %.0f devices/s, index %.1f ms, %.1f MB\n", "generate, 1 thread",
+           (double)timing.generate_ns / lot.device_cnt, lot.device_cnt * 1e9 / (double)timing.generate_ns,
+           timing.index_ns / 1e6, timing.file_size / 1e6);
+
+    lot.threads = (cores < 1) ? 1 : (cores > BEACON_PROVISION_THREADS_MAX) ? BEACON_PROVISION_THREADS_MAX : (uint32_t)cores;
+    BENCH_CHECK(beacon_provision_generate(&lot, path_all, &timing) == BEACON_PROVISION_OK);
+    printf("%-36s %10.1f ns per device, %.0f devices/s, %u threads\n", "generate, thread per core",
+           (double)timing.generate_ns / lot.device_cnt, lot.device_cnt * 1e9 / (double)timing.generate_ns,
+           lot.threads);
+
+    provision_bench_map(path_one, &one);
+    provision_bench_map(path_all, &all);
+    BENCH_CHECK(one.len == all.len && memcmp(one.p_map, all.p_map, one.len) == 0);
+    unlink(path_one);
+    unlink(path_all);
+
+    provision_bench_check_lot(&all, &lot);
+    provision_bench_run_app(beacon_provision_file_blob(all.p_map, lot.first_serial + lot.device_cnt / 2));
+
+    munmap((void *)one.p_map, one.len);
+    munmap((void *)all.p_map, all.len);
+    return 0;
+}
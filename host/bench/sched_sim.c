@@ -0,0 +1,136 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host simulation of the beacon air-time scheduler.
+*
+* Runs each scheduler policy over a set of scenarios (beacon targets and
+* number of hardware adv sets) and reports, for every beacon, the achieved
+* on-air share against its target, the longest time off air against its
+* staleness limit and the missed deadlines, plus the adv set swaps and the
+* controller commands per tick. A start costs the four commands issued by
+* beacon_start() (parameters, address, data, enable), a stop costs one.
+*
+* Usage: sched_sim [ticks]
+*/
+#include "beacon_sched.h"
+#include "bench_util.h"
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+#define SIM_DEFAULT_TICKS       100000
+#define SIM_MAX_BEACONS         16
+#define SIM_CMDS_PER_START      4
+#define SIM_CMDS_PER_STOP       1
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    const char                  *name;
+    const beacon_sched_target_t *p_target;
+    uint16_t                     cnt;
+    uint16_t                     sets;
+    wiced_bool_t                 feasible;  /* Deadline policy must meet every target */
+} sim_scenario_t;
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+/* Targets of beacon.c: iBeacon, UID, URL, EID, TLM */
+static const beacon_sched_target_t sim_app_targets[] =
+{
+    { 800, 2}, { 800, 3}, { 800, 2}, { 600, 4}, {1000, 1},
+};
+
+/* Mixed fleet, a few fast beacons with tight deadlines and many slow ones */
+static const beacon_sched_target_t sim_mixed_targets[] =
+{
+    {1000, 1}, { 500, 2}, { 500, 2}, { 250, 4}, { 250, 4}, { 250, 6},
+    { 250, 6}, { 200, 8}, { 200, 8}, { 200, 0}, { 100, 0}, { 100, 0},
+};
+
+static const sim_scenario_t sim_scenarios[] =
+{
+    { "app targets, 4 sets",   sim_app_targets,   5,  4, WICED_TRUE  },
+    { "app targets, 2 sets",   sim_app_targets,   5,  2, WICED_FALSE },
+    { "mixed fleet, 4 sets",   sim_mixed_targets, 12, 4, WICED_TRUE  },
+};
+
+static const beacon_sched_policy_t *sim_policies[] =
+{
+    &beacon_sched_round_robin,
+    &beacon_sched_deadline,
+};
+
+/******************************************************************************
+ *     Private Function Definitions
+ ******************************************************************************/
+static void sim_run(const sim_scenario_t *p_scn, const beacon_sched_policy_t *p_policy, uint32_t ticks)
+{
+    beacon_sched_t       sched;
+    beacon_sched_state_t state[SIM_MAX_BEACONS];
+    uint16_t             stop[SIM_MAX_BEACONS], start[SIM_MAX_BEACONS];
+    uint16_t             stop_cnt, start_cnt, i, on;
+    uint32_t             t, cmds = 0, missed = 0;
+    uint64_t             begin, elapsed;
+
+    beacon_sched_init(&sched, p_policy, p_scn->p_target, state, p_scn->cnt, p_scn->sets);
+
+    begin = bench_now_ns();
+    for (t = 0; t < ticks; t++)
+    {
+        beacon_sched_tick(&sched, stop, &stop_cnt, start, &start_cnt);
+        cmds += stop_cnt * SIM_CMDS_PER_STOP + start_cnt * SIM_CMDS_PER_START;
+
+        for (i = 0, on = 0; i < p_scn->cnt; i++)
+        {
+            on += state[i].on;
+        }
+        BENCH_CHECK(on <= p_scn->sets);
+    }
+    elapsed = bench_now_ns() - begin;
+
+    printf("\n%s, %s\n", p_scn->name, p_policy->name);
+    printf("  %6s %8s %8s %10s %8s %8s\n", "beacon", "target", "share", "max stale", "max off", "missed");
+    for (i = 0; i < p_scn->cnt; i++)
+    {
+        double share = (double)state[i].on_ticks * BEACON_SCHED_SHARE_FULL / ticks;
+
+        printf("  %6u %8u %8.1f %10u %8u %8u\n", i, p_scn->p_target[i].share, share,
+               p_scn->p_target[i].max_stale, state[i].max_off_age, state[i].missed);
+        missed += state[i].missed;
+
+        if (p_scn->feasible && p_policy == &beacon_sched_deadline)
+        {
+            BENCH_CHECK(share >= p_scn->p_target[i].share - 10);
+        }
+    }
+    printf("  swaps/tick %.3f  cmds/tick %.3f  missed %u  ns/tick %.1f\n",
+           (double)sched.swaps / ticks, (double)cmds / ticks, missed, (double)elapsed / ticks);
+
+    if (p_scn->feasible && p_policy == &beacon_sched_deadline)
+    {
+        BENCH_CHECK(missed == 0);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t ticks = bench_iterations(argc, argv, SIM_DEFAULT_TICKS);
+    uint32_t s, p;
+
+    printf("Beacon scheduler simulation, %u ticks\n", ticks);
+    for (s = 0; s < sizeof(sim_scenarios) / sizeof(sim_scenarios[0]); s++)
+    {
+        for (p = 0; p < sizeof(sim_policies) / sizeof(sim_policies[0]); p++)
+        {
+            sim_run(&sim_scenarios[s], sim_policies[p], ticks);
+        }
+    }
+    return 0;
+}
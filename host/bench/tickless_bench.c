@@ -0,0 +1,302 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host benchmark of the tickless rotation.
+*
+* Runs the application for simulated hours with the 1 s rotation timer and
+* in tickless mode (beacon_set_tickless()), where set-terminated events from
+* the stub controller drive the rotation, and reports the MCU wakeups, log
+* thread wakeups and controller commands per hour of both. Every second the
+* sets on air and their random addresses must be the same in both modes, the
+* tickless mode only sleeps through the seconds that change nothing. The log
+* thread only runs when a callback woke it, so it must not add MCU wakeups.
+* Every run is in its own process so the application starts clean.
+*
+* Where the controller ends sets, the set-terminated events of a transition
+* are also held back past the guard timer, then sent after the next plan has
+* armed its sets. The late events must not issue controller commands or end
+* a set of the new plan.
+*
+* Usage: tickless_bench [iterations], one simulated hour per million
+*/
+#include "wiced_bt_beacon.h"
+#include "host_stub.h"
+#include "beacon.h"
+#include "bench_util.h"
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+#define TICKLESS_SEC_PER_HOUR       3600
+#define TICKLESS_ITERATIONS_PER_HOUR 1000000
+
+/* Longest tickless sleep the application is built with, see BEACON_TICKLESS_MAX_SEC */
+#define TICKLESS_MAX_SEC            10
+
+/* Late set-terminated events sent in a run, and the seconds run before and after them */
+#define TICKLESS_LATE_CNT           20
+#define TICKLESS_LATE_SEC           60
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint16_t     zones;
+    uint8_t      sets;
+    wiced_bool_t ext;
+    wiced_bool_t periodic;
+} tickless_config_t;
+
+/* Result of one run, in memory shared with the parent */
+typedef struct
+{
+    uint32_t wakeups;
+    uint32_t timer_callbacks;
+    uint32_t adv_set_terminated;
+    uint32_t log_wakeups;
+    uint32_t cmds;
+    uint32_t sig[];             /* On-air signature of every second */
+} tickless_result_t;
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+static const tickless_config_t tickless_configs[] =
+{
+    {   0,  4, WICED_FALSE, WICED_FALSE },
+    {   0,  8, WICED_FALSE, WICED_FALSE },
+    {  27,  8, WICED_FALSE, WICED_FALSE },
+    { 123,  8, WICED_FALSE, WICED_FALSE },
+    {   0,  4, WICED_TRUE,  WICED_FALSE },
+    { 123,  8, WICED_TRUE,  WICED_FALSE },
+    {   0,  4, WICED_FALSE, WICED_TRUE  },
+};
+
+static const char * const tickless_modes[2][2] =
+{
+    { "legacy", "legacy+pa" },
+    { "ext",    "ext+pa"    },
+};
+
+/******************************************************************************
+ *     Private Function Definitions
+ ******************************************************************************/
+
+/*
+ * Returns a signature of the enabled sets and their random addresses
+ */
+static uint32_t tickless_signature(uint8_t sets)
+{
+    uint32_t sig = 0, h;
+    uint8_t  handle, i;
+
+    for (handle = 1; handle <= sets; handle++)
+    {
+        const uint8_t *p_bda = host_stub_adv_random_address(handle);
+
+        if (!host_stub_adv_enabled(handle))
+        {
+            continue;
+        }
+        h = 2166136261u ^ handle;
+        for (i = 0; i < BD_ADDR_LEN; i++)
+        {
+            h = (h ^ p_bda[i]) * 16777619u;
+        }
+        sig += h;
+    }
+    return sig;
+}
+
+/*
+ * Returns the controller commands issued since the counters were reset
+ */
+static uint32_t tickless_cmds(void)
+{
+    return host_stub_counters.set_ext_adv_parameters + host_stub_counters.set_ext_adv_random_address +
+           host_stub_counters.set_ext_adv_data + host_stub_counters.start_ext_adv +
+           host_stub_counters.stop_ext_adv + host_stub_counters.set_periodic_adv_data;
+}
+
+/*
+ * Starts the application in a configuration
+ */
+static void tickless_start(const tickless_config_t *p_cfg, wiced_bool_t tickless)
+{
+    host_stub_set_num_ext_adv_sets(p_cfg->sets);
+    beacon_set_zone_beacons(p_cfg->zones);
+    beacon_set_ext_adv(p_cfg->ext);
+    beacon_set_tlm_periodic(p_cfg->periodic);
+    beacon_set_tickless(tickless);
+
+    application_start();
+    host_stub_bt_enable();
+    host_stub_reset_counters();
+}
+
+static void tickless_run(const tickless_config_t *p_cfg, wiced_bool_t tickless, uint32_t secs,
+                         tickless_result_t *p_res)
+{
+    uint32_t t;
+
+    tickless_start(p_cfg, tickless);
+    for (t = 0; t < secs; t++)
+    {
+        host_stub_advance_ms(1000);
+        p_res->sig[t] = tickless_signature(p_cfg->sets);
+    }
+
+    BENCH_CHECK(host_stub_counters.disallowed == 0);
+    p_res->wakeups = host_stub_counters.wakeups;
+    p_res->timer_callbacks = host_stub_counters.timer_callbacks;
+    p_res->adv_set_terminated = host_stub_counters.adv_set_terminated;
+    p_res->log_wakeups = host_stub_counters.log_wakeups;
+    p_res->cmds = tickless_cmds();
+}
+
+/*
+ * Holds back the set-terminated events of a transition until the guard timer
+ * has applied it and the next plan has armed its sets, then sends them
+ */
+static void tickless_late_event(const tickless_config_t *p_cfg)
+{
+    uint32_t ended, cmds, t, n;
+
+    tickless_start(p_cfg, WICED_TRUE);
+    host_stub_advance_ms(TICKLESS_LATE_SEC * 1000);
+
+    for (n = 0; n < TICKLESS_LATE_CNT; n++)
+    {
+        host_stub_hold_adv_set_terminated();
+        ended = host_stub_counters.adv_set_terminated;
+        for (t = 0; t < TICKLESS_LATE_SEC && host_stub_counters.adv_set_terminated == ended; t++)
+        {
+            host_stub_advance_ms(1000);
+        }
+        BENCH_CHECK(host_stub_counters.adv_set_terminated != ended);
+
+        // the guard timer fires a second after the transition, the sets of its plan end a second later at the earliest
+        host_stub_advance_ms(1500);
+        cmds = tickless_cmds();
+        BENCH_CHECK(host_stub_release_adv_set_terminated() != 0);
+        BENCH_CHECK(tickless_cmds() == cmds);
+
+        // back on a whole second, the next hold comes at another point of the rotation
+        host_stub_advance_ms(500 + n * 1000);
+    }
+    ended = host_stub_counters.adv_set_terminated;
+
+    // the sets of the new plan still end on time and the rotation goes on
+    host_stub_advance_ms(TICKLESS_LATE_SEC * 1000);
+    BENCH_CHECK(host_stub_counters.adv_set_terminated > ended);
+    BENCH_CHECK(host_stub_counters.disallowed == 0);
+}
+
+/*
+ * Runs a configuration in a child process, the result lands in p_res
+ */
+static void tickless_fork(const tickless_config_t *p_cfg, wiced_bool_t tickless, uint32_t secs,
+                          tickless_result_t *p_res)
+{
+    pid_t pid;
+    int   status;
+
+    fflush(stdout);
+    pid = fork();
+    BENCH_CHECK(pid >= 0);
+    if (pid == 0)
+    {
+        tickless_run(p_cfg, tickless, secs, p_res);
+        _exit(0);
+    }
+    BENCH_CHECK(waitpid(pid, &status, 0) == pid);
+    BENCH_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+/*
+ * Runs the late event check of a configuration in a child process
+ */
+static void tickless_fork_late_event(const tickless_config_t *p_cfg)
+{
+    pid_t pid;
+    int   status;
+
+    fflush(stdout);
+    pid = fork();
+    BENCH_CHECK(pid >= 0);
+    if (pid == 0)
+    {
+        tickless_late_event(p_cfg);
+        _exit(0);
+    }
+    BENCH_CHECK(waitpid(pid, &status, 0) == pid);
+    BENCH_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t hours = bench_iterations(argc, argv, TICKLESS_ITERATIONS_PER_HOUR) / TICKLESS_ITERATIONS_PER_HOUR;
+    uint32_t secs, c, t;
+    size_t   res_size;
+    tickless_result_t *p_timer, *p_tickless;
+
+    if (hours == 0)
+    {
+        hours = 1;
+    }
+    secs = hours * TICKLESS_SEC_PER_HOUR;
+    res_size = sizeof(tickless_result_t) + secs * sizeof(uint32_t);
+    p_timer = mmap(NULL, 2 * res_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    BENCH_CHECK(p_timer != MAP_FAILED);
+    p_tickless = (tickless_result_t *)((uint8_t *)p_timer + res_size);
+
+    printf("Tickless rotation benchmark, %u simulated hours\n\n", hours);
+    printf("%-9s %6s %5s %13s %13s %8s %13s %11s %11s %13s %10s\n", "mode", "zones", "sets", "1 s wakes/h",
+           "tickless w/h", "saved %", "set ends/h", "1 s log/h", "tl log/h", "1 s cmds/h", "tl cmds/h");
+
+    for (c = 0; c < sizeof(tickless_configs) / sizeof(tickless_configs[0]); c++)
+    {
+        const tickless_config_t *p_cfg = &tickless_configs[c];
+
+        memset(p_timer, 0, 2 * res_size);
+        tickless_fork(p_cfg, WICED_FALSE, secs, p_timer);
+        tickless_fork(p_cfg, WICED_TRUE, secs, p_tickless);
+
+        // the same sets and addresses on air every second
+        for (t = 0; t < secs; t++)
+        {
+            BENCH_CHECK(p_tickless->sig[t] == p_timer->sig[t]);
+        }
+        BENCH_CHECK(p_timer->wakeups == secs && p_timer->adv_set_terminated == 0);
+        BENCH_CHECK(p_tickless->wakeups <= p_timer->wakeups);
+        BENCH_CHECK(p_tickless->wakeups >= secs / TICKLESS_MAX_SEC);
+
+        // the log thread runs only at instants a callback woke the MCU
+        BENCH_CHECK(p_timer->log_wakeups <= p_timer->wakeups);
+        BENCH_CHECK(p_tickless->log_wakeups <= p_tickless->wakeups);
+
+        // a late event only where the controller ends sets
+        if (p_tickless->adv_set_terminated)
+        {
+            tickless_fork_late_event(p_cfg);
+        }
+
+        printf("%-9s %6u %5u %13.0f %13.0f %8.1f %13.0f %11.0f %11.0f %13.0f %10.0f\n",
+               tickless_modes[p_cfg->ext][p_cfg->periodic], p_cfg->zones, p_cfg->sets,
+               (double)p_timer->wakeups / hours, (double)p_tickless->wakeups / hours,
+               100.0 * (p_timer->wakeups - p_tickless->wakeups) / p_timer->wakeups,
+               (double)p_tickless->adv_set_terminated / hours, (double)p_timer->log_wakeups / hours,
+               (double)p_tickless->log_wakeups / hours, (double)p_timer->cmds / hours,
+               (double)p_tickless->cmds / hours);
+    }
+    munmap(p_timer, 2 * res_size);
+    return 0;
+}
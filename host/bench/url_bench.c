@@ -0,0 +1,310 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host benchmark of the Eddystone URL compression.
+*
+* Checks wiced_bt_eddystone_compress_url() on known URLs, then against a
+* brute force longest match over the code tables on random URLs, and reports:
+*  - URLs per second of the trie and of the brute force match
+*  - how many of the random URLs fit a frame with the expansion codes and
+*    with the scheme code alone, as wiced_bt_eddystone_set_data_for_url sends
+*  - average adv data bytes and air time of the URL advertisement both ways
+*
+* Usage: url_bench [iterations]
+*/
+#include "wiced_bt_beacon.h"
+#include "bench_util.h"
+#include <string.h>
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+/* Random URLs compared and measured, reused round robin when timing */
+#define URL_BENCH_URLS              4096
+#define URL_BENCH_URL_MAX           64
+
+/* Legacy advertising PDU on the 1M PHY: preamble, access address, header,
+ * advertiser address and CRC around the adv data, 8 us per byte */
+#define URL_BENCH_PDU_OVERHEAD      (1 + 4 + 2 + 6 + 3)
+#define URL_BENCH_US_PER_BYTE       8
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    const char *url;
+    wiced_bool_t ok;
+    uint8_t scheme;
+    uint8_t len;
+    const char *encoded;
+} url_bench_case_t;
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+/* Code tables of the Eddystone URL specification, in code order */
+static const char *const url_bench_schemes[] = { "http://www.", "https://www.", "http://", "https://" };
+static const char *const url_bench_expansions[] =
+{
+    ".com/", ".org/", ".edu/", ".net/", ".info/", ".biz/", ".gov/",
+    ".com", ".org", ".edu", ".net", ".info", ".biz", ".gov",
+};
+
+static const url_bench_case_t url_bench_cases[] =
+{
+    { "http://www.infineon.com",        WICED_TRUE,  0x00, 9,  "infineon\x07" },
+    { "https://www.infineon.com/",      WICED_TRUE,  0x01, 9,  "infineon\x00" },
+    { "http://goo.gl/S6zT6P",           WICED_TRUE,  0x02, 13, "goo.gl/S6zT6P" },
+    { "https://example.org/beacon",     WICED_TRUE,  0x03, 14, "example\x01" "beacon" },
+    { "http://a.com.org.edu.net.info/", WICED_TRUE,  0x02, 6,  "a\x07\x08\x09\x0a\x04" },
+    { "http://www.x.co",                WICED_TRUE,  0x00, 4,  "x.co" },
+    { "http://www.x.comx",              WICED_TRUE,  0x00, 3,  "x\x07x" },
+    { "http://www.",                    WICED_TRUE,  0x00, 0,  "" },
+    { "http://www.seventeen-char.io",   WICED_TRUE,  0x00, 17, "seventeen-char.io" },
+    { "http://www.eighteen-chars-.io",  WICED_FALSE, 0,    0,  NULL },
+    { "ftp://example.com",              WICED_FALSE, 0,    0,  NULL },
+    { "http:/example.com",              WICED_FALSE, 0,    0,  NULL },
+    { "http://exa mple.com",            WICED_FALSE, 0,    0,  NULL },
+    { "http://example.com/\x7f",        WICED_FALSE, 0,    0,  NULL },
+};
+
+static char url_bench_urls[URL_BENCH_URLS][URL_BENCH_URL_MAX];
+
+/* Sink so the compiler keeps the timed work */
+static volatile uint8_t url_bench_sink;
+
+/******************************************************************************
+ *                          Private Function Definitions
+ ******************************************************************************/
+
+/*
+ * Returns the length of the longest table entry url starts with and sets its
+ * code, 0 if none
+ */
+static size_t url_bench_longest(const char *url, const char *const *p_table, size_t n, uint8_t *p_code)
+{
+    size_t best = 0, len, i;
+
+    for (i = 0; i < n; i++)
+    {
+        len = strlen(p_table[i]);
+        if (len > best && strncmp(url, p_table[i], len) == 0)
+        {
+            best = len;
+            *p_code = (uint8_t)i;
+        }
+    }
+    return best;
+}
+
+/*
+ * Brute force compression: every table entry is compared at every position
+ */
+static wiced_bool_t url_bench_reference(const char *url, uint8_t *p_scheme, uint8_t *p_encoded, uint8_t *p_len)
+{
+    size_t n = sizeof(url_bench_expansions) / sizeof(url_bench_expansions[0]);
+    size_t match;
+    uint8_t len = 0, code;
+
+    match = url_bench_longest(url, url_bench_schemes, sizeof(url_bench_schemes) / sizeof(url_bench_schemes[0]),
+                              p_scheme);
+    if (match == 0)
+    {
+        return WICED_FALSE;
+    }
+    for (url += match; *url != '\0'; url += match)
+    {
+        match = url_bench_longest(url, url_bench_expansions, n, &code);
+        if (match == 0)
+        {
+            code = (uint8_t)*url;
+            match = 1;
+            if (code < EDDYSTONE_URL_CHAR_MIN || code > EDDYSTONE_URL_CHAR_MAX)
+            {
+                return WICED_FALSE;
+            }
+        }
+        if (len == EDDYSTONE_URL_VALUE_MAX_LEN)
+        {
+            return WICED_FALSE;
+        }
+        p_encoded[len++] = code;
+    }
+    *p_len = len;
+    return WICED_TRUE;
+}
+
+/*
+ * Returns the encoded length with the scheme code alone, 0 if it does not fit
+ */
+static uint8_t url_bench_raw_len(const char *url)
+{
+    uint8_t code;
+    size_t match = url_bench_longest(url, url_bench_schemes, sizeof(url_bench_schemes) / sizeof(url_bench_schemes[0]),
+                                     &code);
+    size_t len = strlen(url) - match;
+
+    return (match != 0 && len <= EDDYSTONE_URL_VALUE_MAX_LEN) ? (uint8_t)len : 0;
+}
+
+/*
+ * Returns the adv data bytes of the URL advertisement with an encoded URL
+ */
+static uint8_t url_bench_adv_len(uint8_t scheme, const uint8_t *p_encoded, uint8_t len)
+{
+    uint8_t adv_data[WICED_BT_BEACON_ADV_DATA_MAX];
+    wiced_bt_beacon_encoder_t enc;
+
+    wiced_bt_beacon_encoder_init(&enc, adv_data, sizeof(adv_data));
+    wiced_bt_beacon_encoder_put_flags(&enc, WICED_BT_BEACON_FLAGS);
+    wiced_bt_eddystone_put_uuid_list(&enc);
+    BENCH_CHECK(wiced_bt_eddystone_put_url(&enc, 0, scheme, p_encoded, len));
+    return (uint8_t)wiced_bt_beacon_encoder_len(&enc);
+}
+
+/*
+ * Checks the known URLs
+ */
+static void url_bench_known_answers(void)
+{
+    const url_bench_case_t *p_case;
+    uint8_t encoded[EDDYSTONE_URL_VALUE_MAX_LEN];
+    uint8_t scheme, len;
+    size_t i;
+
+    for (i = 0; i < sizeof(url_bench_cases) / sizeof(url_bench_cases[0]); i++)
+    {
+        p_case = &url_bench_cases[i];
+        BENCH_CHECK(wiced_bt_eddystone_compress_url(p_case->url, &scheme, encoded, &len) == p_case->ok);
+        if (p_case->ok)
+        {
+            BENCH_CHECK(scheme == p_case->scheme);
+            BENCH_CHECK(len == p_case->len);
+            BENCH_CHECK(memcmp(encoded, p_case->encoded, len) == 0);
+        }
+    }
+}
+
+/*
+ * Builds random URLs: a scheme, mostly a valid one, a host of letters,
+ * digits, dots and dashes, often a top level domain and sometimes a path
+ */
+static void url_bench_make_urls(void)
+{
+    static const char *const schemes[] = { "http://www.", "https://www.", "http://", "https://", "ftp://" };
+    static const char *const tlds[] = { ".com", ".org", ".edu", ".net", ".info", ".biz", ".gov", ".io", ".co", "" };
+    static const char host_chars[] = "abcdefghijklmnopqrstuvwxyz0123456789.-";
+    uint32_t seed = 0x2545f491u;
+    char *p;
+    int i, n;
+
+    for (i = 0; i < URL_BENCH_URLS; i++)
+    {
+        p = url_bench_urls[i];
+        seed = seed * 1664525u + 1013904223u;
+        p += sprintf(p, "%s", schemes[(seed >> 24) % 20 == 0 ? 4 : (seed >> 16) % 4]);
+        for (n = 2 + (int)((seed >> 8) % 12); n > 0; n--)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            *p++ = host_chars[(seed >> 16) % (sizeof(host_chars) - 1)];
+        }
+        seed = seed * 1664525u + 1013904223u;
+        p += sprintf(p, "%s", tlds[(seed >> 16) % 10]);
+        if ((seed >> 8) % 3 == 0)
+        {
+            p += sprintf(p, "/%c%c", 'a' + (int)((seed >> 20) % 26), 'A' + (int)((seed >> 4) % 26));
+        }
+        *p = '\0';
+    }
+}
+
+/*
+ * Compares the trie against the brute force match and sums the frame sizes
+ */
+static void url_bench_compare(void)
+{
+    uint8_t encoded[EDDYSTONE_URL_VALUE_MAX_LEN], ref[EDDYSTONE_URL_VALUE_MAX_LEN] = { 0 };
+    uint8_t scheme, ref_scheme, len, ref_len, raw_len;
+    wiced_bool_t ok;
+    uint32_t fit = 0, raw_fit = 0, both = 0, bytes = 0, raw_bytes = 0;
+    int i;
+
+    for (i = 0; i < URL_BENCH_URLS; i++)
+    {
+        ok = wiced_bt_eddystone_compress_url(url_bench_urls[i], &scheme, encoded, &len);
+        BENCH_CHECK(ok == url_bench_reference(url_bench_urls[i], &ref_scheme, ref, &ref_len));
+        if (!ok)
+        {
+            continue;
+        }
+        BENCH_CHECK(scheme == ref_scheme && len == ref_len && memcmp(encoded, ref, len) == 0);
+        fit++;
+
+        raw_len = url_bench_raw_len(url_bench_urls[i]);
+        if (raw_len != 0)
+        {
+            raw_fit++;
+            both++;
+            BENCH_CHECK(len <= raw_len);
+            bytes += url_bench_adv_len(scheme, encoded, len);
+            // only the length of the unexpanded URL matters here
+            raw_bytes += url_bench_adv_len(scheme, ref, raw_len);
+        }
+    }
+    BENCH_CHECK(both != 0);
+
+    printf("%u random URLs: %u fit with expansion codes, %u with the scheme code alone\n",
+           URL_BENCH_URLS, fit, raw_fit);
+    printf("%-36s %10.2f bytes %6.1f us on air\n", "adv data, expansion codes", (double)bytes / both,
+           (double)(bytes + both * URL_BENCH_PDU_OVERHEAD) * URL_BENCH_US_PER_BYTE / both);
+    printf("%-36s %10.2f bytes %6.1f us on air\n\n", "adv data, scheme code alone", (double)raw_bytes / both,
+           (double)(raw_bytes + both * URL_BENCH_PDU_OVERHEAD) * URL_BENCH_US_PER_BYTE / both);
+}
+
+/*
+ * Times the trie and the brute force match
+ */
+static void url_bench_run(uint32_t iterations)
+{
+    uint8_t encoded[EDDYSTONE_URL_VALUE_MAX_LEN];
+    uint8_t scheme, len = 0;
+    uint64_t t0, trie_ns, ref_ns;
+    uint32_t i;
+
+    t0 = bench_now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        url_bench_sink = (uint8_t)wiced_bt_eddystone_compress_url(url_bench_urls[i % URL_BENCH_URLS],
+                                                                  &scheme, encoded, &len);
+    }
+    trie_ns = bench_now_ns() - t0;
+
+    t0 = bench_now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        url_bench_sink = (uint8_t)url_bench_reference(url_bench_urls[i % URL_BENCH_URLS], &scheme, encoded, &len);
+    }
+    ref_ns = bench_now_ns() - t0;
+
+    printf("%-36s %10.1f ns  %7.2f M URLs/s\n", "compress, trie", (double)trie_ns / iterations,
+           (double)iterations * 1000.0 / (double)trie_ns);
+    printf("%-36s %10.1f ns  %7.2f M URLs/s\n", "compress, brute force", (double)ref_ns / iterations,
+           (double)iterations * 1000.0 / (double)ref_ns);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t iterations = bench_iterations(argc, argv, BENCH_DEFAULT_ITERATIONS);
+
+    url_bench_known_answers();
+    url_bench_make_urls();
+
+    printf("Eddystone URL compression benchmark, %u iterations\n\n", iterations);
+    url_bench_compare();
+    url_bench_run(iterations);
+    return 0;
+}
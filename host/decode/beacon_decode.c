@@ -0,0 +1,352 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Beacon frame decoder for gateways
+*
+* Each AD structure costs one table lookup of its type. Service data and
+* manufacturer data are then classified by one 16-bit or 32-bit compare and
+* a lookup of the Eddystone frame type, and the length is checked against
+* the range of the frame kind. Fields are copied with fixed-size loads.
+*/
+#include "beacon_decode.h"
+#include <string.h>
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+/* AD types the decoder looks at */
+#define BEACON_DECODE_AD_FLAGS           0x01
+#define BEACON_DECODE_AD_SERVICE_DATA    0x16
+#define BEACON_DECODE_AD_MANUFACTURER    0xff
+
+/* AD structure classes */
+#define BEACON_DECODE_CLASS_OTHER        0
+#define BEACON_DECODE_CLASS_FLAGS        1
+#define BEACON_DECODE_CLASS_SERVICE      2
+#define BEACON_DECODE_CLASS_MANUFACTURER 3
+
+/* Apple company ID and iBeacon type and length, as one little-endian word */
+#define BEACON_DECODE_IBEACON_PREFIX     0x1502004cu
+
+/* Eddystone service UUID and TLM encrypted version */
+#define BEACON_DECODE_EDDYSTONE_UUID     0xfeaa
+#define BEACON_DECODE_TLM_ENCRYPTED      1
+
+/* Offsets in the AD data of the first field of each frame, after the company
+ * ID and type, or the service UUID and frame type */
+#define BEACON_DECODE_IBEACON_BODY       4
+#define BEACON_DECODE_EDDYSTONE_BODY     3
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+/* AD data bytes a frame kind may have */
+typedef struct
+{
+    uint8_t min;
+    uint8_t max;
+} beacon_decode_len_t;
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+static const uint8_t beacon_decode_ad_class[256] =
+{
+    [BEACON_DECODE_AD_FLAGS]        = BEACON_DECODE_CLASS_FLAGS,
+    [BEACON_DECODE_AD_SERVICE_DATA] = BEACON_DECODE_CLASS_SERVICE,
+    [BEACON_DECODE_AD_MANUFACTURER] = BEACON_DECODE_CLASS_MANUFACTURER,
+};
+
+/* Eddystone frame type to kind, TLM is split by version afterwards */
+static const uint8_t beacon_decode_frame_kind[256] =
+{
+    [0x00] = BEACON_DECODE_EDDYSTONE_UID,
+    [0x10] = BEACON_DECODE_EDDYSTONE_URL,
+    [0x20] = BEACON_DECODE_EDDYSTONE_TLM,
+    [0x30] = BEACON_DECODE_EDDYSTONE_EID,
+};
+
+/* The encoders write exactly these lengths, URL frames carry 0 to 17 bytes of URL */
+static const beacon_decode_len_t beacon_decode_len[BEACON_DECODE_KINDS] =
+{
+    [BEACON_DECODE_NONE]           = { 0xff, 0    },
+    [BEACON_DECODE_IBEACON]        = { 25,   25   },
+    [BEACON_DECODE_EDDYSTONE_UID]  = { 22,   22   },
+    [BEACON_DECODE_EDDYSTONE_URL]  = { 5,    5 + BEACON_DECODE_URL_MAX },
+    [BEACON_DECODE_EDDYSTONE_TLM]  = { 16,   16   },
+    [BEACON_DECODE_EDDYSTONE_ETLM] = { 20,   20   },
+    [BEACON_DECODE_EDDYSTONE_EID]  = { 12,   12   },
+};
+
+/* URL scheme and expansion codes of the Eddystone URL specification */
+static const char *const beacon_decode_url_schemes[] = { "http://www.", "https://www.", "http://", "https://" };
+static const char *const beacon_decode_url_expansions[] =
+{
+    ".com/", ".org/", ".edu/", ".net/", ".info/", ".biz/", ".gov/",
+    ".com", ".org", ".edu", ".net", ".info", ".biz", ".gov",
+};
+
+/******************************************************************************
+ *     Private Function Definitions
+ ******************************************************************************/
+
+static inline uint16_t beacon_decode_le16(const uint8_t *p)
+{
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    uint16_t v;
+
+    memcpy(&v, p, sizeof(v));
+    return v;
+#else
+    return (uint16_t)(p[0] | (p[1] << 8));
+#endif
+}
+
+static inline uint32_t beacon_decode_le32(const uint8_t *p)
+{
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    uint32_t v;
+
+    memcpy(&v, p, sizeof(v));
+    return v;
+#else
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+#endif
+}
+
+/*
+ * Returns the frame kind of service data or manufacturer data, NONE if it is
+ * no beacon frame or its length does not match
+ */
+static inline uint8_t beacon_decode_kind(uint8_t ad_class, const uint8_t *p, uint8_t len)
+{
+    uint8_t kind = BEACON_DECODE_NONE;
+
+    if (ad_class == BEACON_DECODE_CLASS_MANUFACTURER)
+    {
+        kind = (len >= BEACON_DECODE_IBEACON_BODY && beacon_decode_le32(p) == BEACON_DECODE_IBEACON_PREFIX) ?
+               BEACON_DECODE_IBEACON : BEACON_DECODE_NONE;
+    }
+    else if (len >= BEACON_DECODE_EDDYSTONE_BODY && beacon_decode_le16(p) == BEACON_DECODE_EDDYSTONE_UUID)
+    {
+        kind = beacon_decode_frame_kind[p[2]];
+
+        // the version byte is there whenever the length fits a TLM frame
+        if (kind == BEACON_DECODE_EDDYSTONE_TLM && len >= beacon_decode_len[BEACON_DECODE_EDDYSTONE_TLM].min)
+        {
+            kind += (p[BEACON_DECODE_EDDYSTONE_BODY] == BEACON_DECODE_TLM_ENCRYPTED);
+        }
+    }
+    return (len >= beacon_decode_len[kind].min && len <= beacon_decode_len[kind].max) ? kind : BEACON_DECODE_NONE;
+}
+
+/*
+ * Decodes the fields of a frame of a known kind and length
+ */
+static inline void beacon_decode_fields(beacon_decode_frame_t *p_frame, const uint8_t *p, uint8_t len)
+{
+    const uint8_t *p_body = p + BEACON_DECODE_EDDYSTONE_BODY;
+
+    switch (p_frame->kind)
+    {
+    case BEACON_DECODE_IBEACON:
+        p += BEACON_DECODE_IBEACON_BODY;
+        memcpy(p_frame->u.ibeacon.uuid, p, BEACON_DECODE_UUID_LEN);
+        p_frame->u.ibeacon.major = beacon_decode_le16(p + 16);
+        p_frame->u.ibeacon.minor = beacon_decode_le16(p + 18);
+        p_frame->tx_power = (int8_t)p[20];
+        break;
+
+    case BEACON_DECODE_EDDYSTONE_UID:
+        p_frame->tx_power = (int8_t)p_body[0];
+        memcpy(p_frame->u.uid.namespace_id, p_body + 1, BEACON_DECODE_NAMESPACE_LEN);
+        memcpy(p_frame->u.uid.instance, p_body + 1 + BEACON_DECODE_NAMESPACE_LEN, BEACON_DECODE_INSTANCE_LEN);
+        break;
+
+    case BEACON_DECODE_EDDYSTONE_URL:
+        p_frame->tx_power = (int8_t)p_body[0];
+        p_frame->u.url.scheme = p_body[1];
+        p_frame->u.url.len = (uint8_t)(len - BEACON_DECODE_EDDYSTONE_BODY - 2);
+        memcpy(p_frame->u.url.encoded, p_body + 2, p_frame->u.url.len);
+        break;
+
+    case BEACON_DECODE_EDDYSTONE_TLM:
+        p_frame->tx_power = 0;
+        p_frame->u.tlm.vbatt = beacon_decode_le16(p_body + 1);
+        p_frame->u.tlm.temp = beacon_decode_le16(p_body + 3);
+        p_frame->u.tlm.adv_cnt = beacon_decode_le32(p_body + 5);
+        p_frame->u.tlm.sec_cnt = beacon_decode_le32(p_body + 9);
+        break;
+
+    case BEACON_DECODE_EDDYSTONE_ETLM:
+        p_frame->tx_power = 0;
+        memcpy(p_frame->u.etlm.etlm, p_body + 1, BEACON_DECODE_ETLM_LEN);
+        p_frame->u.etlm.salt = beacon_decode_le16(p_body + 1 + BEACON_DECODE_ETLM_LEN);
+        p_frame->u.etlm.mic = beacon_decode_le16(p_body + 3 + BEACON_DECODE_ETLM_LEN);
+        break;
+
+    case BEACON_DECODE_EDDYSTONE_EID:
+        p_frame->tx_power = (int8_t)p_body[0];
+        memcpy(p_frame->u.eid, p_body + 1, BEACON_DECODE_EID_LEN);
+        break;
+    }
+}
+
+/******************************************************************************
+ *     Public Function Definitions
+ ******************************************************************************/
+
+/*
+ * Splits adv data into its AD structures
+ */
+uint32_t beacon_decode_ads(const uint8_t *p_data, uint16_t len, beacon_decode_ad_t *p_ads, uint32_t max_ads,
+                           int *p_ok)
+{
+    uint32_t off = 0, n = 0;
+    uint8_t ad_len;
+
+    *p_ok = 1;
+    while (off < len && n < max_ads)
+    {
+        // a zero length ends the significant part
+        ad_len = p_data[off];
+        if (ad_len == 0)
+        {
+            break;
+        }
+        if (off + 1 + ad_len > len)
+        {
+            *p_ok = 0;
+            break;
+        }
+        p_ads[n].type = p_data[off + 1];
+        p_ads[n].len = (uint8_t)(ad_len - 1);
+        p_ads[n].offset = (uint8_t)(off + 2);
+        n++;
+        off += 1 + ad_len;
+    }
+    return n;
+}
+
+/*
+ * Decodes the beacon frames of one report
+ */
+uint32_t beacon_decode_report(const uint8_t *p_data, uint16_t len, uint32_t report,
+                              beacon_decode_frame_t *p_frames, beacon_decode_stats_t *p_stats)
+{
+    beacon_decode_frame_t *p_frame;
+    const uint8_t *p;
+    uint32_t off = 0, n = 0;
+    uint8_t ad_len, ad_class, kind, flags = 0;
+
+    while (off < len)
+    {
+        ad_len = p_data[off];
+        if (ad_len == 0)
+        {
+            break;
+        }
+        if (off + 1 + ad_len > len)
+        {
+            p_stats->malformed++;
+            break;
+        }
+        p = &p_data[off + 2];
+        ad_class = beacon_decode_ad_class[p_data[off + 1]];
+        off += 1 + ad_len;
+        p_stats->ads++;
+
+        if (ad_class == BEACON_DECODE_CLASS_FLAGS && ad_len > 1)
+        {
+            flags = p[0];
+        }
+        kind = (ad_class >= BEACON_DECODE_CLASS_SERVICE) ?
+               beacon_decode_kind(ad_class, p, (uint8_t)(ad_len - 1)) : BEACON_DECODE_NONE;
+        p_stats->frames[kind]++;
+        if (kind == BEACON_DECODE_NONE)
+        {
+            continue;
+        }
+        if (n == BEACON_DECODE_REPORT_FRAMES_MAX)
+        {
+            p_stats->dropped++;
+            continue;
+        }
+
+        p_frame = &p_frames[n++];
+        p_frame->report = report;
+        p_frame->kind = kind;
+        p_frame->flags = flags;
+        beacon_decode_fields(p_frame, p, (uint8_t)(ad_len - 1));
+    }
+    p_stats->reports++;
+    return n;
+}
+
+/*
+ * Decodes a buffer of length-prefixed reports
+ */
+uint32_t beacon_decode_batch(const uint8_t *p_buf, uint32_t buf_len, beacon_decode_frame_t *p_frames,
+                             uint32_t max_frames, beacon_decode_stats_t *p_stats)
+{
+    uint32_t pos = 0, n = 0;
+    uint8_t len;
+
+    memset(p_stats, 0, sizeof(*p_stats));
+    while (pos < buf_len && max_frames - n >= BEACON_DECODE_REPORT_FRAMES_MAX)
+    {
+        // a truncated last record is left for the next batch
+        len = p_buf[pos];
+        if (pos + 1 + len > buf_len)
+        {
+            break;
+        }
+        n += beacon_decode_report(&p_buf[pos + 1], len, p_stats->reports, &p_frames[n], p_stats);
+        pos += 1 + len;
+    }
+    p_stats->consumed = pos;
+    return n;
+}
+
+/*
+ * Expands an encoded Eddystone URL
+ */
+int beacon_decode_url_string(const beacon_decode_url_t *p_url, char *p_str)
+{
+    const char *p_code;
+    size_t n;
+    uint8_t i, c;
+
+    if (p_url->scheme >= sizeof(beacon_decode_url_schemes) / sizeof(beacon_decode_url_schemes[0]))
+    {
+        return 0;
+    }
+    n = strlen(beacon_decode_url_schemes[p_url->scheme]);
+    memcpy(p_str, beacon_decode_url_schemes[p_url->scheme], n);
+    p_str += n;
+
+    for (i = 0; i < p_url->len; i++)
+    {
+        c = p_url->encoded[i];
+        if (c < sizeof(beacon_decode_url_expansions) / sizeof(beacon_decode_url_expansions[0]))
+        {
+            p_code = beacon_decode_url_expansions[c];
+            n = strlen(p_code);
+            memcpy(p_str, p_code, n);
+            p_str += n;
+        }
+        else if (c >= 0x21 && c <= 0x7e)
+        {
+            *p_str++ = (char)c;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    *p_str = '\0';
+    return 1;
+}
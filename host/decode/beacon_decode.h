@@ -0,0 +1,166 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Beacon frame decoder for gateways
+*
+* The inverse of the encoders in wiced_bt_beacon.h: it parses the AD
+* structures of advertising reports and decodes iBeacon and Eddystone
+* UID, URL, TLM, eTLM and EID frames, in the byte order the encoders write.
+* It needs only the C library, so it builds on a gateway without btstack.
+*
+* Reports are decoded in batches from one contiguous buffer of records, each
+* a length byte followed by that many bytes of adv data, legacy or extended.
+* The caller owns the frame array, nothing is allocated. The AD structure
+* type and the beacon frame kind are looked up in tables, and each frame is
+* decoded with fixed-size loads, so the work per AD structure does not
+* depend on its bytes.
+*/
+#ifndef _BEACON_DECODE_H_
+#define _BEACON_DECODE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+/* Frames one report can yield, a batch stops before a report when fewer slots are left */
+#define BEACON_DECODE_REPORT_FRAMES_MAX  16
+
+/* Largest report, the extended adv data of one set */
+#define BEACON_DECODE_REPORT_MAX         254
+
+/* Field sizes of the decoded frames */
+#define BEACON_DECODE_UUID_LEN           16
+#define BEACON_DECODE_NAMESPACE_LEN      10
+#define BEACON_DECODE_INSTANCE_LEN       6
+#define BEACON_DECODE_URL_MAX            17
+#define BEACON_DECODE_ETLM_LEN           12
+#define BEACON_DECODE_EID_LEN            8
+
+/* Longest URL beacon_decode_url_string() writes, with its terminator */
+#define BEACON_DECODE_URL_STRING_MAX     (12 + BEACON_DECODE_URL_MAX * 6 + 1)
+
+/* Frame kinds */
+#define BEACON_DECODE_NONE               0
+#define BEACON_DECODE_IBEACON            1
+#define BEACON_DECODE_EDDYSTONE_UID      2
+#define BEACON_DECODE_EDDYSTONE_URL      3
+#define BEACON_DECODE_EDDYSTONE_TLM      4
+#define BEACON_DECODE_EDDYSTONE_ETLM     5
+#define BEACON_DECODE_EDDYSTONE_EID      6
+#define BEACON_DECODE_KINDS              7
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+/* One AD structure of a report */
+typedef struct
+{
+    uint8_t type;                           /* AD type */
+    uint8_t len;                            /* Data bytes after the type */
+    uint8_t offset;                         /* Offset of the data in the report */
+} beacon_decode_ad_t;
+
+typedef struct
+{
+    uint8_t  uuid[BEACON_DECODE_UUID_LEN];
+    uint16_t major;
+    uint16_t minor;
+} beacon_decode_ibeacon_t;
+
+typedef struct
+{
+    uint8_t namespace_id[BEACON_DECODE_NAMESPACE_LEN];
+    uint8_t instance[BEACON_DECODE_INSTANCE_LEN];
+} beacon_decode_uid_t;
+
+typedef struct
+{
+    uint8_t scheme;                         /* URL scheme code */
+    uint8_t len;                            /* Encoded URL bytes */
+    uint8_t encoded[BEACON_DECODE_URL_MAX]; /* Encoded URL, expansion codes kept */
+} beacon_decode_url_t;
+
+typedef struct
+{
+    uint16_t vbatt;
+    uint16_t temp;
+    uint32_t adv_cnt;
+    uint32_t sec_cnt;
+} beacon_decode_tlm_t;
+
+typedef struct
+{
+    uint8_t  etlm[BEACON_DECODE_ETLM_LEN];
+    uint16_t salt;
+    uint16_t mic;
+} beacon_decode_etlm_t;
+
+/* One decoded beacon frame */
+typedef struct
+{
+    uint32_t report;                        /* Index of the report in the batch */
+    uint8_t  kind;                          /* BEACON_DECODE_* */
+    uint8_t  flags;                         /* Flags AD value before the frame in the report, 0 if none */
+    int8_t   tx_power;                      /* Measured power, Eddystone ranging data or TX power */
+    union
+    {
+        beacon_decode_ibeacon_t ibeacon;
+        beacon_decode_uid_t     uid;
+        beacon_decode_url_t     url;
+        beacon_decode_tlm_t     tlm;
+        beacon_decode_etlm_t    etlm;
+        uint8_t                 eid[BEACON_DECODE_EID_LEN];
+    } u;
+} beacon_decode_frame_t;
+
+/* Counters of one batch */
+typedef struct
+{
+    uint32_t consumed;                      /* Buffer bytes of the reports decoded */
+    uint32_t reports;                       /* Reports decoded */
+    uint32_t ads;                           /* AD structures walked */
+    uint32_t frames[BEACON_DECODE_KINDS];   /* Frames per kind, NONE counts the other AD structures */
+    uint32_t malformed;                     /* Reports whose AD structures overran the report */
+    uint32_t dropped;                       /* Frames past BEACON_DECODE_REPORT_FRAMES_MAX in one report */
+} beacon_decode_stats_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+
+/*
+ * Splits adv data into its AD structures, the inverse of the encoder put
+ * functions. Returns the number found, at most max_ads, and sets *p_ok to 0
+ * if an AD structure overran the data.
+ */
+uint32_t beacon_decode_ads(const uint8_t *p_data, uint16_t len, beacon_decode_ad_t *p_ads, uint32_t max_ads,
+                           int *p_ok);
+
+/*
+ * Decodes the beacon frames of one report into p_frames, which has room for
+ * BEACON_DECODE_REPORT_FRAMES_MAX frames. Returns the number of frames.
+ */
+uint32_t beacon_decode_report(const uint8_t *p_data, uint16_t len, uint32_t report,
+                              beacon_decode_frame_t *p_frames, beacon_decode_stats_t *p_stats);
+
+/*
+ * Decodes a buffer of length-prefixed reports into p_frames until the buffer
+ * ends or fewer than BEACON_DECODE_REPORT_FRAMES_MAX slots are left. Returns
+ * the number of frames, p_stats->consumed tells where to resume.
+ */
+uint32_t beacon_decode_batch(const uint8_t *p_buf, uint32_t buf_len, beacon_decode_frame_t *p_frames,
+                             uint32_t max_frames, beacon_decode_stats_t *p_stats);
+
+/*
+ * Expands an encoded Eddystone URL into a string of at most
+ * BEACON_DECODE_URL_STRING_MAX bytes. Returns 0 if the scheme or a byte of
+ * the encoded URL has no meaning.
+ */
+int beacon_decode_url_string(const beacon_decode_url_t *p_url, char *p_str);
+
+#endif // _BEACON_DECODE_H_
@@ -0,0 +1,355 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Factory provisioning generator
+*
+* The output file is sized up front and mapped, each thread writes the blobs
+* and index entries of its own range of serials straight into the mapping,
+* so nothing is copied or locked. The index is sorted once all threads are
+* done, which also finds duplicate addresses, and the header is written
+* last, so a file cut short by a crash fails beacon_provision_file_open().
+*/
+#include "beacon_provision_gen.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+/* Last byte of the AES input, tells the derived fields apart */
+#define BEACON_PROVISION_TAG_EID_KEY    1
+#define BEACON_PROVISION_TAG_IDENTITY   2
+
+/* Static random address: the two most significant bits are set */
+#define BEACON_PROVISION_BDA_STATIC     0xc0
+
+/* Minors per major */
+#define BEACON_PROVISION_MINOR_SHIFT    16
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    pthread_t                     thread;
+    const beacon_provision_lot_t *p_lot;
+    const beacon_aes_ctx_t       *p_aes;
+    uint8_t                      *p_map;
+    uint32_t                      first;            /* First device of the range, from 0 */
+    uint32_t                      cnt;
+    wiced_bool_t                  ok;
+} beacon_provision_worker_t;
+
+/******************************************************************************
+ *     Private Function Definitions
+ ******************************************************************************/
+
+static uint64_t beacon_provision_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * Encrypts the serial number and a tag under the master key
+ */
+static void beacon_provision_derive(const beacon_aes_ctx_t *p_aes, uint32_t serial, uint8_t tag, uint8_t *p_out)
+{
+    uint8_t block[BEACON_AES_BLOCK_LEN] = { 0 };
+
+    block[0] = (uint8_t)(serial >> 24);
+    block[1] = (uint8_t)(serial >> 16);
+    block[2] = (uint8_t)(serial >> 8);
+    block[3] = (uint8_t)serial;
+    block[BEACON_AES_BLOCK_LEN - 1] = tag;
+    beacon_aes_encrypt(p_aes, block, p_out);
+}
+
+/*
+ * Generates the blobs and index entries of a range of devices
+ */
+static void *beacon_provision_worker(void *p_arg)
+{
+    beacon_provision_worker_t *p_worker = (beacon_provision_worker_t *)p_arg;
+    const beacon_provision_lot_t *p_lot = p_worker->p_lot;
+    const beacon_provision_file_hdr_t *p_hdr = (const beacon_provision_file_hdr_t *)p_worker->p_map;
+    beacon_provision_index_t *p_index;
+    beacon_provision_t *p_prov;
+    uint32_t n;
+
+    // the offsets are in place, the rest of the header comes last
+    p_index = (beacon_provision_index_t *)(p_worker->p_map + p_hdr->index_offset) + p_worker->first;
+    p_prov = (beacon_provision_t *)(p_worker->p_map + p_hdr->blob_offset) + p_worker->first;
+
+    p_worker->ok = WICED_TRUE;
+    for (n = 0; n < p_worker->cnt; n++, p_index++, p_prov++)
+    {
+        if (!beacon_provision_make_device(p_lot, p_worker->p_aes, p_lot->first_serial + p_worker->first + n, p_prov))
+        {
+            p_worker->ok = WICED_FALSE;
+            break;
+        }
+        memcpy(p_index->random_bda, p_prov->random_bda, BD_ADDR_LEN);
+        p_index->reserved = 0;
+        p_index->serial = p_prov->serial;
+    }
+    return NULL;
+}
+
+static int beacon_provision_index_cmp(const void *p_a, const void *p_b)
+{
+    const beacon_provision_index_t *p_ia = (const beacon_provision_index_t *)p_a;
+    const beacon_provision_index_t *p_ib = (const beacon_provision_index_t *)p_b;
+    int cmp = memcmp(p_ia->random_bda, p_ib->random_bda, BD_ADDR_LEN);
+
+    return cmp ? cmp : (p_ia->serial > p_ib->serial) - (p_ia->serial < p_ib->serial);
+}
+
+/******************************************************************************
+ *     Public Function Definitions
+ ******************************************************************************/
+
+/*
+ * Fills the blob of one device of a lot
+ */
+wiced_bool_t beacon_provision_make_device(const beacon_provision_lot_t *p_lot, const beacon_aes_ctx_t *p_aes,
+                                          uint32_t serial, beacon_provision_t *p_prov)
+{
+    uint8_t identity[BEACON_AES_BLOCK_LEN];
+    uint32_t n = serial - p_lot->first_serial;
+    uint8_t *p_bda = p_prov->random_bda;
+    uint8_t all_or, all_and;
+    int i;
+
+    memset(p_prov, 0, sizeof(*p_prov));
+    p_prov->serial = serial;
+    p_prov->ibeacon_major = (uint16_t)(p_lot->first_major + (n >> BEACON_PROVISION_MINOR_SHIFT));
+    p_prov->ibeacon_minor = (uint16_t)n;
+    memcpy(p_prov->ibeacon_uuid, p_lot->ibeacon_uuid, sizeof(p_prov->ibeacon_uuid));
+    memcpy(p_prov->namespace_id, p_lot->namespace_id, sizeof(p_prov->namespace_id));
+    p_prov->ibeacon_tx_power = p_lot->ibeacon_tx_power;
+    p_prov->ranging_data = p_lot->ranging_data;
+
+    beacon_provision_derive(p_aes, serial, BEACON_PROVISION_TAG_EID_KEY, p_prov->eid_key);
+    beacon_provision_derive(p_aes, serial, BEACON_PROVISION_TAG_IDENTITY, identity);
+    memcpy(p_prov->instance, identity, sizeof(p_prov->instance));
+    memcpy(p_bda, &identity[sizeof(p_prov->instance)], BD_ADDR_LEN);
+
+    // the random part of a static address must not be all zeros or all ones
+    p_bda[0] |= BEACON_PROVISION_BDA_STATIC;
+    all_or = p_bda[0] & (uint8_t)~BEACON_PROVISION_BDA_STATIC;
+    all_and = p_bda[0];
+    for (i = 1; i < BD_ADDR_LEN; i++)
+    {
+        all_or |= p_bda[i];
+        all_and &= p_bda[i];
+    }
+    if (all_or == 0 || all_and == 0xff)
+    {
+        p_bda[BD_ADDR_LEN - 1] ^= 1;
+    }
+
+    return beacon_provision_seal(p_prov);
+}
+
+/*
+ * Generates a lot into a file
+ */
+int beacon_provision_generate(const beacon_provision_lot_t *p_lot, const char *p_path,
+                              beacon_provision_timing_t *p_timing)
+{
+    beacon_provision_worker_t workers[BEACON_PROVISION_THREADS_MAX];
+    beacon_provision_file_hdr_t *p_hdr;
+    beacon_provision_index_t *p_index;
+    beacon_aes_ctx_t aes;
+    uint64_t t0 = beacon_provision_now_ns(), t1;
+    uint64_t index_offset, blob_offset, size;
+    uint32_t i, first = 0, per_thread, started;
+    uint8_t *p_map;
+    int fd, result = BEACON_PROVISION_OK;
+
+    if (p_lot->device_cnt == 0 || p_lot->threads == 0 || p_lot->threads > BEACON_PROVISION_THREADS_MAX ||
+        (uint64_t)p_lot->first_serial + p_lot->device_cnt - 1 > UINT32_MAX ||
+        p_lot->first_major + ((p_lot->device_cnt - 1) >> BEACON_PROVISION_MINOR_SHIFT) > UINT16_MAX)
+    {
+        return BEACON_PROVISION_ERR_ARG;
+    }
+
+    index_offset = sizeof(beacon_provision_file_hdr_t);
+    blob_offset = index_offset + (uint64_t)p_lot->device_cnt * sizeof(beacon_provision_index_t);
+    blob_offset = (blob_offset + BEACON_PROVISION_FILE_ALIGN - 1) & ~(uint64_t)(BEACON_PROVISION_FILE_ALIGN - 1);
+    size = blob_offset + (uint64_t)p_lot->device_cnt * sizeof(beacon_provision_t);
+    if (size > UINT32_MAX)
+    {
+        return BEACON_PROVISION_ERR_ARG;
+    }
+
+    fd = open(p_path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        return BEACON_PROVISION_ERR_FILE;
+    }
+    if (ftruncate(fd, (off_t)size) != 0)
+    {
+        close(fd);
+        unlink(p_path);
+        return BEACON_PROVISION_ERR_FILE;
+    }
+    p_map = (uint8_t *)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p_map == MAP_FAILED)
+    {
+        close(fd);
+        unlink(p_path);
+        return BEACON_PROVISION_ERR_FILE;
+    }
+
+    p_hdr = (beacon_provision_file_hdr_t *)p_map;
+    p_hdr->index_offset = (uint32_t)index_offset;
+    p_hdr->blob_offset = (uint32_t)blob_offset;
+    beacon_aes_set_key(&aes, p_lot->master_key);
+
+    // contiguous ranges, the first threads take one device more
+    t1 = beacon_provision_now_ns();
+    per_thread = p_lot->device_cnt / p_lot->threads;
+    for (i = 0; i < p_lot->threads; i++)
+    {
+        workers[i].p_lot = p_lot;
+        workers[i].p_aes = &aes;
+        workers[i].p_map = p_map;
+        workers[i].first = first;
+        workers[i].cnt = per_thread + (i < p_lot->device_cnt % p_lot->threads);
+        first += workers[i].cnt;
+        if (pthread_create(&workers[i].thread, NULL, beacon_provision_worker, &workers[i]) != 0)
+        {
+            result = BEACON_PROVISION_ERR_THREAD;
+            break;
+        }
+    }
+
+    // only the threads that started have a handle and a result
+    started = i;
+    for (i = 0; i < started; i++)
+    {
+        pthread_join(workers[i].thread, NULL);
+        if (!workers[i].ok && result == BEACON_PROVISION_OK)
+        {
+            result = BEACON_PROVISION_ERR_ENCODE;
+        }
+    }
+    p_timing->generate_ns = beacon_provision_now_ns() - t1;
+
+    t1 = beacon_provision_now_ns();
+    p_index = (beacon_provision_index_t *)(p_map + index_offset);
+    if (result == BEACON_PROVISION_OK)
+    {
+        qsort(p_index, p_lot->device_cnt, sizeof(*p_index), beacon_provision_index_cmp);
+        for (i = 1; i < p_lot->device_cnt; i++)
+        {
+            if (memcmp(p_index[i - 1].random_bda, p_index[i].random_bda, BD_ADDR_LEN) == 0)
+            {
+                result = BEACON_PROVISION_ERR_DUP_ADDR;
+                break;
+            }
+        }
+    }
+    p_timing->index_ns = beacon_provision_now_ns() - t1;
+
+    if (result == BEACON_PROVISION_OK)
+    {
+        p_hdr->magic = BEACON_PROVISION_FILE_MAGIC;
+        p_hdr->version = BEACON_PROVISION_FILE_VERSION;
+        p_hdr->blob_size = sizeof(beacon_provision_t);
+        p_hdr->device_cnt = p_lot->device_cnt;
+        p_hdr->first_serial = p_lot->first_serial;
+        memcpy(p_hdr->namespace_id, p_lot->namespace_id, sizeof(p_hdr->namespace_id));
+        p_hdr->first_major = p_lot->first_major;
+        memset(p_hdr->reserved, 0, sizeof(p_hdr->reserved));
+        p_hdr->crc = beacon_provision_crc32(0, p_map, offsetof(beacon_provision_file_hdr_t, crc));
+    }
+
+    munmap(p_map, size);
+    close(fd);
+    if (result != BEACON_PROVISION_OK)
+    {
+        unlink(p_path);
+    }
+    p_timing->file_size = (size_t)size;
+    p_timing->total_ns = beacon_provision_now_ns() - t0;
+    return result;
+}
+
+/*
+ * Returns the header of a mapped lot file
+ */
+const beacon_provision_file_hdr_t *beacon_provision_file_open(const uint8_t *p_map, size_t len)
+{
+    const beacon_provision_file_hdr_t *p_hdr = (const beacon_provision_file_hdr_t *)p_map;
+
+    if (len < sizeof(*p_hdr) || p_hdr->magic != BEACON_PROVISION_FILE_MAGIC ||
+        p_hdr->version != BEACON_PROVISION_FILE_VERSION || p_hdr->blob_size != sizeof(beacon_provision_t) ||
+        p_hdr->crc != beacon_provision_crc32(0, p_map, offsetof(beacon_provision_file_hdr_t, crc)))
+    {
+        return NULL;
+    }
+    if ((uint64_t)p_hdr->index_offset + (uint64_t)p_hdr->device_cnt * sizeof(beacon_provision_index_t) > len ||
+        (uint64_t)p_hdr->blob_offset + (uint64_t)p_hdr->device_cnt * sizeof(beacon_provision_t) > len)
+    {
+        return NULL;
+    }
+    return p_hdr;
+}
+
+/*
+ * Returns the blob of a serial number in a mapped lot file
+ */
+const beacon_provision_t *beacon_provision_file_blob(const uint8_t *p_map, uint32_t serial)
+{
+    const beacon_provision_file_hdr_t *p_hdr = (const beacon_provision_file_hdr_t *)p_map;
+    uint32_t n = serial - p_hdr->first_serial;
+
+    if (n >= p_hdr->device_cnt)
+    {
+        return NULL;
+    }
+    return (const beacon_provision_t *)(p_map + p_hdr->blob_offset) + n;
+}
+
+/*
+ * Looks a random address up in the index of a mapped lot file
+ */
+const beacon_provision_t *beacon_provision_file_find(const uint8_t *p_map, const uint8_t *p_bda)
+{
+    const beacon_provision_file_hdr_t *p_hdr = (const beacon_provision_file_hdr_t *)p_map;
+    const beacon_provision_index_t *p_index = (const beacon_provision_index_t *)(p_map + p_hdr->index_offset);
+    uint32_t lo = 0, hi = p_hdr->device_cnt, mid;
+    int cmp;
+
+    while (lo < hi)
+    {
+        mid = lo + (hi - lo) / 2;
+        cmp = memcmp(p_index[mid].random_bda, p_bda, BD_ADDR_LEN);
+        if (cmp == 0)
+        {
+            return beacon_provision_file_blob(p_map, p_index[mid].serial);
+        }
+        if (cmp < 0)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return NULL;
+}
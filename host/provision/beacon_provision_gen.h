@@ -0,0 +1,131 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Factory provisioning generator
+*
+* Generates the provisioning blobs of a lot of devices (see beacon_provision.h)
+* on several threads and writes them into one file that a test station or a
+* programmer can mmap:
+*
+*   header | index sorted by random address | blobs in serial order
+*
+* The secret fields of each device, its EID identity key, Eddystone instance
+* and random address, are AES-128 blocks of the serial number under the lot
+* master key, so any thread can generate any device without shared state and
+* a lot can be generated again from its master key. iBeacon major and minor
+* count up from the first major of the lot, 65536 minors per major.
+*/
+#ifndef _BEACON_PROVISION_GEN_H_
+#define _BEACON_PROVISION_GEN_H_
+
+#include "beacon_provision.h"
+#include "beacon_aes.h"
+#include <stddef.h>
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+/* "BPLF" and the file layout version */
+#define BEACON_PROVISION_FILE_MAGIC     0x464c5042u
+#define BEACON_PROVISION_FILE_VERSION   1
+
+/* Alignment of the blob area in the file */
+#define BEACON_PROVISION_FILE_ALIGN     64
+
+/* Most generator threads */
+#define BEACON_PROVISION_THREADS_MAX    64
+
+/* Results of beacon_provision_generate() */
+#define BEACON_PROVISION_OK             0
+#define BEACON_PROVISION_ERR_ARG        1       /* Empty lot, serials wrap or too many threads */
+#define BEACON_PROVISION_ERR_FILE       2       /* The output file could not be created or mapped */
+#define BEACON_PROVISION_ERR_ENCODE     3       /* A blob did not encode */
+#define BEACON_PROVISION_ERR_DUP_ADDR   4       /* Two devices drew the same random address */
+#define BEACON_PROVISION_ERR_THREAD     5       /* A generator thread could not be started */
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+/* Lot parameters, the same parameters always give the same file */
+typedef struct
+{
+    uint8_t  master_key[BEACON_AES_KEY_LEN];
+    uint8_t  ibeacon_uuid[LEN_UUID_128];
+    uint8_t  namespace_id[EDDYSTONE_UID_NAMESPACE_LEN];
+    uint16_t first_major;
+    uint32_t first_serial;
+    uint32_t device_cnt;
+    uint8_t  ibeacon_tx_power;
+    uint8_t  ranging_data;
+    uint32_t threads;
+} beacon_provision_lot_t;
+
+/* File header, little-endian */
+typedef struct
+{
+    uint32_t magic;                                     /* BEACON_PROVISION_FILE_MAGIC */
+    uint16_t version;                                   /* BEACON_PROVISION_FILE_VERSION */
+    uint16_t blob_size;                                 /* BEACON_PROVISION_SIZE */
+    uint32_t device_cnt;
+    uint32_t first_serial;
+    uint32_t index_offset;                              /* File offset of the index */
+    uint32_t blob_offset;                               /* File offset of the first blob */
+    uint8_t  namespace_id[EDDYSTONE_UID_NAMESPACE_LEN];
+    uint16_t first_major;
+    uint8_t  reserved[8];
+    uint32_t crc;                                       /* CRC-32 of the bytes before it */
+} beacon_provision_file_hdr_t;
+
+/* Index entry, sorted by random address */
+typedef struct
+{
+    uint8_t  random_bda[BD_ADDR_LEN];
+    uint16_t reserved;
+    uint32_t serial;
+} beacon_provision_index_t;
+
+/* Time spent in each phase of a generation */
+typedef struct
+{
+    uint64_t generate_ns;                               /* Blobs and index entries, all threads */
+    uint64_t index_ns;                                  /* Sorting the index and checking addresses */
+    uint64_t total_ns;                                  /* Including creating and closing the file */
+    size_t   file_size;
+} beacon_provision_timing_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+
+/*
+ * Fills the blob of one device of a lot, p_aes holds the master key schedule
+ */
+wiced_bool_t beacon_provision_make_device(const beacon_provision_lot_t *p_lot, const beacon_aes_ctx_t *p_aes,
+                                          uint32_t serial, beacon_provision_t *p_prov);
+
+/*
+ * Generates a lot into a file, returns BEACON_PROVISION_OK or an error
+ */
+int beacon_provision_generate(const beacon_provision_lot_t *p_lot, const char *p_path,
+                              beacon_provision_timing_t *p_timing);
+
+/*
+ * Returns the header of a mapped lot file, NULL if the header or the layout
+ * it describes does not fit the file
+ */
+const beacon_provision_file_hdr_t *beacon_provision_file_open(const uint8_t *p_map, size_t len);
+
+/*
+ * Returns the blob of a serial number in a mapped lot file, NULL if there is none
+ */
+const beacon_provision_t *beacon_provision_file_blob(const uint8_t *p_map, uint32_t serial);
+
+/*
+ * Looks a random address up in the index of a mapped lot file, NULL if there is none
+ */
+const beacon_provision_t *beacon_provision_file_find(const uint8_t *p_map, const uint8_t *p_bda);
+
+#endif // _BEACON_PROVISION_GEN_H_
@@ -0,0 +1,158 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Factory provisioning tool
+*
+* Generates the provisioning blobs of a lot of devices into one lot file, see
+* beacon_provision_gen.h, and reports the devices generated per second.
+*
+* Usage: beacon_provision -o <file> [-n devices] [-j threads] [-s first serial]
+*                         [-m first major] [-k master key] [-u iBeacon UUID]
+*                         [-N namespace] [-p iBeacon measured power] [-r ranging data]
+*
+* Keys and identifiers are hex strings. Without -k the master key is drawn
+* from the system random source, pass the same key again to get the same lot.
+*/
+#include "beacon_provision_gen.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/random.h>
+#include <unistd.h>
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+/* Defaults: a lot of 100k devices, the identifiers and powers of beacon.c */
+#define PROVISION_TOOL_DEVICES      100000
+#define PROVISION_TOOL_UUID         0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, \
+                                    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+#define PROVISION_TOOL_NAMESPACE    1, 2, 3, 4, 5, 6, 7, 8, 9, 0
+#define PROVISION_TOOL_MAJOR        1
+#define PROVISION_TOOL_TX_POWER     0xb3
+#define PROVISION_TOOL_RANGING      0xf0
+
+/******************************************************************************
+ *                          Private Function Definitions
+ ******************************************************************************/
+
+/*
+ * Parses exactly len bytes of hex, returns 0 on a malformed string
+ */
+static int provision_tool_hex(const char *p_str, uint8_t *p_out, size_t len)
+{
+    unsigned int byte;
+    size_t i;
+
+    if (strlen(p_str) != len * 2)
+    {
+        return 0;
+    }
+    for (i = 0; i < len; i++)
+    {
+        if (sscanf(&p_str[i * 2], "%2x", &byte) != 1)
+        {
+            return 0;
+        }
+        p_out[i] = (uint8_t)byte;
+    }
+    return 1;
+}
+
+static void provision_tool_usage(const char *p_name)
+{
+    fprintf(stderr, "usage: %s -o <file> [-n devices] [-j threads] [-s first serial] [-m first major]\n"
+                    "       [-k master key, 32 hex] [-u iBeacon UUID, 32 hex] [-N namespace, 20 hex]\n"
+                    "       [-p iBeacon measured power] [-r Eddystone ranging data]\n", p_name);
+}
+
+int main(int argc, char *argv[])
+{
+    static const uint8_t uuid[LEN_UUID_128] = { PROVISION_TOOL_UUID };
+    static const uint8_t namespace_id[EDDYSTONE_UID_NAMESPACE_LEN] = { PROVISION_TOOL_NAMESPACE };
+    static const char *const errors[] =
+    {
+        "ok", "bad lot parameters", "cannot create the output file", "a blob did not encode",
+        "two devices drew the same address, use another master key", "cannot start the generator threads",
+    };
+    beacon_provision_lot_t lot;
+    beacon_provision_timing_t timing;
+    const char *p_path = NULL;
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int opt, key_set = 0, result;
+
+    memset(&lot, 0, sizeof(lot));
+    memcpy(lot.ibeacon_uuid, uuid, sizeof(lot.ibeacon_uuid));
+    memcpy(lot.namespace_id, namespace_id, sizeof(lot.namespace_id));
+    lot.first_major = PROVISION_TOOL_MAJOR;
+    lot.device_cnt = PROVISION_TOOL_DEVICES;
+    lot.ibeacon_tx_power = PROVISION_TOOL_TX_POWER;
+    lot.ranging_data = PROVISION_TOOL_RANGING;
+    lot.threads = (cores < 1) ? 1 : (cores > BEACON_PROVISION_THREADS_MAX) ? BEACON_PROVISION_THREADS_MAX : (uint32_t)cores;
+
+    while ((opt = getopt(argc, argv, "o:n:j:s:m:k:u:N:p:r:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'o': p_path = optarg; break;
+        case 'n': lot.device_cnt = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'j': lot.threads = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 's': lot.first_serial = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'm': lot.first_major = (uint16_t)strtoul(optarg, NULL, 0); break;
+        case 'p': lot.ibeacon_tx_power = (uint8_t)strtoul(optarg, NULL, 0); break;
+        case 'r': lot.ranging_data = (uint8_t)strtoul(optarg, NULL, 0); break;
+        case 'k':
+            key_set = provision_tool_hex(optarg, lot.master_key, sizeof(lot.master_key));
+            if (!key_set)
+            {
+                provision_tool_usage(argv[0]);
+                return 2;
+            }
+            break;
+        case 'u':
+            if (!provision_tool_hex(optarg, lot.ibeacon_uuid, sizeof(lot.ibeacon_uuid)))
+            {
+                provision_tool_usage(argv[0]);
+                return 2;
+            }
+            break;
+        case 'N':
+            if (!provision_tool_hex(optarg, lot.namespace_id, sizeof(lot.namespace_id)))
+            {
+                provision_tool_usage(argv[0]);
+                return 2;
+            }
+            break;
+        default:
+            provision_tool_usage(argv[0]);
+            return 2;
+        }
+    }
+    if (p_path == NULL)
+    {
+        provision_tool_usage(argv[0]);
+        return 2;
+    }
+    if (!key_set && getrandom(lot.master_key, sizeof(lot.master_key), 0) != (ssize_t)sizeof(lot.master_key))
+    {
+        fprintf(stderr, "no random master key\n");
+        return 1;
+    }
+
+    result = beacon_provision_generate(&lot, p_path, &timing);
+    if (result != BEACON_PROVISION_OK)
+    {
+        fprintf(stderr, "%s: %s\n", p_path, errors[result]);
+        return 1;
+    }
+
+    printf("%s: %u devices, serials %u to %u, %.1f MB\n", p_path, lot.device_cnt, lot.first_serial,
+           lot.first_serial + lot.device_cnt - 1, (double)timing.file_size / 1e6);
+    printf("generate %.1f ms on %u threads, %.0f devices/s; index %.1f ms; total %.1f ms, %.0f devices/s\n",
+           timing.generate_ns / 1e6, lot.threads, lot.device_cnt * 1e9 / (double)timing.generate_ns,
+           timing.index_ns / 1e6, timing.total_ns / 1e6, lot.device_cnt * 1e9 / (double)timing.total_ns);
+    return 0;
+}
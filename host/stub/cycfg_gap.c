@@ -0,0 +1,35 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host stand-in for the Bluetooth Configurator generated GAP data (design.cybt).
+*/
+#include "cycfg_gap.h"
+#include "cycfg_gatt_db.h"
+
+const char cy_bt_device_name[] = "ExtAdv Beacon";
+
+static uint8_t cy_bt_adv_packet_elem_0[1] = { BTM_BLE_GENERAL_DISCOVERABLE_FLAG | BTM_BLE_BREDR_NOT_SUPPORTED };
+static uint8_t cy_bt_adv_packet_elem_1[13] = { 'E', 'x', 't', 'A', 'd', 'v', ' ', 'B', 'e', 'a', 'c', 'o', 'n' };
+
+wiced_bt_ble_advert_elem_t cy_bt_adv_packet_data[] =
+{
+    { cy_bt_adv_packet_elem_0, sizeof(cy_bt_adv_packet_elem_0), BTM_BLE_ADVERT_TYPE_FLAG },
+    { cy_bt_adv_packet_elem_1, sizeof(cy_bt_adv_packet_elem_1), BTM_BLE_ADVERT_TYPE_NAME_COMPLETE },
+};
+
+const wiced_bt_cfg_ble_t cy_bt_cfg_ble =
+{
+    .ble_max_simultaneous_links = MAX_NUM_CONNECTIONS,
+    .ble_max_rx_pdu_size        = 512,
+    .appearance                 = 512,
+};
+
+const wiced_bt_cfg_gatt_t cy_bt_cfg_gatt =
+{
+    .max_db_service_modules     = 0,
+    .max_eatt_bearers           = 0,
+    .max_mtu_size               = 23,
+};
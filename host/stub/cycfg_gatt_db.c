@@ -0,0 +1,42 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host stand-in for the Bluetooth Configurator generated GATT database (design.cybt).
+*
+* The database uses the stack's record layout, see the GATT database macros
+* in wiced_bt_gatt.h.
+*/
+#include "cycfg_gatt_db.h"
+
+const uint8_t gatt_database[] =
+{
+    /* Primary Service: Generic Access */
+    PRIMARY_SERVICE_UUID16(HDLS_GAP, __UUID_SERVICE_GENERIC_ACCESS),
+        /* Characteristic: Device Name */
+        CHARACTERISTIC_UUID16(HDLC_GAP_DEVICE_NAME, HDLC_GAP_DEVICE_NAME_VALUE,
+            __UUID_CHARACTERISTIC_DEVICE_NAME, GATT_CHAR_PROPERTIES_BIT_READ, LEGATTDB_PERM_READABLE),
+        /* Characteristic: Appearance */
+        CHARACTERISTIC_UUID16(HDLC_GAP_APPEARANCE, HDLC_GAP_APPEARANCE_VALUE,
+            __UUID_CHARACTERISTIC_APPEARANCE, GATT_CHAR_PROPERTIES_BIT_READ, LEGATTDB_PERM_READABLE),
+    /* Primary Service: Generic Attribute */
+    PRIMARY_SERVICE_UUID16(HDLS_GATT, __UUID_SERVICE_GENERIC_ATTRIBUTE),
+};
+
+const uint16_t gatt_database_len = sizeof(gatt_database);
+
+uint8_t app_gap_device_name[] = { 'E', 'x', 't', 'A', 'd', 'v', ' ', 'B', 'e', 'a', 'c', 'o', 'n', '\0' };
+uint8_t app_gap_appearance[] = { 0x00, 0x02 };
+
+gatt_db_lookup_table_t app_gatt_db_ext_attr_tbl[] =
+{
+    { HDLC_GAP_DEVICE_NAME_VALUE, 13, 13, app_gap_device_name },
+    { HDLC_GAP_APPEARANCE_VALUE,  2,  2,  app_gap_appearance },
+};
+
+const uint16_t app_gatt_db_ext_attr_tbl_size = (sizeof(app_gatt_db_ext_attr_tbl) / sizeof(gatt_db_lookup_table_t));
+
+const uint16_t app_gap_device_name_len = 13;
+const uint16_t app_gap_appearance_len = 2;
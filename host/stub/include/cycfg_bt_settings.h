@@ -0,0 +1,19 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host stand-in for the Bluetooth Configurator generated settings.
+*/
+#ifndef CYCFG_BT_SETTINGS_H
+#define CYCFG_BT_SETTINGS_H
+
+#include "wiced_bt_cfg.h"
+
+#define CY_BT_SECURITY_LEVEL        0
+
+extern const wiced_bt_cfg_ble_t     cy_bt_cfg_ble;
+extern const wiced_bt_cfg_gatt_t    cy_bt_cfg_gatt;
+
+#endif /* CYCFG_BT_SETTINGS_H */
@@ -0,0 +1,20 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host stand-in for the Bluetooth Configurator generated GAP data (design.cybt).
+*/
+#ifndef CYCFG_GAP_H
+#define CYCFG_GAP_H
+
+#include "wiced_bt_ble.h"
+#include "cycfg_bt_settings.h"
+
+#define CY_BT_ADV_PACKET_DATA_SIZE  2
+
+extern const char                   cy_bt_device_name[];
+extern wiced_bt_ble_advert_elem_t   cy_bt_adv_packet_data[];
+
+#endif /* CYCFG_GAP_H */
@@ -0,0 +1,51 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host stand-in for the Bluetooth Configurator generated GATT database (design.cybt).
+*/
+#ifndef CYCFG_GATT_DB_H
+#define CYCFG_GATT_DB_H
+
+#include "wiced_bt_gatt.h"
+
+#define __UUID_SERVICE_GENERIC_ACCESS               0x1800
+#define __UUID_CHARACTERISTIC_DEVICE_NAME           0x2A00
+#define __UUID_CHARACTERISTIC_APPEARANCE            0x2A01
+#define __UUID_SERVICE_GENERIC_ATTRIBUTE            0x1801
+
+/* Service Generic Access */
+#define HDLS_GAP                                    0x0001
+/* Characteristic Device Name */
+#define HDLC_GAP_DEVICE_NAME                        0x0002
+#define HDLC_GAP_DEVICE_NAME_VALUE                  0x0003
+/* Characteristic Appearance */
+#define HDLC_GAP_APPEARANCE                         0x0004
+#define HDLC_GAP_APPEARANCE_VALUE                   0x0005
+/* Service Generic Attribute */
+#define HDLS_GATT                                   0x0006
+
+#define MAX_NUM_CONNECTIONS                         1
+
+/* External Lookup Table Entry */
+typedef struct
+{
+    uint16_t handle;
+    uint16_t max_len;
+    uint16_t cur_len;
+    uint8_t  *p_data;
+} gatt_db_lookup_table_t;
+
+extern const uint8_t  gatt_database[];
+extern const uint16_t gatt_database_len;
+extern gatt_db_lookup_table_t app_gatt_db_ext_attr_tbl[];
+extern const uint16_t app_gatt_db_ext_attr_tbl_size;
+
+extern uint8_t app_gap_device_name[];
+extern uint8_t app_gap_appearance[];
+extern const uint16_t app_gap_device_name_len;
+extern const uint16_t app_gap_appearance_len;
+
+#endif /* CYCFG_GATT_DB_H */
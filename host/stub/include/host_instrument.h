@@ -0,0 +1,31 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Force-included (-include) into the application sources in host builds.
+*
+* Counts bytes moved by memcpy and routes printf through the host trace
+* hook, so a benchmark can report copy volume per encoded frame without
+* touching the application sources.
+*/
+#ifndef HOST_INSTRUMENT_H
+#define HOST_INSTRUMENT_H
+
+#include <stdio.h>
+#include <string.h>
+
+extern _Thread_local size_t host_copy_bytes;
+int host_trace_printf(const char *fmt, ...);
+
+static inline void *host_counted_memcpy(void *dst, const void *src, size_t n)
+{
+    host_copy_bytes += n;
+    return memcpy(dst, src, n);
+}
+
+#define memcpy(dst, src, n)     host_counted_memcpy((dst), (src), (n))
+#define printf                  host_trace_printf
+
+#endif /* HOST_INSTRUMENT_H */
@@ -0,0 +1,101 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host-only controls and counters of the stubbed btstack.
+*
+* The stub records every controller command issued by the application so
+* benchmarks can report command counts and bytes pushed alongside timings.
+*/
+#ifndef HOST_STUB_H
+#define HOST_STUB_H
+
+#include "wiced_bt_stack.h"
+#include "wiced_bt_gatt.h"
+
+/* Max adv sets the stub controller can hold */
+#define HOST_STUB_MAX_ADV_SETS      64
+
+/* Max adv data length the stub controller accepts per set */
+#define HOST_STUB_ADV_DATA_MAX      254
+
+/* Bytes of the last GATT response the stub keeps */
+#define HOST_STUB_GATT_RSP_MAX      512
+
+typedef struct
+{
+    uint32_t set_ext_adv_parameters;    /* wiced_bt_ble_set_ext_adv_parameters calls */
+    uint32_t set_ext_adv_random_address;/* wiced_bt_ble_set_ext_adv_random_address calls */
+    uint32_t set_ext_adv_data;          /* wiced_bt_ble_set_ext_adv_data calls */
+    uint32_t start_ext_adv;             /* wiced_bt_ble_start_ext_adv(MULTI_ADVERT_START) calls */
+    uint32_t stop_ext_adv;              /* wiced_bt_ble_start_ext_adv(MULTI_ADVERT_STOP) calls */
+    uint32_t sets_started;              /* Sum of num_sets over all start calls */
+    uint32_t adv_data_bytes;            /* Bytes pushed with set_ext_adv_data */
+    uint32_t set_periodic_adv_params;   /* wiced_bt_ble_set_periodic_adv_params calls */
+    uint32_t set_periodic_adv_data;     /* wiced_bt_ble_set_periodic_adv_data calls */
+    uint32_t start_periodic_adv;        /* wiced_bt_ble_start_periodic_adv calls */
+    uint32_t periodic_adv_data_bytes;   /* Bytes pushed with set_periodic_adv_data */
+    uint32_t disallowed;                /* Commands the controller rejects in the current set state */
+    uint32_t gatt_rsp;                  /* GATT responses sent */
+    uint32_t gatt_err_rsp;              /* GATT error responses sent */
+    uint32_t gatt_rsp_bytes;            /* Bytes carried by GATT responses */
+    uint32_t buffers_alloc;             /* wiced_bt_get_buffer calls */
+    uint32_t buffer_bytes;              /* Bytes requested from wiced_bt_get_buffer */
+    uint32_t buffers_free;              /* wiced_bt_free_buffer calls */
+    uint32_t log_records;               /* Deferred log records formatted after timer callbacks */
+    uint32_t eid_refills;               /* EIDs computed ahead after timer callbacks */
+    uint32_t log_wakeups;               /* Log thread runs, each woken by a log record or an EID roll */
+    uint32_t timer_callbacks;           /* Timer callbacks run */
+    uint32_t adv_set_terminated;        /* Sets ended by the controller at the end of their duration */
+    uint32_t wakeups;                   /* Distinct instants the application was called back, MCU wakeups */
+} host_stub_counters_t;
+
+extern host_stub_counters_t host_stub_counters;
+
+/* Bytes moved by memcpy in the instrumented library sources, per thread */
+extern _Thread_local size_t host_copy_bytes;
+
+void host_stub_reset_counters(void);
+void host_stub_set_num_ext_adv_sets(uint8_t num_sets);
+
+/* Delivers BTM_ENABLED_EVT to the callback registered by wiced_bt_stack_init */
+void host_stub_bt_enable(void);
+
+/* Advances the virtual clock, ends sets whose duration is over and fires expired timers,
+ * running the log thread after each if it was woken */
+void host_stub_advance_ms(uint32_t ms);
+uint64_t host_stub_now_ms(void);
+
+/* Holds back the set-terminated events from now on, as a controller whose events come late */
+void host_stub_hold_adv_set_terminated(void);
+
+/* Sends the held set-terminated events now, in order, and stops holding, returns their count */
+uint8_t host_stub_release_adv_set_terminated(void);
+
+/* Time spent formatting deferred log records and computing EIDs ahead, not part of the BT thread work */
+uint64_t host_stub_log_drain_ns(void);
+
+/* Returns a copy of the last GATT response sent, truncated to HOST_STUB_GATT_RSP_MAX */
+const uint8_t *host_stub_gatt_rsp(uint16_t *p_len);
+
+/* Returns the adv data the stub controller currently holds for a set */
+const uint8_t *host_stub_adv_data(wiced_bt_ble_ext_adv_handle_t adv_handle, uint16_t *p_len);
+
+/* Returns WICED_TRUE if the set is enabled on the stub controller */
+wiced_bool_t host_stub_adv_enabled(wiced_bt_ble_ext_adv_handle_t adv_handle);
+
+/* Returns the random address last set on a set */
+const uint8_t *host_stub_adv_random_address(wiced_bt_ble_ext_adv_handle_t adv_handle);
+
+/* Returns the periodic adv data of a set, NULL unless periodic adv is enabled on it */
+const uint8_t *host_stub_periodic_adv_data(wiced_bt_ble_ext_adv_handle_t adv_handle, uint16_t *p_len);
+
+/* Returns the air time of a set on the primary and secondary channels, in us per second */
+void host_stub_adv_air_us(wiced_bt_ble_ext_adv_handle_t adv_handle, uint32_t *p_primary_us, uint32_t *p_secondary_us);
+
+/* Routes library printf; output is formatted and dropped unless HOST_TRACE is set */
+int host_trace_printf(const char *fmt, ...);
+
+#endif /* HOST_STUB_H */
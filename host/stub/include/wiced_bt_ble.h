@@ -0,0 +1,167 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host stub of the btstack LE advertising interface.
+*/
+#ifndef WICED_BT_BLE_H
+#define WICED_BT_BLE_H
+
+#include "wiced_bt_dev.h"
+
+/* Advertisement data types */
+enum wiced_bt_ble_advert_type_e
+{
+    BTM_BLE_ADVERT_TYPE_FLAG                = 0x01,
+    BTM_BLE_ADVERT_TYPE_16SRV_PARTIAL       = 0x02,
+    BTM_BLE_ADVERT_TYPE_16SRV_COMPLETE      = 0x03,
+    BTM_BLE_ADVERT_TYPE_NAME_SHORT          = 0x08,
+    BTM_BLE_ADVERT_TYPE_NAME_COMPLETE       = 0x09,
+    BTM_BLE_ADVERT_TYPE_SERVICE_DATA        = 0x16,
+    BTM_BLE_ADVERT_TYPE_MANUFACTURER        = 0xFF,
+};
+typedef uint8_t wiced_bt_ble_advert_type_t;
+
+#define BTM_BLE_LIMITED_DISCOVERABLE_FLAG   (0x01 << 0)
+#define BTM_BLE_GENERAL_DISCOVERABLE_FLAG   (0x01 << 1)
+#define BTM_BLE_BREDR_NOT_SUPPORTED         (0x01 << 2)
+
+/* Advertisement element used by wiced_bt_ble_set_raw_advertisement_data */
+typedef struct
+{
+    uint8_t                    *p_data;
+    uint16_t                    len;
+    wiced_bt_ble_advert_type_t  advert_type;
+} wiced_bt_ble_advert_elem_t;
+
+/* Legacy advertising modes */
+enum wiced_bt_ble_advert_mode_e
+{
+    BTM_BLE_ADVERT_OFF,
+    BTM_BLE_ADVERT_DIRECTED_HIGH,
+    BTM_BLE_ADVERT_DIRECTED_LOW,
+    BTM_BLE_ADVERT_UNDIRECTED_HIGH,
+    BTM_BLE_ADVERT_UNDIRECTED_LOW,
+    BTM_BLE_ADVERT_NONCONN_HIGH,
+    BTM_BLE_ADVERT_NONCONN_LOW,
+    BTM_BLE_ADVERT_DISCOVERABLE_HIGH,
+    BTM_BLE_ADVERT_DISCOVERABLE_LOW,
+};
+
+typedef uint8_t wiced_bt_ble_address_type_t;
+#define BLE_ADDR_PUBLIC                     0x00
+#define BLE_ADDR_RANDOM                     0x01
+
+typedef uint8_t wiced_bt_ble_advert_chnl_map_t;
+#define BTM_BLE_ADVERT_CHNL_37              (0x01 << 0)
+#define BTM_BLE_ADVERT_CHNL_38              (0x01 << 1)
+#define BTM_BLE_ADVERT_CHNL_39              (0x01 << 2)
+#define BTM_BLE_DEFAULT_ADVERT_CHNL_MAP     (BTM_BLE_ADVERT_CHNL_37 | BTM_BLE_ADVERT_CHNL_38 | BTM_BLE_ADVERT_CHNL_39)
+
+typedef uint8_t wiced_bt_ble_advert_filter_policy_t;
+#define BTM_BLE_ADV_POLICY_ACCEPT_CONN_AND_SCAN 0x00
+
+/* Extended advertising */
+typedef uint8_t wiced_bt_ble_ext_adv_handle_t;
+
+typedef uint16_t wiced_bt_ble_ext_adv_event_property_t;
+#define WICED_BT_BLE_EXT_ADV_EVENT_NON_CONN_NON_SCAN_UNDIRECTED 0x00
+#define WICED_BT_BLE_EXT_ADV_EVENT_CONNECTABLE_ADV              (1 << 0)
+#define WICED_BT_BLE_EXT_ADV_EVENT_SCANNABLE_ADV                (1 << 1)
+#define WICED_BT_BLE_EXT_ADV_EVENT_DIRECTED_ADV                 (1 << 2)
+#define WICED_BT_BLE_EXT_ADV_EVENT_HIGH_DUTY_DIRECTED_CONN_ADV  (1 << 3)
+#define WICED_BT_BLE_EXT_ADV_EVENT_LEGACY_ADV                   (1 << 4)
+#define WICED_BT_BLE_EXT_ADV_EVENT_ANONYMOUS_ADV                (1 << 5)
+#define WICED_BT_BLE_EXT_ADV_EVENT_INCLUDE_TX_POWER             (1 << 6)
+
+typedef uint8_t wiced_bt_ble_ext_adv_phy_t;
+#define WICED_BT_BLE_EXT_ADV_PHY_1M         0x01
+#define WICED_BT_BLE_EXT_ADV_PHY_2M         0x02
+#define WICED_BT_BLE_EXT_ADV_PHY_LE_CODED   0x03
+
+typedef uint8_t wiced_bt_ble_ext_adv_sid_t;
+
+typedef uint8_t wiced_bt_ble_ext_adv_scan_req_notification_setting_t;
+#define WICED_BT_BLE_EXT_ADV_SCAN_REQ_NOTIFY_DISABLE    0x00
+#define WICED_BT_BLE_EXT_ADV_SCAN_REQ_NOTIFY_ENABLE     0x01
+
+typedef struct
+{
+    wiced_bt_ble_ext_adv_handle_t adv_handle;
+    uint16_t                      adv_duration;
+    uint8_t                       max_ext_adv_events;
+} wiced_bt_ble_ext_adv_duration_config_t;
+
+#define MULTI_ADVERT_STOP                   0x00
+#define MULTI_ADVERT_START                  0x01
+
+/* Extended adv events, WICED_BT_BLE_ADV_SET_TERMINATED_EVENT is referenced by the application */
+typedef enum
+{
+    WICED_BT_BLE_PERIODIC_ADV_SYNC_ESTABLISHED_EVENT,
+    WICED_BT_BLE_PERIODIC_ADV_REPORT_EVENT,
+    WICED_BT_BLE_PERIODIC_ADV_SYNC_LOST_EVENT,
+    WICED_BT_BLE_ADV_SET_TERMINATED_EVENT,
+    WICED_BT_BLE_SCAN_REQUEST_RECEIVED_EVENT,
+    WICED_BT_BLE_CHANNEL_SELECTION_ALGO_EVENT,
+} wiced_bt_ble_adv_ext_event_t;
+
+typedef struct
+{
+    uint8_t                       status;
+    wiced_bt_ble_ext_adv_handle_t adv_handle;
+    uint16_t                      conn_handle;
+    uint8_t                       num_completed_ext_adv_events;
+} wiced_bt_ble_adv_set_terminated_event_data_t;
+
+typedef union
+{
+    wiced_bt_ble_adv_set_terminated_event_data_t adv_set_terminated;
+} wiced_bt_ble_adv_ext_event_data_t;
+
+typedef void (*wiced_bt_ble_adv_ext_event_cb_fp_t)(wiced_bt_ble_adv_ext_event_t event,
+                                                   wiced_bt_ble_adv_ext_event_data_t *p_data);
+
+/* Periodic advertising */
+typedef uint16_t wiced_bt_ble_periodic_adv_prop_t;
+#define WICED_BT_BLE_PERIODIC_ADV_PROPERTY_INCLUDE_TX_POWER (1 << 6)
+
+wiced_result_t wiced_bt_ble_set_raw_advertisement_data(uint8_t num_elem, wiced_bt_ble_advert_elem_t *p_data);
+wiced_result_t wiced_bt_start_advertisements(wiced_bt_ble_advert_mode_t advert_mode,
+                                             wiced_bt_ble_address_type_t directed_advertisement_bdaddr_type,
+                                             wiced_bt_device_address_ptr_t directed_advertisement_bdaddr_ptr);
+
+uint8_t wiced_bt_ble_read_num_ext_adv_sets(void);
+wiced_result_t wiced_bt_ble_set_ext_adv_parameters(wiced_bt_ble_ext_adv_handle_t adv_handle,
+                                                   wiced_bt_ble_ext_adv_event_property_t event_properties,
+                                                   uint32_t primary_adv_int_min,
+                                                   uint32_t primary_adv_int_max,
+                                                   wiced_bt_ble_advert_chnl_map_t primary_adv_channel_map,
+                                                   wiced_bt_ble_address_type_t own_addr_type,
+                                                   wiced_bt_ble_address_type_t peer_addr_type,
+                                                   wiced_bt_device_address_t peer_addr,
+                                                   wiced_bt_ble_advert_filter_policy_t adv_filter_policy,
+                                                   int8_t adv_tx_power,
+                                                   wiced_bt_ble_ext_adv_phy_t primary_adv_phy,
+                                                   uint8_t secondary_adv_max_skip,
+                                                   wiced_bt_ble_ext_adv_phy_t secondary_adv_phy,
+                                                   wiced_bt_ble_ext_adv_sid_t adv_sid,
+                                                   wiced_bt_ble_ext_adv_scan_req_notification_setting_t scan_request_not);
+wiced_result_t wiced_bt_ble_set_ext_adv_random_address(wiced_bt_ble_ext_adv_handle_t adv_handle,
+                                                       wiced_bt_device_address_t random_address);
+wiced_result_t wiced_bt_ble_set_ext_adv_data(wiced_bt_ble_ext_adv_handle_t adv_handle,
+                                             uint16_t data_len, uint8_t *p_data);
+wiced_result_t wiced_bt_ble_start_ext_adv(uint8_t enable, uint8_t num_sets,
+                                          wiced_bt_ble_ext_adv_duration_config_t *p_set_duration_param);
+wiced_result_t wiced_bt_ble_set_periodic_adv_params(wiced_bt_ble_ext_adv_handle_t adv_handle,
+                                                    uint16_t periodic_adv_int_min,
+                                                    uint16_t periodic_adv_int_max,
+                                                    wiced_bt_ble_periodic_adv_prop_t periodic_adv_properties);
+wiced_result_t wiced_bt_ble_set_periodic_adv_data(wiced_bt_ble_ext_adv_handle_t adv_handle,
+                                                  uint16_t data_len, uint8_t *p_data);
+wiced_result_t wiced_bt_ble_start_periodic_adv(wiced_bt_ble_ext_adv_handle_t adv_handle, wiced_bool_t enable);
+void wiced_bt_ble_register_adv_ext_cback(wiced_bt_ble_adv_ext_event_cb_fp_t p_app_adv_ext_event_cb);
+
+#endif /* WICED_BT_BLE_H */
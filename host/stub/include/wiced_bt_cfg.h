@@ -0,0 +1,36 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host stub of the btstack runtime configuration structures.
+*/
+#ifndef WICED_BT_CFG_H
+#define WICED_BT_CFG_H
+
+#include "wiced_bt_types.h"
+
+typedef struct
+{
+    uint16_t ble_max_simultaneous_links;
+    uint16_t ble_max_rx_pdu_size;
+    uint16_t appearance;
+} wiced_bt_cfg_ble_t;
+
+typedef struct
+{
+    uint16_t max_db_service_modules;
+    uint16_t max_eatt_bearers;
+    uint16_t max_mtu_size;
+} wiced_bt_cfg_gatt_t;
+
+typedef struct
+{
+    uint8_t                      *device_name;
+    uint8_t                       security_required;
+    const wiced_bt_cfg_ble_t     *p_ble_cfg;
+    const wiced_bt_cfg_gatt_t    *p_gatt_cfg;
+} wiced_bt_cfg_settings_t;
+
+#endif /* WICED_BT_CFG_H */
@@ -0,0 +1,99 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host stub of the btstack device management interface.
+*/
+#ifndef WICED_BT_DEV_H
+#define WICED_BT_DEV_H
+
+#include "wiced_bt_types.h"
+
+/* Management events referenced by the application */
+enum wiced_bt_management_evt_e
+{
+    BTM_ENABLED_EVT,
+    BTM_DISABLED_EVT,
+    BTM_POWER_MANAGEMENT_STATUS_EVT,
+    BTM_PIN_REQUEST_EVT,
+    BTM_USER_CONFIRMATION_REQUEST_EVT,
+    BTM_PASSKEY_NOTIFICATION_EVT,
+    BTM_PASSKEY_REQUEST_EVT,
+    BTM_KEYPRESS_NOTIFICATION_EVT,
+    BTM_PAIRING_IO_CAPABILITIES_BR_EDR_REQUEST_EVT,
+    BTM_PAIRING_IO_CAPABILITIES_BR_EDR_RESPONSE_EVT,
+    BTM_PAIRING_IO_CAPABILITIES_BLE_REQUEST_EVT,
+    BTM_PAIRING_COMPLETE_EVT,
+    BTM_ENCRYPTION_STATUS_EVT,
+    BTM_SECURITY_REQUEST_EVT,
+    BTM_SECURITY_FAILED_EVT,
+    BTM_SECURITY_ABORTED_EVT,
+    BTM_READ_LOCAL_OOB_DATA_COMPLETE_EVT,
+    BTM_REMOTE_OOB_DATA_REQUEST_EVT,
+    BTM_PAIRED_DEVICE_LINK_KEYS_UPDATE_EVT,
+    BTM_PAIRED_DEVICE_LINK_KEYS_REQUEST_EVT,
+    BTM_LOCAL_IDENTITY_KEYS_UPDATE_EVT,
+    BTM_LOCAL_IDENTITY_KEYS_REQUEST_EVT,
+    BTM_BLE_SCAN_STATE_CHANGED_EVT,
+    BTM_BLE_ADVERT_STATE_CHANGED_EVT,
+};
+typedef uint8_t wiced_bt_management_evt_t;
+
+#define BTM_IO_CAPABILITIES_NONE        3
+#define BTM_OOB_NONE                    0
+#define BTM_LE_AUTH_REQ_BOND            0x01
+#define BTM_LE_AUTH_REQ_MITM            0x04
+#define BTM_LE_KEY_PENC                 0x01
+#define BTM_LE_KEY_PID                  0x02
+
+typedef uint8_t wiced_bt_ble_advert_mode_t;
+
+typedef struct
+{
+    wiced_bt_device_address_t bd_addr;
+    uint32_t                  numeric_value;
+    uint8_t                   just_works;
+} wiced_bt_dev_user_cfm_req_t;
+
+typedef struct
+{
+    wiced_bt_device_address_t bd_addr;
+    uint32_t                  passkey;
+} wiced_bt_dev_user_key_notif_t;
+
+typedef struct
+{
+    wiced_bt_device_address_t bd_addr;
+    uint8_t                   local_io_cap;
+    uint8_t                   oob_data;
+    uint8_t                   auth_req;
+    uint8_t                   max_key_size;
+    uint8_t                   init_keys;
+    uint8_t                   resp_keys;
+} wiced_bt_dev_ble_io_caps_req_t;
+
+typedef struct
+{
+    wiced_bt_device_address_t bd_addr;
+} wiced_bt_dev_security_request_t;
+
+typedef union
+{
+    wiced_result_t                  enabled;
+    wiced_bt_dev_user_cfm_req_t     user_confirmation_request;
+    wiced_bt_dev_user_key_notif_t   user_passkey_notification;
+    wiced_bt_dev_ble_io_caps_req_t  pairing_io_capabilities_ble_request;
+    wiced_bt_dev_security_request_t security_request;
+    wiced_bt_ble_advert_mode_t      ble_advert_state_changed;
+} wiced_bt_management_evt_data_t;
+
+typedef wiced_result_t (wiced_bt_management_cback_t)(wiced_bt_management_evt_t event,
+                                                     wiced_bt_management_evt_data_t *p_event_data);
+
+void wiced_bt_dev_confirm_req_reply(wiced_result_t res, wiced_bt_device_address_t bd_addr);
+void wiced_bt_ble_security_grant(wiced_bt_device_address_t bd_addr, uint8_t res);
+void wiced_bt_set_pairable_mode(uint8_t allow_pairing, uint8_t connect_only_paired);
+
+#endif /* WICED_BT_DEV_H */
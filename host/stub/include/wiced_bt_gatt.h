@@ -0,0 +1,240 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host stub of the btstack GATT server interface.
+*/
+#ifndef WICED_BT_GATT_H
+#define WICED_BT_GATT_H
+
+#include "wiced_bt_types.h"
+
+enum wiced_bt_gatt_status_e
+{
+    WICED_BT_GATT_SUCCESS               = 0x00,
+    WICED_BT_GATT_INVALID_HANDLE        = 0x01,
+    WICED_BT_GATT_READ_NOT_PERMIT       = 0x02,
+    WICED_BT_GATT_WRITE_NOT_PERMIT      = 0x03,
+    WICED_BT_GATT_INVALID_PDU           = 0x04,
+    WICED_BT_GATT_INSUF_AUTHENTICATION  = 0x05,
+    WICED_BT_GATT_REQ_NOT_SUPPORTED     = 0x06,
+    WICED_BT_GATT_INVALID_OFFSET        = 0x07,
+    WICED_BT_GATT_ATTRIBUTE_NOT_FOUND   = 0x0A,
+    WICED_BT_GATT_NOT_LONG              = 0x0B,
+    WICED_BT_GATT_INVALID_ATTR_LEN      = 0x0D,
+    WICED_BT_GATT_ERR_UNLIKELY          = 0x0E,
+    WICED_BT_GATT_INSUF_RESOURCE        = 0x11,
+};
+typedef uint8_t wiced_bt_gatt_status_t;
+
+enum wiced_bt_gatt_opcode_e
+{
+    GATT_REQ_MTU                        = 0x02,
+    GATT_REQ_READ_BY_TYPE               = 0x08,
+    GATT_REQ_READ                       = 0x0A,
+    GATT_REQ_READ_BLOB                  = 0x0C,
+    GATT_REQ_READ_MULTI                 = 0x0E,
+    GATT_REQ_WRITE                      = 0x12,
+    GATT_HANDLE_VALUE_CONF              = 0x1E,
+    GATT_REQ_READ_MULTI_VAR_LENGTH      = 0x20,
+    GATT_CMD_WRITE                      = 0x52,
+    GATT_CMD_SIGNED_WRITE               = 0xD2,
+};
+typedef uint8_t wiced_bt_gatt_opcode_t;
+
+enum wiced_bt_gatt_evt_e
+{
+    GATT_CONNECTION_STATUS_EVT,
+    GATT_OPERATION_CPLT_EVT,
+    GATT_DISCOVERY_RESULT_EVT,
+    GATT_DISCOVERY_CPLT_EVT,
+    GATT_ATTRIBUTE_REQUEST_EVT,
+    GATT_CONGESTION_EVT,
+    GATT_GET_RESPONSE_BUFFER_EVT,
+    GATT_APP_BUFFER_TRANSMITTED_EVT,
+};
+typedef uint8_t wiced_bt_gatt_evt_t;
+
+/* Attribute permissions in the GATT database records */
+#define LEGATTDB_PERM_NONE                  (0x00)
+#define LEGATTDB_PERM_VARIABLE_LENGTH       (0x1 << 0)
+#define LEGATTDB_PERM_READABLE              (0x1 << 1)
+#define LEGATTDB_PERM_WRITE_CMD             (0x1 << 2)
+#define LEGATTDB_PERM_WRITE_REQ             (0x1 << 3)
+#define LEGATTDB_PERM_AUTH_READABLE         (0x1 << 4)
+#define LEGATTDB_PERM_RELIABLE_WRITE        (0x1 << 5)
+#define LEGATTDB_PERM_AUTH_WRITABLE         (0x1 << 6)
+#define LEGATTDB_PERM_WRITABLE              (LEGATTDB_PERM_WRITE_CMD | LEGATTDB_PERM_WRITE_REQ | LEGATTDB_PERM_AUTH_WRITABLE)
+#define LEGATTDB_PERM_MASK                  (0x7f)
+#define LEGATTDB_PERM_SERVICE_UUID_128      (0x1 << 7)
+
+#define LEGATTDB_UUID16_SIZE                2
+#define LEGATTDB_UUID128_SIZE               16
+
+#define GATT_UUID_PRI_SERVICE               0x2800
+#define GATT_UUID_CHAR_DECLARE              0x2803
+#define GATT_UUID_CHAR_CLIENT_CONFIG        0x2902
+
+#define GATT_CHAR_PROPERTIES_BIT_READ       0x02
+#define GATT_CHAR_PROPERTIES_BIT_WRITE_NR   0x04
+#define GATT_CHAR_PROPERTIES_BIT_WRITE      0x08
+#define GATT_CHAR_PROPERTIES_BIT_NOTIFY     0x10
+
+/*
+ * GATT database records, same layout as the stack: handle (LE16), permission,
+ * length of type + value, one reserved byte if writable, type UUID, value.
+ * A 128-bit type sets LEGATTDB_PERM_SERVICE_UUID_128. 128-bit UUID arguments
+ * are comma separated byte lists.
+ */
+#define ATTRIBUTE16(handle, permission, datalen, uuid) \
+    BIT16_TO_8(handle), (uint8_t)(permission), (uint8_t)((datalen) + 2), BIT16_TO_8(uuid)
+
+#define PRIMARY_SERVICE_UUID16(handle, service) \
+    ATTRIBUTE16(handle, LEGATTDB_PERM_READABLE, 2, GATT_UUID_PRI_SERVICE), BIT16_TO_8(service)
+
+#define PRIMARY_SERVICE_UUID128(handle, service) \
+    ATTRIBUTE16(handle, LEGATTDB_PERM_READABLE, 16, GATT_UUID_PRI_SERVICE), service
+
+#define CHARACTERISTIC_UUID16(handle, handle_value, uuid, properties, permission) \
+    ATTRIBUTE16(handle, LEGATTDB_PERM_READABLE, 5, GATT_UUID_CHAR_DECLARE), \
+    (uint8_t)(properties), BIT16_TO_8(handle_value), BIT16_TO_8(uuid), \
+    BIT16_TO_8(handle_value), (uint8_t)(permission), (uint8_t)(LEGATTDB_UUID16_SIZE), BIT16_TO_8(uuid)
+
+#define CHARACTERISTIC_UUID16_WRITABLE(handle, handle_value, uuid, properties, permission) \
+    ATTRIBUTE16(handle, LEGATTDB_PERM_READABLE, 5, GATT_UUID_CHAR_DECLARE), \
+    (uint8_t)(properties), BIT16_TO_8(handle_value), BIT16_TO_8(uuid), \
+    BIT16_TO_8(handle_value), (uint8_t)(permission), (uint8_t)(LEGATTDB_UUID16_SIZE), (uint8_t)(0), BIT16_TO_8(uuid)
+
+#define CHARACTERISTIC_UUID128(handle, handle_value, uuid, properties, permission) \
+    ATTRIBUTE16(handle, LEGATTDB_PERM_READABLE, 19, GATT_UUID_CHAR_DECLARE), \
+    (uint8_t)(properties), BIT16_TO_8(handle_value), uuid, \
+    BIT16_TO_8(handle_value), (uint8_t)((permission) | LEGATTDB_PERM_SERVICE_UUID_128), \
+    (uint8_t)(LEGATTDB_UUID128_SIZE), uuid
+
+#define CHARACTERISTIC_UUID128_WRITABLE(handle, handle_value, uuid, properties, permission) \
+    ATTRIBUTE16(handle, LEGATTDB_PERM_READABLE, 19, GATT_UUID_CHAR_DECLARE), \
+    (uint8_t)(properties), BIT16_TO_8(handle_value), uuid, \
+    BIT16_TO_8(handle_value), (uint8_t)((permission) | LEGATTDB_PERM_SERVICE_UUID_128), \
+    (uint8_t)(LEGATTDB_UUID128_SIZE), (uint8_t)(0), uuid
+
+#define CHAR_DESCRIPTOR_UUID16(handle, uuid, permission) \
+    BIT16_TO_8(handle), (uint8_t)(permission), (uint8_t)(LEGATTDB_UUID16_SIZE), BIT16_TO_8(uuid)
+
+#define CHAR_DESCRIPTOR_UUID16_WRITABLE(handle, uuid, permission) \
+    BIT16_TO_8(handle), (uint8_t)(permission), (uint8_t)(LEGATTDB_UUID16_SIZE), (uint8_t)(0), BIT16_TO_8(uuid)
+
+typedef uint8_t wiced_bt_db_hash_t[16];
+typedef void *wiced_bt_gatt_app_context_t;
+
+typedef struct
+{
+    uint16_t handle;
+    uint16_t offset;
+} wiced_bt_gatt_read_t;
+
+typedef struct
+{
+    uint16_t        s_handle;
+    uint16_t        e_handle;
+    wiced_bt_uuid_t uuid;
+} wiced_bt_gatt_read_by_type_t;
+
+typedef struct
+{
+    int      num_handles;
+    uint8_t *p_handle_stream;
+} wiced_bt_gatt_read_multiple_req_t;
+
+typedef struct
+{
+    uint16_t handle;
+    uint16_t offset;
+    uint16_t val_len;
+    uint8_t *p_val;
+} wiced_bt_gatt_write_req_t;
+
+typedef struct
+{
+    uint16_t handle;
+} wiced_bt_gatt_confirm_t;
+
+typedef struct
+{
+    uint16_t                conn_id;
+    wiced_bt_gatt_opcode_t  opcode;
+    union
+    {
+        wiced_bt_gatt_read_t                read_req;
+        wiced_bt_gatt_read_by_type_t        read_by_type;
+        wiced_bt_gatt_read_multiple_req_t   read_multiple_req;
+        wiced_bt_gatt_write_req_t           write_req;
+        uint16_t                            remote_mtu;
+        wiced_bt_gatt_confirm_t             confirm;
+    } data;
+    uint16_t                len_requested;
+} wiced_bt_gatt_attribute_request_t;
+
+typedef struct
+{
+    uint8_t                    *bd_addr;
+    uint16_t                    conn_id;
+    wiced_bool_t                connected;
+    uint8_t                     reason;
+} wiced_bt_gatt_connection_status_t;
+
+typedef struct
+{
+    uint8_t *p_app_rsp_buffer;
+    void    *p_app_ctxt;
+} wiced_bt_gatt_buffer_t;
+
+typedef struct
+{
+    uint16_t                len_requested;
+    wiced_bt_gatt_buffer_t  buffer;
+} wiced_bt_gatt_buffer_request_t;
+
+typedef struct
+{
+    uint8_t *p_app_data;
+    void    *p_app_ctxt;
+} wiced_bt_gatt_buffer_transmitted_t;
+
+typedef union
+{
+    wiced_bt_gatt_connection_status_t   connection_status;
+    wiced_bt_gatt_attribute_request_t   attribute_request;
+    wiced_bt_gatt_buffer_request_t      buffer_request;
+    wiced_bt_gatt_buffer_transmitted_t  buffer_xmitted;
+} wiced_bt_gatt_event_data_t;
+
+typedef wiced_bt_gatt_status_t (wiced_bt_gatt_cback_t)(wiced_bt_gatt_evt_t event, wiced_bt_gatt_event_data_t *p_event_data);
+
+wiced_bt_gatt_status_t wiced_bt_gatt_register(wiced_bt_gatt_cback_t *p_gatt_cback);
+wiced_bt_gatt_status_t wiced_bt_gatt_db_init(const uint8_t *p_gatt_db, uint32_t gatt_db_size, wiced_bt_db_hash_t hash);
+
+uint16_t wiced_bt_gatt_find_handle_by_type(uint16_t s_handle, uint16_t e_handle, wiced_bt_uuid_t *p_uuid);
+int wiced_bt_gatt_put_read_by_type_rsp_in_stream(uint8_t *p_stream, int stream_len, uint8_t *p_pair_len,
+                                                 uint16_t n_handle, int len, uint8_t *p_attr);
+int wiced_bt_gatt_put_read_multi_rsp_in_stream(wiced_bt_gatt_opcode_t opcode, uint8_t *p_stream, int stream_len,
+                                               uint16_t n_handle, int len, uint8_t *p_attr);
+uint16_t wiced_bt_gatt_get_handle_from_stream(uint8_t *p_stream, int num_handle);
+
+wiced_bt_gatt_status_t wiced_bt_gatt_server_send_read_handle_rsp(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                                                 uint16_t len, uint8_t *p_attr,
+                                                                 wiced_bt_gatt_app_context_t p_app_ctxt);
+wiced_bt_gatt_status_t wiced_bt_gatt_server_send_read_by_type_rsp(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                                                  uint8_t type_len, uint16_t data_len, uint8_t *p_data,
+                                                                  wiced_bt_gatt_app_context_t p_app_ctxt);
+wiced_bt_gatt_status_t wiced_bt_gatt_server_send_read_multiple_rsp(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                                                   uint16_t data_len, uint8_t *p_data,
+                                                                   wiced_bt_gatt_app_context_t p_app_ctxt);
+wiced_bt_gatt_status_t wiced_bt_gatt_server_send_error_rsp(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                                           uint16_t handle, wiced_bt_gatt_status_t status);
+wiced_bt_gatt_status_t wiced_bt_gatt_server_send_write_rsp(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                                           uint16_t handle);
+wiced_bt_gatt_status_t wiced_bt_gatt_server_send_mtu_rsp(uint16_t conn_id, uint16_t remote_mtu, uint16_t local_mtu);
+
+#endif /* WICED_BT_GATT_H */
@@ -0,0 +1,19 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host stub of the btstack entry points.
+*/
+#ifndef WICED_BT_STACK_H
+#define WICED_BT_STACK_H
+
+#include "wiced_bt_dev.h"
+#include "wiced_bt_ble.h"
+#include "wiced_bt_cfg.h"
+
+wiced_result_t wiced_bt_stack_init(wiced_bt_management_cback_t *p_bt_management_cback,
+                                   const wiced_bt_cfg_settings_t *p_bt_cfg_settings);
+
+#endif /* WICED_BT_STACK_H */
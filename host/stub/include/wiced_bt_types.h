@@ -0,0 +1,61 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host stub of the btstack base types used by the beacon sources.
+*
+* Only the subset referenced by this application is declared. Values match
+* the btstack headers so encoded frames are byte-identical to the target.
+*/
+#ifndef WICED_BT_TYPES_H
+#define WICED_BT_TYPES_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+typedef uint8_t wiced_bool_t;
+#define WICED_TRUE                  1
+#define WICED_FALSE                 0
+
+typedef uint32_t wiced_result_t;
+#define WICED_SUCCESS               0
+#define WICED_BT_SUCCESS            0
+#define WICED_BT_ERROR              0x8009
+#define WICED_BT_BADARG             0x800A
+#define WICED_BT_NO_RESOURCES       0x8007
+
+#define BD_ADDR_LEN                 6
+typedef uint8_t wiced_bt_device_address_t[BD_ADDR_LEN];
+typedef uint8_t *wiced_bt_device_address_ptr_t;
+
+#define LEN_UUID_16                 2
+#define LEN_UUID_32                 4
+#define LEN_UUID_128                16
+
+typedef struct
+{
+    uint16_t len;
+    union
+    {
+        uint16_t uuid16;
+        uint32_t uuid32;
+        uint8_t  uuid128[LEN_UUID_128];
+    } uu;
+} wiced_bt_uuid_t;
+
+#define BIT16_TO_8(val)             (uint8_t)(val), (uint8_t)((val) >> 8)
+
+#define UINT8_TO_STREAM(p, u8)      { *(p)++ = (uint8_t)(u8); }
+#define INT8_TO_STREAM(p, u8)       { *(p)++ = (int8_t)(u8); }
+#define UINT16_TO_STREAM(p, u16)    { *(p)++ = (uint8_t)(u16); *(p)++ = (uint8_t)((u16) >> 8); }
+#define UINT32_TO_STREAM(p, u32)    { *(p)++ = (uint8_t)(u32); *(p)++ = (uint8_t)((u32) >> 8); \
+                                      *(p)++ = (uint8_t)((u32) >> 16); *(p)++ = (uint8_t)((u32) >> 24); }
+#define ARRAY_TO_STREAM(p, a, len)  { int ijk; for (ijk = 0; ijk < (len); ijk++) *(p)++ = (uint8_t)(a)[ijk]; }
+#define BDADDR_TO_STREAM(p, a)      { int ijk; for (ijk = 0; ijk < BD_ADDR_LEN; ijk++) *(p)++ = (uint8_t)(a)[BD_ADDR_LEN - 1 - ijk]; }
+#define STREAM_TO_UINT8(u8, p)      { (u8) = (uint8_t)(*(p)); (p) += 1; }
+#define STREAM_TO_UINT16(u16, p)    { (u16) = ((uint16_t)(*(p)) + (((uint16_t)(*((p) + 1))) << 8)); (p) += 2; }
+
+#endif /* WICED_BT_TYPES_H */
@@ -0,0 +1,17 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host stub of the btstack buffer allocator.
+*/
+#ifndef WICED_MEMORY_H
+#define WICED_MEMORY_H
+
+#include "wiced_bt_types.h"
+
+void *wiced_bt_get_buffer(uint32_t size);
+void wiced_bt_free_buffer(void *p_buf);
+
+#endif /* WICED_MEMORY_H */
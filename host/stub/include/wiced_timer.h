@@ -0,0 +1,45 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host stub of the wiced timer interface.
+*
+* Timers run on a virtual clock advanced by host_stub_advance_ms(), so
+* benchmarks can drive hours of rotation without sleeping.
+*/
+#ifndef WICED_TIMER_H
+#define WICED_TIMER_H
+
+#include "wiced_bt_types.h"
+
+#define WICED_TIMER_PARAM_TYPE      uint32_t
+
+typedef enum
+{
+    WICED_SECONDS_TIMER,
+    WICED_MILLI_SECONDS_TIMER,
+    WICED_SECONDS_PERIODIC_TIMER,
+    WICED_MILLI_SECONDS_PERIODIC_TIMER,
+} wiced_timer_type_t;
+
+typedef void (*wiced_timer_callback_fp)(WICED_TIMER_PARAM_TYPE cb_params);
+
+typedef struct
+{
+    wiced_timer_callback_fp  p_callback;
+    WICED_TIMER_PARAM_TYPE   arg;
+    wiced_timer_type_t       type;
+    uint32_t                 period_ms;
+    uint64_t                 expiry_ms;
+    wiced_bool_t             in_use;
+} wiced_timer_t;
+
+wiced_result_t wiced_init_timer(wiced_timer_t *p_timer, wiced_timer_callback_fp TimerCb,
+                                WICED_TIMER_PARAM_TYPE cBackparam, wiced_timer_type_t type);
+wiced_result_t wiced_start_timer(wiced_timer_t *p_timer, uint32_t timeout);
+wiced_result_t wiced_stop_timer(wiced_timer_t *p_timer);
+wiced_bool_t wiced_is_timer_in_use(wiced_timer_t *p_timer);
+
+#endif /* WICED_TIMER_H */
@@ -0,0 +1,879 @@
+/*
+ * $ Copyright YEAR Cypress Semiconductor $
+ */
+
+/** @file
+*
+* Host stub of the btstack, controller and timer services used by the beacon
+* application.
+*
+* Controller commands are recorded, not executed. The stub keeps the last
+* parameters and data pushed to each adv set so benchmarks can check what
+* would be on air, and counts every command in host_stub_counters.
+*/
+#include "wiced_bt_stack.h"
+#include "wiced_bt_gatt.h"
+#include "wiced_memory.h"
+#include "wiced_timer.h"
+#include "host_stub.h"
+#include "beacon_log.h"
+#include "beacon_eid.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/******************************************************************************
+ *                                Defines
+ ******************************************************************************/
+#define HOST_STUB_MAX_TIMERS        16
+#define HOST_STUB_TRACE_LEN         256
+
+/* On-air time of a PDU: preamble, access address, header, payload and CRC */
+#define HOST_STUB_PDU_US_1M(payload)    ((1 + 4 + 2 + (payload) + 3) * 8)
+#define HOST_STUB_PDU_US_2M(payload)    ((2 + 4 + 2 + (payload) + 3) * 4)
+
+/* Payload bytes ahead of the adv data: AdvA; ext header with AdvA, ADI and AuxPtr; ext header with AdvA and ADI */
+#define HOST_STUB_ADV_IND_HDR           6
+#define HOST_STUB_EXT_IND_HDR           7
+#define HOST_STUB_AUX_IND_HDR           10
+
+/* SyncInfo added to the AUX_ADV_IND of a set with periodic adv, ext header ahead of the AUX_SYNC_IND data */
+#define HOST_STUB_SYNC_INFO_LEN         18
+#define HOST_STUB_SYNC_IND_HDR          2
+
+/* HCI status of a set terminated at the end of its duration, Advertising Timeout */
+#define HOST_STUB_HCI_ADV_TIMEOUT       0x3c
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint8_t      data[HOST_STUB_ADV_DATA_MAX];
+    uint16_t     len;
+    wiced_bool_t enabled;
+    wiced_bool_t legacy;
+    uint32_t     interval;
+    uint8_t      secondary_phy;
+    uint8_t      periodic_data[HOST_STUB_ADV_DATA_MAX];
+    uint16_t     periodic_len;
+    uint16_t     periodic_interval;
+    wiced_bool_t periodic_enabled;
+    wiced_bt_device_address_t random_address;
+    uint64_t     expiry_ms;             /* End of the duration given at enable, 0 for none */
+} host_stub_adv_set_t;
+
+/******************************************************************************
+ *                              Variables Definitions
+ ******************************************************************************/
+host_stub_counters_t                 host_stub_counters;
+_Thread_local size_t                 host_copy_bytes;
+
+static uint8_t                       host_num_ext_adv_sets = 4;
+static host_stub_adv_set_t           host_adv_set[HOST_STUB_MAX_ADV_SETS + 1];
+static wiced_bt_management_cback_t  *host_management_cback;
+static wiced_bt_ble_adv_ext_event_cb_fp_t host_adv_ext_cback;
+static wiced_bt_gatt_cback_t        *host_gatt_cback;
+static const uint8_t                *host_gatt_db;
+static uint8_t                       host_stub_gatt_rsp_data[HOST_STUB_GATT_RSP_MAX];
+static uint16_t                      host_stub_gatt_rsp_len;
+static uint32_t                      host_gatt_db_len;
+static wiced_timer_t                *host_timers[HOST_STUB_MAX_TIMERS];
+static uint64_t                      host_now_ms;
+static int                           host_trace = -1;
+static uint64_t                      host_log_drain_ns;
+static uint64_t                      host_last_wake_ms = UINT64_MAX;
+static wiced_bool_t                  host_log_woken;
+static wiced_bool_t                  host_hold_terminated;  /* Set-terminated events are held back */
+static uint8_t                       host_held_terminated[HOST_STUB_MAX_ADV_SETS];  /* Sets of the held events, in order */
+static uint8_t                       host_held_cnt;
+
+/******************************************************************************
+ *                          Host control
+ ******************************************************************************/
+void host_stub_reset_counters(void)
+{
+    memset(&host_stub_counters, 0, sizeof(host_stub_counters));
+    host_copy_bytes = 0;
+    host_log_drain_ns = 0;
+}
+
+/*
+ * Wakes the log thread, registered with beacon_log_set_wake() as main.c does
+ */
+static void host_stub_log_wake(void)
+{
+    host_log_woken = WICED_TRUE;
+}
+
+/*
+ * Runs the low priority log thread once the BT thread is idle, if something
+ * woke it: drains the deferred log and refills the EID ring. Keeps its time
+ * apart from the BT thread work.
+ */
+static void host_stub_log_drain(void)
+{
+    struct timespec t0, t1;
+
+    if (!host_log_woken)
+    {
+        return;
+    }
+    host_log_woken = WICED_FALSE;
+    host_stub_counters.log_wakeups++;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    host_stub_counters.log_records += beacon_log_drain(0);
+    host_stub_counters.eid_refills += beacon_eid_refill();
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    host_log_drain_ns += (uint64_t)(t1.tv_sec - t0.tv_sec) * 1000000000u + (uint64_t)t1.tv_nsec - (uint64_t)t0.tv_nsec;
+}
+
+/*
+ * Counts a callback into the application, callbacks at the same instant
+ * share one MCU wakeup
+ */
+static void host_stub_wake(void)
+{
+    if (host_now_ms != host_last_wake_ms)
+    {
+        host_stub_counters.wakeups++;
+        host_last_wake_ms = host_now_ms;
+    }
+}
+
+/*
+ * Returns the enabled set whose duration ends first, at or before target,
+ * 0 if there is none
+ */
+static uint8_t host_stub_next_expiry(uint64_t target)
+{
+    uint8_t handle, next = 0;
+
+    for (handle = 1; handle <= host_num_ext_adv_sets; handle++)
+    {
+        if (host_adv_set[handle].enabled && host_adv_set[handle].expiry_ms && host_adv_set[handle].expiry_ms <= target &&
+            (next == 0 || host_adv_set[handle].expiry_ms < host_adv_set[next].expiry_ms))
+        {
+            next = handle;
+        }
+    }
+    return next;
+}
+
+/*
+ * Sends the set-terminated event of a set
+ */
+static void host_stub_adv_set_report(uint8_t handle)
+{
+    wiced_bt_ble_adv_ext_event_data_t evt_data;
+
+    memset(&evt_data, 0, sizeof(evt_data));
+    evt_data.adv_set_terminated.status = HOST_STUB_HCI_ADV_TIMEOUT;
+    evt_data.adv_set_terminated.adv_handle = handle;
+    if (host_adv_ext_cback)
+    {
+        host_stub_wake();
+        host_adv_ext_cback(WICED_BT_BLE_ADV_SET_TERMINATED_EVENT, &evt_data);
+    }
+}
+
+/*
+ * Ends a set at the end of its duration and reports it as the controller
+ * does, unless events are held back
+ */
+static void host_stub_adv_set_terminate(uint8_t handle)
+{
+    host_now_ms = host_adv_set[handle].expiry_ms;
+    host_adv_set[handle].enabled = WICED_FALSE;
+    host_adv_set[handle].expiry_ms = 0;
+    host_stub_counters.adv_set_terminated++;
+
+    if (host_hold_terminated && host_held_cnt < HOST_STUB_MAX_ADV_SETS)
+    {
+        host_held_terminated[host_held_cnt++] = handle;
+        return;
+    }
+    host_stub_adv_set_report(handle);
+}
+
+uint64_t host_stub_log_drain_ns(void)
+{
+    return host_log_drain_ns;
+}
+
+void host_stub_set_num_ext_adv_sets(uint8_t num_sets)
+{
+    host_num_ext_adv_sets = (num_sets > HOST_STUB_MAX_ADV_SETS) ? HOST_STUB_MAX_ADV_SETS : num_sets;
+}
+
+void host_stub_bt_enable(void)
+{
+    wiced_bt_management_evt_data_t evt_data;
+
+    memset(&evt_data, 0, sizeof(evt_data));
+    if (host_management_cback)
+    {
+        host_management_cback(BTM_ENABLED_EVT, &evt_data);
+    }
+    host_stub_log_drain();
+}
+
+void host_stub_hold_adv_set_terminated(void)
+{
+    host_hold_terminated = WICED_TRUE;
+}
+
+uint8_t host_stub_release_adv_set_terminated(void)
+{
+    uint8_t cnt = host_held_cnt, i;
+
+    host_hold_terminated = WICED_FALSE;
+    host_held_cnt = 0;
+    for (i = 0; i < cnt; i++)
+    {
+        host_stub_adv_set_report(host_held_terminated[i]);
+    }
+    host_stub_log_drain();
+    return cnt;
+}
+
+uint64_t host_stub_now_ms(void)
+{
+    return host_now_ms;
+}
+
+void host_stub_advance_ms(uint32_t ms)
+{
+    uint64_t target = host_now_ms + ms;
+
+    while (1)
+    {
+        wiced_timer_t *p_next = NULL;
+        uint8_t expired;
+        int i;
+
+        // fire timers in expiry order so a long advance behaves like real time
+        for (i = 0; i < HOST_STUB_MAX_TIMERS; i++)
+        {
+            wiced_timer_t *p_timer = host_timers[i];
+
+            if (p_timer && p_timer->in_use && p_timer->expiry_ms <= target &&
+                (p_next == NULL || p_timer->expiry_ms < p_next->expiry_ms))
+            {
+                p_next = p_timer;
+            }
+        }
+
+        // a set that ends first, or with the timer, reports before the timer fires
+        expired = host_stub_next_expiry(p_next ? p_next->expiry_ms : target);
+
+        // the log thread runs once the BT thread is idle, after the last callback of an instant
+        if ((expired ? host_adv_set[expired].expiry_ms : p_next ? p_next->expiry_ms : target + 1) != host_now_ms)
+        {
+            host_stub_log_drain();
+        }
+        if (expired)
+        {
+            host_stub_adv_set_terminate(expired);
+            continue;
+        }
+        if (p_next == NULL)
+        {
+            break;
+        }
+
+        host_now_ms = p_next->expiry_ms;
+        if (p_next->type == WICED_SECONDS_PERIODIC_TIMER || p_next->type == WICED_MILLI_SECONDS_PERIODIC_TIMER)
+        {
+            p_next->expiry_ms += p_next->period_ms;
+        }
+        else
+        {
+            p_next->in_use = WICED_FALSE;
+        }
+        host_stub_counters.timer_callbacks++;
+        host_stub_wake();
+        p_next->p_callback(p_next->arg);
+    }
+    host_now_ms = target;
+}
+
+const uint8_t *host_stub_adv_data(wiced_bt_ble_ext_adv_handle_t adv_handle, uint16_t *p_len)
+{
+    if (adv_handle > HOST_STUB_MAX_ADV_SETS)
+    {
+        *p_len = 0;
+        return NULL;
+    }
+    *p_len = host_adv_set[adv_handle].len;
+    return host_adv_set[adv_handle].data;
+}
+
+wiced_bool_t host_stub_adv_enabled(wiced_bt_ble_ext_adv_handle_t adv_handle)
+{
+    return (adv_handle <= HOST_STUB_MAX_ADV_SETS) ? host_adv_set[adv_handle].enabled : WICED_FALSE;
+}
+
+const uint8_t *host_stub_adv_random_address(wiced_bt_ble_ext_adv_handle_t adv_handle)
+{
+    return (adv_handle <= HOST_STUB_MAX_ADV_SETS) ? host_adv_set[adv_handle].random_address : NULL;
+}
+
+const uint8_t *host_stub_periodic_adv_data(wiced_bt_ble_ext_adv_handle_t adv_handle, uint16_t *p_len)
+{
+    if (adv_handle > HOST_STUB_MAX_ADV_SETS || !host_adv_set[adv_handle].periodic_enabled)
+    {
+        *p_len = 0;
+        return NULL;
+    }
+    *p_len = host_adv_set[adv_handle].periodic_len;
+    return host_adv_set[adv_handle].periodic_data;
+}
+
+/*
+ * Air time of an enabled set in us per second. A legacy event sends the
+ * ADV_NONCONN_IND with the data on the 3 primary channels. An extended event
+ * sends an empty ADV_EXT_IND with the AuxPtr on the 3 primary channels and
+ * the AUX_ADV_IND with the data once on the secondary PHY. Periodic adv adds
+ * the SyncInfo to the AUX_ADV_IND and an AUX_SYNC_IND every periodic interval.
+ */
+void host_stub_adv_air_us(wiced_bt_ble_ext_adv_handle_t adv_handle, uint32_t *p_primary_us, uint32_t *p_secondary_us)
+{
+    const host_stub_adv_set_t *p_set;
+    uint32_t events, aux_hdr;
+
+    *p_primary_us = 0;
+    *p_secondary_us = 0;
+    if (adv_handle > HOST_STUB_MAX_ADV_SETS)
+    {
+        return;
+    }
+    p_set = &host_adv_set[adv_handle];
+    if (!p_set->enabled || p_set->interval == 0)
+    {
+        return;
+    }
+
+    // interval is in 0.625 ms slots
+    events = 1600 / p_set->interval;
+    if (p_set->legacy)
+    {
+        *p_primary_us = events * 3 * HOST_STUB_PDU_US_1M(HOST_STUB_ADV_IND_HDR + p_set->len);
+    }
+    else
+    {
+        aux_hdr = HOST_STUB_AUX_IND_HDR + (p_set->periodic_enabled ? HOST_STUB_SYNC_INFO_LEN : 0);
+        *p_primary_us = events * 3 * HOST_STUB_PDU_US_1M(HOST_STUB_EXT_IND_HDR);
+        *p_secondary_us = events * ((p_set->secondary_phy == WICED_BT_BLE_EXT_ADV_PHY_2M) ?
+                                    HOST_STUB_PDU_US_2M(aux_hdr + p_set->len) :
+                                    HOST_STUB_PDU_US_1M(aux_hdr + p_set->len));
+    }
+
+    // periodic interval is in 1.25 ms units
+    if (p_set->periodic_enabled && p_set->periodic_interval)
+    {
+        events = 800 / p_set->periodic_interval;
+        *p_secondary_us += events * ((p_set->secondary_phy == WICED_BT_BLE_EXT_ADV_PHY_2M) ?
+                                     HOST_STUB_PDU_US_2M(HOST_STUB_SYNC_IND_HDR + p_set->periodic_len) :
+                                     HOST_STUB_PDU_US_1M(HOST_STUB_SYNC_IND_HDR + p_set->periodic_len));
+    }
+}
+
+int host_trace_printf(const char *fmt, ...)
+{
+    char    line[HOST_STUB_TRACE_LEN];
+    va_list args;
+    int     len;
+
+    if (host_trace < 0)
+    {
+        host_trace = (getenv("HOST_TRACE") != NULL);
+    }
+
+    // format even when muted so the cost stays in the measurement
+    va_start(args, fmt);
+    len = vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
+
+    if (host_trace)
+    {
+        fputs(line, stdout);
+    }
+    return len;
+}
+
+/******************************************************************************
+ *                          Stack and device management
+ ******************************************************************************/
+wiced_result_t wiced_bt_stack_init(wiced_bt_management_cback_t *p_bt_management_cback,
+                                   const wiced_bt_cfg_settings_t *p_bt_cfg_settings)
+{
+    (void)p_bt_cfg_settings;
+    host_management_cback = p_bt_management_cback;
+    beacon_log_set_wake(host_stub_log_wake);
+    return WICED_BT_SUCCESS;
+}
+
+void wiced_bt_dev_confirm_req_reply(wiced_result_t res, wiced_bt_device_address_t bd_addr)
+{
+    (void)res;
+    (void)bd_addr;
+}
+
+void wiced_bt_ble_security_grant(wiced_bt_device_address_t bd_addr, uint8_t res)
+{
+    (void)bd_addr;
+    (void)res;
+}
+
+void wiced_bt_set_pairable_mode(uint8_t allow_pairing, uint8_t connect_only_paired)
+{
+    (void)allow_pairing;
+    (void)connect_only_paired;
+}
+
+/******************************************************************************
+ *                          Advertising
+ ******************************************************************************/
+wiced_result_t wiced_bt_ble_set_raw_advertisement_data(uint8_t num_elem, wiced_bt_ble_advert_elem_t *p_data)
+{
+    (void)num_elem;
+    (void)p_data;
+    return WICED_BT_SUCCESS;
+}
+
+wiced_result_t wiced_bt_start_advertisements(wiced_bt_ble_advert_mode_t advert_mode,
+                                             wiced_bt_ble_address_type_t directed_advertisement_bdaddr_type,
+                                             wiced_bt_device_address_ptr_t directed_advertisement_bdaddr_ptr)
+{
+    (void)advert_mode;
+    (void)directed_advertisement_bdaddr_type;
+    (void)directed_advertisement_bdaddr_ptr;
+    return WICED_BT_SUCCESS;
+}
+
+uint8_t wiced_bt_ble_read_num_ext_adv_sets(void)
+{
+    return host_num_ext_adv_sets;
+}
+
+wiced_result_t wiced_bt_ble_set_ext_adv_parameters(wiced_bt_ble_ext_adv_handle_t adv_handle,
+                                                   wiced_bt_ble_ext_adv_event_property_t event_properties,
+                                                   uint32_t primary_adv_int_min,
+                                                   uint32_t primary_adv_int_max,
+                                                   wiced_bt_ble_advert_chnl_map_t primary_adv_channel_map,
+                                                   wiced_bt_ble_address_type_t own_addr_type,
+                                                   wiced_bt_ble_address_type_t peer_addr_type,
+                                                   wiced_bt_device_address_t peer_addr,
+                                                   wiced_bt_ble_advert_filter_policy_t adv_filter_policy,
+                                                   int8_t adv_tx_power,
+                                                   wiced_bt_ble_ext_adv_phy_t primary_adv_phy,
+                                                   uint8_t secondary_adv_max_skip,
+                                                   wiced_bt_ble_ext_adv_phy_t secondary_adv_phy,
+                                                   wiced_bt_ble_ext_adv_sid_t adv_sid,
+                                                   wiced_bt_ble_ext_adv_scan_req_notification_setting_t scan_request_not)
+{
+    (void)primary_adv_int_max;
+    (void)primary_adv_channel_map; (void)own_addr_type; (void)peer_addr_type; (void)peer_addr;
+    (void)adv_filter_policy; (void)adv_tx_power; (void)primary_adv_phy; (void)secondary_adv_max_skip;
+    (void)adv_sid; (void)scan_request_not;
+
+    if (adv_handle == 0 || adv_handle > host_num_ext_adv_sets)
+    {
+        return WICED_BT_BADARG;
+    }
+    if (host_adv_set[adv_handle].enabled)
+    {
+        host_stub_counters.disallowed++;
+        return WICED_BT_ERROR;
+    }
+    host_adv_set[adv_handle].legacy = (event_properties & WICED_BT_BLE_EXT_ADV_EVENT_LEGACY_ADV) != 0;
+    host_adv_set[adv_handle].interval = primary_adv_int_min;
+    host_adv_set[adv_handle].secondary_phy = secondary_adv_phy;
+    host_stub_counters.set_ext_adv_parameters++;
+    return WICED_BT_SUCCESS;
+}
+
+wiced_result_t wiced_bt_ble_set_ext_adv_random_address(wiced_bt_ble_ext_adv_handle_t adv_handle,
+                                                       wiced_bt_device_address_t random_address)
+{
+    if (adv_handle == 0 || adv_handle > host_num_ext_adv_sets)
+    {
+        return WICED_BT_BADARG;
+    }
+    if (host_adv_set[adv_handle].enabled)
+    {
+        host_stub_counters.disallowed++;
+        return WICED_BT_ERROR;
+    }
+    memcpy(host_adv_set[adv_handle].random_address, random_address, BD_ADDR_LEN);
+    host_stub_counters.set_ext_adv_random_address++;
+    return WICED_BT_SUCCESS;
+}
+
+wiced_result_t wiced_bt_ble_set_ext_adv_data(wiced_bt_ble_ext_adv_handle_t adv_handle,
+                                             uint16_t data_len, uint8_t *p_data)
+{
+    if (adv_handle == 0 || adv_handle > host_num_ext_adv_sets || data_len > HOST_STUB_ADV_DATA_MAX)
+    {
+        return WICED_BT_BADARG;
+    }
+    memcpy(host_adv_set[adv_handle].data, p_data, data_len);
+    host_adv_set[adv_handle].len = data_len;
+    host_stub_counters.set_ext_adv_data++;
+    host_stub_counters.adv_data_bytes += data_len;
+    return WICED_BT_SUCCESS;
+}
+
+wiced_result_t wiced_bt_ble_start_ext_adv(uint8_t enable, uint8_t num_sets,
+                                          wiced_bt_ble_ext_adv_duration_config_t *p_set_duration_param)
+{
+    uint8_t i;
+
+    for (i = 0; i < num_sets; i++)
+    {
+        wiced_bt_ble_ext_adv_handle_t adv_handle = p_set_duration_param[i].adv_handle;
+
+        if (adv_handle == 0 || adv_handle > host_num_ext_adv_sets)
+        {
+            return WICED_BT_BADARG;
+        }
+        host_adv_set[adv_handle].enabled = (enable == MULTI_ADVERT_START);
+
+        // enabling an enabled set restarts its duration, in 10 ms units
+        host_adv_set[adv_handle].expiry_ms = 0;
+        if (enable == MULTI_ADVERT_START && p_set_duration_param[i].adv_duration)
+        {
+            host_adv_set[adv_handle].expiry_ms = host_now_ms + p_set_duration_param[i].adv_duration * 10u;
+        }
+    }
+
+    if (enable == MULTI_ADVERT_START)
+    {
+        host_stub_counters.start_ext_adv++;
+        host_stub_counters.sets_started += num_sets;
+    }
+    else
+    {
+        host_stub_counters.stop_ext_adv++;
+    }
+    return WICED_BT_SUCCESS;
+}
+
+void wiced_bt_ble_register_adv_ext_cback(wiced_bt_ble_adv_ext_event_cb_fp_t p_app_adv_ext_event_cb)
+{
+    host_adv_ext_cback = p_app_adv_ext_event_cb;
+}
+
+wiced_result_t wiced_bt_ble_set_periodic_adv_params(wiced_bt_ble_ext_adv_handle_t adv_handle,
+                                                    uint16_t periodic_adv_int_min,
+                                                    uint16_t periodic_adv_int_max,
+                                                    wiced_bt_ble_periodic_adv_prop_t periodic_adv_properties)
+{
+    (void)periodic_adv_int_max; (void)periodic_adv_properties;
+
+    if (adv_handle == 0 || adv_handle > host_num_ext_adv_sets)
+    {
+        return WICED_BT_BADARG;
+    }
+    // periodic adv needs a non-legacy set and cannot be reconfigured while it runs
+    if (host_adv_set[adv_handle].legacy || host_adv_set[adv_handle].periodic_enabled)
+    {
+        host_stub_counters.disallowed++;
+        return WICED_BT_ERROR;
+    }
+    host_adv_set[adv_handle].periodic_interval = periodic_adv_int_min;
+    host_stub_counters.set_periodic_adv_params++;
+    return WICED_BT_SUCCESS;
+}
+
+wiced_result_t wiced_bt_ble_set_periodic_adv_data(wiced_bt_ble_ext_adv_handle_t adv_handle,
+                                                  uint16_t data_len, uint8_t *p_data)
+{
+    if (adv_handle == 0 || adv_handle > host_num_ext_adv_sets || data_len > HOST_STUB_ADV_DATA_MAX)
+    {
+        return WICED_BT_BADARG;
+    }
+    memcpy(host_adv_set[adv_handle].periodic_data, p_data, data_len);
+    host_adv_set[adv_handle].periodic_len = data_len;
+    host_stub_counters.set_periodic_adv_data++;
+    host_stub_counters.periodic_adv_data_bytes += data_len;
+    return WICED_BT_SUCCESS;
+}
+
+wiced_result_t wiced_bt_ble_start_periodic_adv(wiced_bt_ble_ext_adv_handle_t adv_handle, wiced_bool_t enable)
+{
+    if (adv_handle == 0 || adv_handle > host_num_ext_adv_sets)
+    {
+        return WICED_BT_BADARG;
+    }
+    if (host_adv_set[adv_handle].periodic_interval == 0)
+    {
+        host_stub_counters.disallowed++;
+        return WICED_BT_ERROR;
+    }
+    host_adv_set[adv_handle].periodic_enabled = enable;
+    host_stub_counters.start_periodic_adv++;
+    return WICED_BT_SUCCESS;
+}
+
+/******************************************************************************
+ *                          Timers
+ ******************************************************************************/
+wiced_result_t wiced_init_timer(wiced_timer_t *p_timer, wiced_timer_callback_fp TimerCb,
+                                WICED_TIMER_PARAM_TYPE cBackparam, wiced_timer_type_t type)
+{
+    int i, free_slot = -1;
+
+    memset(p_timer, 0, sizeof(*p_timer));
+    p_timer->p_callback = TimerCb;
+    p_timer->arg        = cBackparam;
+    p_timer->type       = type;
+
+    for (i = 0; i < HOST_STUB_MAX_TIMERS; i++)
+    {
+        if (host_timers[i] == p_timer)
+        {
+            return WICED_BT_SUCCESS;
+        }
+        if (host_timers[i] == NULL && free_slot < 0)
+        {
+            free_slot = i;
+        }
+    }
+    if (free_slot < 0)
+    {
+        return WICED_BT_NO_RESOURCES;
+    }
+    host_timers[free_slot] = p_timer;
+    return WICED_BT_SUCCESS;
+}
+
+wiced_result_t wiced_start_timer(wiced_timer_t *p_timer, uint32_t timeout)
+{
+    uint32_t period_ms = timeout;
+
+    if (p_timer->type == WICED_SECONDS_TIMER || p_timer->type == WICED_SECONDS_PERIODIC_TIMER)
+    {
+        period_ms *= 1000;
+    }
+    p_timer->period_ms = period_ms;
+    p_timer->expiry_ms = host_now_ms + period_ms;
+    p_timer->in_use    = WICED_TRUE;
+    return WICED_BT_SUCCESS;
+}
+
+wiced_result_t wiced_stop_timer(wiced_timer_t *p_timer)
+{
+    p_timer->in_use = WICED_FALSE;
+    return WICED_BT_SUCCESS;
+}
+
+wiced_bool_t wiced_is_timer_in_use(wiced_timer_t *p_timer)
+{
+    return p_timer->in_use;
+}
+
+/******************************************************************************
+ *                          Buffers
+ ******************************************************************************/
+void *wiced_bt_get_buffer(uint32_t size)
+{
+    host_stub_counters.buffers_alloc++;
+    host_stub_counters.buffer_bytes += size;
+    return malloc(size);
+}
+
+void wiced_bt_free_buffer(void *p_buf)
+{
+    host_stub_counters.buffers_free++;
+    free(p_buf);
+}
+
+/******************************************************************************
+ *                          GATT
+ ******************************************************************************/
+wiced_bt_gatt_status_t wiced_bt_gatt_register(wiced_bt_gatt_cback_t *p_gatt_cback)
+{
+    host_gatt_cback = p_gatt_cback;
+    return WICED_BT_GATT_SUCCESS;
+}
+
+wiced_bt_gatt_status_t wiced_bt_gatt_db_init(const uint8_t *p_gatt_db, uint32_t gatt_db_size, wiced_bt_db_hash_t hash)
+{
+    host_gatt_db     = p_gatt_db;
+    host_gatt_db_len = gatt_db_size;
+    if (hash)
+    {
+        memset(hash, 0, sizeof(wiced_bt_db_hash_t));
+    }
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/*
+ * Linear scan of the database records from the start, like the stack's own search
+ */
+uint16_t wiced_bt_gatt_find_handle_by_type(uint16_t s_handle, uint16_t e_handle, wiced_bt_uuid_t *p_uuid)
+{
+    uint8_t  uuid16[LEN_UUID_16] = { BIT16_TO_8(p_uuid->uu.uuid16) };
+    const uint8_t *p_type = (p_uuid->len == LEN_UUID_16) ? uuid16 : p_uuid->uu.uuid128;
+    uint32_t i = 0;
+
+    if (p_uuid->len != LEN_UUID_16 && p_uuid->len != LEN_UUID_128)
+    {
+        return 0;
+    }
+    while (i + 4 <= host_gatt_db_len)
+    {
+        const uint8_t *p   = &host_gatt_db[i];
+        uint16_t handle    = p[0] | (p[1] << 8);
+        uint8_t  reserved  = (p[2] & LEGATTDB_PERM_WRITABLE) ? 1 : 0;
+        uint8_t  type_len  = (p[2] & LEGATTDB_PERM_SERVICE_UUID_128) ? LEN_UUID_128 : LEN_UUID_16;
+
+        if (handle > e_handle)
+        {
+            break;
+        }
+        if (handle >= s_handle && type_len == p_uuid->len && memcmp(&p[4 + reserved], p_type, type_len) == 0)
+        {
+            return handle;
+        }
+        i += 4 + reserved + p[3];
+    }
+    return 0;
+}
+
+int wiced_bt_gatt_put_read_by_type_rsp_in_stream(uint8_t *p_stream, int stream_len, uint8_t *p_pair_len,
+                                                 uint16_t n_handle, int len, uint8_t *p_attr)
+{
+    // all pairs of a Read By Type response share one length
+    if (*p_pair_len == 0)
+    {
+        *p_pair_len = (uint8_t)(len + 2);
+    }
+    else if (*p_pair_len != len + 2)
+    {
+        return 0;
+    }
+    if (stream_len < len + 2)
+    {
+        return 0;
+    }
+    UINT16_TO_STREAM(p_stream, n_handle);
+    memcpy(p_stream, p_attr, len);
+    return len + 2;
+}
+
+int wiced_bt_gatt_put_read_multi_rsp_in_stream(wiced_bt_gatt_opcode_t opcode, uint8_t *p_stream, int stream_len,
+                                               uint16_t n_handle, int len, uint8_t *p_attr)
+{
+    int hdr = (opcode == GATT_REQ_READ_MULTI_VAR_LENGTH) ? 2 : 0;
+
+    (void)n_handle;
+    if (stream_len < len + hdr)
+    {
+        return 0;
+    }
+    if (hdr)
+    {
+        UINT16_TO_STREAM(p_stream, len);
+    }
+    memcpy(p_stream, p_attr, len);
+    return len + hdr;
+}
+
+uint16_t wiced_bt_gatt_get_handle_from_stream(uint8_t *p_stream, int num_handle)
+{
+    return p_stream[num_handle * 2] | (p_stream[num_handle * 2 + 1] << 8);
+}
+
+/*
+ * The stack hands a response buffer back to the app once it is transmitted.
+ * The stub transmits immediately.
+ */
+static void host_stub_rsp_transmitted(uint16_t len, uint8_t *p_data, wiced_bt_gatt_app_context_t p_app_ctxt)
+{
+    wiced_bt_gatt_event_data_t evt_data;
+
+    host_stub_counters.gatt_rsp++;
+    host_stub_counters.gatt_rsp_bytes += len;
+
+    // keep a copy, the buffer goes back to the app below
+    host_stub_gatt_rsp_len = (len < sizeof(host_stub_gatt_rsp_data)) ? len : sizeof(host_stub_gatt_rsp_data);
+    memcpy(host_stub_gatt_rsp_data, p_data, host_stub_gatt_rsp_len);
+
+    if (host_gatt_cback && p_app_ctxt)
+    {
+        evt_data.buffer_xmitted.p_app_data = p_data;
+        evt_data.buffer_xmitted.p_app_ctxt = p_app_ctxt;
+        host_gatt_cback(GATT_APP_BUFFER_TRANSMITTED_EVT, &evt_data);
+    }
+}
+
+const uint8_t *host_stub_gatt_rsp(uint16_t *p_len)
+{
+    *p_len = host_stub_gatt_rsp_len;
+    return host_stub_gatt_rsp_data;
+}
+
+wiced_bt_gatt_status_t wiced_bt_gatt_server_send_read_handle_rsp(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                                                 uint16_t len, uint8_t *p_attr,
+                                                                 wiced_bt_gatt_app_context_t p_app_ctxt)
+{
+    (void)conn_id;
+    (void)opcode;
+    host_stub_rsp_transmitted(len, p_attr, p_app_ctxt);
+    return WICED_BT_GATT_SUCCESS;
+}
+
+wiced_bt_gatt_status_t wiced_bt_gatt_server_send_read_by_type_rsp(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                                                  uint8_t type_len, uint16_t data_len, uint8_t *p_data,
+                                                                  wiced_bt_gatt_app_context_t p_app_ctxt)
+{
+    (void)conn_id;
+    (void)opcode;
+    (void)type_len;
+    host_stub_rsp_transmitted(data_len, p_data, p_app_ctxt);
+    return WICED_BT_GATT_SUCCESS;
+}
+
+wiced_bt_gatt_status_t wiced_bt_gatt_server_send_read_multiple_rsp(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                                                   uint16_t data_len, uint8_t *p_data,
+                                                                   wiced_bt_gatt_app_context_t p_app_ctxt)
+{
+    (void)conn_id;
+    (void)opcode;
+    host_stub_rsp_transmitted(data_len, p_data, p_app_ctxt);
+    return WICED_BT_GATT_SUCCESS;
+}
+
+wiced_bt_gatt_status_t wiced_bt_gatt_server_send_error_rsp(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                                           uint16_t handle, wiced_bt_gatt_status_t status)
+{
+    (void)conn_id;
+    (void)opcode;
+    (void)handle;
+    (void)status;
+    host_stub_counters.gatt_err_rsp++;
+    return WICED_BT_GATT_SUCCESS;
+}
+
+wiced_bt_gatt_status_t wiced_bt_gatt_server_send_write_rsp(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                                           uint16_t handle)
+{
+    (void)conn_id;
+    (void)opcode;
+    (void)handle;
+    host_stub_counters.gatt_rsp++;
+    return WICED_BT_GATT_SUCCESS;
+}
+
+wiced_bt_gatt_status_t wiced_bt_gatt_server_send_mtu_rsp(uint16_t conn_id, uint16_t remote_mtu, uint16_t local_mtu)
+{
+    (void)conn_id;
+    (void)remote_mtu;
+    (void)local_mtu;
+    return WICED_BT_GATT_SUCCESS;
+}
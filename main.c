@@ -18,8 +18,205 @@
 #include "string.h"
 #include "wiced_bt_stack.h"
 #include "beacon.h"
+#include "beacon_log.h"
+#include "beacon_eid.h"
+#include "beacon_pool.h"
+#include "beacon_prof.h"
 #include "cy_retarget_io.h"
+#include "cyabs_rtos.h"
 
+/* Log drain thread, below the BT stack so formatting, UART output and EID precomputation never delay it */
+#define LOG_THREAD_STACK_SIZE       (1024 * 2)
+#define LOG_THREAD_PRIORITY         CY_RTOS_PRIORITY_LOW
+
+/* Priority of the debug UART receive interrupt that wakes the log thread */
+#define LOG_THREAD_UART_IRQ_PRIORITY    7
+
+/*
+ * The log thread blocks on log_thread_sem, given by the first log record
+ * after a drain, by the rotation when the EID period rolls over and by a
+ * byte on the debug UART. It does not wake the MCU on its own.
+ */
+static cy_thread_t    log_thread;
+static cy_semaphore_t log_thread_sem;
+
+/*
+ * Pages at the end of the first flash block, kept out of the linker script.
+ * The last NVRAM_TIME_PAGES hold the beacon time checkpoint, saves alternate
+ * between them so a reset during a write leaves the previous checkpoint in
+ * the other page. The page below them holds the provisioning blob the
+ * factory programs (beacon_provision.h).
+ */
+#define NVRAM_TIME_PAGES            2
+#define NVRAM_PAGE_MAX              512
+
+static cyhal_flash_t  nvram_flash;
+static uint32_t       nvram_time_addr;      // first checkpoint page
+static uint32_t       nvram_provision_addr;
+static uint32_t       nvram_page_size;
+static uint8_t        nvram_time_next;      // page the next checkpoint goes to
+static uint32_t       nvram_page[NVRAM_PAGE_MAX / sizeof(uint32_t)];
+
+/* Debug UART commands, handled by the log thread */
+#define LOG_CMD_PROF_DUMP           'p'
+#define LOG_CMD_PROF_RESET          'r'
+#define LOG_CMD_POOL_DUMP           'm'
+
+/*
+ * Handles a debug UART command: 'p' dumps the latency probes, 'r' clears them,
+ * 'm' dumps the GATT buffer pool
+ */
+static void log_thread_command(void)
+{
+    uint8_t cmd;
+
+    while (cyhal_uart_readable(&cy_retarget_io_uart_obj) != 0 &&
+           cyhal_uart_getc(&cy_retarget_io_uart_obj, &cmd, 0) == CY_RSLT_SUCCESS)
+    {
+        if (cmd == LOG_CMD_PROF_DUMP)
+        {
+            beacon_prof_dump();
+        }
+        else if (cmd == LOG_CMD_PROF_RESET)
+        {
+            beacon_prof_reset();
+        }
+        else if (cmd == LOG_CMD_POOL_DUMP)
+        {
+            beacon_pool_dump();
+        }
+    }
+
+    // the receive FIFO is empty, the next byte wakes the thread again
+    cyhal_uart_enable_event(&cy_retarget_io_uart_obj, CYHAL_UART_IRQ_RX_NOT_EMPTY, LOG_THREAD_UART_IRQ_PRIORITY, true);
+}
+
+/*
+ * Wakes the log thread, registered with beacon_log_set_wake()
+ */
+static void log_thread_wake(void)
+{
+    cy_rtos_set_semaphore(&log_thread_sem, false);
+}
+
+/*
+ * Debug UART receive interrupt: the event is level triggered, so it stays
+ * off until the thread has emptied the FIFO
+ */
+static void log_thread_uart_event(void *callback_arg, cyhal_uart_event_t event)
+{
+    (void)callback_arg;
+    (void)event;
+
+    cyhal_uart_enable_event(&cy_retarget_io_uart_obj, CYHAL_UART_IRQ_RX_NOT_EMPTY, LOG_THREAD_UART_IRQ_PRIORITY, false);
+    cy_rtos_set_semaphore(&log_thread_sem, true);
+}
+
+/*
+ * Formats the deferred log records over retarget-io, computes the upcoming
+ * Eddystone EIDs and serves the debug commands, each time it is woken
+ */
+static void log_thread_entry(cy_thread_arg_t arg)
+{
+    (void)arg;
+
+    for (;;)
+    {
+        cy_rtos_get_semaphore(&log_thread_sem, CY_RTOS_NEVER_TIMEOUT, false);
+        beacon_log_drain(0);
+        beacon_eid_refill();
+        log_thread_command();
+    }
+}
+
+/*
+ * Locates the checkpoint pages, returns false if the flash cannot be used
+ */
+static bool nvram_init(void)
+{
+    cyhal_flash_info_t info;
+    const cyhal_flash_block_info_t *p_block;
+
+    if (cyhal_flash_init(&nvram_flash) != CY_RSLT_SUCCESS)
+    {
+        printf("Flash init failed\n");
+        return false;
+    }
+    cyhal_flash_get_info(&nvram_flash, &info);
+    p_block = &info.blocks[0];
+    if (p_block->page_size > NVRAM_PAGE_MAX)
+    {
+        printf("Flash page of %lu bytes too large\n", (unsigned long)p_block->page_size);
+        return false;
+    }
+    nvram_page_size = p_block->page_size;
+    nvram_time_addr = p_block->start_address + p_block->size - NVRAM_TIME_PAGES * nvram_page_size;
+    nvram_provision_addr = nvram_time_addr - nvram_page_size;
+    return true;
+}
+
+/*
+ * Gives the provisioning blob to the application, a device without one keeps
+ * the sample values
+ */
+static void nvram_provision(void)
+{
+    static beacon_provision_t prov;
+
+    if (cyhal_flash_read(&nvram_flash, nvram_provision_addr, (uint8_t *)&prov, sizeof(prov)) != CY_RSLT_SUCCESS ||
+        prov.magic != BEACON_PROVISION_MAGIC)
+    {
+        printf("Not provisioned, sample values\n");
+        return;
+    }
+    beacon_set_provisioning(&prov);
+}
+
+/*
+ * Reads the latest time checkpoint: each page holds a checkpoint and its
+ * complement, the largest valid one wins
+ */
+static wiced_bool_t nvram_time_load(uint32_t *p_checkpoint)
+{
+    uint32_t     word[2];
+    wiced_bool_t found = WICED_FALSE;
+    uint8_t      i;
+
+    for (i = 0; i < NVRAM_TIME_PAGES; i++)
+    {
+        if (cyhal_flash_read(&nvram_flash, nvram_time_addr + i * nvram_page_size, (uint8_t *)word,
+                             sizeof(word)) != CY_RSLT_SUCCESS || word[1] != ~word[0])
+        {
+            continue;
+        }
+        if (!found || word[0] > *p_checkpoint)
+        {
+            *p_checkpoint = word[0];
+            nvram_time_next = (uint8_t)((i + 1) % NVRAM_TIME_PAGES);
+            found = WICED_TRUE;
+        }
+    }
+    return found;
+}
+
+/*
+ * Writes a time checkpoint over the older page
+ */
+static wiced_bool_t nvram_time_save(uint32_t checkpoint)
+{
+    memset(nvram_page, 0, nvram_page_size);
+    nvram_page[0] = checkpoint;
+    nvram_page[1] = ~checkpoint;
+    if (cyhal_flash_write(&nvram_flash, nvram_time_addr + nvram_time_next * nvram_page_size,
+                          nvram_page) != CY_RSLT_SUCCESS)
+    {
+        return WICED_FALSE;
+    }
+    nvram_time_next = (uint8_t)((nvram_time_next + 1) % NVRAM_TIME_PAGES);
+    return WICED_TRUE;
+}
+
+static const beacon_time_store_t nvram_time_store = { nvram_time_load, nvram_time_save };
 
 int main()
 {
@@ -49,6 +246,30 @@ int main()
 
     printf("EXTENDED ADVERTISEMENT BEACON APPLICATION \n");
 
+    /* Start the log drain before the stack logs anything */
+    cy_result = cy_rtos_init_semaphore(&log_thread_sem, 1, 0);
+    if (cy_result != CY_RSLT_SUCCESS)
+    {
+        printf("Log thread semaphore init failed\n");
+        CY_ASSERT(0);
+    }
+    cy_result = cy_rtos_create_thread(&log_thread, log_thread_entry, "beacon_log", NULL,
+                                      LOG_THREAD_STACK_SIZE, LOG_THREAD_PRIORITY, 0);
+    if (cy_result != CY_RSLT_SUCCESS)
+    {
+        printf("Log thread create failed\n");
+    }
+    beacon_log_set_wake(log_thread_wake);
+    cyhal_uart_register_callback(&cy_retarget_io_uart_obj, log_thread_uart_event, NULL);
+    cyhal_uart_enable_event(&cy_retarget_io_uart_obj, CYHAL_UART_IRQ_RX_NOT_EMPTY, LOG_THREAD_UART_IRQ_PRIORITY, true);
+
+    /* The device identity comes from the factory, the EID time counter carries on from the last boot, and so do the eTLM nonces */
+    if (nvram_init())
+    {
+        nvram_provision();
+        beacon_set_time_store(&nvram_time_store);
+    }
+
     application_start();
 
 }
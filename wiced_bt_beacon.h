@@ -21,6 +21,125 @@
 /* Max adv data length */
 #define WICED_BT_BEACON_ADV_DATA_MAX 31
 
+/* Max adv data length of one extended (non-legacy) advertising set */
+#define WICED_BT_BEACON_EXT_ADV_DATA_MAX 254
+
+/* Length of a Flags AD structure */
+#define WICED_BT_BEACON_FLAGS_AD_LEN 3
+
+/* Flags value used by all beacon advertisements */
+#define WICED_BT_BEACON_FLAGS        (BTM_BLE_GENERAL_DISCOVERABLE_FLAG | BTM_BLE_BREDR_NOT_SUPPORTED)
+
+/******************************************************************************
+*                   Constant initialisers
+******************************************************************************/
+/* The *_INIT macros expand to the bytes the encoders write, so a beacon whose
+   inputs are all compile-time constants can keep its adv data in flash:
+
+     static const uint8_t adv[] = { IBEACON_ADV_DATA_INIT(UUID, 1, 2, 0xb3) };
+
+   Byte list arguments (UUID, namespace, instance, encoded URL) are passed as
+   macros that expand to comma-separated bytes. */
+
+/* A 16-bit field, little-endian as UINT16_TO_STREAM writes it */
+#define WICED_BT_BEACON_LE16_INIT(value)     (uint8_t)((value) & 0xff), (uint8_t)(((value) >> 8) & 0xff)
+
+/* AD structure header: length (type byte included) and type */
+#define WICED_BT_BEACON_AD_HDR_INIT(type, data_len)  (uint8_t)((data_len) + 1), (uint8_t)(type)
+
+/* Flags AD structure, as wiced_bt_beacon_encoder_put_flags() writes it */
+#define WICED_BT_BEACON_FLAGS_AD_INIT(flags) WICED_BT_BEACON_AD_HDR_INIT(BTM_BLE_ADVERT_TYPE_FLAG, 1), (uint8_t)(flags)
+
+/******************************************************************************
+*                   Encoder context
+******************************************************************************/
+/* State of one encoding pass into a caller-owned advertisement buffer.
+   The library keeps no encoding state of its own, so any number of threads can
+   encode at the same time, each with its own context and buffer. */
+typedef struct
+{
+    uint8_t      *p_buf;        /* Buffer of advertisement data */
+    uint16_t      size;         /* Size of p_buf */
+    uint16_t      len;          /* Bytes encoded so far */
+    wiced_bool_t  overflow;     /* Set when an AD structure did not fit */
+} wiced_bt_beacon_encoder_t;
+
+/******************************************************************************
+* Function Name: wiced_bt_beacon_encoder_init
+***************************************************************************//**
+*
+* \brief Starts an encoding pass into a caller-owned buffer.
+*
+* @param[out]  p_enc        Encoder context
+* @param[out]  p_buf        Buffer of advertisement data, legacy or extended length
+* @param[in]   size         Size of p_buf
+*
+* \return     None.
+*
+******************************************************************************/
+void wiced_bt_beacon_encoder_init(wiced_bt_beacon_encoder_t *p_enc, uint8_t *p_buf, uint16_t size);
+
+/******************************************************************************
+* Function Name: wiced_bt_beacon_encoder_reserve
+***************************************************************************//**
+*
+* \brief Appends the header of an AD structure and reserves its payload.
+* \details The caller writes data_len bytes of payload at the returned position.
+*
+* @param[in]   p_enc        Encoder context
+* @param[in]   advert_type  AD type
+* @param[in]   data_len     Payload length, excluding the length and AD type bytes
+*
+* \return     Position of the payload, or NULL if the AD structure does not fit.
+*
+******************************************************************************/
+uint8_t *wiced_bt_beacon_encoder_reserve(wiced_bt_beacon_encoder_t *p_enc, wiced_bt_ble_advert_type_t advert_type,
+                                         uint8_t data_len);
+
+/******************************************************************************
+* Function Name: wiced_bt_beacon_encoder_put_elem
+***************************************************************************//**
+*
+* \brief Appends an AD structure.
+*
+* @param[in]   p_enc        Encoder context
+* @param[in]   advert_type  AD type
+* @param[in]   p_data       AD payload
+* @param[in]   data_len     Length of p_data
+*
+* \return     WICED_TRUE if the AD structure fits in the buffer.
+*
+******************************************************************************/
+wiced_bool_t wiced_bt_beacon_encoder_put_elem(wiced_bt_beacon_encoder_t *p_enc, wiced_bt_ble_advert_type_t advert_type,
+                                              const uint8_t *p_data, uint8_t data_len);
+
+/******************************************************************************
+* Function Name: wiced_bt_beacon_encoder_put_flags
+***************************************************************************//**
+*
+* \brief Appends a Flags AD structure.
+*
+* @param[in]   p_enc        Encoder context
+* @param[in]   flags        Flags value, e.g. WICED_BT_BEACON_FLAGS
+*
+* \return     WICED_TRUE if the AD structure fits in the buffer.
+*
+******************************************************************************/
+wiced_bool_t wiced_bt_beacon_encoder_put_flags(wiced_bt_beacon_encoder_t *p_enc, uint8_t flags);
+
+/******************************************************************************
+* Function Name: wiced_bt_beacon_encoder_len
+***************************************************************************//**
+*
+* \brief Ends an encoding pass.
+*
+* @param[in]   p_enc        Encoder context
+*
+* \return     Length of advertisement data, or 0 if any AD structure did not fit.
+*
+******************************************************************************/
+uint16_t wiced_bt_beacon_encoder_len(const wiced_bt_beacon_encoder_t *p_enc);
+
 /* Type of eddystone frame
    https://github.com/google/eddystone/blob/master/protocol-specification.md */
 
@@ -48,6 +167,14 @@
 #define EDDYSTONE_TLM_ENCRYPTED_FRAME_LEN           18
 #define EDDYSTONE_ETLM_LEN 12
 
+/* Offsets of the TLM unencrypted fields within the advertisement data encoded by
+   wiced_bt_eddystone_encode_tlm_unencrypted, i.e. after the Eddystone header,
+   frame type and version */
+#define EDDYSTONE_TLM_VBATT_OFFSET                  (EDDYSTONE_ADV_HDR_LEN + 2)
+#define EDDYSTONE_TLM_TEMP_OFFSET                   (EDDYSTONE_ADV_HDR_LEN + 4)
+#define EDDYSTONE_TLM_ADV_CNT_OFFSET                (EDDYSTONE_ADV_HDR_LEN + 6)
+#define EDDYSTONE_TLM_SEC_CNT_OFFSET                (EDDYSTONE_ADV_HDR_LEN + 10)
+
 /* Definitions for EID frame format */
 #define EDDYSTONE_EID_FRAME_LEN           10
 #define EDDYSTONE_EID_LEN                 8
@@ -58,6 +185,12 @@
 /* Number of advertiment elements for Eddystone*/
 #define EDDYSTONE_ELEM_NUM                3
 
+/* Bytes of the Service Data AD header (length, type, Eddystone UUID) in front of a frame */
+#define EDDYSTONE_SERVICE_DATA_HDR_LEN    4
+
+/* Bytes of Flags, UUID list and Service Data header in front of an Eddystone frame */
+#define EDDYSTONE_ADV_HDR_LEN             11
+
 /******************************************************************************
 * URL Scheme Prefix for Google Eddystone
 * Decimal Hex   Expansion
@@ -72,6 +205,51 @@
 #define EDDYSTONE_URL_SCHEME_2           0x02
 #define EDDYSTONE_URL_SCHEME_3           0x03
 
+/******************************************************************************
+* URL Expansion codes for Google Eddystone, replace a TLD within the encoded URL
+* Decimal Hex   Expansion
+*   0      0x00   .com/
+*   1      0x01   .org/
+*   2      0x02   .edu/
+*   3      0x03   .net/
+*   4      0x04   .info/
+*   5      0x05   .biz/
+*   6      0x06   .gov/
+*   7      0x07   .com
+*   8      0x08   .org
+*   9      0x09   .edu
+*  10      0x0a   .net
+*  11      0x0b   .info
+*  12      0x0c   .biz
+*  13      0x0d   .gov
+*
+* Other bytes of an encoded URL are sent as is and must be 0x21 to 0x7e.
+******************************************************************************/
+#define EDDYSTONE_URL_CHAR_MIN           0x21
+#define EDDYSTONE_URL_CHAR_MAX           0x7e
+
+/* Flags and Eddystone UUID list in front of every Eddystone frame, EDDYSTONE_ADV_HDR_LEN - EDDYSTONE_SERVICE_DATA_HDR_LEN bytes */
+#define EDDYSTONE_ADV_PREFIX_INIT \
+    WICED_BT_BEACON_FLAGS_AD_INIT(WICED_BT_BEACON_FLAGS), \
+    WICED_BT_BEACON_AD_HDR_INIT(BTM_BLE_ADVERT_TYPE_16SRV_COMPLETE, LEN_UUID_16), WICED_BT_BEACON_LE16_INIT(EDDYSTONE_UUID16)
+
+/* Service Data header and frame type of a frame of frame_len bytes, frame type included */
+#define EDDYSTONE_FRAME_HDR_INIT(frame_type, frame_len) \
+    WICED_BT_BEACON_AD_HDR_INIT(BTM_BLE_ADVERT_TYPE_SERVICE_DATA, LEN_UUID_16 + (frame_len)), \
+    WICED_BT_BEACON_LE16_INIT(EDDYSTONE_UUID16), (uint8_t)(frame_type)
+
+/* Eddystone UID adv data, as wiced_bt_eddystone_encode_uid() writes it */
+#define EDDYSTONE_UID_ADV_DATA_INIT(ranging_data, namespace_bytes, instance_bytes) \
+    EDDYSTONE_ADV_PREFIX_INIT, \
+    EDDYSTONE_FRAME_HDR_INIT(EDDYSTONE_FRAME_TYPE_UID, EDDYSTONE_UID_FRAME_LEN), \
+    (uint8_t)(ranging_data), namespace_bytes, instance_bytes, 0, 0
+
+/* Eddystone URL adv data of an encoded URL of url_len bytes, as wiced_bt_eddystone_encode_url() writes it */
+#define EDDYSTONE_URL_ADV_DATA_INIT(tx_power, urlscheme, url_len, encoded_url_bytes) \
+    EDDYSTONE_ADV_PREFIX_INIT, \
+    EDDYSTONE_FRAME_HDR_INIT(EDDYSTONE_FRAME_TYPE_URL, (url_len) + 3), \
+    (uint8_t)(tx_power), (uint8_t)(urlscheme), encoded_url_bytes
+
 /******************************************************************************
 * Function Name: wiced_bt_eddystone_set_data_for_uid
 ***************************************************************************//**
@@ -182,6 +360,316 @@ void wiced_bt_eddystone_set_data_for_tlm_encrypted(uint8_t etlm[EDDYSTONE_ETLM_L
                                                    uint16_t mic,
                                                    uint8_t adv_data[WICED_BT_BEACON_ADV_DATA_MAX], uint8_t *adv_len);
 
+
+/******************************************************************************
+* Function Name: wiced_bt_eddystone_encode_uid
+***************************************************************************//**
+*
+* \brief Encodes Google Eddystone UID format advertising data in one pass.
+* \details Writes the Flags, UUID list and Service Data AD structures directly
+*          into the caller's buffer, without intermediate copies. The buffer
+*          may be a legacy (WICED_BT_BEACON_ADV_DATA_MAX) or an extended-length
+*          advertising buffer.
+*
+* @param[in]   eddystone_ranging_data     Calibrated TX power
+* @param[in]   eddystone_namespace        UID namespace
+* @param[in]   eddystone_instance         Instance
+* @param[out]  p_adv_data                 Buffer of advertisement data
+* @param[in]   adv_data_size              Size of p_adv_data
+*
+* \return     Length of advertisement data, or 0 if it does not fit in the buffer.
+*
+******************************************************************************/
+uint16_t wiced_bt_eddystone_encode_uid(uint8_t eddystone_ranging_data,
+                                       const uint8_t eddystone_namespace[EDDYSTONE_UID_NAMESPACE_LEN],
+                                       const uint8_t eddystone_instance[EDDYSTONE_UID_INSTANCE_ID_LEN],
+                                       uint8_t *p_adv_data, uint16_t adv_data_size);
+
+/******************************************************************************
+* Function Name: wiced_bt_eddystone_encode_url
+***************************************************************************//**
+*
+* \brief Encodes Google Eddystone URL format advertising data in one pass.
+*
+* @param[in]   tx_power         Calibrated TX power
+* @param[in]   urlscheme        URL scheme
+* @param[in]   encoded_url      Encoded URL (not NULL terminated)
+* @param[in]   url_len          Length of encoded_url, up to EDDYSTONE_URL_VALUE_MAX_LEN
+* @param[out]  p_adv_data       Buffer of advertisement data
+* @param[in]   adv_data_size    Size of p_adv_data
+*
+* \return     Length of advertisement data, or 0 if it does not fit in the buffer.
+*
+******************************************************************************/
+uint16_t wiced_bt_eddystone_encode_url(uint8_t tx_power,
+                                       uint8_t urlscheme,
+                                       const uint8_t *encoded_url, uint8_t url_len,
+                                       uint8_t *p_adv_data, uint16_t adv_data_size);
+
+/******************************************************************************
+* Function Name: wiced_bt_eddystone_compress_url
+***************************************************************************//**
+*
+* \brief Compresses a full URL into an Eddystone URL scheme and encoded URL.
+* \details Takes the longest URL scheme prefix, then replaces every TLD the
+*          expansion codes cover with its code. All expansions start with '.',
+*          which no expansion contains elsewhere, so taking the longest one at
+*          each '.' gives the shortest encoded URL.
+*
+* @param[in]   url              URL with its scheme, NULL terminated
+* @param[out]  p_urlscheme      URL scheme
+* @param[out]  encoded_url      Encoded URL (not NULL terminated)
+* @param[out]  p_url_len        Length of encoded_url
+*
+* \return     WICED_TRUE if the URL has a known scheme, only holds bytes that
+*             can be sent and fits in EDDYSTONE_URL_VALUE_MAX_LEN bytes.
+*
+******************************************************************************/
+wiced_bool_t wiced_bt_eddystone_compress_url(const char *url,
+                                             uint8_t *p_urlscheme,
+                                             uint8_t encoded_url[EDDYSTONE_URL_VALUE_MAX_LEN],
+                                             uint8_t *p_url_len);
+
+/******************************************************************************
+* Function Name: wiced_bt_eddystone_encode_eid
+***************************************************************************//**
+*
+* \brief Encodes Google Eddystone EID format advertising data in one pass.
+*
+* @param[in]   eddystone_ranging_data     Calibrated TX power
+* @param[in]   eid                        Ephemeral identifier
+* @param[out]  p_adv_data                 Buffer of advertisement data
+* @param[in]   adv_data_size              Size of p_adv_data
+*
+* \return     Length of advertisement data, or 0 if it does not fit in the buffer.
+*
+******************************************************************************/
+uint16_t wiced_bt_eddystone_encode_eid(uint8_t eddystone_ranging_data,
+                                       const uint8_t eid[EDDYSTONE_EID_LEN],
+                                       uint8_t *p_adv_data, uint16_t adv_data_size);
+
+/******************************************************************************
+* Function Name: wiced_bt_eddystone_encode_tlm_unencrypted
+***************************************************************************//**
+*
+* \brief Encodes Google Eddystone TLM unencrypted format advertising data in one pass.
+*
+* @param[in]   vbatt        Battery voltage
+* @param[in]   temp         Beacon temperature
+* @param[in]   adv_cnt      Advertising PDU count
+* @param[in]   sec_cnt      Time since power-on or reboot
+* @param[out]  p_adv_data   Buffer of advertisement data
+* @param[in]   adv_data_size Size of p_adv_data
+*
+* \return     Length of advertisement data, or 0 if it does not fit in the buffer.
+*
+******************************************************************************/
+uint16_t wiced_bt_eddystone_encode_tlm_unencrypted(uint16_t vbatt,
+                                                   uint16_t temp,
+                                                   uint32_t adv_cnt,
+                                                   uint32_t sec_cnt,
+                                                   uint8_t *p_adv_data, uint16_t adv_data_size);
+
+/******************************************************************************
+* Function Name: wiced_bt_eddystone_patch_tlm_unencrypted
+***************************************************************************//**
+*
+* \brief Updates the fields of an encoded Eddystone TLM unencrypted advertisement in place.
+* \details Only the VBATT, TEMP, ADV_CNT and SEC_CNT bytes are rewritten, using
+*          word-wise little-endian stores. The rest of the advertisement stays as
+*          encoded by wiced_bt_eddystone_encode_tlm_unencrypted.
+*
+* @param[in,out] p_adv_data   Advertisement data from wiced_bt_eddystone_encode_tlm_unencrypted
+* @param[in]     vbatt        Battery voltage
+* @param[in]     temp         Beacon temperature
+* @param[in]     adv_cnt      Advertising PDU count
+* @param[in]     sec_cnt      Time since power-on or reboot
+*
+* \return     None.
+*
+******************************************************************************/
+void wiced_bt_eddystone_patch_tlm_unencrypted(uint8_t *p_adv_data,
+                                              uint16_t vbatt,
+                                              uint16_t temp,
+                                              uint32_t adv_cnt,
+                                              uint32_t sec_cnt);
+
+/******************************************************************************
+* Function Name: wiced_bt_eddystone_patch_tlm_frame
+***************************************************************************//**
+*
+* \brief Updates the fields of a TLM unencrypted frame in place, anywhere in an advertisement.
+* \details Same as wiced_bt_eddystone_patch_tlm_unencrypted for a frame appended
+*          with wiced_bt_eddystone_put_tlm_unencrypted, e.g. one of several frames in
+*          an extended advertisement. The frame starts EDDYSTONE_SERVICE_DATA_HDR_LEN
+*          bytes after the encoder length at the time the frame was appended.
+*
+* @param[in,out] p_frame      Frame type byte of the TLM frame
+* @param[in]     vbatt        Battery voltage
+* @param[in]     temp         Beacon temperature
+* @param[in]     adv_cnt      Advertising PDU count
+* @param[in]     sec_cnt      Time since power-on or reboot
+*
+* \return     None.
+*
+******************************************************************************/
+void wiced_bt_eddystone_patch_tlm_frame(uint8_t *p_frame,
+                                        uint16_t vbatt,
+                                        uint16_t temp,
+                                        uint32_t adv_cnt,
+                                        uint32_t sec_cnt);
+
+/******************************************************************************
+* Function Name: wiced_bt_eddystone_encode_tlm_encrypted
+***************************************************************************//**
+*
+* \brief Encodes Google Eddystone TLM encrypted format advertising data in one pass.
+*
+* @param[in]   etlm         Encrypted TLM data
+* @param[in]   salt         16-bit Salt
+* @param[in]   mic          16 bit Message Integrity Check
+* @param[out]  p_adv_data   Buffer of advertisement data
+* @param[in]   adv_data_size Size of p_adv_data
+*
+* \return     Length of advertisement data, or 0 if it does not fit in the buffer.
+*
+******************************************************************************/
+uint16_t wiced_bt_eddystone_encode_tlm_encrypted(const uint8_t etlm[EDDYSTONE_ETLM_LEN],
+                                                 uint16_t salt,
+                                                 uint16_t mic,
+                                                 uint8_t *p_adv_data, uint16_t adv_data_size);
+
+/******************************************************************************
+* Function Name: wiced_bt_eddystone_put_uuid_list
+***************************************************************************//**
+*
+* \brief Appends the Complete 16-bit Service UUID list AD structure with the Eddystone UUID.
+* \details Together with a Flags AD structure it forms the header every Eddystone
+*          advertisement carries before its Service Data frame(s).
+*
+* @param[in]   p_enc        Encoder context
+*
+* \return     WICED_TRUE if the AD structure fits in the buffer.
+*
+******************************************************************************/
+wiced_bool_t wiced_bt_eddystone_put_uuid_list(wiced_bt_beacon_encoder_t *p_enc);
+
+/******************************************************************************
+* Function Name: wiced_bt_eddystone_put_uid
+***************************************************************************//**
+*
+* \brief Appends an Eddystone UID frame as a Service Data AD structure.
+* \details The wiced_bt_eddystone_put_* functions write only the frame. They let
+*          a caller compose several frames into one (extended) advertisement.
+*
+* @param[in]   p_enc                      Encoder context
+* @param[in]   eddystone_ranging_data     Calibrated TX power
+* @param[in]   eddystone_namespace        UID namespace
+* @param[in]   eddystone_instance         Instance
+*
+* \return     WICED_TRUE if the frame fits in the buffer.
+*
+******************************************************************************/
+wiced_bool_t wiced_bt_eddystone_put_uid(wiced_bt_beacon_encoder_t *p_enc,
+                                        uint8_t eddystone_ranging_data,
+                                        const uint8_t eddystone_namespace[EDDYSTONE_UID_NAMESPACE_LEN],
+                                        const uint8_t eddystone_instance[EDDYSTONE_UID_INSTANCE_ID_LEN]);
+
+/******************************************************************************
+* Function Name: wiced_bt_eddystone_put_url
+***************************************************************************//**
+*
+* \brief Appends an Eddystone URL frame as a Service Data AD structure.
+*
+* @param[in]   p_enc            Encoder context
+* @param[in]   tx_power         Calibrated TX power
+* @param[in]   urlscheme        URL scheme
+* @param[in]   encoded_url      Encoded URL (not NULL terminated)
+* @param[in]   url_len          Length of encoded_url, up to EDDYSTONE_URL_VALUE_MAX_LEN
+*
+* \return     WICED_TRUE if the frame fits in the buffer.
+*
+******************************************************************************/
+wiced_bool_t wiced_bt_eddystone_put_url(wiced_bt_beacon_encoder_t *p_enc,
+                                        uint8_t tx_power,
+                                        uint8_t urlscheme,
+                                        const uint8_t *encoded_url, uint8_t url_len);
+
+/******************************************************************************
+* Function Name: wiced_bt_eddystone_put_url_string
+***************************************************************************//**
+*
+* \brief Appends an Eddystone URL frame of a full URL, compressed with
+*        wiced_bt_eddystone_compress_url.
+*
+* @param[in]   p_enc            Encoder context
+* @param[in]   tx_power         Calibrated TX power
+* @param[in]   url              URL with its scheme, NULL terminated
+*
+* \return     WICED_TRUE if the URL compresses and the frame fits in the buffer.
+*
+******************************************************************************/
+wiced_bool_t wiced_bt_eddystone_put_url_string(wiced_bt_beacon_encoder_t *p_enc,
+                                               uint8_t tx_power,
+                                               const char *url);
+
+/******************************************************************************
+* Function Name: wiced_bt_eddystone_put_eid
+***************************************************************************//**
+*
+* \brief Appends an Eddystone EID frame as a Service Data AD structure.
+*
+* @param[in]   p_enc                      Encoder context
+* @param[in]   eddystone_ranging_data     Calibrated TX power
+* @param[in]   eid                        Ephemeral identifier
+*
+* \return     WICED_TRUE if the frame fits in the buffer.
+*
+******************************************************************************/
+wiced_bool_t wiced_bt_eddystone_put_eid(wiced_bt_beacon_encoder_t *p_enc,
+                                        uint8_t eddystone_ranging_data,
+                                        const uint8_t eid[EDDYSTONE_EID_LEN]);
+
+/******************************************************************************
+* Function Name: wiced_bt_eddystone_put_tlm_unencrypted
+***************************************************************************//**
+*
+* \brief Appends an Eddystone TLM unencrypted frame as a Service Data AD structure.
+*
+* @param[in]   p_enc        Encoder context
+* @param[in]   vbatt        Battery voltage
+* @param[in]   temp         Beacon temperature
+* @param[in]   adv_cnt      Advertising PDU count
+* @param[in]   sec_cnt      Time since power-on or reboot
+*
+* \return     WICED_TRUE if the frame fits in the buffer.
+*
+******************************************************************************/
+wiced_bool_t wiced_bt_eddystone_put_tlm_unencrypted(wiced_bt_beacon_encoder_t *p_enc,
+                                                    uint16_t vbatt,
+                                                    uint16_t temp,
+                                                    uint32_t adv_cnt,
+                                                    uint32_t sec_cnt);
+
+/******************************************************************************
+* Function Name: wiced_bt_eddystone_put_tlm_encrypted
+***************************************************************************//**
+*
+* \brief Appends an Eddystone TLM encrypted frame as a Service Data AD structure.
+*
+* @param[in]   p_enc        Encoder context
+* @param[in]   etlm         Encrypted TLM data
+* @param[in]   salt         16-bit Salt
+* @param[in]   mic          16 bit Message Integrity Check
+*
+* \return     WICED_TRUE if the frame fits in the buffer.
+*
+******************************************************************************/
+wiced_bool_t wiced_bt_eddystone_put_tlm_encrypted(wiced_bt_beacon_encoder_t *p_enc,
+                                                  const uint8_t etlm[EDDYSTONE_ETLM_LEN],
+                                                  uint16_t salt,
+                                                  uint16_t mic);
+
 /******************************************************************************
     Definitions for Apple iBeacon
 ******************************************************************************/
@@ -199,6 +687,15 @@ void wiced_bt_eddystone_set_data_for_tlm_encrypted(uint8_t etlm[EDDYSTONE_ETLM_L
 #define IBEACON_DATA_LENGTH        0x19
 /* number of elements in advertisement */
 #define IBEACON_ELEM_NUM           2
+/* Length of iBeacon advertisement data */
+#define IBEACON_ADV_LEN            (WICED_BT_BEACON_FLAGS_AD_LEN + 2 + IBEACON_DATA_LENGTH)
+
+/* iBeacon adv data, as wiced_bt_ibeacon_encode() writes it */
+#define IBEACON_ADV_DATA_INIT(uuid_bytes, major, minor, tx_power) \
+    WICED_BT_BEACON_FLAGS_AD_INIT(WICED_BT_BEACON_FLAGS), \
+    WICED_BT_BEACON_AD_HDR_INIT(BTM_BLE_ADVERT_TYPE_MANUFACTURER, IBEACON_DATA_LENGTH), \
+    IBEACON_COMPANY_ID_APPLE, IBEACON_PROXIMITY, uuid_bytes, \
+    WICED_BT_BEACON_LE16_INIT(major), WICED_BT_BEACON_LE16_INIT(minor), (uint8_t)(tx_power)
 
 /******************************************************************************
 * Function Name: wiced_bt_ibeacon_set_adv_data
@@ -226,12 +723,49 @@ void wiced_bt_ibeacon_set_adv_data(uint8_t ibeacon_uuid[LEN_UUID_128],
 
 
 
-/* Structure to hold advertisement element data */
-typedef struct
-{
-    uint8_t data[WICED_BT_BEACON_ADV_DATA_MAX];     /* Advertisement  data */
-    uint8_t len;                                    /* Advertisement length */
-    wiced_bt_ble_advert_type_t advert_type;         /* Advertisement data type */
-}wiced_bt_beacon_ble_advert_elem_t;
+/******************************************************************************
+* Function Name: wiced_bt_ibeacon_encode
+***************************************************************************//**
+*
+* \brief Encodes Apple iBeacon format advertising data in one pass.
+* \details Writes the Flags and Manufacturer Specific AD structures directly
+*          into the caller's buffer, without intermediate copies.
+*
+* @param[in]   ibeacon_uuid                 Customer beacon UUID
+* @param[in]   ibeacon_major_number         Beacon major number
+* @param[in]   ibeacon_minor_number         Beacon minor number
+* @param[in]   tx_power_lcl                 measured power
+* @param[out]  p_adv_data                   Buffer of advertisement data
+* @param[in]   adv_data_size                Size of p_adv_data
+*
+* \return     Length of advertisement data, or 0 if it does not fit in the buffer.
+*
+******************************************************************************/
+uint16_t wiced_bt_ibeacon_encode(const uint8_t ibeacon_uuid[LEN_UUID_128],
+                                 uint16_t ibeacon_major_number,
+                                 uint16_t ibeacon_minor_number,
+                                 uint8_t tx_power_lcl,
+                                 uint8_t *p_adv_data, uint16_t adv_data_size);
+
+/******************************************************************************
+* Function Name: wiced_bt_ibeacon_put
+***************************************************************************//**
+*
+* \brief Appends the iBeacon Manufacturer Specific AD structure.
+*
+* @param[in]   p_enc                        Encoder context
+* @param[in]   ibeacon_uuid                 Customer beacon UUID
+* @param[in]   ibeacon_major_number         Beacon major number
+* @param[in]   ibeacon_minor_number         Beacon minor number
+* @param[in]   tx_power_lcl                 measured power
+*
+* \return     WICED_TRUE if the AD structure fits in the buffer.
+*
+******************************************************************************/
+wiced_bool_t wiced_bt_ibeacon_put(wiced_bt_beacon_encoder_t *p_enc,
+                                  const uint8_t ibeacon_uuid[LEN_UUID_128],
+                                  uint16_t ibeacon_major_number,
+                                  uint16_t ibeacon_minor_number,
+                                  uint8_t tx_power_lcl);
 
 #endif /* _WICED_BT_BEACON_H_ */
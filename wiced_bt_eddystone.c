@@ -39,18 +39,92 @@
 #include "wiced_timer.h"
 #include "wiced_bt_beacon.h"
 #include "wiced_bt_gatt.h"
+#include "beacon_log.h"
 #include "stdio.h"
 
 /******************************************************************************
-*                               Functions
+*                               Constants
 ******************************************************************************/
-static void wiced_bt_eddystone_set_data_common(wiced_bt_beacon_ble_advert_elem_t *eddystone_adv_elem, uint8_t frame_type, uint8_t frame_len);
-void wiced_bt_beacon_set_adv_data(wiced_bt_beacon_ble_advert_elem_t *beacon_adv_elem, uint8_t num_elem,uint8_t adv_data[WICED_BT_BEACON_ADV_DATA_MAX], uint8_t *adv_len);
+/* URL trie node without a code, and the first nodes of the scheme and expansion levels */
+#define EDDYSTONE_URL_TRIE_NONE           0xff
+#define EDDYSTONE_URL_TRIE_SCHEMES        1
+#define EDDYSTONE_URL_TRIE_EXPANSIONS     20
+
+/* URL trie node: character, code of the word it ends or NONE, first child and next sibling, 0 for none */
+typedef struct
+{
+    char    ch;
+    uint8_t code;
+    uint8_t child;
+    uint8_t next;
+} wiced_bt_eddystone_url_node_t;
+
+/*
+ * Trie of the URL scheme prefixes and the expansion codes, built at compile
+ * time. Siblings are tried in order, so matching a word costs at most one
+ * compare per character plus the siblings skipped on the way.
+ */
+static const wiced_bt_eddystone_url_node_t wiced_bt_eddystone_url_trie[] =
+{
+    { 0,   EDDYSTONE_URL_TRIE_NONE,  0,  0 },  /*  0: none */
+    { 'h', EDDYSTONE_URL_TRIE_NONE,  2,  0 },  /*  1: h */
+    { 't', EDDYSTONE_URL_TRIE_NONE,  3,  0 },  /*  2: ht */
+    { 't', EDDYSTONE_URL_TRIE_NONE,  4,  0 },  /*  3: htt */
+    { 'p', EDDYSTONE_URL_TRIE_NONE,  5,  0 },  /*  4: http */
+    { ':', EDDYSTONE_URL_TRIE_NONE,  7,  6 },  /*  5: http: */
+    { 's', EDDYSTONE_URL_TRIE_NONE, 13,  0 },  /*  6: https */
+    { '/', EDDYSTONE_URL_TRIE_NONE,  8,  0 },  /*  7: http:/ */
+    { '/', 0x02,                     9,  0 },  /*  8: http:// */
+    { 'w', EDDYSTONE_URL_TRIE_NONE, 10,  0 },  /*  9: http://w */
+    { 'w', EDDYSTONE_URL_TRIE_NONE, 11,  0 },  /* 10: http://ww */
+    { 'w', EDDYSTONE_URL_TRIE_NONE, 12,  0 },  /* 11: http://www */
+    { '.', 0x00,                     0,  0 },  /* 12: http://www. */
+    { ':', EDDYSTONE_URL_TRIE_NONE, 14,  0 },  /* 13: https: */
+    { '/', EDDYSTONE_URL_TRIE_NONE, 15,  0 },  /* 14: https:/ */
+    { '/', 0x03,                    16,  0 },  /* 15: https:// */
+    { 'w', EDDYSTONE_URL_TRIE_NONE, 17,  0 },  /* 16: https://w */
+    { 'w', EDDYSTONE_URL_TRIE_NONE, 18,  0 },  /* 17: https://ww */
+    { 'w', EDDYSTONE_URL_TRIE_NONE, 19,  0 },  /* 18: https://www */
+    { '.', 0x01,                     0,  0 },  /* 19: https://www. */
+    { '.', EDDYSTONE_URL_TRIE_NONE, 21,  0 },  /* 20: . */
+    { 'c', EDDYSTONE_URL_TRIE_NONE, 28, 22 },  /* 21: .c */
+    { 'o', EDDYSTONE_URL_TRIE_NONE, 31, 23 },  /* 22: .o */
+    { 'e', EDDYSTONE_URL_TRIE_NONE, 34, 24 },  /* 23: .e */
+    { 'n', EDDYSTONE_URL_TRIE_NONE, 37, 25 },  /* 24: .n */
+    { 'i', EDDYSTONE_URL_TRIE_NONE, 40, 26 },  /* 25: .i */
+    { 'b', EDDYSTONE_URL_TRIE_NONE, 44, 27 },  /* 26: .b */
+    { 'g', EDDYSTONE_URL_TRIE_NONE, 47,  0 },  /* 27: .g */
+    { 'o', EDDYSTONE_URL_TRIE_NONE, 29,  0 },  /* 28: .co */
+    { 'm', 0x07,                    30,  0 },  /* 29: .com */
+    { '/', 0x00,                     0,  0 },  /* 30: .com/ */
+    { 'r', EDDYSTONE_URL_TRIE_NONE, 32,  0 },  /* 31: .or */
+    { 'g', 0x08,                    33,  0 },  /* 32: .org */
+    { '/', 0x01,                     0,  0 },  /* 33: .org/ */
+    { 'd', EDDYSTONE_URL_TRIE_NONE, 35,  0 },  /* 34: .ed */
+    { 'u', 0x09,                    36,  0 },  /* 35: .edu */
+    { '/', 0x02,                     0,  0 },  /* 36: .edu/ */
+    { 'e', EDDYSTONE_URL_TRIE_NONE, 38,  0 },  /* 37: .ne */
+    { 't', 0x0a,                    39,  0 },  /* 38: .net */
+    { '/', 0x03,                     0,  0 },  /* 39: .net/ */
+    { 'n', EDDYSTONE_URL_TRIE_NONE, 41,  0 },  /* 40: .in */
+    { 'f', EDDYSTONE_URL_TRIE_NONE, 42,  0 },  /* 41: .inf */
+    { 'o', 0x0b,                    43,  0 },  /* 42: .info */
+    { '/', 0x04,                     0,  0 },  /* 43: .info/ */
+    { 'i', EDDYSTONE_URL_TRIE_NONE, 45,  0 },  /* 44: .bi */
+    { 'z', 0x0c,                    46,  0 },  /* 45: .biz */
+    { '/', 0x05,                     0,  0 },  /* 46: .biz/ */
+    { 'o', EDDYSTONE_URL_TRIE_NONE, 48,  0 },  /* 47: .go */
+    { 'v', 0x0d,                    49,  0 },  /* 48: .gov */
+    { '/', 0x06,                     0,  0 },  /* 49: .gov/ */
+};
+
 /******************************************************************************
- *                               Constants
- ******************************************************************************/
-/* Google Eddystone */
-static wiced_bt_beacon_ble_advert_elem_t eddystone_adv_elem[EDDYSTONE_ELEM_NUM];
+*                               Functions
+******************************************************************************/
+static uint8_t wiced_bt_eddystone_url_match(uint8_t node, const char *p_str, uint8_t *p_code);
+static void wiced_bt_eddystone_encode_common(wiced_bt_beacon_encoder_t *p_enc, uint8_t *p_adv_data, uint16_t adv_data_size);
+static uint8_t *wiced_bt_eddystone_put_frame_hdr(wiced_bt_beacon_encoder_t *p_enc, uint8_t frame_type, uint8_t frame_len);
+static void wiced_bt_eddystone_put_le32(uint8_t *p, uint32_t value);
 
 /*
  * This function creates Google Eddystone UID format advertising data
@@ -60,24 +134,10 @@ void wiced_bt_eddystone_set_data_for_uid(uint8_t eddystone_ranging_data,
                                         uint8_t eddystone_instance[EDDYSTONE_UID_INSTANCE_ID_LEN],
                                         uint8_t adv_data[WICED_BT_BEACON_ADV_DATA_MAX], uint8_t *adv_len)
 {
-    uint8_t frame_data[EDDYSTONE_UID_FRAME_LEN];
-
-    printf("wiced_bt_eddystone_set_data_for_uid\n");
-
-    // Set common portion of the adv data
-    wiced_bt_eddystone_set_data_common(eddystone_adv_elem, EDDYSTONE_FRAME_TYPE_UID, EDDYSTONE_UID_FRAME_LEN);
-
-    // Set frame data
-    frame_data[0] = EDDYSTONE_FRAME_TYPE_UID;
-    frame_data[1] = eddystone_ranging_data;
-    memcpy( &frame_data[2], eddystone_namespace, EDDYSTONE_UID_NAMESPACE_LEN );
-    memcpy( &frame_data[12], eddystone_instance, EDDYSTONE_UID_INSTANCE_ID_LEN );
-
-    memcpy(&(eddystone_adv_elem[2].data[2]), frame_data, EDDYSTONE_UID_FRAME_LEN);
-
-    // Copy the adv data to output buffer
-    wiced_bt_beacon_set_adv_data(eddystone_adv_elem, EDDYSTONE_ELEM_NUM, adv_data, adv_len);
+    BEACON_LOG_DEBUG("wiced_bt_eddystone_set_data_for_uid\n");
 
+    *adv_len = (uint8_t)wiced_bt_eddystone_encode_uid(eddystone_ranging_data, eddystone_namespace, eddystone_instance,
+                                                      adv_data, WICED_BT_BEACON_ADV_DATA_MAX);
 }
 
 /*
@@ -88,24 +148,12 @@ void wiced_bt_eddystone_set_data_for_url(uint8_t tx_power,
                                         uint8_t encoded_url[EDDYSTONE_URL_VALUE_MAX_LEN],
                                         uint8_t adv_data[WICED_BT_BEACON_ADV_DATA_MAX], uint8_t *adv_len)
 {
-    uint8_t frame_data[EDDYSTONE_URL_FRAME_LEN];
     uint8_t len = strlen((char *)encoded_url);
 
-    printf("eddystone_set_data_for_url_adv\n");
+    BEACON_LOG_DEBUG("eddystone_set_data_for_url_adv\n");
 
-    // Set common portion of the adv data
-    wiced_bt_eddystone_set_data_common(eddystone_adv_elem, EDDYSTONE_FRAME_TYPE_URL, len + 3);
-
-    // Set frame data
-    frame_data[0] = EDDYSTONE_FRAME_TYPE_URL;
-    frame_data[1] = tx_power;
-    frame_data[2] = urlscheme;
-    memcpy(&frame_data[3], encoded_url, len);
-
-    memcpy(&(eddystone_adv_elem[2].data[2]), frame_data, len+3);
-
-    // Copy the adv data to output buffer
-    wiced_bt_beacon_set_adv_data(eddystone_adv_elem, EDDYSTONE_ELEM_NUM, adv_data, adv_len);
+    *adv_len = (uint8_t)wiced_bt_eddystone_encode_url(tx_power, urlscheme, encoded_url, len,
+                                                      adv_data, WICED_BT_BEACON_ADV_DATA_MAX);
 }
 
 /*
@@ -115,22 +163,9 @@ void wiced_bt_eddystone_set_data_for_eid(uint8_t eddystone_ranging_data,
                                                 uint8_t eid[EDDYSTONE_EID_LEN],
                                                 uint8_t adv_data[WICED_BT_BEACON_ADV_DATA_MAX], uint8_t *adv_len)
 {
-    uint8_t frame_data[EDDYSTONE_EID_FRAME_LEN];
-
-    printf("eddystone_set_data_for_uid_adv\n");
+    BEACON_LOG_DEBUG("eddystone_set_data_for_uid_adv\n");
 
-    // Set common portion of the adv data
-    wiced_bt_eddystone_set_data_common(eddystone_adv_elem, EDDYSTONE_FRAME_TYPE_EID, EDDYSTONE_EID_FRAME_LEN);
-
-    // Set frame data
-    frame_data[0] = EDDYSTONE_FRAME_TYPE_EID;
-    frame_data[1] = eddystone_ranging_data;
-    memcpy( &frame_data[2], eid, EDDYSTONE_EID_LEN );
-
-    memcpy(&(eddystone_adv_elem[2].data[2]), frame_data, EDDYSTONE_EID_FRAME_LEN);
-
-    // Copy the adv data to output buffer
-    wiced_bt_beacon_set_adv_data(eddystone_adv_elem, EDDYSTONE_ELEM_NUM, adv_data, adv_len);
+    *adv_len = (uint8_t)wiced_bt_eddystone_encode_eid(eddystone_ranging_data, eid, adv_data, WICED_BT_BEACON_ADV_DATA_MAX);
 }
 
 /*
@@ -142,33 +177,10 @@ void wiced_bt_eddystone_set_data_for_tlm_unencrypted(uint16_t vbatt,
                                                             uint32_t sec_cnt,
                                                             uint8_t adv_data[WICED_BT_BEACON_ADV_DATA_MAX], uint8_t *adv_len)
 {
-    uint8_t frame_data[EDDYSTONE_TLM_UNENCRYPTED_FRAME_LEN];
-
-    printf("wiced_bt_eddystone_set_data_for_tlm_unencrypted\n");
-
-    // Set common portion of the adv data
-    wiced_bt_eddystone_set_data_common(eddystone_adv_elem, EDDYSTONE_FRAME_TYPE_TLM, EDDYSTONE_TLM_UNENCRYPTED_FRAME_LEN);
+    BEACON_LOG_DEBUG("wiced_bt_eddystone_set_data_for_tlm_unencrypted\n");
 
-    // Set frame data
-    frame_data[0] = EDDYSTONE_FRAME_TYPE_TLM;
-    frame_data[1] = EDDYSTONE_TLM_UNENCRYPTED_VERSION;
-    frame_data[2] = vbatt & 0xff;
-    frame_data[3] = (vbatt >> 8) & 0xff;
-    frame_data[4] = temp & 0xff;
-    frame_data[5] = (temp >> 8) & 0xff;
-    frame_data[6] = adv_cnt & 0xff;
-    frame_data[7] = (adv_cnt >> 8) & 0xff;
-    frame_data[8] = (adv_cnt >> 16) & 0xff;
-    frame_data[9] = (adv_cnt >> 24) & 0xff;
-    frame_data[10] = sec_cnt & 0xff;
-    frame_data[11] = (sec_cnt >> 8) & 0xff;
-    frame_data[12] = (sec_cnt >> 16) & 0xff;
-    frame_data[13] = (sec_cnt >> 24) & 0xff;
-
-    memcpy(&(eddystone_adv_elem[2].data[2]), frame_data, EDDYSTONE_TLM_UNENCRYPTED_FRAME_LEN);
-
-    // Copy the adv data to output buffer
-    wiced_bt_beacon_set_adv_data(eddystone_adv_elem, EDDYSTONE_ELEM_NUM, adv_data, adv_len);
+    *adv_len = (uint8_t)wiced_bt_eddystone_encode_tlm_unencrypted(vbatt, temp, adv_cnt, sec_cnt,
+                                                                  adv_data, WICED_BT_BEACON_ADV_DATA_MAX);
 }
 
 /*
@@ -178,47 +190,385 @@ void wiced_bt_eddystone_set_data_for_tlm_encrypted(uint8_t etlm[EDDYSTONE_ETLM_L
                                                           uint16_t salt, uint16_t mic,
                                                           uint8_t adv_data[WICED_BT_BEACON_ADV_DATA_MAX], uint8_t *adv_len)
 {
-    uint8_t frame_data[EDDYSTONE_TLM_ENCRYPTED_FRAME_LEN];
+    BEACON_LOG_DEBUG("wiced_bt_eddystone_set_data_for_tlm_encrypted\n");
+
+    *adv_len = (uint8_t)wiced_bt_eddystone_encode_tlm_encrypted(etlm, salt, mic, adv_data, WICED_BT_BEACON_ADV_DATA_MAX);
+}
+
+/*
+ * This function encodes Google Eddystone UID format advertising data into the caller's buffer
+ */
+uint16_t wiced_bt_eddystone_encode_uid(uint8_t eddystone_ranging_data,
+                                       const uint8_t eddystone_namespace[EDDYSTONE_UID_NAMESPACE_LEN],
+                                       const uint8_t eddystone_instance[EDDYSTONE_UID_INSTANCE_ID_LEN],
+                                       uint8_t *p_adv_data, uint16_t adv_data_size)
+{
+    wiced_bt_beacon_encoder_t enc;
+
+    wiced_bt_eddystone_encode_common(&enc, p_adv_data, adv_data_size);
+    wiced_bt_eddystone_put_uid(&enc, eddystone_ranging_data, eddystone_namespace, eddystone_instance);
+    return wiced_bt_beacon_encoder_len(&enc);
+}
+
+/*
+ * This function encodes Google Eddystone URL format advertising data into the caller's buffer
+ */
+uint16_t wiced_bt_eddystone_encode_url(uint8_t tx_power,
+                                       uint8_t urlscheme,
+                                       const uint8_t *encoded_url, uint8_t url_len,
+                                       uint8_t *p_adv_data, uint16_t adv_data_size)
+{
+    wiced_bt_beacon_encoder_t enc;
+
+    wiced_bt_eddystone_encode_common(&enc, p_adv_data, adv_data_size);
+    wiced_bt_eddystone_put_url(&enc, tx_power, urlscheme, encoded_url, url_len);
+    return wiced_bt_beacon_encoder_len(&enc);
+}
+
+/*
+ * This function encodes Google Eddystone EID format advertising data into the caller's buffer
+ */
+uint16_t wiced_bt_eddystone_encode_eid(uint8_t eddystone_ranging_data,
+                                       const uint8_t eid[EDDYSTONE_EID_LEN],
+                                       uint8_t *p_adv_data, uint16_t adv_data_size)
+{
+    wiced_bt_beacon_encoder_t enc;
+
+    wiced_bt_eddystone_encode_common(&enc, p_adv_data, adv_data_size);
+    wiced_bt_eddystone_put_eid(&enc, eddystone_ranging_data, eid);
+    return wiced_bt_beacon_encoder_len(&enc);
+}
+
+/*
+ * This function encodes Google Eddystone TLM unencrypted format advertising data into the caller's buffer
+ */
+uint16_t wiced_bt_eddystone_encode_tlm_unencrypted(uint16_t vbatt,
+                                                   uint16_t temp,
+                                                   uint32_t adv_cnt,
+                                                   uint32_t sec_cnt,
+                                                   uint8_t *p_adv_data, uint16_t adv_data_size)
+{
+    wiced_bt_beacon_encoder_t enc;
+
+    wiced_bt_eddystone_encode_common(&enc, p_adv_data, adv_data_size);
+    wiced_bt_eddystone_put_tlm_unencrypted(&enc, vbatt, temp, adv_cnt, sec_cnt);
+    return wiced_bt_beacon_encoder_len(&enc);
+}
+
+/*
+ * This function updates the fields of an encoded TLM unencrypted advertisement in place.
+ * VBATT and TEMP are adjacent, so the frame is patched with three 32-bit stores.
+ */
+void wiced_bt_eddystone_patch_tlm_unencrypted(uint8_t *p_adv_data,
+                                              uint16_t vbatt,
+                                              uint16_t temp,
+                                              uint32_t adv_cnt,
+                                              uint32_t sec_cnt)
+{
+    wiced_bt_eddystone_patch_tlm_frame(&p_adv_data[EDDYSTONE_ADV_HDR_LEN], vbatt, temp, adv_cnt, sec_cnt);
+}
+
+/*
+ * This function updates the fields of a TLM unencrypted frame in place, p_frame is its frame type byte
+ */
+void wiced_bt_eddystone_patch_tlm_frame(uint8_t *p_frame,
+                                        uint16_t vbatt,
+                                        uint16_t temp,
+                                        uint32_t adv_cnt,
+                                        uint32_t sec_cnt)
+{
+    wiced_bt_eddystone_put_le32(&p_frame[EDDYSTONE_TLM_VBATT_OFFSET - EDDYSTONE_ADV_HDR_LEN], (uint32_t)vbatt | ((uint32_t)temp << 16));
+    wiced_bt_eddystone_put_le32(&p_frame[EDDYSTONE_TLM_ADV_CNT_OFFSET - EDDYSTONE_ADV_HDR_LEN], adv_cnt);
+    wiced_bt_eddystone_put_le32(&p_frame[EDDYSTONE_TLM_SEC_CNT_OFFSET - EDDYSTONE_ADV_HDR_LEN], sec_cnt);
+}
+
+/*
+ * This function encodes Google Eddystone TLM encrypted format advertising data into the caller's buffer
+ */
+uint16_t wiced_bt_eddystone_encode_tlm_encrypted(const uint8_t etlm[EDDYSTONE_ETLM_LEN],
+                                                 uint16_t salt,
+                                                 uint16_t mic,
+                                                 uint8_t *p_adv_data, uint16_t adv_data_size)
+{
+    wiced_bt_beacon_encoder_t enc;
 
-    printf("wiced_bt_eddystone_set_data_for_tlm_encrypted\n");
+    wiced_bt_eddystone_encode_common(&enc, p_adv_data, adv_data_size);
+    wiced_bt_eddystone_put_tlm_encrypted(&enc, etlm, salt, mic);
+    return wiced_bt_beacon_encoder_len(&enc);
+}
+
+/*
+ * This function appends the Complete 16-bit UUID list with the Eddystone UUID
+ */
+wiced_bool_t wiced_bt_eddystone_put_uuid_list(wiced_bt_beacon_encoder_t *p_enc)
+{
+    uint8_t *p = wiced_bt_beacon_encoder_reserve(p_enc, BTM_BLE_ADVERT_TYPE_16SRV_COMPLETE, LEN_UUID_16);
+
+    if (p == NULL)
+    {
+        return WICED_FALSE;
+    }
+    UINT16_TO_STREAM(p, EDDYSTONE_UUID16);
+    return WICED_TRUE;
+}
+
+/*
+ * This function appends an Eddystone UID frame
+ */
+wiced_bool_t wiced_bt_eddystone_put_uid(wiced_bt_beacon_encoder_t *p_enc,
+                                        uint8_t eddystone_ranging_data,
+                                        const uint8_t eddystone_namespace[EDDYSTONE_UID_NAMESPACE_LEN],
+                                        const uint8_t eddystone_instance[EDDYSTONE_UID_INSTANCE_ID_LEN])
+{
+    uint8_t *p = wiced_bt_eddystone_put_frame_hdr(p_enc, EDDYSTONE_FRAME_TYPE_UID, EDDYSTONE_UID_FRAME_LEN);
+
+    if (p == NULL)
+    {
+        return WICED_FALSE;
+    }
+
+    // Set frame data
+    *p++ = eddystone_ranging_data;
+    memcpy(p, eddystone_namespace, EDDYSTONE_UID_NAMESPACE_LEN);
+    p += EDDYSTONE_UID_NAMESPACE_LEN;
+    memcpy(p, eddystone_instance, EDDYSTONE_UID_INSTANCE_ID_LEN);
+    p += EDDYSTONE_UID_INSTANCE_ID_LEN;
+
+    // RFU, must be 0
+    *p++ = 0;
+    *p++ = 0;
+
+    return WICED_TRUE;
+}
+
+/*
+ * This function appends an Eddystone URL frame
+ */
+wiced_bool_t wiced_bt_eddystone_put_url(wiced_bt_beacon_encoder_t *p_enc,
+                                        uint8_t tx_power,
+                                        uint8_t urlscheme,
+                                        const uint8_t *encoded_url, uint8_t url_len)
+{
+    uint8_t *p;
+
+    if (url_len > EDDYSTONE_URL_VALUE_MAX_LEN)
+    {
+        p_enc->overflow = WICED_TRUE;
+        return WICED_FALSE;
+    }
+
+    p = wiced_bt_eddystone_put_frame_hdr(p_enc, EDDYSTONE_FRAME_TYPE_URL, url_len + 3);
+    if (p == NULL)
+    {
+        return WICED_FALSE;
+    }
+
+    // Set frame data
+    *p++ = tx_power;
+    *p++ = urlscheme;
+    memcpy(p, encoded_url, url_len);
+
+    return WICED_TRUE;
+}
+
+/*
+ * This function compresses a full URL into a URL scheme and encoded URL
+ */
+wiced_bool_t wiced_bt_eddystone_compress_url(const char *url,
+                                             uint8_t *p_urlscheme,
+                                             uint8_t encoded_url[EDDYSTONE_URL_VALUE_MAX_LEN],
+                                             uint8_t *p_url_len)
+{
+    uint8_t len = 0;
+    uint8_t match, code;
+
+    match = wiced_bt_eddystone_url_match(EDDYSTONE_URL_TRIE_SCHEMES, url, p_urlscheme);
+    if (match == 0)
+    {
+        return WICED_FALSE;
+    }
+    url += match;
+
+    while (*url != '\0')
+    {
+        // only a '.' can start an expansion
+        match = (*url == '.') ? wiced_bt_eddystone_url_match(EDDYSTONE_URL_TRIE_EXPANSIONS, url, &code) : 0;
+        if (match == 0)
+        {
+            code = (uint8_t)*url;
+            match = 1;
+            if (code < EDDYSTONE_URL_CHAR_MIN || code > EDDYSTONE_URL_CHAR_MAX)
+            {
+                return WICED_FALSE;
+            }
+        }
+        if (len == EDDYSTONE_URL_VALUE_MAX_LEN)
+        {
+            return WICED_FALSE;
+        }
+        encoded_url[len++] = code;
+        url += match;
+    }
+
+    *p_url_len = len;
+    return WICED_TRUE;
+}
+
+/*
+ * This function appends an Eddystone URL frame of a full URL
+ */
+wiced_bool_t wiced_bt_eddystone_put_url_string(wiced_bt_beacon_encoder_t *p_enc,
+                                               uint8_t tx_power,
+                                               const char *url)
+{
+    uint8_t encoded_url[EDDYSTONE_URL_VALUE_MAX_LEN];
+    uint8_t urlscheme, url_len;
+
+    if (!wiced_bt_eddystone_compress_url(url, &urlscheme, encoded_url, &url_len))
+    {
+        p_enc->overflow = WICED_TRUE;
+        return WICED_FALSE;
+    }
+    return wiced_bt_eddystone_put_url(p_enc, tx_power, urlscheme, encoded_url, url_len);
+}
 
-    // Set common portion of the adv data
-    wiced_bt_eddystone_set_data_common(eddystone_adv_elem, EDDYSTONE_FRAME_TYPE_TLM, EDDYSTONE_TLM_ENCRYPTED_FRAME_LEN);
+/*
+ * This function appends an Eddystone EID frame
+ */
+wiced_bool_t wiced_bt_eddystone_put_eid(wiced_bt_beacon_encoder_t *p_enc,
+                                        uint8_t eddystone_ranging_data,
+                                        const uint8_t eid[EDDYSTONE_EID_LEN])
+{
+    uint8_t *p = wiced_bt_eddystone_put_frame_hdr(p_enc, EDDYSTONE_FRAME_TYPE_EID, EDDYSTONE_EID_FRAME_LEN);
+
+    if (p == NULL)
+    {
+        return WICED_FALSE;
+    }
 
     // Set frame data
-    frame_data[0] = EDDYSTONE_FRAME_TYPE_TLM;
-    frame_data[1] = EDDYSTONE_TLM_ENCRYPTED_VERSION;
-    memcpy(&frame_data[2], etlm, EDDYSTONE_ETLM_LEN);
-    frame_data[14] = salt & 0xff;
-    frame_data[15] = (salt >> 8) & 0xff;
-    frame_data[16] = mic & 0xff;
-    frame_data[17] = (mic >> 8) & 0xff;
+    *p++ = eddystone_ranging_data;
+    memcpy(p, eid, EDDYSTONE_EID_LEN);
+
+    return WICED_TRUE;
+}
+
+/*
+ * This function appends an Eddystone TLM unencrypted frame
+ */
+wiced_bool_t wiced_bt_eddystone_put_tlm_unencrypted(wiced_bt_beacon_encoder_t *p_enc,
+                                                    uint16_t vbatt,
+                                                    uint16_t temp,
+                                                    uint32_t adv_cnt,
+                                                    uint32_t sec_cnt)
+{
+    uint8_t *p = wiced_bt_eddystone_put_frame_hdr(p_enc, EDDYSTONE_FRAME_TYPE_TLM, EDDYSTONE_TLM_UNENCRYPTED_FRAME_LEN);
 
-    memcpy(&(eddystone_adv_elem[2].data[2]), frame_data, EDDYSTONE_TLM_ENCRYPTED_FRAME_LEN);
+    if (p == NULL)
+    {
+        return WICED_FALSE;
+    }
+
+    // Set frame data
+    UINT8_TO_STREAM(p, EDDYSTONE_TLM_UNENCRYPTED_VERSION);
+    UINT16_TO_STREAM(p, vbatt);
+    UINT16_TO_STREAM(p, temp);
+    UINT32_TO_STREAM(p, adv_cnt);
+    UINT32_TO_STREAM(p, sec_cnt);
 
-    // Copy the adv data to output buffer
-    wiced_bt_beacon_set_adv_data(eddystone_adv_elem, EDDYSTONE_ELEM_NUM, adv_data, adv_len);
+    return WICED_TRUE;
 }
 
-/* Sets up data common for all Eddystone frames */
-static void wiced_bt_eddystone_set_data_common(wiced_bt_beacon_ble_advert_elem_t *eddystone_adv_elem, uint8_t frame_type, uint8_t frame_len)
+/*
+ * This function appends an Eddystone TLM encrypted frame
+ */
+wiced_bool_t wiced_bt_eddystone_put_tlm_encrypted(wiced_bt_beacon_encoder_t *p_enc,
+                                                  const uint8_t etlm[EDDYSTONE_ETLM_LEN],
+                                                  uint16_t salt,
+                                                  uint16_t mic)
 {
-    uint8_t flag = BTM_BLE_GENERAL_DISCOVERABLE_FLAG | BTM_BLE_BREDR_NOT_SUPPORTED;
-    uint8_t eddyston_uuid[LEN_UUID_16] = { BIT16_TO_8(EDDYSTONE_UUID16) };
+    uint8_t *p = wiced_bt_eddystone_put_frame_hdr(p_enc, EDDYSTONE_FRAME_TYPE_TLM, EDDYSTONE_TLM_ENCRYPTED_FRAME_LEN);
 
-    // First adv element
-    eddystone_adv_elem[0].len = 2;
-    eddystone_adv_elem[0].advert_type = BTM_BLE_ADVERT_TYPE_FLAG;
-    eddystone_adv_elem[0].data[0] = flag;
+    if (p == NULL)
+    {
+        return WICED_FALSE;
+    }
 
-    // Second adv element
-    eddystone_adv_elem[1].len = 3;
-    eddystone_adv_elem[1].advert_type = BTM_BLE_ADVERT_TYPE_16SRV_COMPLETE;
-    memcpy(eddystone_adv_elem[1].data, eddyston_uuid, 2);
+    // Set frame data
+    UINT8_TO_STREAM(p, EDDYSTONE_TLM_ENCRYPTED_VERSION);
+    memcpy(p, etlm, EDDYSTONE_ETLM_LEN);
+    p += EDDYSTONE_ETLM_LEN;
+    UINT16_TO_STREAM(p, salt);
+    UINT16_TO_STREAM(p, mic);
 
-    // Third adv element (partial), rest is frame specific
-    eddystone_adv_elem[2].len = frame_len + 3;  // frame_len + advert_type (1) + uuid (2)
-    eddystone_adv_elem[2].advert_type = BTM_BLE_ADVERT_TYPE_SERVICE_DATA;
-    eddystone_adv_elem[2].data[0] = eddyston_uuid[0];
-    eddystone_adv_elem[2].data[1] = eddyston_uuid[1];
+    return WICED_TRUE;
+}
+
+/*
+ * Walks the URL trie from the first node of a level along p_str. It returns the
+ * length of the longest word matched and sets its code, or returns 0.
+ */
+static uint8_t wiced_bt_eddystone_url_match(uint8_t node, const char *p_str, uint8_t *p_code)
+{
+    const wiced_bt_eddystone_url_node_t *p_node;
+    uint8_t len = 0;
+    uint8_t i;
+
+    for (i = 0; node != 0 && p_str[i] != '\0'; i++)
+    {
+        p_node = &wiced_bt_eddystone_url_trie[node];
+        while (p_node->ch != p_str[i])
+        {
+            if (p_node->next == 0)
+            {
+                return len;
+            }
+            p_node = &wiced_bt_eddystone_url_trie[p_node->next];
+        }
+        if (p_node->code != EDDYSTONE_URL_TRIE_NONE)
+        {
+            *p_code = p_node->code;
+            len = i + 1;
+        }
+        node = p_node->child;
+    }
+    return len;
+}
+
+/* Starts an encoding pass with the Flags and UUID list AD structures common to all Eddystone advertisements */
+static void wiced_bt_eddystone_encode_common(wiced_bt_beacon_encoder_t *p_enc, uint8_t *p_adv_data, uint16_t adv_data_size)
+{
+    wiced_bt_beacon_encoder_init(p_enc, p_adv_data, adv_data_size);
+    wiced_bt_beacon_encoder_put_flags(p_enc, WICED_BT_BEACON_FLAGS);
+    wiced_bt_eddystone_put_uuid_list(p_enc);
+}
+
+/*
+ * Appends the Service Data AD structure header and frame type of an Eddystone frame.
+ * It returns the position of the rest of the frame, or NULL if the frame does not fit.
+ */
+static uint8_t *wiced_bt_eddystone_put_frame_hdr(wiced_bt_beacon_encoder_t *p_enc, uint8_t frame_type, uint8_t frame_len)
+{
+    uint8_t *p = wiced_bt_beacon_encoder_reserve(p_enc, BTM_BLE_ADVERT_TYPE_SERVICE_DATA, LEN_UUID_16 + frame_len);
+
+    if (p == NULL)
+    {
+        return NULL;
+    }
+    UINT16_TO_STREAM(p, EDDYSTONE_UUID16);
+    UINT8_TO_STREAM(p, frame_type);
+    return p;
+}
+
+/*
+ * Stores a 32-bit value little-endian at any alignment. On little-endian targets
+ * this is a single (unaligned) word store.
+ */
+static void wiced_bt_eddystone_put_le32(uint8_t *p, uint32_t value)
+{
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    memcpy(p, &value, sizeof(value));
+#else
+    UINT32_TO_STREAM(p, value);
+#endif
 }
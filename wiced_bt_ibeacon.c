@@ -48,15 +48,12 @@
  ******************************************************************************/
 
  /* local data used by methods */
-static wiced_bt_beacon_ble_advert_elem_t ibeacon_adv_elem[IBEACON_ELEM_NUM];
 const uint8_t ibeacon_type[ LEN_UUID_16 ] = { IBEACON_PROXIMITY };
 const uint8_t ibeacon_company_id[ LEN_UUID_16 ] = { IBEACON_COMPANY_ID_APPLE };
 
 /******************************************************************************
 *                              Function Definitions
 ******************************************************************************/
-void wiced_bt_beacon_set_adv_data(wiced_bt_beacon_ble_advert_elem_t *beacon_adv_elem, uint8_t num_elem,
-    uint8_t adv_data[WICED_BT_BEACON_ADV_DATA_MAX], uint8_t *adv_len);
 
 /*
  * This function creates Apple iBeacon advertising data format. Calling applications provides
@@ -69,42 +66,69 @@ void wiced_bt_ibeacon_set_adv_data(uint8_t ibeacon_uuid[LEN_UUID_128],
                                     uint8_t tx_power_lcl,
                                     uint8_t adv_data[WICED_BT_BEACON_ADV_DATA_MAX], uint8_t *adv_len)
 {
-    uint8_t flag = BTM_BLE_GENERAL_DISCOVERABLE_FLAG|BTM_BLE_BREDR_NOT_SUPPORTED;
-    uint8_t ibeacon_data[IBEACON_DATA_LENGTH];
+    *adv_len = (uint8_t)wiced_bt_ibeacon_encode(ibeacon_uuid, ibeacon_major_number, ibeacon_minor_number, tx_power_lcl,
+                                                adv_data, WICED_BT_BEACON_ADV_DATA_MAX);
+}
+
+/*
+ * This function encodes Apple iBeacon advertising data directly into the caller's buffer.
+ * It returns the advertisement data length, or 0 if the buffer is too small.
+ */
+uint16_t wiced_bt_ibeacon_encode(const uint8_t ibeacon_uuid[LEN_UUID_128],
+                                 uint16_t ibeacon_major_number,
+                                 uint16_t ibeacon_minor_number,
+                                 uint8_t tx_power_lcl,
+                                 uint8_t *p_adv_data, uint16_t adv_data_size)
+{
+    wiced_bt_beacon_encoder_t enc;
+
+    wiced_bt_beacon_encoder_init(&enc, p_adv_data, adv_data_size);
 
     /* first adv element */
-    ibeacon_adv_elem[0].len          = sizeof(uint8_t)+1;
-    ibeacon_adv_elem[0].advert_type  = BTM_BLE_ADVERT_TYPE_FLAG;
-    ibeacon_adv_elem[0].data[0]       = flag;
+    wiced_bt_beacon_encoder_put_flags(&enc, WICED_BT_BEACON_FLAGS);
 
     /* Second adv element */
-    ibeacon_adv_elem[1].len          = IBEACON_DATA_LENGTH+1;
-    ibeacon_adv_elem[1].advert_type  = BTM_BLE_ADVERT_TYPE_MANUFACTURER;
+    wiced_bt_ibeacon_put(&enc, ibeacon_uuid, ibeacon_major_number, ibeacon_minor_number, tx_power_lcl);
+
+    return wiced_bt_beacon_encoder_len(&enc);
+}
+
+/*
+ * This function appends the iBeacon Manufacturer Specific AD structure
+ */
+wiced_bool_t wiced_bt_ibeacon_put(wiced_bt_beacon_encoder_t *p_enc,
+                                  const uint8_t ibeacon_uuid[LEN_UUID_128],
+                                  uint16_t ibeacon_major_number,
+                                  uint16_t ibeacon_minor_number,
+                                  uint8_t tx_power_lcl)
+{
+    uint8_t *p = wiced_bt_beacon_encoder_reserve(p_enc, BTM_BLE_ADVERT_TYPE_MANUFACTURER, IBEACON_DATA_LENGTH);
+
+    if (p == NULL)
+    {
+        return WICED_FALSE;
+    }
 
     /* Setting Company Identifier */
-    ibeacon_data[0] = ibeacon_company_id[0];
-    ibeacon_data[1] = ibeacon_company_id[1];
+    UINT8_TO_STREAM(p, ibeacon_company_id[0]);
+    UINT8_TO_STREAM(p, ibeacon_company_id[1]);
 
     /* Setting beacon type */
-    ibeacon_data[2] = ibeacon_type[0];
-    ibeacon_data[3] = ibeacon_type[1];
+    UINT8_TO_STREAM(p, ibeacon_type[0]);
+    UINT8_TO_STREAM(p, ibeacon_type[1]);
 
     /* Setting the ibeacon UUID in the manufacturer data */
-    memcpy( &ibeacon_data[4], ibeacon_uuid, LEN_UUID_128 );
+    memcpy(p, ibeacon_uuid, LEN_UUID_128);
+    p += LEN_UUID_128;
 
     /* Setting the Major field */
-    ibeacon_data[20] = ibeacon_major_number & 0xff;
-    ibeacon_data[21] = (ibeacon_major_number >> 8) & 0xff;
+    UINT16_TO_STREAM(p, ibeacon_major_number);
 
     /* Setting the Minor field */
-    ibeacon_data[22] = ibeacon_minor_number & 0xff;
-    ibeacon_data[23] = (ibeacon_minor_number >> 8) & 0xff;
+    UINT16_TO_STREAM(p, ibeacon_minor_number);
 
     /* Measured power */
-    ibeacon_data[24] = tx_power_lcl;
-
-    memcpy(ibeacon_adv_elem[1].data, ibeacon_data, IBEACON_DATA_LENGTH);
+    UINT8_TO_STREAM(p, tx_power_lcl);
 
-    // Copy the adv data to output buffer
-    wiced_bt_beacon_set_adv_data(ibeacon_adv_elem, IBEACON_ELEM_NUM, adv_data, adv_len);
+    return WICED_TRUE;
 }